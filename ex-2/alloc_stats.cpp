@@ -0,0 +1,67 @@
+#include "alloc_stats.h"
+#include <new>
+#include <cstdlib>
+#include <malloc.h>
+
+/* 线程私有的计数器（平凡类型，无需动态初始化，可在任何分配中安全访问） */
+struct AllocCounters {
+    uint64_t allocs;
+    uint64_t frees;
+    uint64_t bytes;
+    int64_t live;
+    int64_t peak;
+};
+
+static bool g_tracking = false;
+static thread_local AllocCounters t_counters;
+
+/* 全局分配函数替换 */
+// 其余形式（new[]、nothrow、带大小的delete等）在libstdc++中均转发到以下两个函数
+void* operator new(std::size_t size) {
+    void* p = malloc(size ? size : 1);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    if (g_tracking) {
+        int64_t usable = (int64_t)malloc_usable_size(p);
+        t_counters.allocs++;
+        t_counters.bytes += size;
+        t_counters.live += usable;
+        if (t_counters.live > t_counters.peak) {
+            t_counters.peak = t_counters.live;
+        }
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    if (p == nullptr) return;
+    if (g_tracking) {
+        t_counters.frees++;
+        t_counters.live -= (int64_t)malloc_usable_size(p);
+    }
+    free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    operator delete(p);
+}
+
+/* 接口实现 */
+void allocTrackingEnable() {
+    g_tracking = true;
+}
+
+bool allocTrackingEnabled() {
+    return g_tracking;
+}
+
+AllocSnapshot allocSnapshot() {
+    AllocSnapshot snap = { t_counters.allocs, t_counters.frees, t_counters.bytes,
+                           t_counters.live, t_counters.peak };
+    return snap;
+}
+
+void allocResetPeak() {
+    t_counters.peak = t_counters.live;
+}
@@ -0,0 +1,33 @@
+#ifndef ALLOC_STATS_H
+#define ALLOC_STATS_H
+
+#include <cstdint>
+
+/*
+ * 内存分配统计
+ * 本模块替换全局 operator new/delete，启用后按线程统计分配次数、字节数
+ * 与当前/峰值存活字节数；未启用时每次分配只多一次标志判断。
+ */
+
+/* 某一时刻的分配计数（当前线程） */
+struct AllocSnapshot {
+    uint64_t allocs;    // 累计分配次数
+    uint64_t frees;     // 累计释放次数
+    uint64_t bytes;     // 累计分配字节数
+    int64_t live;       // 当前存活字节数
+    int64_t peak;       // 自上次allocResetPeak以来的峰值存活字节数
+};
+
+// 启用分配统计（须在开始分析前调用）
+void allocTrackingEnable();
+
+// 是否启用了分配统计
+bool allocTrackingEnabled();
+
+// 获取当前线程的分配计数
+AllocSnapshot allocSnapshot();
+
+// 将当前线程的峰值重置为当前存活字节数
+void allocResetPeak();
+
+#endif /* ALLOC_STATS_H */
@@ -0,0 +1,326 @@
+#include "archive.h"
+#include <atomic>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+static const char kFileMagic[8] = { 'M', 'I', 'N', 'I', 'A', 'R', 'C', '\0' };
+static const char kTrailerMagic[8] = { 'M', 'I', 'N', 'I', 'I', 'D', 'X', '\0' };
+static const uint32_t kVersion = 1;
+static const uint32_t kRecordMagic = 0x44434552;  // "RECD"
+static const uint32_t kIndexMagic = 0x58444e49;   // "INDX"
+static const size_t kFileHeaderSize = 16;
+static const size_t kTrailerSize = 16;
+
+/* 写入状态 */
+// 索引节点：每次追加生成一个，用无锁栈串起来，关闭时统一排序写出
+struct IndexNode {
+    ArchiveRecord record;
+    IndexNode* next;
+};
+
+static int g_fd = -1;
+static std::string g_path;
+static std::atomic<uint64_t> g_end(0);            // 下一条记录的偏移
+static std::atomic<IndexNode*> g_indexHead(nullptr);
+static std::atomic<bool> g_writeFailed(false);
+
+/* INFO 编码 */
+
+static void putU32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back((char)(value >> (8 * i)));
+    }
+}
+
+static void putU64(std::string& out, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out.push_back((char)(value >> (8 * i)));
+    }
+}
+
+static uint32_t getU32(const char* p) {
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; i--) {
+        value = (value << 8) | (unsigned char)p[i];
+    }
+    return value;
+}
+
+static uint64_t getU64(const char* p) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; i--) {
+        value = (value << 8) | (unsigned char)p[i];
+    }
+    return value;
+}
+
+// 在指定偏移写入全部数据
+static bool writeAt(int fd, const std::string& data, uint64_t offset) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t put = pwrite(fd, data.data() + written, data.size() - written, (off_t)(offset + written));
+        if (put < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        written += (size_t)put;
+    }
+    return true;
+}
+
+// 从指定偏移读取len字节，不足时返回false
+static bool readAt(int fd, uint64_t offset, size_t len, std::string& data) {
+    data.resize(len);
+    size_t filled = 0;
+    while (filled < len) {
+        ssize_t got = pread(fd, &data[filled], len - filled, (off_t)(offset + filled));
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (got == 0) return false;
+        filled += (size_t)got;
+    }
+    return true;
+}
+
+/* 接口实现 */
+
+bool archiveOpen(const std::string& path) {
+    g_fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (g_fd < 0) {
+        return false;
+    }
+    std::string header(kFileMagic, sizeof(kFileMagic));
+    putU32(header, kVersion);
+    putU32(header, 0);
+    if (!writeAt(g_fd, header, 0)) {
+        close(g_fd);
+        g_fd = -1;
+        return false;
+    }
+    g_path = path;
+    g_end = kFileHeaderSize;
+    g_indexHead = nullptr;
+    g_writeFailed = false;
+    return true;
+}
+
+bool archiveEnabled() {
+    return g_fd >= 0;
+}
+
+const std::string& archivePath() {
+    return g_path;
+}
+
+bool archiveAppend(const std::string& inputPath, const std::vector<OutputFile>& files) {
+    IndexNode* node = new IndexNode();
+    node->record.path = inputPath;
+
+    // 在本线程内编码整条记录，内容偏移先按记录内的相对位置记下
+    std::string blob;
+    putU32(blob, kRecordMagic);
+    putU32(blob, (uint32_t)inputPath.size());
+    putU32(blob, (uint32_t)files.size());
+    putU32(blob, 0);
+    blob += inputPath;
+    for (const auto& file : files) {
+        putU32(blob, (uint32_t)file.name.size());
+        putU32(blob, 0);
+        putU64(blob, file.content.size());
+        blob += file.name;
+        node->record.entries.push_back({ file.name, blob.size(), file.content.size() });
+        blob += file.content;
+    }
+
+    // 预留空间：各线程写入互不重叠的区域
+    uint64_t offset = g_end.fetch_add(blob.size());
+    if (!writeAt(g_fd, blob, offset)) {
+        g_writeFailed = true;
+        delete node;
+        return false;
+    }
+    node->record.offset = offset;
+    for (auto& entry : node->record.entries) {
+        entry.offset += offset;
+    }
+
+    node->next = g_indexHead.load(std::memory_order_relaxed);
+    while (!g_indexHead.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+    }
+    return true;
+}
+
+bool archiveClose() {
+    if (g_fd < 0) {
+        return false;
+    }
+
+    std::vector<IndexNode*> nodes;
+    for (IndexNode* node = g_indexHead.exchange(nullptr); node != nullptr; node = node->next) {
+        nodes.push_back(node);
+    }
+    std::sort(nodes.begin(), nodes.end(), [](const IndexNode* a, const IndexNode* b) {
+        if (a->record.path != b->record.path) return a->record.path < b->record.path;
+        return a->record.offset < b->record.offset;
+    });
+
+    std::string index;
+    putU32(index, kIndexMagic);
+    putU32(index, (uint32_t)nodes.size());
+    for (const IndexNode* node : nodes) {
+        const ArchiveRecord& record = node->record;
+        putU32(index, (uint32_t)record.path.size());
+        putU32(index, (uint32_t)record.entries.size());
+        putU64(index, record.offset);
+        index += record.path;
+        for (const auto& entry : record.entries) {
+            putU32(index, (uint32_t)entry.name.size());
+            putU32(index, 0);
+            putU64(index, entry.offset);
+            putU64(index, entry.size);
+            index += entry.name;
+        }
+        delete node;
+    }
+
+    uint64_t indexOffset = g_end;
+    putU64(index, indexOffset);
+    index.append(kTrailerMagic, sizeof(kTrailerMagic));
+    bool ok = !g_writeFailed && writeAt(g_fd, index, indexOffset);
+    if (close(g_fd) != 0) {
+        ok = false;
+    }
+    g_fd = -1;
+    return ok;
+}
+
+// 解析文件尾指向的索引，格式不符时返回false
+static bool parseIndex(const std::string& index, uint64_t fileSize, std::vector<ArchiveRecord>& records) {
+    const char* p = index.data();
+    const char* end = p + index.size();
+    if (end - p < 8 || getU32(p) != kIndexMagic) return false;
+    uint32_t count = getU32(p + 4);
+    p += 8;
+    for (uint32_t i = 0; i < count; i++) {
+        if (end - p < 16) return false;
+        ArchiveRecord record;
+        uint32_t pathLen = getU32(p);
+        uint32_t entryCount = getU32(p + 4);
+        record.offset = getU64(p + 8);
+        p += 16;
+        if ((uint64_t)(end - p) < pathLen) return false;
+        record.path.assign(p, pathLen);
+        p += pathLen;
+        for (uint32_t k = 0; k < entryCount; k++) {
+            if (end - p < 24) return false;
+            ArchiveEntry entry;
+            uint32_t nameLen = getU32(p);
+            entry.offset = getU64(p + 8);
+            entry.size = getU64(p + 16);
+            p += 24;
+            if ((uint64_t)(end - p) < nameLen || entry.offset > fileSize || entry.size > fileSize - entry.offset) {
+                return false;
+            }
+            entry.name.assign(p, nameLen);
+            p += nameLen;
+            record.entries.push_back(entry);
+        }
+        records.push_back(record);
+    }
+    return true;
+}
+
+// 没有有效索引时顺序扫描记录，遇到不完整的记录（写入中途退出）时停止
+static void scanRecords(int fd, uint64_t fileSize, std::vector<ArchiveRecord>& records) {
+    uint64_t pos = kFileHeaderSize;
+    std::string buffer;
+    while (pos + 16 <= fileSize) {
+        if (!readAt(fd, pos, 16, buffer) || getU32(&buffer[0]) != kRecordMagic) return;
+        ArchiveRecord record;
+        record.offset = pos;
+        uint32_t pathLen = getU32(&buffer[4]);
+        uint32_t entryCount = getU32(&buffer[8]);
+        pos += 16;
+        if (pathLen > fileSize - pos || !readAt(fd, pos, pathLen, record.path)) return;
+        pos += pathLen;
+        for (uint32_t k = 0; k < entryCount; k++) {
+            if (pos + 16 > fileSize || !readAt(fd, pos, 16, buffer)) return;
+            ArchiveEntry entry;
+            uint32_t nameLen = getU32(&buffer[0]);
+            entry.size = getU64(&buffer[8]);
+            pos += 16;
+            if (nameLen > fileSize - pos || !readAt(fd, pos, nameLen, entry.name)) return;
+            pos += nameLen;
+            if (entry.size > fileSize - pos) return;
+            entry.offset = pos;
+            pos += entry.size;
+            record.entries.push_back(entry);
+        }
+        records.push_back(record);
+    }
+}
+
+bool readArchiveIndex(const std::string& path, std::vector<ArchiveRecord>& records, bool& indexed,
+                      std::string& error) {
+    records.clear();
+    indexed = false;
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = std::string("无法打开归档: ") + strerror(errno);
+        return false;
+    }
+    struct stat info;
+    std::string header;
+    if (fstat(fd, &info) != 0 || !readAt(fd, 0, kFileHeaderSize, header) ||
+        memcmp(header.data(), kFileMagic, sizeof(kFileMagic)) != 0) {
+        close(fd);
+        error = "不是结果归档文件";
+        return false;
+    }
+    if (getU32(&header[8]) != kVersion) {
+        close(fd);
+        error = "不支持的归档版本 " + std::to_string(getU32(&header[8]));
+        return false;
+    }
+    uint64_t fileSize = (uint64_t)info.st_size;
+
+    // 优先使用末尾的索引
+    std::string trailer;
+    if (fileSize >= kFileHeaderSize + kTrailerSize && readAt(fd, fileSize - kTrailerSize, kTrailerSize, trailer) &&
+        memcmp(trailer.data() + 8, kTrailerMagic, sizeof(kTrailerMagic)) == 0) {
+        uint64_t indexOffset = getU64(&trailer[0]);
+        std::string index;
+        if (indexOffset >= kFileHeaderSize && indexOffset <= fileSize - kTrailerSize &&
+            readAt(fd, indexOffset, fileSize - kTrailerSize - indexOffset, index) &&
+            parseIndex(index, indexOffset, records)) {
+            indexed = true;
+        } else {
+            records.clear();
+        }
+    }
+    if (!indexed) {
+        scanRecords(fd, fileSize, records);
+        std::stable_sort(records.begin(), records.end(), [](const ArchiveRecord& a, const ArchiveRecord& b) {
+            return a.path < b.path;
+        });
+    }
+    close(fd);
+    return true;
+}
+
+bool readArchiveEntry(const std::string& path, const ArchiveEntry& entry, std::string& data) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = readAt(fd, entry.offset, (size_t)entry.size, data);
+    close(fd);
+    return ok;
+}
@@ -0,0 +1,66 @@
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include "output.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/*
+ * 结果归档（--archive）
+ * ===========================
+ * 把所有输入文件的结果（tokens.txt 等）追加写入同一个文件，代替每个输入一个 -output 目录。
+ * 格式（整数均为小端）：
+ *   文件头   "MINIARC\0" + u32 版本 + u32 保留
+ *   记录     u32 'RECD' + u32 路径长度 + u32 条目数 + u32 保留 + 路径，
+ *            之后每个条目：u32 名称长度 + u32 保留 + u64 内容长度 + 名称 + 内容
+ *   索引     u32 'INDX' + u32 记录数，之后每条记录：
+ *            u32 路径长度 + u32 条目数 + u64 记录偏移 + 路径，
+ *            每个条目：u32 名称长度 + u32 保留 + u64 内容偏移 + u64 内容长度 + 名称
+ *   文件尾   u64 索引偏移 + "MINIIDX\0"
+ * 写入时各线程用原子加法预留空间后 pwrite，不需要全局锁；索引在关闭时统一写在末尾。
+ * 记录自带路径与长度，索引缺失（如进程中途退出）时读取端顺序扫描记录重建索引。
+ */
+
+/* INFO 写入接口 */
+
+// 创建（或截断）归档文件并写入文件头，失败时返回false
+bool archiveOpen(const std::string& path);
+
+// 是否已打开归档（启用 --archive）
+bool archiveEnabled();
+
+// 归档文件路径
+const std::string& archivePath();
+
+// 追加一个输入文件的全部结果文件，可在多个线程中同时调用
+bool archiveAppend(const std::string& inputPath, const std::vector<OutputFile>& files);
+
+// 写入索引与文件尾并关闭，须在所有写入线程结束后调用
+bool archiveClose();
+
+/* INFO 读取接口 */
+
+// 归档中的一个结果文件
+struct ArchiveEntry {
+    std::string name;      // tokens.txt 等
+    uint64_t offset;       // 内容在归档中的偏移
+    uint64_t size;
+};
+
+// 一个输入文件的记录
+struct ArchiveRecord {
+    std::string path;      // 输入文件路径
+    uint64_t offset;       // 记录在归档中的偏移
+    std::vector<ArchiveEntry> entries;
+};
+
+// 读取归档索引（按路径排序；同一路径出现多次时保留全部，后写入的在后）
+// indexed为false表示没有有效索引、记录由扫描得到
+bool readArchiveIndex(const std::string& path, std::vector<ArchiveRecord>& records, bool& indexed,
+                      std::string& error);
+
+// 读取一个结果文件的内容
+bool readArchiveEntry(const std::string& path, const ArchiveEntry& entry, std::string& data);
+
+#endif /* ARCHIVE_H */
@@ -0,0 +1,364 @@
+#include "ast.h"
+#include <cstdlib>
+
+/* INFO 标识符驻留表 */
+
+static uint32_t hashName(const std::string& name) {
+    uint32_t hash = 2166136261u;  // FNV-1a
+    for (unsigned char ch : name) {
+        hash = (hash ^ ch) * 16777619u;
+    }
+    return hash;
+}
+
+uint32_t NameTable::find(const std::string& name) const {
+    if (slots.empty()) {
+        return kNoName;
+    }
+    size_t mask = slots.size() - 1;
+    for (size_t i = hashName(name) & mask; slots[i] != 0; i = (i + 1) & mask) {
+        if (names[slots[i] - 1] == name) {
+            return slots[i] - 1;
+        }
+    }
+    return kNoName;
+}
+
+uint32_t NameTable::intern(const std::string& name) {
+    // 装载因子不超过1/2
+    if ((names.size() + 1) * 2 > slots.size()) {
+        std::vector<uint32_t> old;
+        old.swap(slots);
+        slots.assign(old.empty() ? 64 : old.size() * 2, 0);
+        size_t mask = slots.size() - 1;
+        for (uint32_t entry : old) {
+            if (entry == 0) continue;
+            size_t i = hashName(names[entry - 1]) & mask;
+            while (slots[i] != 0) i = (i + 1) & mask;
+            slots[i] = entry;
+        }
+    }
+    size_t mask = slots.size() - 1;
+    size_t i = hashName(name) & mask;
+    for (; slots[i] != 0; i = (i + 1) & mask) {
+        if (names[slots[i] - 1] == name) {
+            return slots[i] - 1;
+        }
+    }
+    names.push_back(name);
+    slots[i] = (uint32_t)names.size();
+    return (uint32_t)names.size() - 1;
+}
+
+/* INFO 构造 */
+
+// 按 parser.cpp 的文法逐个消费Token；输入已通过语法分析，只在不符时失败
+struct AstBuilder {
+    const std::vector<TokenAttr>& tokens;
+    AstProgram& program;
+    size_t pos = 0;
+    bool failed = false;
+
+    AstBuilder(const std::vector<TokenAttr>& tokenList, AstProgram& target) : tokens(tokenList), program(target) {}
+
+    TokenCode peek(size_t ahead = 0) const {
+        return pos + ahead < tokens.size() ? tokens[pos + ahead].code : TK_EOF;
+    }
+
+    int line() const {
+        return pos < tokens.size() ? tokens[pos].startLine : (tokens.empty() ? 1 : tokens.back().startLine);
+    }
+
+    bool expect(TokenCode code) {
+        if (peek() != code) {
+            failed = true;
+            return false;
+        }
+        pos++;
+        return true;
+    }
+
+    uint32_t node(AstKind kind, int nodeLine) {
+        AstNode n;
+        n.kind = kind;
+        n.op = 0;
+        n.type = TYPE_NONE;
+        n.line = nodeLine;
+        n.name = kNoName;
+        n.a = n.b = n.c = n.next = kNoNode;
+        n.slot = 0;
+        n.intValue = 0;
+        program.nodes.push_back(n);
+        return (uint32_t)program.nodes.size() - 1;
+    }
+
+    static bool isType(TokenCode code) {
+        return code == KW_INT || code == KW_DOUBLE || code == KW_FLOAT;
+    }
+
+    MiniType type() {
+        TokenCode code = peek();
+        pos++;
+        return code == KW_INT ? TYPE_INT : (code == KW_FLOAT ? TYPE_FLOAT : TYPE_DOUBLE);
+    }
+
+    uint32_t identifier() {
+        if (peek() != TK_IDENT) {
+            failed = true;
+            return kNoName;
+        }
+        return program.names.intern(tokens[pos++].value);
+    }
+
+    // 把新节点接到链表末尾
+    void append(uint32_t& head, uint32_t& tail, uint32_t item) {
+        if (head == kNoNode) {
+            head = item;
+        } else {
+            program.nodes[tail].next = item;
+        }
+        tail = item;
+    }
+
+    void build() {
+        while (!failed && peek() != TK_EOF) {
+            program.functions.push_back(function());
+        }
+    }
+
+    uint32_t function() {
+        if (!isType(peek())) {
+            failed = true;
+            return kNoNode;
+        }
+        MiniType returnType = type();
+        uint32_t result = node(AST_FUNCTION, line());
+        program.nodes[result].type = returnType;
+        program.nodes[result].name = identifier();
+        expect(TK_OPENPA);
+        uint32_t head = kNoNode, tail = kNoNode;
+        while (!failed && isType(peek())) {
+            MiniType paramType = type();
+            uint32_t param = node(AST_PARAM, line());
+            program.nodes[param].type = paramType;
+            program.nodes[param].name = identifier();
+            append(head, tail, param);
+            if (peek() != TK_COMMA) break;
+            pos++;
+        }
+        program.nodes[result].a = head;
+        expect(TK_CLOSEPA);
+        uint32_t body = block();
+        program.nodes[result].b = body;
+        return result;
+    }
+
+    uint32_t block() {
+        uint32_t result = node(AST_BLOCK, line());
+        expect(TK_BEGIN);
+        uint32_t head = kNoNode, tail = kNoNode;
+        while (!failed && peek() != TK_END && peek() != TK_EOF) {
+            append(head, tail, statement());
+        }
+        program.nodes[result].a = head;
+        expect(TK_END);
+        return result;
+    }
+
+    uint32_t statement() {
+        int statementLine = line();
+        switch (peek()) {
+            case TK_BEGIN:
+                return block();
+            case KW_IF: {
+                pos++;
+                uint32_t result = node(AST_IF, statementLine);
+                expect(TK_OPENPA);
+                uint32_t condition = expression();
+                expect(TK_CLOSEPA);
+                if (peek() == KW_THEN) pos++;
+                uint32_t then = statement();
+                uint32_t otherwise = kNoNode;
+                if (!failed && peek() == KW_ELSE) {
+                    pos++;
+                    otherwise = statement();
+                }
+                AstNode& n = program.nodes[result];
+                n.a = condition;
+                n.b = then;
+                n.c = otherwise;
+                return result;
+            }
+            case KW_WHILE: {
+                pos++;
+                uint32_t result = node(AST_WHILE, statementLine);
+                expect(TK_OPENPA);
+                uint32_t condition = expression();
+                expect(TK_CLOSEPA);
+                uint32_t body = statement();
+                program.nodes[result].a = condition;
+                program.nodes[result].b = body;
+                return result;
+            }
+            case KW_RETURN: {
+                pos++;
+                uint32_t result = node(AST_RETURN, statementLine);
+                if (peek() != TK_SEMOCOLOM) {
+                    uint32_t value = expression();
+                    program.nodes[result].a = value;
+                }
+                expect(TK_SEMOCOLOM);
+                return result;
+            }
+            case KW_INT:
+            case KW_DOUBLE:
+            case KW_FLOAT: {
+                MiniType varType = type();
+                uint32_t result = node(AST_VAR_DECL, line());
+                program.nodes[result].type = varType;
+                program.nodes[result].name = identifier();
+                if (!failed && peek() == TK_ASSIGN) {
+                    pos++;
+                    uint32_t init = binary(0);
+                    program.nodes[result].a = init;
+                }
+                expect(TK_SEMOCOLOM);
+                return result;
+            }
+            default: {
+                uint32_t result = node(AST_EXPR_STMT, statementLine);
+                if (peek() != TK_SEMOCOLOM) {
+                    uint32_t value = expression();
+                    program.nodes[result].a = value;
+                }
+                expect(TK_SEMOCOLOM);
+                return result;
+            }
+        }
+    }
+
+    // <assignment-expression> ::= <identifier> '=' <logical-or-expression> | <logical-or-expression>
+    uint32_t expression() {
+        if (peek() == TK_IDENT && peek(1) == TK_ASSIGN) {
+            uint32_t result = node(AST_ASSIGN, line());
+            program.nodes[result].name = identifier();
+            pos++;
+            uint32_t value = binary(0);
+            program.nodes[result].a = value;
+            return result;
+        }
+        return binary(0);
+    }
+
+    // 二元运算符所在的文法层（0为逻辑或，5为乘除），不是二元运算符时为-1
+    static int level(TokenCode code) {
+        switch (code) {
+            case TK_OR: return 0;
+            case TK_AND: return 1;
+            case TK_EQ: return 2;
+            case TK_LT: case TK_GT: case TK_LEQ: case TK_GEQ: return 3;
+            case TK_PLUS: case TK_MINUS: case TK_BITOR: case TK_BITAND: return 4;
+            case TK_STAR: case TK_DIVIDE: return 5;
+            default: return -1;
+        }
+    }
+
+    // 第 minLevel 层及以上的表达式，各层均为左结合
+    uint32_t binary(int minLevel) {
+        if (minLevel > 5) {
+            return primary();
+        }
+        uint32_t left = binary(minLevel + 1);
+        while (!failed && level(peek()) == minLevel) {
+            uint32_t result = node(AST_BINARY, line());
+            program.nodes[result].op = (uint8_t)peek();
+            pos++;
+            uint32_t right = binary(minLevel + 1);
+            program.nodes[result].a = left;
+            program.nodes[result].b = right;
+            left = result;
+        }
+        return left;
+    }
+
+    uint32_t primary() {
+        int primaryLine = line();
+        switch (peek()) {
+            case TK_IDENT: {
+                if (peek(1) != TK_OPENPA) {
+                    uint32_t result = node(AST_IDENT, primaryLine);
+                    program.nodes[result].name = identifier();
+                    return result;
+                }
+                uint32_t result = node(AST_CALL, primaryLine);
+                program.nodes[result].name = identifier();
+                pos++;
+                uint32_t head = kNoNode, tail = kNoNode;
+                while (!failed && peek() != TK_CLOSEPA) {
+                    append(head, tail, expression());
+                    if (peek() != TK_COMMA) break;
+                    pos++;
+                }
+                program.nodes[result].a = head;
+                expect(TK_CLOSEPA);
+                return result;
+            }
+            case TK_INT: {
+                uint32_t result = node(AST_INT_CONST, primaryLine);
+                program.nodes[result].intValue = parseInteger(tokens[pos++].value);
+                return result;
+            }
+            case TK_DOUBLE: {
+                uint32_t result = node(AST_DOUBLE_CONST, primaryLine);
+                program.nodes[result].doubleValue = strtod(tokens[pos++].value.c_str(), nullptr);
+                return result;
+            }
+            case TK_OPENPA: {
+                pos++;
+                uint32_t result = expression();
+                expect(TK_CLOSEPA);
+                return result;
+            }
+            default:
+                failed = true;
+                return kNoNode;
+        }
+    }
+
+    // 十进制整数（可带负号），超出int64范围时饱和
+    static int64_t parseInteger(const std::string& text) {
+        size_t i = 0;
+        bool negative = !text.empty() && text[0] == '-';
+        if (negative) i++;
+        uint64_t value = 0;
+        const uint64_t limit = (uint64_t)INT64_MAX;
+        for (; i < text.size(); i++) {
+            uint64_t digit = (uint64_t)(text[i] - '0');
+            if (value > (limit - digit) / 10) {
+                return negative ? INT64_MIN : INT64_MAX;
+            }
+            value = value * 10 + digit;
+        }
+        return negative ? -(int64_t)value : (int64_t)value;
+    }
+};
+
+/* 接口实现 */
+
+bool buildAst(const std::vector<TokenAttr>& tokens, AstProgram& program) {
+    program = AstProgram();
+    // 节点数不超过Token数：一次预留，长程序的节点数组不必逐次倍增复制
+    program.nodes.reserve(tokens.size());
+    AstBuilder builder(tokens, program);
+    builder.build();
+    return !builder.failed;
+}
+
+const char* miniTypeName(MiniType type) {
+    switch (type) {
+        case TYPE_INT: return "int";
+        case TYPE_FLOAT: return "float";
+        case TYPE_DOUBLE: return "double";
+        default: return "void";
+    }
+}
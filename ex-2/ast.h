@@ -0,0 +1,91 @@
+#ifndef AST_H
+#define AST_H
+
+#include "lexer.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/*
+ * 抽象语法树
+ * ===========================
+ * 语法分析成功后由Token列表构造，供语义分析及之后的各遍使用。
+ * 全部节点存放在一个连续数组中，以32位下标互相引用（kNoNode表示没有），
+ * 语句、参数与实参各自以 next 串成链表。标识符在构造时驻留为从0开始的稠密ID，
+ * 之后各遍以ID代替字符串比较与查找。
+ */
+
+static const uint32_t kNoNode = UINT32_MAX;
+static const uint32_t kNoName = UINT32_MAX;
+
+// 节点类型（a/b/c 为子节点）
+enum AstKind : uint8_t {
+    AST_FUNCTION,       // 函数定义：name，type为返回类型，a=首个参数，b=函数体
+    AST_PARAM,          // 参数：name，type
+    AST_BLOCK,          // 复合语句：a=首条语句
+    AST_VAR_DECL,       // 变量声明：name，type，a=初值（可无）
+    AST_EXPR_STMT,      // 表达式语句：a=表达式（空语句时无）
+    AST_IF,             // a=条件，b=then分支，c=else分支（可无）
+    AST_WHILE,          // a=条件，b=循环体
+    AST_RETURN,         // a=返回值（可无）
+    AST_ASSIGN,         // 赋值：name=被赋值的变量，a=右部
+    AST_BINARY,         // 二元运算：op，a=左操作数，b=右操作数
+    AST_IDENT,          // 变量引用：name
+    AST_INT_CONST,      // 整型常量：intValue
+    AST_DOUBLE_CONST,   // 浮点常量：doubleValue
+    AST_CALL            // 函数调用：name，a=首个实参
+};
+
+// 值类型（数值按等级递增：int < float < double）
+enum MiniType : uint8_t {
+    TYPE_NONE = 0,
+    TYPE_INT,
+    TYPE_FLOAT,
+    TYPE_DOUBLE
+};
+
+// 语法树节点
+struct AstNode {
+    AstKind kind;
+    uint8_t op;             // AST_BINARY 的运算符（TokenCode）
+    MiniType type;          // 声明的类型；表达式节点在语义分析后为表达式的类型
+    int32_t line;
+    uint32_t name;          // 标识符ID
+    uint32_t a, b, c;       // 子节点
+    uint32_t next;          // 同一链表中的下一个节点
+    uint32_t slot;          // 语义分析结果：变量的槽位，或被调用函数的编号
+    union {
+        int64_t intValue;   // 整型常量（超出int范围时由语义分析报告）
+        double doubleValue;
+    };
+};
+
+// 标识符驻留表：名称 <-> 稠密ID，开放寻址
+struct NameTable {
+    std::vector<std::string> names;   // ID -> 名称
+    std::vector<uint32_t> slots;      // 哈希表，存 ID+1，0 表示空
+
+    // 返回名称的ID，不存在时新建
+    uint32_t intern(const std::string& name);
+    // 返回名称的ID，不存在时返回kNoName
+    uint32_t find(const std::string& name) const;
+    const std::string& name(uint32_t id) const { return names[id]; }
+    size_t size() const { return names.size(); }
+};
+
+// 一个程序的语法树
+struct AstProgram {
+    std::vector<AstNode> nodes;
+    std::vector<uint32_t> functions;  // 函数定义节点，按出现顺序
+    NameTable names;
+};
+
+/* INFO 构造接口 */
+
+// 由Token列表（须已通过语法分析，含末尾的EOF）构造语法树，Token与文法不符时返回false
+bool buildAst(const std::vector<TokenAttr>& tokens, AstProgram& program);
+
+// 类型名（int/float/double）
+const char* miniTypeName(MiniType type);
+
+#endif /* AST_H */
@@ -0,0 +1,501 @@
+#include "batch_io.h"
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+/* 后端状态 */
+static IoBackend g_backend = IO_BACKEND_THREADS;
+static int g_threads = 4;                  // 线程池的线程数
+
+static const unsigned kRingEntries = 256;  // 提交队列大小（同时在途的请求数上限）
+static const size_t kReadChunk = 65536;    // 大小未知（如管道）时每次读取的字节数
+static const int kPending = INT_MIN;       // 操作尚未完成时result的值
+
+/* INFO io_uring */
+
+// 内存映射的提交/完成队列
+struct Uring {
+    int fd = -1;
+    unsigned* sqHead;
+    unsigned* sqTail;
+    unsigned sqMask;
+    unsigned* sqArray;
+    io_uring_sqe* sqes;
+    unsigned* cqHead;
+    unsigned* cqTail;
+    unsigned cqMask;
+    io_uring_cqe* cqes;
+    void* sqRing = MAP_FAILED;
+    size_t sqRingSize = 0;
+    void* cqRing = MAP_FAILED;
+    size_t cqRingSize = 0;
+    size_t sqesSize = 0;
+    bool mkdirSupported = false;
+};
+
+static Uring g_ring;
+
+// 一个待提交的操作；result为完成时的返回值（负数为-errno）
+struct IoOp {
+    uint8_t opcode;
+    int fd;
+    const void* addr;
+    uint32_t len;
+    uint64_t off;
+    uint32_t flags;        // open_flags 或 statx_flags
+    int result;
+};
+
+static int uringSetup(unsigned entries, io_uring_params* params) {
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int uringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0);
+}
+
+static int uringRegister(int fd, unsigned opcode, void* arg, unsigned nrArgs) {
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs);
+}
+
+static void uringClose() {
+    if (g_ring.sqes != nullptr && g_ring.sqesSize > 0) munmap(g_ring.sqes, g_ring.sqesSize);
+    if (g_ring.cqRing != MAP_FAILED && g_ring.cqRing != g_ring.sqRing) munmap(g_ring.cqRing, g_ring.cqRingSize);
+    if (g_ring.sqRing != MAP_FAILED) munmap(g_ring.sqRing, g_ring.sqRingSize);
+    if (g_ring.fd >= 0) close(g_ring.fd);
+    g_ring = Uring();
+}
+
+// 检查用到的操作是否都受支持（需要 Linux 5.6 以上）
+static bool uringProbe() {
+    size_t size = sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op);
+    std::vector<char> buffer(size, 0);
+    io_uring_probe* probe = (io_uring_probe*)buffer.data();
+    if (uringRegister(g_ring.fd, IORING_REGISTER_PROBE, probe, 256) < 0) {
+        return false;
+    }
+    auto supported = [&](int op) {
+        return op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+    };
+    g_ring.mkdirSupported = supported(IORING_OP_MKDIRAT);  // 5.15以上，缺少时改用mkdir
+    return supported(IORING_OP_OPENAT) && supported(IORING_OP_STATX) && supported(IORING_OP_READ) &&
+           supported(IORING_OP_WRITE) && supported(IORING_OP_CLOSE);
+}
+
+static bool uringInit() {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    g_ring.fd = uringSetup(kRingEntries, &params);
+    if (g_ring.fd < 0) {
+        return false;  // ENOSYS（内核不支持）或 EPERM（被seccomp等禁止）
+    }
+
+    g_ring.sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    g_ring.cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        g_ring.sqRingSize = g_ring.cqRingSize = std::max(g_ring.sqRingSize, g_ring.cqRingSize);
+    }
+    g_ring.sqRing = mmap(nullptr, g_ring.sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         g_ring.fd, IORING_OFF_SQ_RING);
+    if (g_ring.sqRing == MAP_FAILED) {
+        uringClose();
+        return false;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        g_ring.cqRing = g_ring.sqRing;
+    } else {
+        g_ring.cqRing = mmap(nullptr, g_ring.cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                             g_ring.fd, IORING_OFF_CQ_RING);
+        if (g_ring.cqRing == MAP_FAILED) {
+            uringClose();
+            return false;
+        }
+    }
+    g_ring.sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, g_ring.sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      g_ring.fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        g_ring.sqesSize = 0;
+        uringClose();
+        return false;
+    }
+    g_ring.sqes = (io_uring_sqe*)sqes;
+
+    char* sq = (char*)g_ring.sqRing;
+    char* cq = (char*)g_ring.cqRing;
+    g_ring.sqHead = (unsigned*)(sq + params.sq_off.head);
+    g_ring.sqTail = (unsigned*)(sq + params.sq_off.tail);
+    g_ring.sqMask = *(unsigned*)(sq + params.sq_off.ring_mask);
+    g_ring.sqArray = (unsigned*)(sq + params.sq_off.array);
+    g_ring.cqHead = (unsigned*)(cq + params.cq_off.head);
+    g_ring.cqTail = (unsigned*)(cq + params.cq_off.tail);
+    g_ring.cqMask = *(unsigned*)(cq + params.cq_off.ring_mask);
+    g_ring.cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+
+    if (!uringProbe()) {
+        uringClose();
+        return false;
+    }
+    return true;
+}
+
+// 提交一组操作并等待全部完成
+// 在途请求不超过提交队列大小（完成队列为其两倍，不会溢出），每次io_uring_enter同时提交与收割
+static void uringRun(std::vector<IoOp>& ops) {
+    size_t next = 0;       // 下一个待提交的操作
+    size_t inFlight = 0;   // 已放入提交队列、尚未收割的操作
+    size_t queued = 0;     // 其中内核尚未取走的操作（上次只提交了一部分时留在队列中）
+    size_t done = 0;
+    while (done < ops.size()) {
+        // 填充提交队列
+        unsigned tail = *g_ring.sqTail;
+        while (next < ops.size() && inFlight < kRingEntries) {
+            const IoOp& op = ops[next];
+            unsigned index = tail & g_ring.sqMask;
+            io_uring_sqe* sqe = &g_ring.sqes[index];
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = op.opcode;
+            sqe->fd = op.fd;
+            sqe->addr = (uint64_t)(uintptr_t)op.addr;
+            sqe->len = op.len;
+            sqe->off = op.off;
+            sqe->open_flags = op.flags;  // 与statx_flags/rw_flags共用同一字段
+            sqe->user_data = next;
+            g_ring.sqArray[index] = index;
+            tail++;
+            next++;
+            inFlight++;
+            queued++;
+        }
+        __atomic_store_n(g_ring.sqTail, tail, __ATOMIC_RELEASE);
+
+        // 内核只取走一部分时返回已提交数且不等待完成；其余的留在队列中，下一轮连同新填充的一起提交，
+        // 否则它们计入 inFlight 却永远不会完成，等待会一直阻塞
+        int ret = uringEnter(g_ring.fd, (unsigned)queued, 1, IORING_ENTER_GETEVENTS);
+        if (ret > 0) queued -= std::min(queued, (size_t)ret);
+        if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            // 提交失败：把尚未完成的操作都标记为失败
+            int err = errno;
+            for (IoOp& op : ops) {
+                if (op.result == kPending) op.result = -err;
+            }
+            return;
+        }
+
+        // 收割完成队列
+        unsigned head = *g_ring.cqHead;
+        while (head != __atomic_load_n(g_ring.cqTail, __ATOMIC_ACQUIRE)) {
+            io_uring_cqe* cqe = &g_ring.cqes[head & g_ring.cqMask];
+            ops[cqe->user_data].result = cqe->res;
+            head++;
+            inFlight--;
+            done++;
+        }
+        __atomic_store_n(g_ring.cqHead, head, __ATOMIC_RELEASE);
+    }
+}
+
+static IoOp makeOp(uint8_t opcode, int fd, const void* addr, uint32_t len, uint64_t off, uint32_t flags) {
+    IoOp op = { opcode, fd, addr, len, off, flags, kPending };
+    return op;
+}
+
+// 并行关闭一组文件描述符
+static void uringCloseAll(const std::vector<int>& fds) {
+    std::vector<IoOp> ops;
+    for (int fd : fds) {
+        if (fd >= 0) ops.push_back(makeOp(IORING_OP_CLOSE, fd, nullptr, 0, 0, 0));
+    }
+    uringRun(ops);
+}
+
+static void uringRead(std::vector<ReadRequest>& requests) {
+    size_t n = requests.size();
+    std::vector<int> fds(n, -1);
+    std::vector<struct statx> stats(n);
+
+    // 第一轮：打开文件并取得大小
+    std::vector<IoOp> ops;
+    for (size_t i = 0; i < n; i++) {
+        ops.push_back(makeOp(IORING_OP_OPENAT, AT_FDCWD, requests[i].path.c_str(), 0, 0, O_RDONLY | O_CLOEXEC));
+        ops.push_back(makeOp(IORING_OP_STATX, AT_FDCWD, requests[i].path.c_str(), STATX_SIZE,
+                             (uint64_t)(uintptr_t)&stats[i], 0));
+    }
+    uringRun(ops);
+
+    // 按大小分配缓冲区（多留一个字节，读满说明文件在此期间变大了）
+    std::vector<size_t> filled(n, 0);
+    std::vector<size_t> active;
+    for (size_t i = 0; i < n; i++) {
+        requests[i].error = 0;
+        int openResult = ops[2 * i].result;
+        if (openResult < 0) {
+            requests[i].error = -openResult;
+            continue;
+        }
+        fds[i] = openResult;
+        size_t size = ops[2 * i + 1].result == 0 ? (size_t)stats[i].stx_size : 0;
+        requests[i].data.resize(size > 0 ? size + 1 : kReadChunk);
+        active.push_back(i);
+    }
+
+    // 之后各轮：读取所有未到达文件末尾的文件，直到全部读完
+    while (!active.empty()) {
+        ops.clear();
+        for (size_t i : active) {
+            std::string& data = requests[i].data;
+            if (filled[i] == data.size()) data.resize(data.size() * 2);
+            ops.push_back(makeOp(IORING_OP_READ, fds[i], &data[filled[i]], (uint32_t)(data.size() - filled[i]),
+                                 filled[i], 0));
+        }
+        uringRun(ops);
+
+        std::vector<size_t> stillActive;
+        for (size_t k = 0; k < active.size(); k++) {
+            size_t i = active[k];
+            int result = ops[k].result;
+            if (result < 0) {
+                requests[i].error = -result;
+                requests[i].data.clear();
+            } else if (result == 0) {
+                requests[i].data.resize(filled[i]);  // 到达文件末尾
+            } else {
+                filled[i] += (size_t)result;
+                stillActive.push_back(i);
+            }
+        }
+        active.swap(stillActive);
+    }
+
+    uringCloseAll(fds);
+}
+
+static void uringEnsureDirs(const std::vector<std::string>& dirs, std::vector<int>& errors) {
+    size_t n = dirs.size();
+    std::vector<struct statx> stats(n);
+    std::vector<IoOp> ops;
+    for (size_t i = 0; i < n; i++) {
+        ops.push_back(makeOp(IORING_OP_STATX, AT_FDCWD, dirs[i].c_str(), STATX_TYPE, (uint64_t)(uintptr_t)&stats[i], 0));
+    }
+    uringRun(ops);
+
+    // 不存在的目录统一创建
+    std::vector<size_t> missing;
+    for (size_t i = 0; i < n; i++) {
+        if (ops[i].result == 0) {
+            errors[i] = S_ISDIR(stats[i].stx_mode) ? 0 : ENOTDIR;
+        } else {
+            missing.push_back(i);
+        }
+    }
+    if (missing.empty()) return;
+
+    if (g_ring.mkdirSupported) {
+        ops.clear();
+        for (size_t i : missing) {
+            ops.push_back(makeOp(IORING_OP_MKDIRAT, AT_FDCWD, dirs[i].c_str(), 0777, 0, 0));
+        }
+        uringRun(ops);
+        for (size_t k = 0; k < missing.size(); k++) {
+            int result = ops[k].result;
+            errors[missing[k]] = (result == 0 || result == -EEXIST) ? 0 : -result;
+        }
+    } else {
+        for (size_t i : missing) {
+            errors[i] = (mkdir(dirs[i].c_str(), 0777) == 0 || errno == EEXIST) ? 0 : errno;
+        }
+    }
+}
+
+static void uringWrite(std::vector<WriteRequest>& requests) {
+    size_t n = requests.size();
+    std::vector<int> fds(n, -1);
+    std::vector<IoOp> ops;
+    for (size_t i = 0; i < n; i++) {
+        ops.push_back(makeOp(IORING_OP_OPENAT, AT_FDCWD, requests[i].path.c_str(), 0666, 0,
+                             O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC));
+    }
+    uringRun(ops);
+
+    std::vector<size_t> written(n, 0);
+    std::vector<size_t> active;
+    for (size_t i = 0; i < n; i++) {
+        requests[i].error = ops[i].result < 0 ? -ops[i].result : 0;
+        if (ops[i].result >= 0) {
+            fds[i] = ops[i].result;
+            if (!requests[i].data.empty()) active.push_back(i);
+        }
+    }
+
+    // 写入，短写时继续写剩余部分
+    while (!active.empty()) {
+        ops.clear();
+        for (size_t i : active) {
+            const std::string& data = requests[i].data;
+            ops.push_back(makeOp(IORING_OP_WRITE, fds[i], data.data() + written[i],
+                                 (uint32_t)std::min<size_t>(data.size() - written[i], 1u << 30), written[i], 0));
+        }
+        uringRun(ops);
+
+        std::vector<size_t> stillActive;
+        for (size_t k = 0; k < active.size(); k++) {
+            size_t i = active[k];
+            int result = ops[k].result;
+            if (result <= 0) {
+                requests[i].error = result < 0 ? -result : EIO;
+            } else {
+                written[i] += (size_t)result;
+                if (written[i] < requests[i].data.size()) stillActive.push_back(i);
+            }
+        }
+        active.swap(stillActive);
+    }
+
+    uringCloseAll(fds);
+}
+
+/* INFO 线程池后端 */
+
+// 用g_threads个线程并行处理下标 [0, count)
+template <typename Work>
+static void parallelFor(size_t count, Work work) {
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        size_t i;
+        while ((i = next.fetch_add(1)) < count) {
+            work(i);
+        }
+    };
+    int threadCount = (int)std::min<size_t>((size_t)g_threads, count);
+    std::vector<std::thread> threads;
+    for (int t = 1; t < threadCount; t++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+static void threadRead(std::vector<ReadRequest>& requests) {
+    parallelFor(requests.size(), [&](size_t i) {
+        ReadRequest& request = requests[i];
+        request.error = 0;
+        int fd = open(request.path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            request.error = errno;
+            return;
+        }
+        struct stat info;
+        bool regular = fstat(fd, &info) == 0 && S_ISREG(info.st_mode);
+        size_t size = regular && info.st_size > 0 ? (size_t)info.st_size : 0;
+        request.data.resize(size > 0 ? size + 1 : kReadChunk);
+        size_t filled = 0;
+        while (true) {
+            if (filled == request.data.size()) request.data.resize(request.data.size() * 2);
+            // 管道等不可定位的文件不支持 pread（ESPIPE），顺序 read 即可
+            char* target = &request.data[filled];
+            size_t room = request.data.size() - filled;
+            ssize_t got = regular ? pread(fd, target, room, (off_t)filled) : read(fd, target, room);
+            if (got < 0) {
+                if (errno == EINTR) continue;
+                request.error = errno;
+                request.data.clear();
+                break;
+            }
+            if (got == 0) {
+                request.data.resize(filled);
+                break;
+            }
+            filled += (size_t)got;
+        }
+        close(fd);
+    });
+}
+
+static void threadEnsureDirs(const std::vector<std::string>& dirs, std::vector<int>& errors) {
+    parallelFor(dirs.size(), [&](size_t i) {
+        struct stat info;
+        if (stat(dirs[i].c_str(), &info) == 0) {
+            errors[i] = S_ISDIR(info.st_mode) ? 0 : ENOTDIR;
+        } else {
+            errors[i] = (mkdir(dirs[i].c_str(), 0777) == 0 || errno == EEXIST) ? 0 : errno;
+        }
+    });
+}
+
+static void threadWrite(std::vector<WriteRequest>& requests) {
+    parallelFor(requests.size(), [&](size_t i) {
+        WriteRequest& request = requests[i];
+        request.error = 0;
+        int fd = open(request.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+        if (fd < 0) {
+            request.error = errno;
+            return;
+        }
+        size_t written = 0;
+        while (written < request.data.size()) {
+            ssize_t put = pwrite(fd, request.data.data() + written, request.data.size() - written, (off_t)written);
+            if (put < 0) {
+                if (errno == EINTR) continue;
+                request.error = errno;
+                break;
+            }
+            written += (size_t)put;
+        }
+        close(fd);
+    });
+}
+
+/* 接口实现 */
+
+IoBackend batchIoInit(bool preferUring, int threads) {
+    g_threads = std::max(1, threads);
+    g_backend = (preferUring && uringInit()) ? IO_BACKEND_URING : IO_BACKEND_THREADS;
+    return g_backend;
+}
+
+const char* batchIoBackendName() {
+    return g_backend == IO_BACKEND_URING ? "io_uring" : "threads";
+}
+
+void batchRead(std::vector<ReadRequest>& requests) {
+    if (g_backend == IO_BACKEND_URING) {
+        uringRead(requests);
+    } else {
+        threadRead(requests);
+    }
+}
+
+void batchEnsureDirs(const std::vector<std::string>& dirs, std::vector<int>& errors) {
+    errors.assign(dirs.size(), 0);
+    if (g_backend == IO_BACKEND_URING) {
+        uringEnsureDirs(dirs, errors);
+    } else {
+        threadEnsureDirs(dirs, errors);
+    }
+}
+
+void batchWrite(std::vector<WriteRequest>& requests) {
+    if (g_backend == IO_BACKEND_URING) {
+        uringWrite(requests);
+    } else {
+        threadWrite(requests);
+    }
+}
+
+void batchIoClose() {
+    if (g_backend == IO_BACKEND_URING) {
+        uringClose();
+    }
+    g_backend = IO_BACKEND_THREADS;
+}
@@ -0,0 +1,55 @@
+#ifndef BATCH_IO_H
+#define BATCH_IO_H
+
+#include <string>
+#include <vector>
+
+/*
+ * 批量文件I/O
+ * ===========================
+ * 为大量小文件的批处理减少系统调用：每个阶段（打开、读写、关闭等）的全部请求一次提交。
+ * 优先使用 io_uring（直接调用 io_uring_setup/io_uring_enter，不依赖liburing）；
+ * 内核不支持或被禁止时退回线程池，用 open/pread/pwrite 并行完成同样的请求。
+ */
+
+// 后端类型
+enum IoBackend {
+    IO_BACKEND_URING,      // io_uring
+    IO_BACKEND_THREADS     // 线程池 + pread/pwrite
+};
+
+// 一个读取请求：读取整个文件
+struct ReadRequest {
+    std::string path;
+    std::string data;      // 文件内容
+    int error;             // 0表示成功，否则为errno
+};
+
+// 一个写出请求：创建（或截断）文件并写入全部内容
+struct WriteRequest {
+    std::string path;
+    std::string data;
+    int error;             // 0表示成功，否则为errno
+};
+
+/* INFO 批量I/O接口 */
+
+// 初始化；preferUring为false时直接使用线程池。threads为线程池的线程数
+IoBackend batchIoInit(bool preferUring, int threads);
+
+// 当前后端的名称（"io_uring" 或 "threads"）
+const char* batchIoBackendName();
+
+// 批量读取
+void batchRead(std::vector<ReadRequest>& requests);
+
+// 批量确保目录存在（不存在时创建）；errors[i]为0表示成功，已存在但不是目录时为ENOTDIR
+void batchEnsureDirs(const std::vector<std::string>& dirs, std::vector<int>& errors);
+
+// 批量写出
+void batchWrite(std::vector<WriteRequest>& requests);
+
+// 释放后端资源
+void batchIoClose();
+
+#endif /* BATCH_IO_H */
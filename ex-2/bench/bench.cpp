@@ -0,0 +1,402 @@
+#include "../lexer.h"
+#include "../parser.h"
+#include "../output.h"
+#include "../pipeline.h"
+#include "../lalr.h"
+#include "../token_shm.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <functional>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <unistd.h>
+
+/*
+ * 词法/语法分析器微基准
+ * ===========================
+ * 不依赖任何外部库。每个用例先预热，再重复测量若干次（每次测量内部循环到
+ * 至少 kMinSampleSeconds），报告单次操作耗时的中位数与标准差，以及 MB/s、tokens/s。
+ *
+ * 用例：
+ *   lex        getNextToken() 扫描整个程序
+ *   parse      parse() 分析整个程序（含其内部的词法分析）
+ *   keywords   只含关键字与标识符的输入，主要开销为关键字查找
+ *   constants  大量互不相同的常量，主要开销为常量表插入
+ *   output     writeOutputFiles() 写出 tokens.txt 等结果文件
+ *   serial     命令行程序的串行方式：一遍词法分析收集Token，再 parse()
+ *   serial-sink 单线程一遍：parse() 过程中经 setTokenSink() 收集Token（pipeline 的串行对照）
+ *   pipeline   parsePipelined()：词法线程与语法分析重叠，一遍完成同样的工作
+ *   lalr       parseLalr()：表驱动的LALR(1)分析器识别同一程序，与 parse 对比
+ *   text-export 下游经文本交换Token：写出结果文件，再读回 tokens.txt 逐行解析
+ *   shm-export  下游经共享内存交换Token：发布段，再只读映射并遍历全部Token
+ */
+
+static const double kMinSampleSeconds = 0.02;
+
+/* 命令行选项 */
+struct BenchOptions {
+    int warmup = 1;               // 预热次数
+    int reps = 5;                 // 测量次数
+    size_t hugeBytes = 32u << 20; // huge 输入的大小
+    bool quick = false;           // 跳过 huge 输入
+    bool json = false;            // 以JSON输出
+    std::string filter;           // 只运行名称包含该子串的用例
+};
+
+/* 单个用例的结果 */
+struct BenchResult {
+    std::string name;
+    std::string size;
+    size_t bytes;
+    size_t tokens;
+    int reps;
+    double medianSec;   // 单次操作耗时中位数
+    double stddevSec;   // 单次操作耗时标准差
+};
+
+/* INFO 输入生成 */
+
+// 生成一个由若干函数组成的合法Mini程序，大小约为targetBytes
+// （常量后必须紧跟运算符或分隔符，否则是词法错误）
+static std::string makeProgram(size_t targetBytes) {
+    std::string src;
+    src.reserve(targetBytes + 512);
+    for (int f = 0; src.size() < targetBytes; f++) {
+        std::string n = std::to_string(f);
+        src += "int func" + n + "(int a, double b) {\n";
+        src += "    int x" + n + " = a * 2+ " + n + ";\n";
+        src += "    double y = b / 3.5- x" + n + ";\n";
+        src += "    // 注释 comment " + n + "\n";
+        src += "    while (x" + n + " > 0&& y <= 100.25) {\n";
+        src += "        x" + n + " = x" + n + " - 1;\n";
+        src += "        if (x" + n + " == 7) then { y = y + helper(x" + n + ", y); } else { y = y * 2; }\n";
+        src += "    }\n";
+        src += "    return x" + n + " | 1;\n";
+        src += "}\n\n";
+    }
+    return src;
+}
+
+// 只含关键字与标识符
+static std::string makeKeywords(size_t targetBytes) {
+    static const char* words[] = { "int", "double", "float", "if", "then", "else", "return", "while",
+                                   "alpha", "beta", "gamma", "intx", "iff", "whilst" };
+    std::string src;
+    src.reserve(targetBytes + 16);
+    for (size_t i = 0; src.size() < targetBytes; i++) {
+        src += words[(i * 7) % (sizeof(words) / sizeof(words[0]))];
+        src += (i % 12 == 11) ? '\n' : ' ';
+    }
+    return src;
+}
+
+// 大量互不相同的整数与浮点常量
+static std::string makeConstants(size_t targetBytes) {
+    std::string src;
+    src.reserve(targetBytes + 32);
+    for (size_t i = 0; src.size() < targetBytes; i++) {
+        src += std::to_string(i * 2654435761u % 100000000u);
+        if (i % 3 == 0) src += ".5";
+        src += (i % 10 == 9) ? ",\n" : ", ";
+    }
+    return src;
+}
+
+// 统计Token数（含EOF）
+static size_t countTokens(const std::string& src) {
+    initLexerBuffer(src.data(), src.size());
+    size_t count = 0;
+    TokenAttr token;
+    do {
+        token = getNextToken();
+        count++;
+    } while (token.code != TK_EOF);
+    closeLexer();
+    return count;
+}
+
+/* INFO 测量 */
+
+static double nowSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static BenchResult measure(const std::string& name, const std::string& size, size_t bytes, size_t tokens,
+                           const BenchOptions& options, const std::function<void()>& op) {
+    // 预热，同时估计单次耗时以确定每次测量的内部循环次数
+    double once = 0;
+    for (int i = 0; i < std::max(1, options.warmup); i++) {
+        double start = nowSeconds();
+        op();
+        once = nowSeconds() - start;
+    }
+    int inner = (once > 0 && once < kMinSampleSeconds) ? (int)std::ceil(kMinSampleSeconds / once) : 1;
+
+    std::vector<double> samples;
+    for (int r = 0; r < options.reps; r++) {
+        double start = nowSeconds();
+        for (int i = 0; i < inner; i++) {
+            op();
+        }
+        samples.push_back((nowSeconds() - start) / inner);
+    }
+
+    std::sort(samples.begin(), samples.end());
+    double mean = 0;
+    for (double s : samples) mean += s;
+    mean /= samples.size();
+    double var = 0;
+    for (double s : samples) var += (s - mean) * (s - mean);
+
+    BenchResult result;
+    result.name = name;
+    result.size = size;
+    result.bytes = bytes;
+    result.tokens = tokens;
+    result.reps = options.reps;
+    size_t mid = samples.size() / 2;
+    result.medianSec = (samples.size() % 2) ? samples[mid] : (samples[mid - 1] + samples[mid]) / 2;
+    result.stddevSec = samples.size() > 1 ? std::sqrt(var / (samples.size() - 1)) : 0.0;
+    return result;
+}
+
+static void printText(const BenchResult& r) {
+    char line[200];
+    snprintf(line, sizeof(line), "%-11s %-7s %10zu B %9zu tok  median %10.3f ms  stddev %8.3f ms  %8.2f MB/s  %12.0f tok/s\n",
+             r.name.c_str(), r.size.c_str(), r.bytes, r.tokens, r.medianSec * 1e3, r.stddevSec * 1e3,
+             r.bytes / r.medianSec / 1e6, r.tokens / r.medianSec);
+    std::cout << line;
+    std::cout.flush();
+}
+
+static void printJson(const std::vector<BenchResult>& results) {
+    char line[320];
+    std::cout << "{\"benchmarks\":[\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        snprintf(line, sizeof(line),
+                 "  {\"name\":\"%s\",\"size\":\"%s\",\"bytes\":%zu,\"tokens\":%zu,\"reps\":%d,"
+                 "\"median_ms\":%.6f,\"stddev_ms\":%.6f,\"mb_per_sec\":%.3f,\"tokens_per_sec\":%.1f}%s\n",
+                 r.name.c_str(), r.size.c_str(), r.bytes, r.tokens, r.reps, r.medianSec * 1e3, r.stddevSec * 1e3,
+                 r.bytes / r.medianSec / 1e6, r.tokens / r.medianSec, (i + 1 < results.size()) ? "," : "");
+        std::cout << line;
+    }
+    std::cout << "]}\n";
+}
+
+/* INFO 用例 */
+
+// 完整扫描一遍Token
+static void lexAll(const std::string& src) {
+    initLexerBuffer(src.data(), src.size());
+    TokenAttr token;
+    do {
+        token = getNextToken();
+    } while (token.code != TK_EOF);
+    closeLexer();
+}
+
+static void parseAll(const std::string& src) {
+    initParserBuffer(src.data(), src.size());
+    parse();
+    closeParser();
+}
+
+// 与命令行程序相同：先收集Token，再语法分析
+static void serialAll(const std::string& src) {
+    std::vector<TokenAttr> tokens;
+    initLexerBuffer(src.data(), src.size());
+    TokenAttr token;
+    do {
+        token = getNextToken();
+        tokens.push_back(token);
+    } while (token.code != TK_EOF);
+    parseAll(src);
+}
+
+// 单线程一遍完成：parse() 过程中经 Token 收集位置得到 Token 列表，与 pipeline 做的工作相同，
+// 两者之差才是词法与语法分析重叠带来的收益
+// （收集位置在初始化时被清除，须在 initParserBuffer 之后设置）
+static void serialSinkAll(const std::string& src) {
+    std::vector<TokenAttr> tokens;
+    initParserBuffer(src.data(), src.size());
+    setTokenSink(&tokens);
+    parse();
+    closeParser();
+}
+
+static void lalrAll(const std::string& src) {
+    initLexerBuffer(src.data(), src.size());
+    parseLalr();
+    closeLexer();
+}
+
+static void pipelineAll(const std::string& src) {
+    std::vector<TokenAttr> tokens;
+    parsePipelined(src.data(), src.size(), &tokens);
+    closeParser();
+}
+
+// 下游工具读回 tokens.txt：逐行解析行号、类型名与值，返回值用于防止被优化掉
+static size_t readTokensText(const std::string& path, const std::map<std::string, TokenCode>& codes) {
+    std::ifstream file(path, std::ios::binary);
+    std::string line;
+    std::vector<TokenAttr> tokens;
+    std::getline(file, line);  // 表头
+    std::getline(file, line);
+    while (std::getline(file, line)) {
+        size_t first = line.find('\t');
+        size_t second = line.find('\t', first + 1);
+        if (first == std::string::npos || second == std::string::npos) continue;
+        TokenAttr token = {};
+        token.line = atoi(line.c_str());
+        auto code = codes.find(line.substr(first + 1, second - first - 1));
+        token.code = code != codes.end() ? code->second : TK_UNDEF;
+        token.value = line.substr(second + 1);
+        tokens.push_back(token);
+    }
+    return tokens.size();
+}
+
+// 下游工具映射共享内存段并遍历全部Token
+static size_t readTokensShm(const std::string& name) {
+    TokenShmView view;
+    std::string error;
+    if (!tokenShmOpen(name, 0, view, error)) {
+        return 0;
+    }
+    size_t sum = 0;
+    for (uint64_t i = 0; i < view.header->tokenCount; i++) {
+        const ShmToken& token = view.tokens[i];
+        sum += token.code + token.line + tokenShmString(view, token.valueOffset, token.valueLength).size();
+    }
+    tokenShmClose(view);
+    return sum;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--json") {
+            options.json = true;
+        } else if (arg == "--quick") {
+            options.quick = true;
+        } else if (arg == "--reps" && i + 1 < argc) {
+            options.reps = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            options.warmup = std::max(0, atoi(argv[++i]));
+        } else if (arg == "--huge-mb" && i + 1 < argc) {
+            options.hugeBytes = (size_t)atoi(argv[++i]) << 20;
+        } else if (arg == "--filter" && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else {
+            std::cout << "用法: " << argv[0] << " [--json] [--quick] [--reps N] [--warmup N] [--huge-mb N] [--filter 名称]\n";
+            return arg == "-h" || arg == "--help" ? 0 : 1;
+        }
+    }
+
+    setParserErrorEcho(false);
+
+    // 两种分析器必须给出相同的结果，否则对比没有意义
+    {
+        std::string program = makeProgram(64u << 10);
+        initParserBuffer(program.data(), program.size());
+        ParserResult expected = parse();
+        closeParser();
+        initLexerBuffer(program.data(), program.size());
+        if (parseLalr() != expected) {
+            std::cerr << "警告: parseLalr 与 parse 的结果不一致\n";
+        }
+        closeLexer();
+    }
+
+    struct SizeClass { const char* label; size_t bytes; };
+    std::vector<SizeClass> sizes = { { "small", 4u << 10 }, { "medium", 512u << 10 } };
+    if (!options.quick) {
+        sizes.push_back({ "huge", options.hugeBytes });
+    }
+
+    // 输出用例写到临时目录
+    char tmpl[] = "/tmp/mini-bench-XXXXXX";
+    std::string tmpDir = mkdtemp(tmpl) ? tmpl : "/tmp";
+    std::string outDir = tmpDir + "/out";
+
+    std::vector<BenchResult> results;
+    auto run = [&](const std::string& name, const SizeClass& size, const std::string& src,
+                   const std::function<void()>& op) {
+        if (!options.filter.empty() && name.find(options.filter) == std::string::npos) return;
+        BenchResult r = measure(name, size.label, src.size(), countTokens(src), options, op);
+        results.push_back(r);
+        if (!options.json) printText(r);
+    };
+
+    for (const auto& size : sizes) {
+        std::string program = makeProgram(size.bytes);
+        std::string keywords = makeKeywords(size.bytes);
+        std::string constants = makeConstants(size.bytes);
+
+        run("lex", size, program, [&] { lexAll(program); });
+        run("parse", size, program, [&] { parseAll(program); });
+        run("serial", size, program, [&] { serialAll(program); });
+        run("serial-sink", size, program, [&] { serialSinkAll(program); });
+        run("pipeline", size, program, [&] { pipelineAll(program); });
+        run("lalr", size, program, [&] { lalrAll(program); });
+        run("keywords", size, keywords, [&] { lexAll(keywords); });
+        run("constants", size, constants, [&] { lexAll(constants); });
+
+        bool wantOutput = options.filter.empty() || std::string("output").find(options.filter) != std::string::npos;
+        bool wantExport = options.filter.empty() || std::string("text-export shm-export").find(options.filter) != std::string::npos;
+        if (wantOutput || wantExport) {
+            // 预先收集Token与错误，只测量写文件本身
+            std::vector<TokenAttr> tokens;
+            initParserBuffer(program.data(), program.size());
+            parse();
+            std::vector<ParserError> parseErrors = getParserErrors();
+            initLexerBuffer(program.data(), program.size());
+            TokenAttr token;
+            do {
+                token = getNextToken();
+                tokens.push_back(token);
+            } while (token.code != TK_EOF);
+            std::vector<ErrorInfo> lexErrors = getErrors();
+            run("output", size, program, [&] { writeOutputFiles(outDir, tokens, lexErrors, &parseErrors); });
+
+            std::map<std::string, TokenCode> codes;
+            for (int code = TK_UNDEF; code <= TK_EOF; code++) {
+                codes[getTokenName((TokenCode)code)] = (TokenCode)code;
+            }
+            volatile size_t sink = 0;
+            run("text-export", size, program, [&] {
+                writeOutputFiles(outDir, tokens, lexErrors, &parseErrors);
+                sink = sink + readTokensText(outDir + "/tokens.txt", codes);
+            });
+            std::string segment = "mini-bench-" + std::to_string(getpid());
+            run("shm-export", size, program, [&] {
+                std::string error;
+                tokenShmPublish(segment, "bench", program.size(), tokens, lexErrors, &parseErrors, true, error);
+                sink = sink + readTokensShm(segment);
+            });
+            tokenShmUnlink(segment);
+        }
+    }
+
+    if (options.json) {
+        printJson(results);
+    }
+
+    // 清理临时文件
+    unlink((outDir + "/tokens.txt").c_str());
+    unlink((outDir + "/lex_errors.txt").c_str());
+    unlink((outDir + "/parse_errors.txt").c_str());
+    rmdir(outDir.c_str());
+    rmdir(tmpDir.c_str());
+    return 0;
+}
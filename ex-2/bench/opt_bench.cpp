@@ -0,0 +1,184 @@
+#include "../lexer.h"
+#include "../parser.h"
+#include "../ast.h"
+#include "../sema.h"
+#include "../ir.h"
+#include "../opt.h"
+#include "../ssa.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+/*
+ * 中间代码优化基准
+ * ===========================
+ * 生成以嵌套 while 循环为主的合成程序（循环中有不变量、重复的公共子表达式与分支），
+ * 分别在级别0（不优化）、1、2 下生成并优化中间代码，报告：
+ *   insts     静态指令数
+ *   weighted  按循环嵌套深度加权的指令数：每条指令计 10^深度，近似动态执行的指令数
+ *   time      生成 + 优化的耗时（多次测量取最小值）
+ * 级别2相对级别1的 weighted 减少量主要来自循环不变量外提与全局值编号。
+ */
+
+static const int kMaxLevel = 2;
+
+/* 命令行选项 */
+struct OptBenchOptions {
+    int functions = 200;   // 生成的函数个数
+    int reps = 3;          // 测量次数
+    bool json = false;     // 以JSON输出
+};
+
+/* 单个优化级别的结果 */
+struct OptBenchResult {
+    int level;
+    size_t insts;
+    double weighted;
+    double seconds;
+};
+
+/* INFO 输入生成 */
+
+// 第f个函数：嵌套深度1~3的循环，内层含外层循环不变的表达式与重复计算
+// （常量后必须紧跟运算符或分隔符，否则是词法错误）
+static std::string makeKernel(int f) {
+    std::string n = std::to_string(f);
+    int depth = 1 + f % 3;
+    std::string src = "int kernel" + n + "(int n, int m) {\n";
+    src += "    int s = 0;\n    int t = 0;\n    int i = 0;\n";
+    src += "    while (i < n) {\n";
+    std::string indent = "        ";
+    if (depth >= 2) {
+        src += indent + "int j = 0;\n" + indent + "while (j < m) {\n";
+        indent += "    ";
+    }
+    if (depth >= 3) {
+        src += indent + "int k = 0;\n" + indent + "while (k < m) {\n";
+        indent += "    ";
+    }
+    src += indent + "t = (n * m+ " + n + ") * (i + m);\n";
+    src += indent + "s = s + t + (i + m) * 2+ (m * n+ " + n + ");\n";
+    src += indent + "if (s > 100000) then { s = s - n * m; } else { s = s + (i + m); }\n";
+    if (depth >= 3) {
+        src += indent + "k = k + 1;\n";
+        indent.resize(indent.size() - 4);
+        src += indent + "}\n";
+    }
+    if (depth >= 2) {
+        src += indent + "j = j + 1;\n";
+        indent.resize(indent.size() - 4);
+        src += indent + "}\n";
+    }
+    src += "        i = i + 1;\n    }\n";
+    src += "    return s + t;\n}\n\n";
+    return src;
+}
+
+static std::string makeProgram(int functions) {
+    std::string src;
+    for (int f = 0; f < functions; f++) src += makeKernel(f);
+    src += "int main() {\n    int r = 0;\n";
+    for (int f = 0; f < functions; f++) src += "    r = r + kernel" + std::to_string(f) + "(10, 20);\n";
+    src += "    return r;\n}\n";
+    return src;
+}
+
+/* INFO 测量 */
+
+static double nowSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 每条指令按所在块的循环嵌套深度计 10^深度
+static double weightedCount(IrModule& module) {
+    double total = 0;
+    for (IrFunction& function : module.functions) {
+        irComputeCfg(function);
+        std::vector<uint32_t> depths = irLoopDepths(function);
+        for (uint32_t b = 0; b < function.blocks.size(); b++) {
+            const IrBlock& block = function.blocks[b];
+            double weight = 1;
+            for (uint32_t d = 0; d < depths[b]; d++) weight *= 10;
+            for (uint32_t i = block.begin; i < block.end; i++) {
+                if (function.insts[i].op != IR_NOP) total += weight;
+            }
+        }
+    }
+    return total;
+}
+
+static OptBenchResult measure(const AstProgram& program, const SemaResult& sema, int level, int reps) {
+    OptBenchResult result{ level, 0, 0, 1e30 };
+    for (int rep = 0; rep < reps; rep++) {
+        IrModule module;
+        OptStats stats;
+        double start = nowSeconds();
+        lowerToIr(program, sema, module);
+        if (level > 0) optimizeModule(module, stats, level);
+        result.seconds = std::min(result.seconds, nowSeconds() - start);
+        if (rep == 0) {
+            result.insts = 0;
+            for (const IrFunction& function : module.functions) result.insts += irInstructionCount(function);
+            result.weighted = weightedCount(module);
+        }
+    }
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    OptBenchOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--json") {
+            options.json = true;
+        } else if (arg == "--functions" && i + 1 < argc) {
+            options.functions = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--reps" && i + 1 < argc) {
+            options.reps = std::max(1, atoi(argv[++i]));
+        } else {
+            std::cout << "用法: " << argv[0] << " [--json] [--functions N] [--reps N]\n";
+            return arg == "-h" || arg == "--help" ? 0 : 1;
+        }
+    }
+
+    std::string src = makeProgram(options.functions);
+    setParserErrorEcho(false);
+    std::vector<TokenAttr> tokens;
+    initLexerBuffer(src.data(), src.size());
+    do {
+        tokens.push_back(getNextToken());
+    } while (tokens.back().code != TK_EOF);
+    bool lexed = getErrors().empty();
+    closeLexer();
+    AstProgram program;
+    SemaResult sema;
+    if (!lexed || !buildAst(tokens, program) || !analyzeSemantics(program, sema)) {
+        std::cerr << "生成的程序未通过语义分析\n";
+        return 1;
+    }
+
+    std::vector<OptBenchResult> results;
+    for (int level = 0; level <= kMaxLevel; level++) results.push_back(measure(program, sema, level, options.reps));
+
+    if (options.json) {
+        std::cout << "{\"functions\":" << options.functions << ",\"bytes\":" << src.size() << ",\"levels\":[";
+        for (size_t k = 0; k < results.size(); k++) {
+            const OptBenchResult& r = results[k];
+            std::printf("%s{\"level\":%d,\"insts\":%zu,\"weighted\":%.0f,\"seconds\":%.6f}", k ? "," : "", r.level,
+                        r.insts, r.weighted, r.seconds);
+        }
+        std::cout << "]}\n";
+        return 0;
+    }
+    std::printf("合成程序: %d 个函数，%zu 字节\n", options.functions, src.size());
+    std::printf("级别       指令数     加权指令数     相对O0     耗时(ms)\n");
+    for (const OptBenchResult& r : results) {
+        std::printf("-O%-4d %10zu %14.0f %9.1f%% %12.3f\n", r.level, r.insts, r.weighted,
+                    100.0 * r.weighted / results[0].weighted, r.seconds * 1e3);
+    }
+    return 0;
+}
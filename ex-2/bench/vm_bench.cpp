@@ -0,0 +1,313 @@
+#include "../lexer.h"
+#include "../parser.h"
+#include "../ast.h"
+#include "../sema.h"
+#include "../ir.h"
+#include "../opt.h"
+#include "../vm.h"
+#include "../jit.h"
+#include "../emitc.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <dirent.h>
+#include <unistd.h>
+
+/*
+ * 字节码虚拟机、JIT 与 C 后端的基准与结果检查
+ * ===========================
+ * 读取 tests/programs 下的 Mini 程序（首行注释“// 期望结果: ...”给出 main 的返回值，
+ * 或运行时错误的文本），分别在优化级别0、1、2下编译为字节码与 x86-64 机器码并执行：
+ *   - 任一引擎的结果与期望不同时报告 FAIL，退出码为1
+ *   - 报告代码大小、执行的字节码指令数、耗时（多次执行取最小值）与每秒执行的指令数；
+ *     JIT 不计数，按同一程序的字节码指令数折算，便于与虚拟机比较
+ *   - --cc 时另把程序翻译为 C（emitc.h），用系统的 C 编译器（环境变量 CC，默认 cc）以 -std=c99 -O2
+ *     编译后执行，比较标准输出与期望；C 代码与优化级别无关，只执行一次（级别列为 -），
+ *     耗时含进程的启动。第二行注释“// #line: ...”列出的行号须各有一条 #line 指向
+ * 程序：fib（递归调用）、loops（嵌套循环）、kernels（整数与浮点算术内核）、
+ * semantics（运行时语义的边界）、order（求值顺序与短路求值）、divzero / recursion（运行时错误）、
+ * lines（空行与注释之后的语句与运算的行号）。
+ */
+
+static const char* const kExpectPrefix = "// 期望结果: ";
+static const char* const kLinePrefix = "// #line: ";
+
+/* 命令行选项 */
+struct VmBenchOptions {
+    std::string dir = "tests/programs";   // 程序目录
+    int reps = 3;                         // 测量次数
+    bool check = false;                   // 只检查结果，每个级别执行一次
+    bool json = false;                    // 以JSON输出
+    std::string filter;                   // 只运行名称包含该子串的程序
+    bool jit = true;                      // 是否同时以 JIT 执行
+    bool cc = false;                      // 是否同时翻译为 C 并用系统的 C 编译器编译执行
+};
+
+/* 一个程序在一个优化级别、一个引擎下的结果 */
+struct VmBenchResult {
+    std::string name;
+    int level;
+    const char* engine;       // "vm"、"jit" 或 "cc"
+    bool passed;
+    std::string actual;
+    size_t codeSize;          // 字节码指令数、机器码字节数，或 C 代码字节数
+    uint64_t executed;        // 执行的字节码指令数（JIT 取虚拟机的计数）
+    double seconds;           // 单次执行耗时（最小值）
+};
+
+/* INFO 编译 */
+
+// 词法分析并完成语义分析；失败时返回false
+static bool analyze(const std::string& src, AstProgram& program, SemaResult& sema) {
+    setParserErrorEcho(false);
+    std::vector<TokenAttr> tokens;
+    initLexerBuffer(src.data(), src.size());
+    do {
+        tokens.push_back(getNextToken());
+    } while (tokens.back().code != TK_EOF);
+    bool lexed = getErrors().empty();
+    closeLexer();
+    return lexed && buildAst(tokens, program) && analyzeSemantics(program, sema);
+}
+
+// 与命令行程序 --run 的摘要相同的结果文本
+static std::string resultText(bool ok, const VmResult& result) {
+    if (ok) return vmValueText(result.type, result.value);
+    return "运行时错误（第 " + std::to_string(result.errorLine) + " 行）: " + result.error;
+}
+
+// 级别列的文本：-O0 ~ -O2，C 代码为 -
+static std::string levelText(int level) {
+    return level < 0 ? "-" : "-O" + std::to_string(level);
+}
+
+static double nowSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void measure(const std::string& name, const std::string& expected, const AstProgram& program,
+                    const SemaResult& sema, int level, const VmBenchOptions& options, VmMachine& machine,
+                    std::vector<VmBenchResult>& results) {
+    IrModule module;
+    lowerToIr(program, sema, module);
+    if (level > 0) {
+        OptStats stats;
+        optimizeModule(module, stats, level);
+    }
+    int reps = options.check ? 1 : options.reps;
+
+    VmProgram bytecode;
+    compileBytecode(module, bytecode);
+    VmBenchResult vm{ name, level, "vm", false, "没有 main 函数", bytecode.code.size(), 0, 1e30 };
+    uint32_t entry = vmFindFunction(bytecode, "main");
+    for (int rep = 0; entry != UINT32_MAX && rep < reps; rep++) {
+        VmResult result;
+        double start = nowSeconds();
+        bool ok = vmRun(bytecode, machine, entry, result);
+        vm.seconds = std::min(vm.seconds, nowSeconds() - start);
+        vm.executed = result.instructions;
+        vm.actual = resultText(ok, result);
+    }
+    vm.passed = vm.actual == expected;
+    results.push_back(vm);
+    if (!options.jit) return;
+
+    JitProgram machineCode;
+    std::string error;
+    VmBenchResult jit{ name, level, "jit", false, "没有 main 函数", 0, vm.executed, 1e30 };
+    if (!compileJit(module, machineCode, error)) {
+        jit.actual = error;
+        results.push_back(jit);
+        return;
+    }
+    jit.codeSize = machineCode.codeSize;
+    entry = jitFindFunction(machineCode, "main");
+    for (int rep = 0; entry != UINT32_MAX && rep < reps; rep++) {
+        VmResult result;
+        double start = nowSeconds();
+        bool ok = jitRun(machineCode, entry, result);
+        jit.seconds = std::min(jit.seconds, nowSeconds() - start);
+        jit.actual = resultText(ok, result);
+    }
+    jit.passed = jit.actual == expected;
+    results.push_back(jit);
+}
+
+// 把程序翻译为 C，检查 lines 中的行号各有一条 #line，编译并执行；level 为 -1。失败时 actual 为原因
+static void measureC(const std::string& name, const std::string& path, const std::string& expected,
+                     const std::vector<int>& lines, const AstProgram& program, const SemaResult& sema,
+                     const VmBenchOptions& options, uint64_t executed, std::vector<VmBenchResult>& results) {
+    VmBenchResult c{ name, -1, "cc", false, "", 0, executed, 1e30 };
+    char dir[] = "/tmp/vm_bench_cXXXXXX";
+    if (mkdtemp(dir) == nullptr) {
+        c.actual = "无法创建临时目录";
+        results.push_back(c);
+        return;
+    }
+    std::string source = std::string(dir) + "/program.c";
+    std::string binary = std::string(dir) + "/program";
+    {
+        std::ostringstream code;
+        emitC(program, sema, path, code);
+        std::ofstream out(source, std::ios::binary);
+        out << code.str();
+        c.codeSize = code.str().size();
+        for (int line : lines) {
+            if (code.str().find("#line " + std::to_string(line) + " \"") == std::string::npos) {
+                c.actual = "缺少 #line " + std::to_string(line);
+                break;
+            }
+        }
+    }
+    const char* compiler = getenv("CC");
+    std::string command = std::string(compiler && *compiler ? compiler : "cc") + " -std=c99 -O2 -o " + binary +
+                          " " + source + " 2>&1";
+    std::string log;
+    FILE* compile = c.actual.empty() ? popen(command.c_str(), "r") : nullptr;  // #line 检查失败时不再编译
+    if (compile) {
+        char buf[4096];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), compile)) > 0) log.append(buf, n);
+        c.actual = pclose(compile) == 0 ? "" : "编译失败: " + log.substr(0, log.find('\n'));
+    } else if (c.actual.empty()) {
+        c.actual = "无法执行 C 编译器";
+    }
+    int reps = options.check ? 1 : options.reps;
+    for (int rep = 0; c.actual.empty() && rep < reps; rep++) {
+        double start = nowSeconds();
+        FILE* pipe = popen(binary.c_str(), "r");
+        std::string output;
+        char buf[4096];
+        size_t n;
+        while (pipe && (n = fread(buf, 1, sizeof(buf), pipe)) > 0) output.append(buf, n);
+        if (pipe) pclose(pipe);
+        c.seconds = std::min(c.seconds, nowSeconds() - start);
+        if (!output.empty() && output.back() == '\n') output.pop_back();
+        if (rep + 1 == reps) c.actual = output;
+    }
+    unlink(binary.c_str());
+    unlink(source.c_str());
+    rmdir(dir);
+    c.passed = c.actual == expected;
+    results.push_back(c);
+}
+
+int main(int argc, char* argv[]) {
+    VmBenchOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--json") {
+            options.json = true;
+        } else if (arg == "--check") {
+            options.check = true;
+        } else if (arg == "--no-jit") {
+            options.jit = false;
+        } else if (arg == "--cc") {
+            options.cc = true;
+        } else if (arg == "--reps" && i + 1 < argc) {
+            options.reps = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--dir" && i + 1 < argc) {
+            options.dir = argv[++i];
+        } else if (arg == "--filter" && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else {
+            std::cout << "用法: " << argv[0] << " [--check] [--no-jit] [--cc] [--json] [--reps N] [--dir 目录] [--filter 名称]\n";
+            return arg == "-h" || arg == "--help" ? 0 : 1;
+        }
+    }
+
+    std::vector<std::string> files;
+    if (DIR* dir = opendir(options.dir.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.size() > 4 && name.compare(name.size() - 4, 4, ".txt") == 0 &&
+                name.find(options.filter) != std::string::npos) {
+                files.push_back(name);
+            }
+        }
+        closedir(dir);
+    }
+    std::sort(files.begin(), files.end());
+    if (files.empty()) {
+        std::cerr << "没有找到程序: " << options.dir << "\n";
+        return 1;
+    }
+
+    VmMachine machine;
+    std::vector<VmBenchResult> results;
+    int failures = 0;
+    for (const std::string& file : files) {
+        std::ifstream in(options.dir + "/" + file, std::ios::binary);
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        std::string src = buffer.str();
+        std::string name = file.substr(0, file.size() - 4);
+        std::string firstLine = src.substr(0, src.find('\n'));
+        if (firstLine.compare(0, strlen(kExpectPrefix), kExpectPrefix) != 0) {
+            std::cerr << name << ": 首行缺少“" << kExpectPrefix << "”\n";
+            failures++;
+            continue;
+        }
+        std::string expected = firstLine.substr(strlen(kExpectPrefix));
+        std::vector<int> lines;
+        size_t secondStart = src.find('\n') + 1;
+        if (src.compare(secondStart, strlen(kLinePrefix), kLinePrefix) == 0) {
+            std::istringstream numbers(src.substr(secondStart + strlen(kLinePrefix),
+                                                  src.find('\n', secondStart) - secondStart - strlen(kLinePrefix)));
+            for (int line; numbers >> line;) lines.push_back(line);
+        }
+        AstProgram program;
+        SemaResult sema;
+        if (!analyze(src, program, sema)) {
+            std::cerr << name << ": 未通过语法或语义分析\n";
+            failures++;
+            continue;
+        }
+        size_t first = results.size();
+        for (int level = 0; level <= 2; level++) {
+            measure(name, expected, program, sema, level, options, machine, results);
+        }
+        if (options.cc) {
+            measureC(name, options.dir + "/" + file, expected, lines, program, sema, options,
+                     results[first].executed, results);
+        }
+        for (size_t k = first; k < results.size(); k++) {
+            if (results[k].passed) continue;
+            failures++;
+            if (!options.json) {
+                std::printf("FAIL %s %s %s: 期望 %s，实际 %s\n", name.c_str(), levelText(results[k].level).c_str(),
+                            results[k].engine, expected.c_str(), results[k].actual.c_str());
+            }
+        }
+    }
+
+    if (options.json) {
+        std::cout << "{\"programs\":[";
+        for (size_t k = 0; k < results.size(); k++) {
+            const VmBenchResult& r = results[k];
+            std::printf("%s{\"name\":\"%s\",\"level\":%d,\"engine\":\"%s\",\"passed\":%s,\"code\":%zu,"
+                        "\"executed\":%llu,\"seconds\":%.6f}",
+                        k ? "," : "", r.name.c_str(), r.level, r.engine, r.passed ? "true" : "false", r.codeSize,
+                        (unsigned long long)r.executed, r.seconds);
+        }
+        std::cout << "],\"failures\":" << failures << "}\n";
+        return failures ? 1 : 0;
+    }
+    std::printf("程序          级别  引擎   代码大小    执行指令数      耗时(ms)   百万条/秒\n");
+    for (const VmBenchResult& r : results) {
+        std::printf("%-12s  %-3s  %-4s  %8zu  %12llu  %12.3f  %10.1f\n", r.name.c_str(), levelText(r.level).c_str(), r.engine,
+                    r.codeSize, (unsigned long long)r.executed, r.seconds * 1e3,
+                    r.seconds > 0 ? r.executed / r.seconds / 1e6 : 0.0);
+    }
+    std::printf("代码大小：虚拟机为字节码指令数，JIT 为机器码字节数，cc 为 C 代码字节数；"
+                "JIT 与 cc 的指令数取虚拟机的计数\n");
+    std::printf("%s\n", failures ? "有程序的结果与期望不同" : "全部结果与期望相同");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,318 @@
+#include "callgraph.h"
+#include <algorithm>
+
+static const uint32_t kUnvisited = UINT32_MAX;
+
+/* INFO 公共工具 */
+
+// 依次访问函数中各块的 call 指令
+template <typename Fn>
+static void forEachCall(const IrFunction& function, Fn fn) {
+    for (const IrBlock& block : function.blocks) {
+        for (uint32_t i = block.begin; i < block.end; i++) {
+            if (function.insts[i].op == IR_CALL) fn(function.insts[i]);
+        }
+    }
+}
+
+/* INFO 调用图 */
+
+// 迭代的 Tarjan 算法：每个栈项是函数与下一条要访问的边；分量在其根出栈时完成
+static void findComponents(CallGraph& graph) {
+    uint32_t count = (uint32_t)graph.callSites.size();
+    std::vector<uint32_t> index(count, kUnvisited), low(count, 0), stack;
+    std::vector<bool> onStack(count, false);
+    std::vector<std::pair<uint32_t, uint32_t>> path;
+    uint32_t counter = 0;
+    graph.component.assign(count, kUnvisited);
+    graph.componentCount = 0;
+
+    auto visit = [&](uint32_t f) {
+        index[f] = low[f] = counter++;
+        stack.push_back(f);
+        onStack[f] = true;
+        path.push_back({ f, graph.calleeStart[f] });
+    };
+    for (uint32_t root = 0; root < count; root++) {
+        if (index[root] != kUnvisited) continue;
+        visit(root);
+        while (!path.empty()) {
+            uint32_t f = path.back().first;
+            if (path.back().second < graph.calleeStart[f + 1]) {
+                uint32_t g = graph.callees[path.back().second++];
+                if (index[g] == kUnvisited) {
+                    visit(g);
+                } else if (onStack[g]) {
+                    low[f] = std::min(low[f], index[g]);
+                }
+                continue;
+            }
+            path.pop_back();
+            if (!path.empty()) {
+                uint32_t parent = path.back().first;
+                low[parent] = std::min(low[parent], low[f]);
+            }
+            if (low[f] != index[f]) continue;
+            // f 是分量的根：栈中 f 及其上的函数组成一个分量
+            size_t first = stack.size();
+            do {
+                first--;
+                onStack[stack[first]] = false;
+                graph.component[stack[first]] = graph.componentCount;
+            } while (stack[first] != f);
+            if (stack.size() - first > 1) {
+                for (size_t k = first; k < stack.size(); k++) graph.recursive[stack[k]] = true;
+            }
+            stack.resize(first);
+            graph.componentCount++;
+        }
+    }
+}
+
+void irBuildCallGraph(const IrModule& module, CallGraph& graph) {
+    uint32_t count = (uint32_t)module.functions.size();
+    graph.calleeStart.assign(1, 0);
+    graph.callees.clear();
+    graph.callSites.assign(count, 0);
+    graph.recursive.assign(count, false);
+    std::vector<uint32_t> seen(count, kUnvisited);   // 等于调用者下标时表示该边已记录
+    for (uint32_t f = 0; f < count; f++) {
+        forEachCall(module.functions[f], [&](const IrInst& inst) {
+            graph.callSites[inst.a]++;
+            if (seen[inst.a] == f) return;
+            seen[inst.a] = f;
+            graph.callees.push_back(inst.a);
+            if (inst.a == f) graph.recursive[f] = true;
+        });
+        graph.calleeStart.push_back((uint32_t)graph.callees.size());
+    }
+    findComponents(graph);
+}
+
+/* INFO 内联 */
+
+// 在 caller 的块 block 中展开第 index 条指令（对 callee 的 call），返回 call 之后的后半块。
+// 被调用者的值在第一次使用时才复制，不复制整理后已不再使用的临时值
+static uint32_t inlineCall(IrFunction& caller, uint32_t block, uint32_t index, const IrFunction& callee,
+                           std::vector<uint32_t>& remap) {
+    const IrInst call = caller.insts[index];
+    remap.assign(callee.values.size(), kNoValue);
+    auto value = [&](uint32_t v) {
+        if (remap[v] == kNoValue) {
+            remap[v] = (uint32_t)caller.values.size();
+            caller.values.push_back(callee.values[v]);
+            if (callee.values[v].kind == IRV_VAR) caller.values.back().kind = IRV_TEMP;
+        }
+        return remap[v];
+    };
+
+    // 块一分为二：前半以跳到入口块结束，后半是新块 after
+    uint32_t after = (uint32_t)caller.blocks.size();
+    uint32_t entry = after + 1;
+    uint32_t blockBase = after + 2;
+    caller.blocks.push_back({ index + 1, caller.blocks[block].end, {}, {} });
+    caller.blocks[block].end = index + 1;
+    caller.insts[index] = { IR_JMP, call.line, kNoValue, kNoValue, entry, 0 };
+    caller.blocks.push_back({ 0, 0, {}, {} });
+
+    // 被调用者的块：值与块重新编号，ret 改为给调用结果赋值并跳到后半块
+    for (const IrBlock& source : callee.blocks) {
+        IrBlock copy{ (uint32_t)caller.insts.size(), 0, {}, {} };
+        for (uint32_t i = source.begin; i < source.end; i++) {
+            IrInst inst = callee.insts[i];
+            if (inst.dst != kNoValue) inst.dst = value(inst.dst);
+            switch (inst.op) {
+                case IR_NOP:
+                    continue;
+                case IR_MOV:
+                case IR_CONV:
+                    inst.a = value(inst.a);
+                    break;
+                case IR_CALL: {
+                    uint32_t offset = (uint32_t)caller.args.size();
+                    for (uint32_t k = 0; k < inst.c; k++) caller.args.push_back(value(callee.args[inst.b + k]));
+                    inst.b = offset;
+                    break;
+                }
+                case IR_JMP:
+                    inst.b += blockBase;
+                    break;
+                case IR_BR:
+                    inst.a = value(inst.a);
+                    inst.b += blockBase;
+                    inst.c += blockBase;
+                    break;
+                case IR_RET:
+                    if (call.dst != kNoValue) {
+                        caller.insts.push_back({ IR_MOV, inst.line, call.dst, value(inst.a), 0, 0 });
+                    }
+                    inst = { IR_JMP, inst.line, kNoValue, kNoValue, after, 0 };
+                    break;
+                default:
+                    inst.a = value(inst.a);
+                    inst.b = value(inst.b);
+                    break;
+            }
+            caller.insts.push_back(inst);
+        }
+        copy.end = (uint32_t)caller.insts.size();
+        caller.blocks.push_back(copy);
+    }
+
+    // 入口块：用到的参数取实参的值，用到的其余变量置0（每次经过展开处都重新开始）
+    uint32_t zero[TYPE_DOUBLE + 1];
+    std::fill(zero, zero + TYPE_DOUBLE + 1, kNoValue);
+    caller.blocks[entry].begin = (uint32_t)caller.insts.size();
+    for (uint32_t slot = 0; slot < callee.slotCount; slot++) {
+        if (remap[slot] == kNoValue) continue;
+        uint32_t source;
+        if (slot < callee.paramCount) {
+            source = caller.args[call.b + slot];
+        } else {
+            MiniType type = callee.values[slot].type;
+            if (zero[type] == kNoValue) {
+                zero[type] = type == TYPE_INT ? irNewIntConst(caller, 0) : irNewFloatConst(caller, type, 0);
+            }
+            source = zero[type];
+        }
+        caller.insts.push_back({ IR_MOV, call.line, remap[slot], source, 0, 0 });
+    }
+    caller.insts.push_back({ IR_JMP, call.line, kNoValue, kNoValue, blockBase, 0 });
+    caller.blocks[entry].end = (uint32_t)caller.insts.size();
+    return after;
+}
+
+void irInlineModule(IrModule& module, InlineStats& stats, const std::function<void(IrFunction&)>& simplify) {
+    uint32_t count = (uint32_t)module.functions.size();
+    // 有分支的函数先整理，删除不可达代码中的 call，调用图与调用点数才准确；
+    // 只有一个块的函数中没有这样的 call，留到展开之后整理一次
+    std::vector<bool> tidy(count, false);
+    for (uint32_t f = 0; f < count; f++) {
+        if (module.functions[f].blocks.size() <= 1) continue;
+        simplify(module.functions[f]);
+        tidy[f] = true;
+    }
+    CallGraph graph;
+    irBuildCallGraph(module, graph);
+    stats.components += graph.componentCount;
+    stats.recursive += std::count(graph.recursive.begin(), graph.recursive.end(), true);
+
+    // 按分量编号自底向上；调用点数与大小随展开更新
+    std::vector<uint32_t> order(count);
+    for (uint32_t f = 0; f < count; f++) order[f] = f;
+    std::stable_sort(order.begin(), order.end(),
+                     [&](uint32_t x, uint32_t y) { return graph.component[x] < graph.component[y]; });
+    std::vector<uint32_t> sites = graph.callSites;
+    std::vector<uint32_t> remap;
+    bool hasMain = false;
+    for (const IrFunction& function : module.functions) hasMain = hasMain || function.name == "main";
+    std::vector<size_t> size(count);
+    for (uint32_t f = 0; f < count; f++) size[f] = irInstructionCount(module.functions[f]);
+
+    // 展开过调用点或尚未整理的函数推迟整理：未整理的大小（含展开留下的 jmp 与复制）超出代价时先整理再判断，
+    // 其余的最后统一整理
+    std::vector<bool> pending(count, false);
+    auto tidyUp = [&](uint32_t g) {
+        irCompact(module.functions[g]);
+        irComputeCfg(module.functions[g]);
+        simplify(module.functions[g]);
+        size[g] = irInstructionCount(module.functions[g]);
+        pending[g] = false;
+    };
+
+    for (uint32_t f : order) {
+        IrFunction& caller = module.functions[f];
+        auto fits = [&](uint32_t g) {
+            if (size[f] + size[g] > kInlineCallerLimit) return false;
+            return size[g] <= kInlineSmallCost || (sites[g] == 1 && size[g] <= kInlineSingleCallCost);
+        };
+        auto profitable = [&](uint32_t g) {
+            if (graph.recursive[g]) return false;
+            if (fits(g)) return true;
+            if (!pending[g]) return false;
+            tidyUp(g);
+            return fits(g);
+        };
+        size_t inlined = 0;
+        uint32_t blockCount = (uint32_t)caller.blocks.size();
+        for (uint32_t b = 0; b < blockCount; b++) {
+            // 展开后 call 之后的指令属于后半块，继续在其中扫描
+            uint32_t current = b;
+            for (uint32_t i = caller.blocks[current].begin; i < caller.blocks[current].end; i++) {
+                if (caller.insts[i].op != IR_CALL || !profitable(caller.insts[i].a)) continue;
+                uint32_t g = caller.insts[i].a;
+                IrFunction& callee = module.functions[g];
+                sites[g]--;
+                forEachCall(callee, [&](const IrInst& inst) { sites[inst.a]++; });
+                size[f] += size[g];
+                current = inlineCall(caller, current, i, callee, remap);
+                inlined++;
+                if (sites[g] == 0 && hasMain && callee.name != "main") {
+                    // 最后一个调用点已展开：之后由 irRemoveDeadFunctions 删除，先释放函数体
+                    IrFunction released{ callee.name, callee.returnType, callee.paramCount, callee.slotCount,
+                                         {}, {}, {}, {} };
+                    std::swap(callee, released);
+                }
+            }
+        }
+        if (inlined > 0) {
+            stats.inlined += inlined;
+            size[f] = irInstructionCount(caller);
+        } else if (tidy[f]) {
+            continue;
+        }
+        pending[f] = true;
+    }
+    for (uint32_t f = 0; f < count; f++) {
+        // 最后一个调用点已展开的函数已释放，不再整理
+        if (pending[f] && !module.functions[f].blocks.empty()) tidyUp(f);
+    }
+}
+
+/* INFO 无用函数删除 */
+
+size_t irRemoveDeadFunctions(IrModule& module) {
+    uint32_t count = (uint32_t)module.functions.size();
+    uint32_t root = kUnvisited;
+    for (uint32_t f = 0; f < count; f++) {
+        if (module.functions[f].name == "main") root = f;
+    }
+    if (root == kUnvisited) return 0;
+
+    CallGraph graph;
+    irBuildCallGraph(module, graph);
+    std::vector<bool> reachable(count, false);
+    std::vector<uint32_t> work{ root };
+    reachable[root] = true;
+    while (!work.empty()) {
+        uint32_t f = work.back();
+        work.pop_back();
+        for (uint32_t k = graph.calleeStart[f]; k < graph.calleeStart[f + 1]; k++) {
+            uint32_t g = graph.callees[k];
+            if (!reachable[g]) {
+                reachable[g] = true;
+                work.push_back(g);
+            }
+        }
+    }
+
+    // 保留的函数按原顺序前移，call 的目标改为新下标
+    std::vector<uint32_t> renumber(count, kUnvisited);
+    uint32_t kept = 0;
+    for (uint32_t f = 0; f < count; f++) {
+        if (!reachable[f]) continue;
+        renumber[f] = kept;
+        if (kept != f) module.functions[kept] = std::move(module.functions[f]);
+        kept++;
+    }
+    module.functions.resize(kept);
+    if (kept == count) return 0;
+    for (IrFunction& function : module.functions) {
+        for (const IrBlock& block : function.blocks) {
+            for (uint32_t i = block.begin; i < block.end; i++) {
+                if (function.insts[i].op == IR_CALL) function.insts[i].a = renumber[function.insts[i].a];
+            }
+        }
+    }
+    return count - kept;
+}
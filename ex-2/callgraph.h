@@ -0,0 +1,66 @@
+#ifndef CALLGRAPH_H
+#define CALLGRAPH_H
+
+#include "ir.h"
+#include <functional>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * 调用图、内联与无用函数删除
+ * ===========================
+ * 调用图由各函数的 call 指令得到：边按调用者存放（CSR，同一被调用者只记一次），并记录每个函数的调用点数。
+ * 强连通分量用迭代的 Tarjan 算法求得（显式栈，深度与调用链长度无关），分量按逆拓扑序编号：
+ * 被调用者所在的分量先完成，编号较小。位于多函数分量中或调用自身的函数是递归函数。
+ *
+ * irInlineModule 按分量编号自底向上处理各函数，展开满足代价模型的调用点：
+ *   - 只展开非递归函数；调用深度超限的报错因此只取决于递归调用链，与是否内联无关
+ *   - 被调用者（已完成它自己的内联）的有效指令数不超过 kInlineSmallCost，
+ *     或者它只剩这一个调用点且不超过 kInlineSingleCallCost（展开后原函数不再被调用，代码不重复）
+ *   - 展开后调用者不超过 kInlineCallerLimit 条指令，避免逐层展开使单个函数膨胀
+ * 展开时调用点所在的块在 call 处一分为二：call 改为跳到新的入口块（参数 = 实参，其余变量置0），
+ * 被调用者的块与值复制到调用者中（其变量成为保留变量名的临时值），ret 改为给调用结果赋值并跳到后半块。
+ * 展开的指令保留被调用者的行号，运行时错误的报告与不内联时相同。
+ * 有分支的函数在建立调用图之前先由 simplify（opt.h 的各遍）整理，删除不可达代码中的 call，使调用点数准确；
+ * 此后展开过调用点的函数与尚未整理的函数（只有一个块，没有不可达的 call）推迟整理：作为被调用者时
+ * 先按未整理的大小计算代价，超出时整理后再算；只剩一个调用点的函数因此常常未经整理就展开，与调用者一起整理，
+ * 一串逐层展开的调用不必每层都重新整理越来越长的函数体。其余的函数在最后各整理一次。
+ *
+ * irRemoveDeadFunctions 删除从 main 经调用图不可达的函数（没有 main 时全部保留），并重新编号 call 的目标。
+ * 各步的耗时与指令数（含展开产生的指令）成线性。
+ */
+
+static const size_t kInlineSmallCost = 16;
+static const size_t kInlineSingleCallCost = 200;
+static const size_t kInlineCallerLimit = 5000;
+
+// 调用图（函数下标为 IrModule::functions 的下标）
+struct CallGraph {
+    std::vector<uint32_t> calleeStart;   // 函数 f 调用的函数为 callees[calleeStart[f] .. calleeStart[f+1])
+    std::vector<uint32_t> callees;
+    std::vector<uint32_t> callSites;     // 各函数被调用的调用点数
+    std::vector<uint32_t> component;     // 所在的强连通分量，按逆拓扑序编号
+    std::vector<bool> recursive;         // 是否在调用环上
+    uint32_t componentCount = 0;
+};
+
+// 内联统计
+struct InlineStats {
+    size_t components = 0;   // 强连通分量数
+    size_t recursive = 0;    // 递归函数数
+    size_t inlined = 0;      // 展开的调用点数
+};
+
+/* INFO 分析与变换接口 */
+
+// 由各函数的 call 指令建立调用图并求强连通分量
+void irBuildCallGraph(const IrModule& module, CallGraph& graph);
+
+// 自底向上内联；simplify 整理各函数（执行前指令数组已压缩、控制流图已更新）
+void irInlineModule(IrModule& module, InlineStats& stats, const std::function<void(IrFunction&)>& simplify);
+
+// 删除从 main 不可达的函数，返回删除的函数数
+size_t irRemoveDeadFunctions(IrModule& module);
+
+#endif /* CALLGRAPH_H */
@@ -0,0 +1,357 @@
+#include "dataflow.h"
+#include <algorithm>
+#include <deque>
+
+static const uint32_t kNoBit = UINT32_MAX;
+
+/* INFO 公共工具 */
+
+// 依次访问指令读取的值
+template <typename Fn>
+static void forEachUse(const IrFunction& function, const IrInst& inst, Fn fn) {
+    switch (inst.op) {
+        case IR_NOP:
+        case IR_JMP:
+            break;
+        case IR_MOV:
+        case IR_CONV:
+        case IR_BR:
+        case IR_RET:
+            fn(inst.a);
+            break;
+        case IR_CALL:
+            for (uint32_t k = 0; k < inst.c; k++) fn(function.args[inst.b + k]);
+            break;
+        default:
+            fn(inst.a);
+            fn(inst.b);
+            break;
+    }
+}
+
+/* INFO 单个函数的检查 */
+
+struct FunctionChecker {
+    const IrModule& module;
+    const IrFunction& function;
+    DataflowStats& stats;
+    std::vector<ParserError>& warnings;
+
+    std::vector<uint32_t> order;                       // 可达块的逆后序（irNestedOrder）
+    std::vector<uint32_t> position;                    // 块在逆后序中的位置，不可达时为kNoBit
+    std::vector<std::pair<uint32_t, uint32_t>> spans;  // 回边覆盖的位置区间，重叠的已合并
+    std::vector<uint32_t> lo, hi;                      // 各变量被引用的块的位置范围
+    std::vector<uint32_t> tracked;                     // 有向上暴露使用的变量，按引用范围排序
+    std::vector<bool> isTracked;
+    std::vector<uint32_t> bitOf;                       // 变量在当前组中的位号，不在当前组时为kNoBit
+    std::vector<uint32_t> mark, killed;                // 块内扫描的标记（槽位为下标，等于stamp时有效）
+    uint32_t stamp = 0;
+    std::vector<int> firstLine;                        // 各变量最早的未初始化使用
+    std::vector<std::pair<int, uint32_t>> dead;        // 无用赋值（行号，变量）
+
+    // 当前组：位置区间 [first, last] 中的块各有一个位向量
+    uint32_t first = 0, last = 0;
+    size_t words = 0;                                  // 每个位向量的64位字数
+    std::vector<uint64_t> sets;                        // 位置 p 的块为 sets[(p - first) * words ..)
+    std::vector<uint64_t> scratch;
+    std::vector<uint64_t> entry;                       // 从区间外进入时未初始化的变量（非参数）
+    std::vector<uint32_t> killStart, kills;            // 各块赋值的组内变量（CSR，位号）
+    std::vector<uint32_t> useStart, uses;              // 各块向上暴露使用的组内变量（CSR，位号）
+    std::deque<uint32_t> work;
+    std::vector<bool> queued;
+
+    FunctionChecker(const IrModule& m, const IrFunction& f, DataflowStats& s, std::vector<ParserError>& w)
+        : module(m), function(f), stats(s), warnings(w) {}
+
+    bool isVar(uint32_t value) const { return value < function.slotCount; }
+    bool inGroup(uint32_t value) const { return isVar(value) && bitOf[value] != kNoBit; }
+    bool test(const uint64_t* set, uint32_t bit) const { return (set[bit >> 6] >> (bit & 63)) & 1; }
+    void set(uint64_t* set, uint32_t bit) { set[bit >> 6] |= (uint64_t)1 << (bit & 63); }
+    void clear(uint64_t* set, uint32_t bit) { set[bit >> 6] &= ~((uint64_t)1 << (bit & 63)); }
+    uint64_t* setAt(uint32_t p) { return sets.data() + (p - first) * words; }
+    bool inRange(uint32_t p) const { return p >= first && p <= last; }
+
+    std::string name(uint32_t slot) const { return module.names.name(function.values[slot].name); }
+
+    // 找出有向上暴露使用的变量及各变量被引用的范围，并合并回边区间
+    void collect() {
+        order = irNestedOrder(function);
+        position.assign(function.blocks.size(), kNoBit);
+        for (uint32_t p = 0; p < order.size(); p++) position[order[p]] = p;
+        lo.assign(function.slotCount, kNoBit);
+        hi.assign(function.slotCount, 0);
+        isTracked.assign(function.slotCount, false);
+        bitOf.assign(function.slotCount, kNoBit);
+        mark.assign(function.slotCount, 0);
+        killed.assign(function.slotCount, 0);
+        firstLine.assign(function.slotCount, 0);
+        for (uint32_t p = 0; p < order.size(); p++) {
+            const IrBlock& block = function.blocks[order[p]];
+            auto touch = [&](uint32_t v) {
+                lo[v] = std::min(lo[v], p);
+                hi[v] = std::max(hi[v], p);
+            };
+            stamp++;
+            for (uint32_t i = block.begin; i < block.end; i++) {
+                const IrInst& inst = function.insts[i];
+                forEachUse(function, inst, [&](uint32_t v) {
+                    if (!isVar(v)) return;
+                    touch(v);
+                    if (mark[v] != stamp) isTracked[v] = true;
+                });
+                if (inst.dst != kNoValue && isVar(inst.dst)) {
+                    touch(inst.dst);
+                    mark[inst.dst] = stamp;
+                }
+            }
+            for (uint32_t succ : block.succs) {
+                if (position[succ] <= p) spans.push_back({ position[succ], p });
+            }
+        }
+        std::sort(spans.begin(), spans.end());
+        size_t merged = 0;
+        for (const auto& span : spans) {
+            if (merged > 0 && span.first <= spans[merged - 1].second) {
+                spans[merged - 1].second = std::max(spans[merged - 1].second, span.second);
+            } else {
+                spans[merged++] = span;
+            }
+        }
+        spans.resize(merged);
+        for (uint32_t v = 0; v < function.slotCount; v++) {
+            if (isTracked[v]) tracked.push_back(v);
+        }
+        std::stable_sort(tracked.begin(), tracked.end(),
+                         [&](uint32_t x, uint32_t y) { return lo[x] != lo[y] ? lo[x] < lo[y] : hi[x] < hi[y]; });
+        stats.bits += tracked.size();
+    }
+
+    // 把 [first, last] 扩展到与之相交的回边区间；合并后的区间互不重叠，只需看两端落在哪个区间中
+    void closeRange() {
+        auto containing = [&](uint32_t p) {
+            auto it = std::upper_bound(spans.begin(), spans.end(), std::make_pair(p, UINT32_MAX));
+            return it != spans.begin() && (it - 1)->second >= p ? it - 1 : spans.end();
+        };
+        auto low = containing(first);
+        if (low != spans.end()) first = low->first;
+        auto high = containing(last);
+        if (high != spans.end()) last = high->second;
+    }
+
+    // 建立当前组在区间内各块的杀死集与使用集，每个变量在一块的表中只出现一次
+    void buildSets() {
+        uint32_t count = last - first + 1;
+        kills.clear();
+        uses.clear();
+        killStart.assign(count + 1, 0);
+        useStart.assign(count + 1, 0);
+        for (uint32_t p = first; p <= last; p++) {
+            killStart[p - first] = (uint32_t)kills.size();
+            useStart[p - first] = (uint32_t)uses.size();
+            const IrBlock& block = function.blocks[order[p]];
+            stamp++;
+            for (uint32_t i = block.begin; i < block.end; i++) {
+                const IrInst& inst = function.insts[i];
+                forEachUse(function, inst, [&](uint32_t v) {
+                    if (!inGroup(v) || mark[v] == stamp || killed[v] == stamp) return;
+                    mark[v] = stamp;
+                    uses.push_back(bitOf[v]);
+                });
+                uint32_t d = inst.dst;
+                if (d != kNoValue && inGroup(d) && killed[d] != stamp) {
+                    killed[d] = stamp;
+                    kills.push_back(bitOf[d]);
+                }
+            }
+        }
+        killStart[count] = (uint32_t)kills.size();
+        useStart[count] = (uint32_t)uses.size();
+        sets.assign(count * words, 0);
+        scratch.assign(words, 0);
+        queued.assign(count, false);
+    }
+
+    void push(uint32_t p) {
+        if (inRange(p) && !queued[p - first]) {
+            queued[p - first] = true;
+            work.push_back(p);
+        }
+    }
+
+    // 前向：入口为区间内各前驱出口之并，函数入口块或有区间外的前驱时另加未初始化的隐含定值，写入scratch
+    void forwardIn(uint32_t p) {
+        std::fill(scratch.begin(), scratch.end(), 0);
+        bool outside = p == 0;
+        for (uint32_t pred : function.blocks[order[p]].preds) {
+            uint32_t q = position[pred];
+            if (q == kNoBit) continue;
+            if (!inRange(q)) {
+                outside = true;
+                continue;
+            }
+            const uint64_t* out = setAt(q);
+            for (size_t w = 0; w < words; w++) scratch[w] |= out[w];
+        }
+        if (outside) {
+            for (size_t w = 0; w < words; w++) scratch[w] |= entry[w];
+        }
+    }
+
+    // 后向：出口为区间内各后继入口之并（组内变量在区间之外不再被引用），写入scratch
+    void backwardOut(uint32_t p) {
+        std::fill(scratch.begin(), scratch.end(), 0);
+        for (uint32_t succ : function.blocks[order[p]].succs) {
+            uint32_t q = position[succ];
+            if (!inRange(q)) continue;
+            const uint64_t* in = setAt(q);
+            for (size_t w = 0; w < words; w++) scratch[w] |= in[w];
+        }
+    }
+
+    // 把scratch存为位置 p 的块的结果，返回是否改变
+    bool store(uint32_t p) {
+        uint64_t* target = setAt(p);
+        if (std::equal(scratch.begin(), scratch.end(), target)) return false;
+        std::copy(scratch.begin(), scratch.end(), target);
+        return true;
+    }
+
+    // 到达定值：隐含定值可能到达的使用处记为未初始化
+    void checkUninitialized() {
+        for (uint32_t p = first; p <= last; p++) push(p);
+        while (!work.empty()) {
+            uint32_t p = work.front();
+            work.pop_front();
+            queued[p - first] = false;
+            stats.visits++;
+            forwardIn(p);
+            for (uint32_t k = killStart[p - first]; k < killStart[p - first + 1]; k++) clear(scratch.data(), kills[k]);
+            if (store(p)) {
+                for (uint32_t succ : function.blocks[order[p]].succs) push(position[succ]);
+            }
+        }
+        for (uint32_t p = first; p <= last; p++) {
+            forwardIn(p);
+            const IrBlock& block = function.blocks[order[p]];
+            for (uint32_t i = block.begin; i < block.end; i++) {
+                const IrInst& inst = function.insts[i];
+                forEachUse(function, inst, [&](uint32_t v) {
+                    if (!inGroup(v) || !test(scratch.data(), bitOf[v])) return;
+                    if (firstLine[v] == 0 || inst.line < firstLine[v]) firstLine[v] = inst.line;
+                });
+                if (inst.dst != kNoValue && inGroup(inst.dst)) clear(scratch.data(), bitOf[inst.dst]);
+            }
+        }
+    }
+
+    // 活跃变量：赋值之后不再活跃的记为无用赋值
+    void checkDeadAssignments() {
+        std::fill(sets.begin(), sets.end(), 0);
+        for (uint32_t p = last + 1; p-- > first;) push(p);
+        while (!work.empty()) {
+            uint32_t p = work.front();
+            work.pop_front();
+            queued[p - first] = false;
+            stats.visits++;
+            backwardOut(p);
+            for (uint32_t k = killStart[p - first]; k < killStart[p - first + 1]; k++) clear(scratch.data(), kills[k]);
+            for (uint32_t k = useStart[p - first]; k < useStart[p - first + 1]; k++) set(scratch.data(), uses[k]);
+            if (store(p)) {
+                for (uint32_t pred : function.blocks[order[p]].preds) {
+                    if (position[pred] != kNoBit) push(position[pred]);
+                }
+            }
+        }
+        for (uint32_t p = first; p <= last; p++) {
+            backwardOut(p);
+            const IrBlock& block = function.blocks[order[p]];
+            for (uint32_t i = block.end; i-- > block.begin;) {
+                const IrInst& inst = function.insts[i];
+                uint32_t d = inst.dst;
+                if (d != kNoValue && inGroup(d)) {
+                    if (!test(scratch.data(), bitOf[d])) dead.push_back({ inst.line, d });
+                    clear(scratch.data(), bitOf[d]);
+                }
+                forEachUse(function, inst, [&](uint32_t v) {
+                    if (inGroup(v)) set(scratch.data(), bitOf[v]);
+                });
+            }
+        }
+    }
+
+    // 没有位的变量每次使用之前都有同一块中的赋值，不会未初始化，用 mark 记录块内的活跃即可
+    void checkLocalAssignments() {
+        for (uint32_t b : order) {
+            const IrBlock& block = function.blocks[b];
+            stamp++;
+            for (uint32_t i = block.end; i-- > block.begin;) {
+                const IrInst& inst = function.insts[i];
+                uint32_t d = inst.dst;
+                if (d != kNoValue && isVar(d) && !isTracked[d]) {
+                    if (mark[d] != stamp) dead.push_back({ inst.line, d });
+                    mark[d] = 0;
+                }
+                forEachUse(function, inst, [&](uint32_t v) {
+                    if (isVar(v)) mark[v] = stamp;
+                });
+            }
+        }
+    }
+
+    // 有位的变量按引用范围分组，每组只在组内变量引用范围的闭包区间上分析（见 dataflow.h）
+    void run() {
+        collect();
+        for (size_t k = 0; k < tracked.size(); k += kDataflowGroupBits) {
+            size_t end = std::min(tracked.size(), k + kDataflowGroupBits);
+            first = UINT32_MAX;
+            last = 0;
+            words = (end - k + 63) / 64;
+            entry.assign(words, 0);
+            for (size_t j = k; j < end; j++) {
+                uint32_t v = tracked[j];
+                bitOf[v] = (uint32_t)(j - k);
+                if (v >= function.paramCount) set(entry.data(), bitOf[v]);
+                first = std::min(first, lo[v]);
+                last = std::max(last, hi[v]);
+            }
+            closeRange();
+            buildSets();
+            checkUninitialized();
+            checkDeadAssignments();
+            for (size_t j = k; j < end; j++) bitOf[tracked[j]] = kNoBit;
+        }
+        checkLocalAssignments();
+        report();
+    }
+
+    // 每个变量的未初始化使用只报告最早的一行，同一行对同一变量的无用赋值只报告一次
+    void report() {
+        for (uint32_t slot = function.paramCount; slot < function.slotCount; slot++) {
+            if (firstLine[slot] == 0) continue;
+            warnings.push_back({ firstLine[slot], "警告: 变量 '" + name(slot) + "' 可能在初始化之前使用（此时为0）" });
+            stats.uninitialized++;
+        }
+        std::sort(dead.begin(), dead.end());
+        dead.erase(std::unique(dead.begin(), dead.end()), dead.end());
+        for (const auto& entry : dead) {
+            warnings.push_back({ entry.first, "警告: 赋给变量 '" + name(entry.second) + "' 的值从未被读取" });
+        }
+        stats.deadAssignments += dead.size();
+    }
+};
+
+/* 接口实现 */
+
+void checkDataflow(const IrModule& module, SemaResult& sema, DataflowStats& stats) {
+    std::vector<ParserError> warnings;
+    for (const IrFunction& function : module.functions) {
+        if (function.blocks.empty()) continue;
+        FunctionChecker checker(module, function, stats, warnings);
+        checker.run();
+    }
+    if (warnings.empty()) return;
+    sema.warningCount += warnings.size();
+    sema.diagnostics.insert(sema.diagnostics.end(), warnings.begin(), warnings.end());
+    std::stable_sort(sema.diagnostics.begin(), sema.diagnostics.end(),
+                     [](const ParserError& x, const ParserError& y) { return x.line < y.line; });
+}
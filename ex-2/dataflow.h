@@ -0,0 +1,47 @@
+#ifndef DATAFLOW_H
+#define DATAFLOW_H
+
+#include "ir.h"
+#include "sema.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * 数据流检查：未初始化的变量与无用的赋值
+ * ===========================
+ * 在未优化的中间代码上逐个函数做两种位向量数据流分析，每个变量槽位一位：
+ *   - 到达定值（前向，汇合处取并）：函数入口处每个非参数变量有一个“未初始化”的隐含定值，
+ *     对变量的赋值杀死它。隐含定值仍可能到达的使用处报告“可能在初始化之前使用”
+ *     （按 ir.h 的语义此时值为0，程序仍然合法，因此是警告）
+ *   - 活跃变量（后向，汇合处取并）：赋值之后在任何路径上都不再读取该变量时，报告“赋给变量的值从未被读取”
+ * 只为有向上暴露使用（在某个块中先于赋值被读取）的变量分配位，其余变量的每次使用前都有同一块中的赋值，
+ * 扫描块时直接判断。
+ *
+ * 有位的变量按被引用的块在逆后序中的位置范围排序，每 kDataflowGroupBits 个一组分别分析，
+ * 一组的位向量只覆盖组内变量引用范围的并再扩展到与之相交的回边区间后的块：路径离开这样的区间后不会再回来，
+ * 因此从区间外进入时组内变量都处于函数入口的状态，离开区间后都不再活跃。普通函数只有一组、覆盖整个函数；
+ * 变量与块都很多时（例如深层嵌套的循环各自声明变量）各组只覆盖一段，总开销不随两者之积增长。
+ *
+ * 两种分析都用工作表迭代：前向按逆后序、后向按后序放入初始的块，某块的结果改变时把后继（前驱）加入工作表；
+ * 每块只保存一个位向量（前向为出口、后向为入口），块内的杀死集与使用集以位号表存放，
+ * 一次传递函数的计算是按64位字的或运算加上逐个清除被杀死的位。
+ * 不可达的块不参与分析也不报告。每个变量的未初始化使用只报告最早的一行，同一行对同一变量的无用赋值只报告一次。
+ */
+
+static const size_t kDataflowGroupBits = 256;
+
+// 检查统计
+struct DataflowStats {
+    size_t uninitialized = 0;   // 可能在初始化之前使用的变量
+    size_t deadAssignments = 0; // 从未被读取的赋值
+    size_t bits = 0;            // 分配了位的变量数（各函数之和）
+    size_t visits = 0;          // 工作表处理块的次数（两种分析、各组之和）
+};
+
+/* INFO 检查接口 */
+
+// 检查由 lowerToIr 生成（未优化）的各函数，警告按行号并入 sema.diagnostics，计入 sema.warningCount
+void checkDataflow(const IrModule& module, SemaResult& sema, DataflowStats& stats);
+
+#endif /* DATAFLOW_H */
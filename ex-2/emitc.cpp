@@ -0,0 +1,662 @@
+#include "emitc.h"
+#include "vm.h"
+#include <vector>
+#include <type_traits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/* INFO 运行时支持 */
+
+// 写在每个生成文件开头。mini_depth 为活动的 Mini 函数帧数（含 main），
+// 因此 mini_depth 超过 MINI_MAX_DEPTH 时相当于虚拟机在深度 kVmMaxDepth 处的调用
+static const char* const kPrelude =
+    "#include <stdint.h>\n"
+    "#include <stdio.h>\n"
+    "#include <stdlib.h>\n"
+    "#include <math.h>\n"
+    "\n"
+    "/* 运行时支持：int 按补码回绕，运行时错误的报告与字节码虚拟机相同 */\n"
+    "static int32_t mini_depth;\n"
+    "\n"
+    "static inline void mini_fail(int32_t line, const char* message) {\n"
+    "    printf(\"运行时错误（第 %d 行）: %s\\n\", (int)line, message);\n"
+    "    exit(1);\n"
+    "}\n"
+    "\n"
+    "static inline void mini_enter(int32_t line) {\n"
+    "    if (++mini_depth > MINI_MAX_DEPTH) {\n"
+    "        printf(\"运行时错误（第 %d 行）: 调用栈溢出（深度 %d）\\n\", (int)line, MINI_MAX_DEPTH);\n"
+    "        exit(1);\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "static inline int32_t mini_leave_i(int32_t value) { mini_depth--; return value; }\n"
+    "static inline float mini_leave_f(float value) { mini_depth--; return value; }\n"
+    "static inline double mini_leave_d(double value) { mini_depth--; return value; }\n"
+    "\n"
+    "static inline int32_t mini_add(int32_t a, int32_t b) { return (int32_t)((uint32_t)a + (uint32_t)b); }\n"
+    "static inline int32_t mini_sub(int32_t a, int32_t b) { return (int32_t)((uint32_t)a - (uint32_t)b); }\n"
+    "static inline int32_t mini_mul(int32_t a, int32_t b) { return (int32_t)((uint32_t)a * (uint32_t)b); }\n"
+    "\n"
+    "static inline int32_t mini_div(int32_t a, int32_t b, int32_t line) {\n"
+    "    if (b == 0) mini_fail(line, \"int 除以0\");\n"
+    "    return b == -1 ? (int32_t)(0u - (uint32_t)a) : a / b;\n"
+    "}\n"
+    "\n"
+    "static inline int32_t mini_ftoi(double value) {\n"
+    "    return value > -2147483649.0 && value < 2147483648.0 ? (int32_t)value : INT32_MIN;\n"
+    "}\n";
+
+/* INFO 输出缓冲 */
+
+// 按块写到输出流：生成的代码由大量很短的片段组成，逐个经 ostream 写出开销大
+struct CWriter {
+    std::ostream& out;
+    char buffer[1 << 16];
+    size_t used = 0;
+
+    explicit CWriter(std::ostream& stream) : out(stream) {}
+    ~CWriter() { flush(); }
+
+    void flush() {
+        out.write(buffer, (std::streamsize)used);
+        used = 0;
+    }
+
+    CWriter& write(const char* text, size_t size) {
+        if (used + size > sizeof(buffer)) {
+            flush();
+            if (size > sizeof(buffer)) {
+                out.write(text, (std::streamsize)size);
+                return *this;
+            }
+        }
+        memcpy(buffer + used, text, size);
+        used += size;
+        return *this;
+    }
+
+    CWriter& operator<<(const char* text) { return write(text, strlen(text)); }
+    CWriter& operator<<(const std::string& text) { return write(text.data(), text.size()); }
+    CWriter& operator<<(char ch) { return write(&ch, 1); }
+
+    // 整数（char 按字符写出，见上）
+    template <typename T, typename = typename std::enable_if<std::is_integral<T>::value>::type>
+    CWriter& operator<<(T value) {
+        char digits[24];
+        int n = snprintf(digits, sizeof(digits), "%lld", (long long)value);
+        return write(digits, (size_t)n);
+    }
+};
+
+/* INFO 名称 */
+
+// 可能与 Mini 标识符相同的 C 关键字（含 C23）与 GNU 模式下预定义的小写宏。
+// Mini 的标识符只含字母与数字，不会与生成的 mini_*、fn_* 及带后缀的名称冲突
+static const char* const kReservedNames[] = {
+    "auto", "break", "case", "char", "const", "continue", "default", "do", "enum", "extern", "for", "goto",
+    "inline", "long", "register", "restrict", "short", "signed", "sizeof", "static", "struct", "switch", "typedef",
+    "union", "unsigned", "void", "volatile", "asm", "bool", "true", "false", "alignas", "alignof", "constexpr",
+    "nullptr", "typeof", "linux", "unix", "i386"
+};
+
+// 需要改名的变量名：C 的保留名，或没有小写字母（按惯例是宏，如 EOF、NULL）
+static bool isReserved(const std::string& name) {
+    for (const char* reserved : kReservedNames) {
+        if (name == reserved) return true;
+    }
+    for (char ch : name) {
+        if (ch >= 'a' && ch <= 'z') return false;
+    }
+    return true;
+}
+
+/* INFO 生成 */
+
+// 表达式的副作用标记（决定是否需要先把一侧存入临时变量）
+enum CEffect : uint8_t {
+    FX_READ = 1,     // 读变量
+    FX_WRITE = 2,    // 赋值
+    FX_CALL = 4,     // 调用（可能出错）
+    FX_FAIL = 8      // int 除法（可能出错）
+};
+static const uint8_t FX_ORDERED = FX_WRITE | FX_CALL | FX_FAIL;
+
+// 先求值的 first 与之后求值的 later 在 C 中不能交换或交错求值
+static bool conflicts(uint8_t first, uint8_t later) {
+    return ((later & FX_WRITE) && (first & (FX_READ | FX_WRITE))) ||
+           ((first & FX_WRITE) && (later & (FX_READ | FX_WRITE))) ||
+           ((first & FX_ORDERED) && (later & FX_ORDERED));
+}
+
+static const char* cTypeName(MiniType type) {
+    return type == TYPE_INT ? "int32_t" : (type == TYPE_FLOAT ? "float" : "double");
+}
+
+static char typeLetter(MiniType type) {
+    return type == TYPE_INT ? 'i' : (type == TYPE_FLOAT ? 'f' : 'd');
+}
+
+struct CEmitter {
+    // 左脊上一个二元运算的状态
+    struct SpineEntry {
+        uint32_t node;
+        uint32_t temp;    // 左操作数所在的临时变量编号，0表示不需要
+        bool paren;       // 是否需要外层括号
+    };
+
+    const AstProgram& program;
+    const SemaResult& sema;
+    CWriter out;
+    std::string file;                          // #line 中的文件名（已转义）
+    std::vector<uint8_t> effects;              // 各表达式节点的副作用标记
+    std::vector<std::string> functionNames;    // fn_<名称>
+    std::vector<std::string> slotNames;        // 当前函数各槽位的 C 名称
+    std::vector<uint32_t> nameSeen;            // 名称ID -> 最后使用它的函数编号+1
+    const SemaFunction* function = nullptr;
+    uint32_t temps[4] = {};                    // 当前函数已用的临时变量个数（按类型）
+    int indent = 0;
+    bool mapped = false;                       // 是否已写出过 #line
+    int32_t nextLine = 0;                      // 下一输出行对应的源码行号
+    std::vector<SpineEntry> spine;
+    std::vector<uint32_t> argNodes;            // 正在写出的调用的实参（嵌套调用依次向后追加）
+    std::vector<uint32_t> argTemps;            // 与 argNodes 对应：先存入的临时变量编号，0表示直接写出
+    std::vector<std::pair<uint32_t, bool>> walk;
+
+    CEmitter(const AstProgram& ast, const SemaResult& result, std::ostream& stream)
+        : program(ast), sema(result), out(stream) {}
+
+    const AstNode& node(uint32_t index) const {
+        return program.nodes[index];
+    }
+
+    void newline() {
+        out << '\n';
+        nextLine++;
+    }
+
+    void writeIndent() {
+        for (int i = 0; i < indent; i++) out << "    ";
+    }
+
+    // 开始一行源码第 line 行的代码：行号与编译器的计数不符时先写 #line
+    void startLine(int32_t line) {
+        if (!mapped || nextLine != line) {
+            out << "#line " << line << " \"" << file << "\"\n";
+            mapped = true;
+            nextLine = line;
+        }
+        writeIndent();
+    }
+
+    void temp(MiniType type, uint32_t number) {
+        out << "mini_" << typeLetter(type) << number;
+    }
+
+    /* 预处理 */
+
+    // 后序遍历函数体（显式栈），计算表达式的副作用标记与需要的临时变量个数
+    void analyzeFunction(uint32_t body, uint32_t counts[4]) {
+        walk.clear();
+        walk.push_back({ body, false });
+        while (!walk.empty()) {
+            uint32_t index = walk.back().first;
+            bool done = walk.back().second;
+            walk.pop_back();
+            const AstNode& n = node(index);
+            if (!done) {
+                walk.push_back({ index, true });
+                if (n.kind == AST_BLOCK || n.kind == AST_CALL) {
+                    for (uint32_t child = n.a; child != kNoNode; child = node(child).next) {
+                        walk.push_back({ child, false });
+                    }
+                } else {
+                    if (n.a != kNoNode) walk.push_back({ n.a, false });
+                    if (n.b != kNoNode) walk.push_back({ n.b, false });
+                    if (n.c != kNoNode) walk.push_back({ n.c, false });
+                }
+                continue;
+            }
+            switch (n.kind) {
+                case AST_IDENT:
+                    effects[index] = FX_READ;
+                    break;
+                case AST_ASSIGN:
+                    effects[index] = effects[n.a] | FX_WRITE;
+                    if (effects[n.a] & FX_WRITE) counts[function->slotTypes[n.slot]]++;
+                    break;
+                case AST_BINARY:
+                    effects[index] = effects[n.a] | effects[n.b];
+                    if (n.op == TK_DIVIDE && n.type == TYPE_INT) effects[index] |= FX_FAIL;
+                    if (n.op != TK_AND && n.op != TK_OR && conflicts(effects[n.a], effects[n.b])) {
+                        counts[node(n.a).type]++;
+                    }
+                    break;
+                case AST_CALL: {
+                    size_t base = collectArgs(n);
+                    effects[index] = FX_CALL;
+                    for (size_t k = base; k < argNodes.size(); k++) {
+                        effects[index] |= effects[argNodes[k]];
+                        if (argTemps[k]) counts[sema.functions[n.slot].slotTypes[k - base]]++;
+                    }
+                    argNodes.resize(base);
+                    argTemps.resize(base);
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+    }
+
+    // 把调用的实参追加到 argNodes，并标出需要先存入临时变量的实参（argTemps 为1），返回起始位置
+    size_t collectArgs(const AstNode& call) {
+        size_t base = argNodes.size();
+        for (uint32_t arg = call.a; arg != kNoNode; arg = node(arg).next) {
+            argNodes.push_back(arg);
+            argTemps.push_back(0);
+        }
+        uint8_t later = 0;
+        for (size_t k = argNodes.size(); k-- > base;) {
+            uint8_t effect = effects[argNodes[k]];
+            argTemps[k] = conflicts(effect, later) ? 1 : 0;
+            later |= effect;
+        }
+        return base;
+    }
+
+    // 当前函数各槽位的 C 名称：保留名加“_”，与之前的槽位同名时加“_槽位”
+    void nameSlots(uint32_t functionIndex) {
+        slotNames.clear();
+        for (uint32_t slot = 0; slot < function->slotTypes.size(); slot++) {
+            uint32_t id = function->slotNames[slot];
+            std::string name = program.names.name(id);
+            if (isReserved(name)) name += "_";
+            if (nameSeen[id] == functionIndex + 1) {
+                name += "_" + std::to_string(slot);
+            }
+            nameSeen[id] = functionIndex + 1;
+            slotNames.push_back(name);
+        }
+    }
+
+    /* 表达式 */
+
+    // 写出转换为 target 类型的表达式；其余的转换由 C 的隐式转换完成
+    void converted(uint32_t index, MiniType target) {
+        if (target == TYPE_INT && node(index).type != TYPE_INT) {
+            out << "mini_ftoi(";
+            expression(index, false);
+            out << ")";
+        } else {
+            expression(index, false);
+        }
+    }
+
+    static const char* helperName(uint8_t op) {
+        switch (op) {
+            case TK_PLUS: return "mini_add";
+            case TK_MINUS: return "mini_sub";
+            case TK_STAR: return "mini_mul";
+            default: return "mini_div";
+        }
+    }
+
+    static const char* operatorText(uint8_t op) {
+        switch (op) {
+            case TK_PLUS: return " + ";
+            case TK_MINUS: return " - ";
+            case TK_STAR: return " * ";
+            case TK_DIVIDE: return " / ";
+            case TK_BITAND: return " & ";
+            case TK_BITOR: return " | ";
+            case TK_AND: return " && ";
+            case TK_OR: return " || ";
+            case TK_EQ: return " == ";
+            case TK_LT: return " < ";
+            case TK_LEQ: return " <= ";
+            case TK_GT: return " > ";
+            default: return " >= ";
+        }
+    }
+
+    // int 的算术经运行时函数，其余运算直接用 C 的运算符
+    static bool usesHelper(const AstNode& n) {
+        return n.type == TYPE_INT &&
+               (n.op == TK_PLUS || n.op == TK_MINUS || n.op == TK_STAR || n.op == TK_DIVIDE);
+    }
+
+    // paren 为表达式作 C 运算符的操作数时，需要括号
+    void expression(uint32_t index, bool paren) {
+        size_t base = spine.size();
+        while (node(index).kind == AST_BINARY) {
+            const AstNode& n = node(index);
+            SpineEntry entry{ index, 0, paren };
+            if (n.op != TK_AND && n.op != TK_OR && conflicts(effects[n.a], effects[n.b])) {
+                // (mini_t = 左操作数, mini_t 运算 右操作数)
+                MiniType type = node(n.a).type;
+                entry.temp = ++temps[type];
+                out << "(";
+                temp(type, entry.temp);
+                out << " = ";
+                paren = false;
+            } else if (usesHelper(n)) {
+                out << helperName(n.op) << "(";
+                paren = false;
+            } else {
+                if (paren) out << "(";
+                paren = true;
+            }
+            spine.push_back(entry);
+            index = n.a;
+        }
+        operand(index, paren);
+        while (spine.size() > base) {
+            SpineEntry entry = spine.back();
+            spine.pop_back();
+            const AstNode& n = node(entry.node);
+            bool helper = usesHelper(n);
+            if (entry.temp != 0) {
+                out << ", ";
+                if (helper) out << helperName(n.op) << "(";
+                temp(node(n.a).type, entry.temp);
+            }
+            if (helper) {
+                out << ", ";
+                expression(n.b, false);
+                if (n.op == TK_DIVIDE) out << ", " << n.line;
+                out << ")";
+            } else {
+                out << operatorText(n.op);
+                expression(n.b, true);
+            }
+            if (entry.temp != 0 || (!helper && entry.paren)) out << ")";
+        }
+    }
+
+    void operand(uint32_t index, bool paren) {
+        const AstNode& n = node(index);
+        switch (n.kind) {
+            case AST_INT_CONST: {
+                int32_t value = (int32_t)n.intValue;
+                if (value == INT32_MIN) {
+                    out << "(-2147483647 - 1)";
+                } else if (value < 0) {
+                    out << "(" << value << ")";
+                } else {
+                    out << value;
+                }
+                break;
+            }
+            case AST_DOUBLE_CONST:
+                writeDouble(n.doubleValue);
+                break;
+            case AST_IDENT:
+                out << slotNames[n.slot];
+                break;
+            case AST_ASSIGN: {
+                MiniType type = function->slotTypes[n.slot];
+                if (effects[n.a] & FX_WRITE) {
+                    // 右部也有赋值：C 中两次写入同一变量之间没有顺序点
+                    uint32_t number = ++temps[type];
+                    out << "(";
+                    temp(type, number);
+                    out << " = ";
+                    converted(n.a, type);
+                    out << ", " << slotNames[n.slot] << " = ";
+                    temp(type, number);
+                    out << ")";
+                    break;
+                }
+                if (paren) out << "(";
+                out << slotNames[n.slot] << " = ";
+                converted(n.a, type);
+                if (paren) out << ")";
+                break;
+            }
+            case AST_CALL:
+                call(n);
+                break;
+            default:
+                out << "0";
+                break;
+        }
+    }
+
+    // fn_名称(行号, 实参...)；需要先求值的实参先存入临时变量：(mini_t = 实参, fn_名称(行号, mini_t, ...))
+    void call(const AstNode& n) {
+        const SemaFunction& callee = sema.functions[n.slot];
+        size_t base = collectArgs(n);
+        size_t count = argNodes.size() - base;
+        bool hoisted = false;
+        for (size_t k = 0; k < count; k++) {
+            if (argTemps[base + k] == 0) continue;
+            MiniType type = callee.slotTypes[k];
+            argTemps[base + k] = ++temps[type];
+            out << (hoisted ? "" : "(");
+            hoisted = true;
+            temp(type, argTemps[base + k]);
+            out << " = ";
+            converted(argNodes[base + k], type);
+            out << ", ";
+        }
+        out << functionNames[n.slot] << "(" << n.line;
+        for (size_t k = 0; k < count; k++) {
+            out << ", ";
+            if (argTemps[base + k] != 0) {
+                temp(callee.slotTypes[k], argTemps[base + k]);
+            } else {
+                converted(argNodes[base + k], callee.slotTypes[k]);
+            }
+        }
+        out << (hoisted ? "))" : ")");
+        argNodes.resize(base);
+        argTemps.resize(base);
+    }
+
+    // 能还原为同一 double 的最短十进制形式
+    void writeDouble(double value) {
+        if (value > 1.7976931348623157e308) {
+            out << "HUGE_VAL";
+            return;
+        }
+        char buf[64];
+        for (int precision = 15; precision <= 17; precision++) {
+            snprintf(buf, sizeof(buf), "%.*g", precision, value);
+            if (strtod(buf, nullptr) == value) break;
+        }
+        bool integral = strpbrk(buf, ".e") == nullptr;
+        if (value < 0) out << "(";
+        out << buf << (integral ? ".0" : "");
+        if (value < 0) out << ")";
+    }
+
+    /* 语句 */
+
+    // 写出“{”、分支中的语句与“}”，不换行
+    void branch(uint32_t index) {
+        out << "{";
+        newline();
+        indent++;
+        const AstNode& n = node(index);
+        if (n.kind == AST_BLOCK) {
+            for (uint32_t stmt = n.a; stmt != kNoNode; stmt = node(stmt).next) statement(stmt);
+        } else {
+            statement(index);
+        }
+        indent--;
+        writeIndent();
+        out << "}";
+    }
+
+    void statement(uint32_t index) {
+        const AstNode& n = node(index);
+        switch (n.kind) {
+            case AST_BLOCK:
+                startLine(n.line);
+                branch(index);
+                newline();
+                break;
+            case AST_VAR_DECL:
+                // 变量已在函数开头声明并置0；不带初值的声明不改变变量的值
+                if (n.a != kNoNode) {
+                    startLine(n.line);
+                    out << slotNames[n.slot] << " = ";
+                    converted(n.a, n.type);
+                    out << ";";
+                    newline();
+                }
+                break;
+            case AST_EXPR_STMT:
+                startLine(n.line);
+                if (n.a != kNoNode) expression(n.a, false);
+                out << ";";
+                newline();
+                break;
+            case AST_IF:
+                startLine(n.line);
+                out << "if (";
+                expression(n.a, false);
+                out << ") ";
+                branch(n.b);
+                if (n.c != kNoNode) {
+                    out << " else ";
+                    branch(n.c);
+                }
+                newline();
+                break;
+            case AST_WHILE:
+                startLine(n.line);
+                out << "while (";
+                expression(n.a, false);
+                out << ") ";
+                branch(n.b);
+                newline();
+                break;
+            case AST_RETURN:
+                startLine(n.line);
+                out << "return mini_leave_" << typeLetter(function->returnType) << "(";
+                if (n.a != kNoNode) {
+                    converted(n.a, function->returnType);
+                } else {
+                    out << "0";
+                }
+                out << ");";
+                newline();
+                break;
+            default:
+                break;
+        }
+    }
+
+    /* 函数 */
+
+    void signature(uint32_t f, bool named) {
+        const SemaFunction& info = sema.functions[f];
+        out << "static " << cTypeName(info.returnType) << " " << functionNames[f] << "(int32_t"
+            << (named ? " mini_line" : "");
+        for (uint32_t p = 0; p < info.paramCount; p++) {
+            out << ", " << cTypeName(info.slotTypes[p]);
+            if (named) out << " " << slotNames[p];
+        }
+        out << ")";
+    }
+
+    void emitFunction(uint32_t f) {
+        function = &sema.functions[f];
+        const AstNode& definition = node(function->node);
+        uint32_t counts[4] = {};
+        analyzeFunction(definition.b, counts);
+        nameSlots(f);
+        startLine(definition.line);
+        signature(f, true);
+        out << " {";
+        newline();
+        indent = 1;
+        for (uint32_t slot = function->paramCount; slot < function->slotTypes.size(); slot++) {
+            writeIndent();
+            out << cTypeName(function->slotTypes[slot]) << " " << slotNames[slot] << " = 0;";
+            newline();
+        }
+        for (MiniType type : { TYPE_INT, TYPE_FLOAT, TYPE_DOUBLE }) {
+            if (counts[type] == 0) continue;
+            writeIndent();
+            out << cTypeName(type) << " ";
+            for (uint32_t k = 1; k <= counts[type]; k++) {
+                if (k > 1) out << ", ";
+                temp(type, k);
+            }
+            out << ";";
+            newline();
+        }
+        writeIndent();
+        out << "mini_enter(mini_line);";
+        newline();
+        memset(temps, 0, sizeof(temps));
+        uint32_t last = kNoNode;
+        for (uint32_t stmt = node(definition.b).a; stmt != kNoNode; stmt = node(stmt).next) {
+            statement(stmt);
+            last = stmt;
+        }
+        if (last == kNoNode || node(last).kind != AST_RETURN) {
+            writeIndent();
+            out << "return mini_leave_" << typeLetter(function->returnType) << "(0);";
+            newline();
+        }
+        indent = 0;
+        out << "}";
+        newline();
+        newline();
+        function = nullptr;
+    }
+
+    // 以全0的实参调用 main 并按 vmValueText 的格式打印返回值
+    void emitDriver(uint32_t f) {
+        const SemaFunction& info = sema.functions[f];
+        out << "int main(void) {\n    " << cTypeName(info.returnType) << " result = " << functionNames[f] << "(0";
+        for (uint32_t p = 0; p < info.paramCount; p++) out << ", 0";
+        out << ");\n";
+        if (info.returnType == TYPE_INT) {
+            out << "    printf(\"%d\\n\", (int)result);\n";
+        } else {
+            out << "    printf(\"" << (info.returnType == TYPE_FLOAT ? "%.9g" : "%.17g") << "\\n\", (double)result);\n";
+        }
+        out << "    return 0;\n}\n\n";
+    }
+
+    void emitProgram(const std::string& sourceName) {
+        for (char ch : sourceName) {
+            if (ch == '\\' || ch == '"') file += '\\';
+            file += ch;
+        }
+        effects.assign(program.nodes.size(), 0);
+        nameSeen.assign(program.names.size(), 0);
+        uint32_t mainFunction = UINT32_MAX;
+        for (uint32_t f = 0; f < sema.functions.size(); f++) {
+            const std::string& name = program.names.name(sema.functions[f].name);
+            functionNames.push_back("fn_" + name);
+            if (name == "main") mainFunction = f;
+        }
+
+        out << "/* 由 Mini 源文件 " << sourceName << " 生成 */\n";
+        out << "#define MINI_MAX_DEPTH " << kVmMaxDepth << "\n";
+        out << kPrelude << "\n";
+        for (uint32_t f = 0; f < sema.functions.size(); f++) {
+            signature(f, false);
+            out << ";\n";
+        }
+        out << "\n";
+        if (mainFunction != UINT32_MAX) emitDriver(mainFunction);
+        for (uint32_t f = 0; f < sema.functions.size(); f++) {
+            emitFunction(f);
+        }
+    }
+};
+
+/* 接口实现 */
+
+void emitC(const AstProgram& program, const SemaResult& sema, const std::string& sourceName, std::ostream& out) {
+    CEmitter emitter(program, sema, out);
+    emitter.emitProgram(sourceName);
+}
@@ -0,0 +1,37 @@
+#ifndef EMITC_H
+#define EMITC_H
+
+#include "ast.h"
+#include "sema.h"
+#include <ostream>
+#include <string>
+
+/*
+ * C 代码生成
+ * ===========================
+ * 把通过语义分析（没有错误）的语法树翻译为可移植的 C99 源码，由系统的 C 编译器编译为本机代码。
+ * 生成的代码保留源程序的结构（if/while/块、&& || 的短路求值），语义与 ir.h 相同：
+ *   - 类型：int -> int32_t，float -> float，double -> double；混合运算依赖 C 的常规算术转换，
+ *     与中间代码的 conv 一致
+ *   - int 的加减乘经 mini_add/mini_sub/mini_mul 按补码回绕（无符号运算，不触发 C 的未定义行为），
+ *     除法经 mini_div 检查除以0并处理 INT_MIN / -1；浮点转 int 经 mini_ftoi（越界与 NaN 为 INT_MIN）
+ *   - 求值顺序：C 不规定二元运算两侧与各实参的求值顺序，一侧的赋值、调用或可能出错的除法
+ *     会影响另一侧时，先用逗号表达式把左侧（或先求值的实参）存入临时变量 mini_i/f/d<n>
+ *   - 运行时错误：与 vm.h 相同的文本写到标准输出，退出码为1；调用深度超过 kVmMaxDepth 时报告调用处的行号
+ *     （每个函数的第一个参数 mini_line 为调用处的行号）
+ *   - Mini 的函数为 static 的 fn_<名称>；变量保留原名，与 C 的关键字或宏冲突、或同一函数内重名时加后缀
+ * 程序有 main 函数时生成 C 的 main：以全0的实参调用，按 vmValueText 的格式打印返回值。
+ * 每条语句前按需写出 #line，编译错误与调试信息指向 Mini 源文件的行号。
+ * 浮点结果与虚拟机逐位相同的前提是 float 按单精度求值且不合并乘加（FLT_EVAL_METHOD 为0，
+ * 如 x86-64 上的 cc -std=c99），并且本机栈能容纳 kVmMaxDepth 层调用。
+ *
+ * 整个程序一遍写出到输出流，不为语法树节点拼接字符串；表达式沿左脊循环、只在右操作数上递归
+ * （同 ir.cpp），递归深度与运算链长度无关。
+ */
+
+/* INFO 生成接口 */
+
+// 把程序写为 C 源码；sourceName 为 #line 中的源文件名
+void emitC(const AstProgram& program, const SemaResult& sema, const std::string& sourceName, std::ostream& out);
+
+#endif /* EMITC_H */
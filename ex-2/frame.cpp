@@ -0,0 +1,94 @@
+#include "frame.h"
+#include <unistd.h>
+#include <cerrno>
+
+/* 辅助函数 */
+// 完整写出len字节，处理短写与信号中断
+static bool writeAll(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+// 完整读取len字节，对端提前关闭时返回false
+static bool readAll(int fd, char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = read(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (n == 0) return false;
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+// 编码帧头：类型 + 小端长度
+static void encodeHeader(char header[5], char kind, uint32_t len) {
+    header[0] = kind;
+    header[1] = (char)(len & 0xFF);
+    header[2] = (char)((len >> 8) & 0xFF);
+    header[3] = (char)((len >> 16) & 0xFF);
+    header[4] = (char)((len >> 24) & 0xFF);
+}
+
+// 解码帧头中的长度
+static uint32_t decodeLength(const unsigned char* header) {
+    return header[1] | (header[2] << 8) | (header[3] << 16) | ((uint32_t)header[4] << 24);
+}
+
+/* 接口实现 */
+bool writeFrame(int fd, char kind, const std::string& payload) {
+    char header[5];
+    encodeHeader(header, kind, (uint32_t)payload.size());
+    return writeAll(fd, header, sizeof(header)) && writeAll(fd, payload.data(), payload.size());
+}
+
+void appendFrame(std::string& out, char kind, const std::string& payload) {
+    char header[5];
+    encodeHeader(header, kind, (uint32_t)payload.size());
+    out.append(header, sizeof(header));
+    out += payload;
+}
+
+size_t decodeFrame(const std::string& in, size_t offset, char& kind, std::string& payload, bool& malformed) {
+    malformed = false;
+    if (in.size() - offset < 5) {
+        return 0;
+    }
+    const unsigned char* header = (const unsigned char*)in.data() + offset;
+    uint32_t len = decodeLength(header);
+    if (len > kMaxFramePayload) {
+        malformed = true;
+        return 0;
+    }
+    if (in.size() - offset - 5 < len) {
+        return 0;
+    }
+    kind = (char)header[0];
+    payload.assign(in, offset + 5, len);
+    return 5 + (size_t)len;
+}
+
+bool readFrame(int fd, char& kind, std::string& payload) {
+    unsigned char header[5];
+    if (!readAll(fd, (char*)header, sizeof(header))) {
+        return false;
+    }
+    uint32_t len = decodeLength(header);
+    if (len > kMaxFramePayload) {
+        return false;
+    }
+    kind = (char)header[0];
+    payload.resize(len);  // 复用调用者的缓冲区容量
+    return len == 0 || readAll(fd, &payload[0], len);
+}
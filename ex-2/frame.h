@@ -0,0 +1,52 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <string>
+#include <cstdint>
+
+/*
+ * 编译服务的帧格式
+ * ===========================
+ * 每一帧：1字节类型 + 4字节小端长度 + 负载
+ *
+ * 请求类型：
+ *   'P'  负载为文件路径，由服务端读取并分析
+ *   'B'  负载为源程序文本，直接在内存中分析
+ *   'Q'  请求服务端退出
+ *
+ * 响应类型：
+ *   'R'  分析结果，负载第一行为 "<成功> <Token数> <词法错误数> <语法错误数> <是否命中缓存>"，
+ *        其后每行一条诊断："L<行号>\t<信息>"（词法）或 "P<行号>\t<信息>"（语法），
+ *        信息中的反斜杠与换行分别转义为两字符序列 \\ 与 \n
+ *   'E'  请求失败，负载为错误信息
+ */
+
+/* 帧类型 */
+enum FrameKind {
+    FRAME_PATH = 'P',
+    FRAME_BUFFER = 'B',
+    FRAME_QUIT = 'Q',
+    FRAME_RESULT = 'R',
+    FRAME_ERROR = 'E',
+};
+
+// 单帧负载上限（64MB），防止异常长度导致过量分配
+static const uint32_t kMaxFramePayload = 64u << 20;
+
+// 默认的Unix域套接字路径
+static const char* const kDefaultSocketPath = "/tmp/mini-compiler.sock";
+
+// 写出一帧，成功返回true
+bool writeFrame(int fd, char kind, const std::string& payload);
+
+// 读取一帧，连接关闭或格式错误时返回false
+bool readFrame(int fd, char& kind, std::string& payload);
+
+// 把一帧追加到输出缓冲区（非阻塞连接先编码再按可写情况写出）
+void appendFrame(std::string& out, char kind, const std::string& payload);
+
+// 从输入缓冲区 offset 处解出一帧：返回该帧占用的字节数，数据尚不完整时返回0；
+// 长度超过上限时置 malformed
+size_t decodeFrame(const std::string& in, size_t offset, char& kind, std::string& payload, bool& malformed);
+
+#endif /* FRAME_H */
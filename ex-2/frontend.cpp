@@ -0,0 +1,80 @@
+#include "frontend.h"
+#include "ir.h"
+#include "dataflow.h"
+
+// 在作用域内关闭当前线程的错误回显，离开时恢复原设置
+struct SilentScope {
+    bool saved;
+    SilentScope() : saved(getLexerErrorEcho()) { setParserErrorEcho(false); }
+    ~SilentScope() { setParserErrorEcho(saved); }
+};
+
+/* 接口实现 */
+
+LexResult lexBuffer(const char* data, size_t len) {
+    SilentScope silent;
+    LexResult result;
+    initLexerBuffer(data, len);
+    TokenAttr token;
+    do {
+        token = getNextToken();
+        result.tokens.push_back(token);
+    } while (token.code != TK_EOF);
+    result.errors = getErrors();
+    closeLexer();
+    return result;
+}
+
+LexResult lexBuffer(std::string_view source) {
+    return lexBuffer(source.data(), source.size());
+}
+
+AnalysisResult analyzeBuffer(const char* data, size_t len, const FrontendOptions& options) {
+    SilentScope silent;
+    AnalysisResult result;
+
+    // 一遍完成词法与语法分析：parse() 过程中经收集位置得到Token列表（须在初始化之后设置）；
+    // 语义分析需要Token列表构造语法树
+    std::vector<TokenAttr> localTokens;
+    std::vector<TokenAttr>& tokens = options.keepTokens ? result.tokens : localTokens;
+    initParserBuffer(data, len);
+    if (options.keepTokens || options.semantics) {
+        setTokenSink(&tokens);
+    }
+    result.success = (parse() == RESULT_SUCCESS);
+    result.tokenCount = (size_t)getScannedTokenCount();
+    result.lexErrors = getErrors();
+    result.parseErrors = getParserErrors();
+    result.functions = getParsedFunctions();
+    result.skippedTokens = getSkippedTokenCount();
+    closeParser();
+
+    // 可选：与命令行的 --sema 相同，没有语义错误时在中间代码上做数据流检查，警告并入结果
+    if (options.semantics && result.success && result.lexErrors.empty() && result.parseErrors.empty()) {
+        result.analyzed = true;
+        if (!buildAst(tokens, result.program)) {
+            result.sema.diagnostics.push_back({ 0, "内部错误: Token序列与文法不符，无法构造语法树" });
+            result.sema.errorCount = 1;
+        } else if (analyzeSemantics(result.program, result.sema)) {
+            IrModule module;
+            DataflowStats dataflow;
+            lowerToIr(result.program, result.sema, module);
+            checkDataflow(module, result.sema, dataflow);
+        }
+    }
+    return result;
+}
+
+AnalysisResult analyzeBuffer(std::string_view source, const FrontendOptions& options) {
+    return analyzeBuffer(source.data(), source.size(), options);
+}
+
+AnalysisResult analyzeBuffer(const char* data, size_t len, bool keepTokens) {
+    FrontendOptions options;
+    options.keepTokens = keepTokens;
+    return analyzeBuffer(data, len, options);
+}
+
+AnalysisResult analyzeBuffer(std::string_view source, bool keepTokens) {
+    return analyzeBuffer(source.data(), source.size(), keepTokens);
+}
@@ -0,0 +1,60 @@
+#ifndef FRONTEND_H
+#define FRONTEND_H
+
+#include "lexer.h"
+#include "parser.h"
+#include "ast.h"
+#include "sema.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * 前端库接口
+ * ===========================
+ * 以内存缓冲区为输入运行词法/语法分析（可选语义分析），结果全部通过返回值给出：
+ * 不读写文件系统，也不向标准输出或标准错误输出任何内容，可直接嵌入其他程序。
+ * 分析器状态按线程独立，不同线程可以同时调用。
+ */
+
+// 词法分析结果
+struct LexResult {
+    std::vector<TokenAttr> tokens;    // Token列表（最后一个为TK_EOF）
+    std::vector<ErrorInfo> errors;    // 词法错误
+};
+
+// 完整分析结果
+struct AnalysisResult {
+    bool success;                           // parse()是否成功
+    size_t tokenCount;                      // Token总数（含EOF）
+    std::vector<TokenAttr> tokens;          // Token列表（keepTokens为false时为空）
+    std::vector<ErrorInfo> lexErrors;       // 词法错误
+    std::vector<ParserError> parseErrors;   // 语法错误
+    std::vector<FunctionInfo> functions;    // 识别出的函数定义
+    long skippedTokens;                     // 错误恢复中跳过的Token数
+    bool analyzed = false;                  // 是否进行了语义分析（options.semantics为true且没有词法与语法错误）
+    AstProgram program;                     // 语义分析标注后的语法树（analyzed为false时为空）
+    SemaResult sema;                        // 语义错误与警告，含数据流检查的警告（同 --sema）
+};
+
+// analyzeBuffer 的选项
+struct FrontendOptions {
+    bool keepTokens = true;   // 保存Token列表；为false时只统计Token数
+    bool semantics = false;   // 没有词法与语法错误时，再构造语法树并做语义分析
+};
+
+/* INFO 前端库接口 */
+
+// 只进行词法分析
+LexResult lexBuffer(const char* data, size_t len);
+LexResult lexBuffer(std::string_view source);
+
+// 词法与语法分析；keepTokens为false时只统计Token数，不保存Token列表
+AnalysisResult analyzeBuffer(const char* data, size_t len, bool keepTokens = true);
+AnalysisResult analyzeBuffer(std::string_view source, bool keepTokens = true);
+
+// 按选项分析，可另做语义分析
+AnalysisResult analyzeBuffer(const char* data, size_t len, const FrontendOptions& options);
+AnalysisResult analyzeBuffer(std::string_view source, const FrontendOptions& options);
+
+#endif /* FRONTEND_H */
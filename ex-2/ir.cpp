@@ -0,0 +1,613 @@
+#include "ir.h"
+#include <unordered_map>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+static const uint32_t kNoBlock = UINT32_MAX;
+
+/* INFO 值 */
+
+uint32_t irNewTemp(IrFunction& function, MiniType type) {
+    IrValue value;
+    value.kind = IRV_TEMP;
+    value.type = type;
+    value.name = kNoName;
+    value.doubleValue = 0;
+    function.values.push_back(value);
+    return (uint32_t)function.values.size() - 1;
+}
+
+uint32_t irNewIntConst(IrFunction& function, int32_t constant) {
+    IrValue value;
+    value.kind = IRV_CONST;
+    value.type = TYPE_INT;
+    value.name = kNoName;
+    value.doubleValue = 0;
+    value.intValue = constant;
+    function.values.push_back(value);
+    return (uint32_t)function.values.size() - 1;
+}
+
+uint32_t irNewFloatConst(IrFunction& function, MiniType type, double constant) {
+    IrValue value;
+    value.kind = IRV_CONST;
+    value.type = type;
+    value.name = kNoName;
+    value.doubleValue = type == TYPE_FLOAT ? (double)(float)constant : constant;
+    function.values.push_back(value);
+    return (uint32_t)function.values.size() - 1;
+}
+
+/* INFO 生成 */
+
+struct IrLowering {
+    const AstProgram& program;
+    const SemaResult& sema;
+    IrFunction* function = nullptr;
+    uint32_t current = kNoBlock;                           // 正在填充的块，已终结时为kNoBlock
+    std::unordered_map<int32_t, uint32_t> intConsts;       // 函数内的常量去重
+    std::unordered_map<uint64_t, uint32_t> floatConsts[2]; // [0] float，[1] double，按位模式
+    std::vector<uint32_t> spine;                           // 二元表达式的左脊
+    std::vector<uint32_t> pending;                         // 正在求值的实参
+    std::vector<uint32_t> stack;                           // containsAssign 的遍历栈
+
+    IrLowering(const AstProgram& ast, const SemaResult& result) : program(ast), sema(result) {}
+
+    const AstNode& node(uint32_t index) const {
+        return program.nodes[index];
+    }
+
+    MiniType typeOf(uint32_t value) const {
+        return function->values[value].type;
+    }
+
+    uint32_t intConst(int32_t constant) {
+        auto found = intConsts.find(constant);
+        if (found != intConsts.end()) return found->second;
+        uint32_t value = irNewIntConst(*function, constant);
+        intConsts.emplace(constant, value);
+        return value;
+    }
+
+    uint32_t floatConst(MiniType type, double constant) {
+        if (type == TYPE_FLOAT) constant = (float)constant;
+        uint64_t bits;
+        memcpy(&bits, &constant, sizeof(bits));
+        auto& table = floatConsts[type == TYPE_DOUBLE];
+        auto found = table.find(bits);
+        if (found != table.end()) return found->second;
+        uint32_t value = irNewFloatConst(*function, type, constant);
+        table.emplace(bits, value);
+        return value;
+    }
+
+    uint32_t zero(MiniType type) {
+        return type == TYPE_INT ? intConst(0) : floatConst(type, 0.0);
+    }
+
+    uint32_t newBlock() {
+        function->blocks.push_back(IrBlock{ 0, 0, {}, {} });
+        return (uint32_t)function->blocks.size() - 1;
+    }
+
+    void startBlock(uint32_t block) {
+        function->blocks[block].begin = (uint32_t)function->insts.size();
+        current = block;
+    }
+
+    void emit(IrOp op, int line, uint32_t dst, uint32_t a, uint32_t b = kNoValue, uint32_t c = kNoValue) {
+        if (current == kNoBlock) {
+            startBlock(newBlock());  // return 之后的语句：放入一个不可达的块
+        }
+        function->insts.push_back(IrInst{ op, line, dst, a, b, c });
+        if (op == IR_JMP || op == IR_BR || op == IR_RET) {
+            function->blocks[current].end = (uint32_t)function->insts.size();
+            current = kNoBlock;
+        }
+    }
+
+    // 当前块未终结时跳转到block
+    void jumpTo(uint32_t block, int line) {
+        if (current != kNoBlock) {
+            emit(IR_JMP, line, kNoValue, kNoValue, block);
+        }
+    }
+
+    // 把value转换为type类型；常量直接换算
+    uint32_t convert(uint32_t value, MiniType type, int line) {
+        const IrValue& v = function->values[value];
+        if (v.type == type) return value;
+        if (v.kind == IRV_CONST) {
+            if (type != TYPE_INT) {
+                return floatConst(type, v.type == TYPE_INT ? (double)v.intValue : v.doubleValue);
+            }
+            double d = v.doubleValue;
+            return intConst(d > -2147483649.0 && d < 2147483648.0 ? (int32_t)d : INT32_MIN);
+        }
+        uint32_t result = irNewTemp(*function, type);
+        emit(IR_CONV, line, result, value);
+        return result;
+    }
+
+    // 把value存入变量var：value是刚由上一条指令产生的临时值时直接改写该指令的目标
+    void store(uint32_t var, uint32_t value, int line) {
+        if (function->values[value].kind == IRV_TEMP && current != kNoBlock &&
+            function->insts.size() > function->blocks[current].begin) {
+            IrInst& last = function->insts.back();
+            if (last.dst == value && last.op != IR_MOV && typeOf(value) == typeOf(var)) {
+                last.dst = var;
+                return;
+            }
+        }
+        emit(IR_MOV, line, var, value);
+    }
+
+    // 子树中是否有赋值（决定之前求得的变量值是否需要先复制）；显式栈，不递归
+    bool containsAssign(uint32_t root) {
+        stack.clear();
+        stack.push_back(root);
+        while (!stack.empty()) {
+            const AstNode& n = node(stack.back());
+            stack.pop_back();
+            if (n.kind == AST_ASSIGN) return true;
+            if (n.a != kNoNode) stack.push_back(n.a);
+            if (n.b != kNoNode) stack.push_back(n.b);
+            if (n.kind == AST_CALL) {
+                for (uint32_t arg = n.a; arg != kNoNode; arg = node(arg).next) stack.push_back(arg);
+            }
+        }
+        return false;
+    }
+
+    // 保证之后对later的求值不改变value：value是变量且later中有赋值时复制到临时值
+    uint32_t stabilize(uint32_t value, uint32_t later, int line) {
+        if (function->values[value].kind != IRV_VAR || !containsAssign(later)) {
+            return value;
+        }
+        uint32_t copy = irNewTemp(*function, typeOf(value));
+        emit(IR_MOV, line, copy, value);
+        return copy;
+    }
+
+    void lowerFunction(size_t index, IrFunction& target) {
+        function = &target;
+        intConsts.clear();
+        floatConsts[0].clear();
+        floatConsts[1].clear();
+        const SemaFunction& info = sema.functions[index];
+        const AstNode& definition = node(info.node);
+        target.name = program.names.name(info.name);
+        target.returnType = info.returnType;
+        target.paramCount = info.paramCount;
+        target.slotCount = (uint32_t)info.slotTypes.size();
+        // 函数的语法树节点连续存放到下一个函数定义为止，每个节点大约产生一条指令与一个值：
+        // 按节点数预留，长函数的数组不必逐次倍增复制
+        size_t nodeEnd = index + 1 < program.functions.size() ? program.functions[index + 1] : program.nodes.size();
+        target.insts.reserve(nodeEnd - info.node);
+        target.values.reserve(target.slotCount + nodeEnd - info.node);
+        for (uint32_t slot = 0; slot < target.slotCount; slot++) {
+            IrValue value;
+            value.kind = IRV_VAR;
+            value.type = info.slotTypes[slot];
+            value.name = info.slotNames[slot];
+            value.doubleValue = 0;
+            target.values.push_back(value);
+        }
+        startBlock(newBlock());
+        for (uint32_t stmt = node(definition.b).a; stmt != kNoNode; stmt = node(stmt).next) {
+            statement(stmt);
+        }
+        if (current != kNoBlock) {
+            emit(IR_RET, definition.line, kNoValue, zero(target.returnType));
+        }
+        irComputeCfg(target);
+        function = nullptr;
+    }
+
+    void statement(uint32_t index) {
+        const AstNode& n = node(index);
+        switch (n.kind) {
+            case AST_BLOCK:
+                for (uint32_t stmt = n.a; stmt != kNoNode; stmt = node(stmt).next) {
+                    statement(stmt);
+                }
+                break;
+            case AST_VAR_DECL:
+                if (n.a != kNoNode) {
+                    store(n.slot, convert(expression(n.a), n.type, n.line), n.line);
+                }
+                break;
+            case AST_EXPR_STMT:
+                if (n.a != kNoNode) expression(n.a);
+                break;
+            case AST_IF: {
+                uint32_t condition = expression(n.a);
+                uint32_t thenBlock = newBlock();
+                uint32_t elseBlock = n.c != kNoNode ? newBlock() : kNoBlock;
+                uint32_t join = newBlock();
+                emit(IR_BR, n.line, kNoValue, condition, thenBlock, elseBlock != kNoBlock ? elseBlock : join);
+                startBlock(thenBlock);
+                statement(n.b);
+                jumpTo(join, n.line);
+                if (elseBlock != kNoBlock) {
+                    startBlock(elseBlock);
+                    statement(n.c);
+                    jumpTo(join, n.line);
+                }
+                startBlock(join);
+                break;
+            }
+            case AST_WHILE: {
+                uint32_t header = newBlock();
+                uint32_t body = newBlock();
+                uint32_t exit = newBlock();
+                jumpTo(header, n.line);
+                startBlock(header);
+                uint32_t condition = expression(n.a);
+                emit(IR_BR, n.line, kNoValue, condition, body, exit);
+                startBlock(body);
+                statement(n.b);
+                jumpTo(header, n.line);
+                startBlock(exit);
+                break;
+            }
+            case AST_RETURN: {
+                MiniType type = function->returnType;
+                uint32_t value = n.a != kNoNode ? convert(expression(n.a), type, n.line) : zero(type);
+                emit(IR_RET, n.line, kNoValue, value);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    // 沿左脊循环、只在右操作数上递归（同语义分析），递归深度与运算链长度无关
+    uint32_t expression(uint32_t index) {
+        size_t base = spine.size();
+        while (node(index).kind == AST_BINARY) {
+            spine.push_back(index);
+            index = node(index).a;
+        }
+        uint32_t value = operand(index);
+        while (spine.size() > base) {
+            uint32_t binary = spine.back();
+            spine.pop_back();
+            value = lowerBinary(binary, value);
+        }
+        return value;
+    }
+
+    uint32_t lowerBinary(uint32_t index, uint32_t left) {
+        const AstNode& n = node(index);
+        if (n.op == TK_AND || n.op == TK_OR) {
+            // 短路求值：result 先取不求右操作数时的结果
+            bool isAnd = n.op == TK_AND;
+            uint32_t result = irNewTemp(*function, TYPE_INT);
+            uint32_t rhsBlock = newBlock();
+            uint32_t join = newBlock();
+            emit(IR_MOV, n.line, result, intConst(isAnd ? 0 : 1));
+            emit(IR_BR, n.line, kNoValue, left, isAnd ? rhsBlock : join, isAnd ? join : rhsBlock);
+            startBlock(rhsBlock);
+            uint32_t right = expression(n.b);
+            emit(IR_NE, n.line, result, right, zero(typeOf(right)));
+            jumpTo(join, n.line);
+            startBlock(join);
+            return result;
+        }
+
+        left = stabilize(left, n.b, n.line);
+        uint32_t right = expression(n.b);
+        IrOp op;
+        switch (n.op) {
+            case TK_PLUS: op = IR_ADD; break;
+            case TK_MINUS: op = IR_SUB; break;
+            case TK_STAR: op = IR_MUL; break;
+            case TK_DIVIDE: op = IR_DIV; break;
+            case TK_BITAND: op = IR_AND; break;
+            case TK_BITOR: op = IR_OR; break;
+            case TK_EQ: op = IR_EQ; break;
+            case TK_LT: op = IR_LT; break;
+            case TK_LEQ: op = IR_LE; break;
+            case TK_GT: op = IR_GT; break;
+            default: op = IR_GE; break;
+        }
+        MiniType common = std::max(typeOf(left), typeOf(right));
+        left = convert(left, common, n.line);
+        right = convert(right, common, n.line);
+        bool comparison = op >= IR_EQ && op <= IR_GE;
+        uint32_t result = irNewTemp(*function, comparison ? TYPE_INT : common);
+        emit(op, n.line, result, left, right);
+        return result;
+    }
+
+    uint32_t operand(uint32_t index) {
+        const AstNode& n = node(index);
+        switch (n.kind) {
+            case AST_INT_CONST:
+                return intConst((int32_t)n.intValue);
+            case AST_DOUBLE_CONST:
+                return floatConst(TYPE_DOUBLE, n.doubleValue);
+            case AST_IDENT:
+                return n.slot;
+            case AST_ASSIGN:
+                store(n.slot, convert(expression(n.a), typeOf(n.slot), n.line), n.line);
+                return n.slot;
+            case AST_CALL:
+                return call(n);
+            default:
+                return zero(TYPE_INT);
+        }
+    }
+
+    uint32_t call(const AstNode& n) {
+        const SemaFunction& callee = sema.functions[n.slot];
+        size_t base = pending.size();
+        // pending 中先放各实参之后的实参是否有赋值（自后向前计算），求值后换为实参的值
+        for (uint32_t arg = n.a; arg != kNoNode; arg = node(arg).next) pending.push_back(arg);
+        bool assigned = false;
+        for (size_t k = pending.size(); k-- > base;) {
+            uint32_t arg = pending[k];
+            pending[k] = assigned;
+            assigned = assigned || containsAssign(arg);
+        }
+        uint32_t param = 0;
+        for (uint32_t arg = n.a; arg != kNoNode; arg = node(arg).next, param++) {
+            uint32_t value = convert(expression(arg), callee.slotTypes[param], n.line);
+            if (pending[base + param] && function->values[value].kind == IRV_VAR) {
+                // 之后的实参可能修改该变量：先复制
+                uint32_t copy = irNewTemp(*function, typeOf(value));
+                emit(IR_MOV, n.line, copy, value);
+                value = copy;
+            }
+            pending[base + param] = value;
+        }
+        uint32_t offset = (uint32_t)function->args.size();
+        uint32_t count = (uint32_t)(pending.size() - base);
+        function->args.insert(function->args.end(), pending.begin() + base, pending.end());
+        pending.resize(base);
+        uint32_t result = irNewTemp(*function, callee.returnType);
+        emit(IR_CALL, n.line, result, n.slot, offset, count);
+        return result;
+    }
+};
+
+/* INFO 文本输出 */
+
+static const char* opName(IrOp op) {
+    static const char* names[] = { "nop", "mov", "conv", "add", "sub", "mul", "div", "and", "or",
+                                   "eq", "ne", "lt", "le", "gt", "ge", "call", "jmp", "br", "ret" };
+    return names[op];
+}
+
+static char typeSuffix(MiniType type) {
+    return type == TYPE_INT ? 'i' : (type == TYPE_FLOAT ? 'f' : 'd');
+}
+
+// 值的文本：变量用变量名（同名变量加 .槽位），临时值 %编号，常量直接写出
+static std::string valueText(const IrModule& module, const IrFunction& function,
+                             const std::vector<bool>& shadowed, uint32_t id) {
+    const IrValue& value = function.values[id];
+    char buf[64];
+    if (value.kind == IRV_VAR) {
+        std::string name = module.names.name(value.name);
+        return shadowed[id] ? name + "." + std::to_string(id) : name;
+    }
+    if (value.kind == IRV_TEMP) {
+        // 由变量重命名得到的临时值（SSA 版本）带上变量名
+        return value.name == kNoName ? "%" + std::to_string(id)
+                                     : "%" + module.names.name(value.name) + "." + std::to_string(id);
+    }
+    if (value.type == TYPE_INT) {
+        return std::to_string(value.intValue);
+    }
+    snprintf(buf, sizeof(buf), "%.17g", value.doubleValue);
+    std::string text = buf;
+    if (text.find_first_of(".en") == std::string::npos) text += ".0";
+    return value.type == TYPE_FLOAT ? text + "f" : text;
+}
+
+/* 接口实现 */
+
+void lowerToIr(const AstProgram& program, const SemaResult& sema, IrModule& module) {
+    module = IrModule();
+    module.names = program.names;
+    module.functions.resize(program.functions.size());
+    IrLowering lowering(program, sema);
+    for (size_t i = 0; i < program.functions.size(); i++) {
+        lowering.lowerFunction(i, module.functions[i]);
+    }
+}
+
+void irComputeCfg(IrFunction& function) {
+    for (auto& block : function.blocks) {
+        block.preds.clear();
+        block.succs.clear();
+    }
+    for (uint32_t b = 0; b < function.blocks.size(); b++) {
+        IrBlock& block = function.blocks[b];
+        if (block.end == block.begin) continue;
+        const IrInst& last = function.insts[block.end - 1];
+        if (last.op == IR_JMP) {
+            block.succs.push_back(last.b);
+        } else if (last.op == IR_BR) {
+            block.succs.push_back(last.b);
+            if (last.c != last.b) block.succs.push_back(last.c);
+        }
+        for (uint32_t succ : block.succs) {
+            function.blocks[succ].preds.push_back(b);
+        }
+    }
+}
+
+void irCompact(IrFunction& function) {
+    // 各块的指令区间按块号递增排列时（各遍之后的常态）原地压缩，不为大函数每次分配新数组；否则按块的顺序复制
+    bool ordered = true;
+    for (size_t b = 1; b < function.blocks.size() && ordered; b++) {
+        ordered = function.blocks[b].begin >= function.blocks[b - 1].end;
+    }
+    if (ordered) {
+        uint32_t out = 0;
+        for (auto& block : function.blocks) {
+            uint32_t begin = out;
+            for (uint32_t i = block.begin; i < block.end; i++) {
+                if (function.insts[i].op != IR_NOP) function.insts[out++] = function.insts[i];
+            }
+            block.begin = begin;
+            block.end = out;
+        }
+        function.insts.resize(out);
+        return;
+    }
+    std::vector<IrInst> insts;
+    insts.reserve(function.insts.size());
+    for (auto& block : function.blocks) {
+        uint32_t begin = (uint32_t)insts.size();
+        for (uint32_t i = block.begin; i < block.end; i++) {
+            if (function.insts[i].op != IR_NOP) insts.push_back(function.insts[i]);
+        }
+        block.begin = begin;
+        block.end = (uint32_t)insts.size();
+    }
+    function.insts.swap(insts);
+}
+
+std::vector<uint32_t> irReversePostorder(const IrFunction& function) {
+    // 显式栈的深度优先遍历：每个栈项是块与下一个要访问的后继下标
+    std::vector<uint32_t> order;
+    std::vector<bool> visited(function.blocks.size(), false);
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+    if (function.blocks.empty()) return order;
+    stack.push_back({ 0, 0 });
+    visited[0] = true;
+    while (!stack.empty()) {
+        auto& top = stack.back();
+        const IrBlock& block = function.blocks[top.first];
+        if (top.second < block.succs.size()) {
+            uint32_t succ = block.succs[top.second++];
+            if (!visited[succ]) {
+                visited[succ] = true;
+                stack.push_back({ succ, 0 });
+            }
+        } else {
+            order.push_back(top.first);
+            stack.pop_back();
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+std::vector<uint32_t> irNestedOrder(const IrFunction& function) {
+    std::vector<uint32_t> order;
+    std::vector<bool> visited(function.blocks.size(), false);
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+    if (function.blocks.empty()) return order;
+    stack.push_back({ 0, (uint32_t)function.blocks[0].succs.size() });
+    visited[0] = true;
+    while (!stack.empty()) {
+        auto& top = stack.back();
+        if (top.second > 0) {
+            uint32_t succ = function.blocks[top.first].succs[--top.second];
+            if (!visited[succ]) {
+                visited[succ] = true;
+                stack.push_back({ succ, (uint32_t)function.blocks[succ].succs.size() });
+            }
+        } else {
+            order.push_back(top.first);
+            stack.pop_back();
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+size_t irInstructionCount(const IrFunction& function) {
+    size_t count = 0;
+    for (const auto& block : function.blocks) {
+        for (uint32_t i = block.begin; i < block.end; i++) {
+            if (function.insts[i].op != IR_NOP) count++;
+        }
+    }
+    return count;
+}
+
+std::string dumpIr(const IrModule& module) {
+    std::string out;
+    for (const IrFunction& function : module.functions) {
+        // 函数内重名的变量（不同作用域）加槽位后缀区分
+        std::vector<bool> shadowed(function.values.size(), false);
+        std::unordered_map<uint32_t, uint32_t> firstSlot;
+        for (uint32_t slot = 0; slot < function.slotCount; slot++) {
+            auto inserted = firstSlot.emplace(function.values[slot].name, slot);
+            if (!inserted.second) {
+                shadowed[slot] = shadowed[inserted.first->second] = true;
+            }
+        }
+        auto text = [&](uint32_t id) { return valueText(module, function, shadowed, id); };
+
+        out += std::string(miniTypeName(function.returnType)) + " " + function.name + "(";
+        for (uint32_t p = 0; p < function.paramCount; p++) {
+            out += std::string(p ? ", " : "") + miniTypeName(function.values[p].type) + " " + text(p);
+        }
+        out += ")\n";
+        if (function.slotCount > function.paramCount) {
+            out += "    ; 变量:";
+            for (uint32_t slot = function.paramCount; slot < function.slotCount; slot++) {
+                out += std::string(" ") + miniTypeName(function.values[slot].type) + " " + text(slot);
+                out += slot + 1 < function.slotCount ? "," : "";
+            }
+            out += "\n";
+        }
+
+        for (uint32_t b = 0; b < function.blocks.size(); b++) {
+            const IrBlock& block = function.blocks[b];
+            out += "b" + std::to_string(b) + ":";
+            if (!block.preds.empty()) {
+                out += "    ; 前驱:";
+                for (uint32_t pred : block.preds) out += " b" + std::to_string(pred);
+            }
+            out += "\n";
+            for (uint32_t i = block.begin; i < block.end; i++) {
+                const IrInst& inst = function.insts[i];
+                std::string line = "    ";
+                switch (inst.op) {
+                    case IR_NOP:
+                        continue;
+                    case IR_MOV:
+                        line += text(inst.dst) + " = " + text(inst.a);
+                        break;
+                    case IR_CONV:
+                        line += text(inst.dst) + " = conv." + typeSuffix(function.values[inst.dst].type) + " " +
+                                text(inst.a);
+                        break;
+                    case IR_CALL: {
+                        line += text(inst.dst) + " = call " + module.functions[inst.a].name + "(";
+                        for (uint32_t k = 0; k < inst.c; k++) {
+                            line += (k ? ", " : "") + text(function.args[inst.b + k]);
+                        }
+                        line += ")";
+                        break;
+                    }
+                    case IR_JMP:
+                        line += "jmp b" + std::to_string(inst.b);
+                        break;
+                    case IR_BR:
+                        line += "br " + text(inst.a) + ", b" + std::to_string(inst.b) + ", b" + std::to_string(inst.c);
+                        break;
+                    case IR_RET:
+                        line += "ret " + text(inst.a);
+                        break;
+                    default:
+                        line += text(inst.dst) + " = " + opName(inst.op) + "." +
+                                typeSuffix(function.values[inst.a].type) + " " + text(inst.a) + ", " + text(inst.b);
+                        break;
+                }
+                out += line + "\n";
+            }
+        }
+        out += "\n";
+    }
+    return out;
+}
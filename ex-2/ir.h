@@ -0,0 +1,138 @@
+#ifndef IR_H
+#define IR_H
+
+#include "ast.h"
+#include "sema.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/*
+ * 三地址码中间表示
+ * ===========================
+ * 由通过语义分析的语法树生成，每个函数一个 IrFunction：
+ *   - 值：32位编号。编号 0..slotCount-1 是函数的变量（与语义分析的槽位相同，参数在前），
+ *     其后是临时值与常量（常量在函数内去重）。每个值有静态类型 int/float/double。
+ *   - 指令：全部存放在函数的指令数组（arena）中，每条指令定长，操作数都是值编号。
+ *     调用的实参另存于 args 数组，指令只记录起始位置与个数。
+ *   - 基本块：占指令数组中连续的一段 [begin, end)，最后一条是终结指令（jmp/br/ret），
+ *     前驱与后继由 irComputeCfg 根据终结指令重建。块0是入口块。
+ *
+ * 语义（与生成的各后端一致）：
+ *   - int 为32位补码，加减乘按补码回绕；除以0是运行时错误，INT_MIN / -1 的结果为 INT_MIN
+ *   - float 运算按单精度舍入；浮点转 int 向零截断，超出 int 范围或为 NaN 时结果为 INT_MIN
+ *   - 比较与逻辑运算结果为 int 0/1；br 的条件按其类型与0比较
+ *   - 变量（参数除外）在函数入口为0，不带初值的声明不改变变量的值；
+ *     不带值的 return 与执行到函数末尾都返回0
+ *   - 求值顺序从左到右：二元运算的左操作数与先求值的实参不受其后赋值的影响
+ * 二元运算的两个操作数已转换为相同类型（conv），结果类型即目标值的类型。
+ */
+
+static const uint32_t kNoValue = UINT32_MAX;
+
+// 操作码
+enum IrOp : uint8_t {
+    IR_NOP,      // 已删除的指令（各遍之后由 irCompact 清除）
+    IR_MOV,      // dst = a
+    IR_CONV,     // dst = (dst的类型) a
+    IR_ADD,      // dst = a + b
+    IR_SUB,      // dst = a - b
+    IR_MUL,      // dst = a * b
+    IR_DIV,      // dst = a / b
+    IR_AND,      // dst = a & b（int）
+    IR_OR,       // dst = a | b（int）
+    IR_EQ,       // dst = a == b（结果为int，以下同）
+    IR_NE,       // dst = a != b
+    IR_LT,       // dst = a < b
+    IR_LE,       // dst = a <= b
+    IR_GT,       // dst = a > b
+    IR_GE,       // dst = a >= b
+    IR_CALL,     // dst = 函数a(args[b .. b+c))
+    IR_JMP,      // 跳转到块 b
+    IR_BR,       // a 非0时跳转到块 b，否则跳转到块 c
+    IR_RET       // 返回 a
+};
+
+// 值的种类
+enum IrValueKind : uint8_t {
+    IRV_VAR,     // 变量（含参数）
+    IRV_TEMP,    // 临时值
+    IRV_CONST    // 常量
+};
+
+// 一个值
+struct IrValue {
+    IrValueKind kind;
+    MiniType type;
+    uint32_t name;          // 变量名ID（IRV_VAR；由变量重命名得到的临时值也保留），否则为kNoName
+    union {
+        int32_t intValue;   // int 常量
+        double doubleValue; // float/double 常量（float 常量已按单精度舍入）
+    };
+};
+
+// 一条指令（定长，24字节）
+struct IrInst {
+    IrOp op;
+    int32_t line;           // 源码行号
+    uint32_t dst;           // 目标值，没有时为kNoValue
+    uint32_t a, b, c;       // 操作数，含义见 IrOp
+};
+
+// 一个基本块
+struct IrBlock {
+    uint32_t begin, end;             // 在指令数组中的范围
+    std::vector<uint32_t> preds;     // 前驱块
+    std::vector<uint32_t> succs;     // 后继块
+};
+
+// 一个函数
+struct IrFunction {
+    std::string name;
+    MiniType returnType;
+    uint32_t paramCount;             // 参数为值 0..paramCount-1
+    uint32_t slotCount;              // 变量为值 0..slotCount-1
+    std::vector<IrValue> values;
+    std::vector<IrInst> insts;       // 指令arena
+    std::vector<uint32_t> args;      // 调用的实参
+    std::vector<IrBlock> blocks;
+};
+
+// 整个程序
+struct IrModule {
+    std::vector<IrFunction> functions;   // 生成时与 program.functions 一一对应（级别2的优化删除无用函数），call 的 a 为下标
+    NameTable names;                     // 变量名（与语法树相同的ID）
+};
+
+/* INFO 生成与查询接口 */
+
+// 由通过语义分析（没有错误）的语法树生成中间代码
+void lowerToIr(const AstProgram& program, const SemaResult& sema, IrModule& module);
+
+// 根据各块的终结指令重建前驱与后继
+void irComputeCfg(IrFunction& function);
+
+// 删除NOP指令，并按块的顺序重新排列指令数组
+void irCompact(IrFunction& function);
+
+// 从入口可达的块的逆后序（需先 irComputeCfg）。按此顺序处理时，支配者先于被支配的块
+std::vector<uint32_t> irReversePostorder(const IrFunction& function);
+
+// 从入口可达的块的逆后序，深度优先遍历时后继从后往前访问：br 的后继为（循环体，出口），
+// 循环体因此紧跟在循环头之后、在出口之前，每个循环在序列中占一段连续的位置（需先 irComputeCfg）
+std::vector<uint32_t> irNestedOrder(const IrFunction& function);
+
+// 新建临时值
+uint32_t irNewTemp(IrFunction& function, MiniType type);
+
+// 新建常量（不去重）
+uint32_t irNewIntConst(IrFunction& function, int32_t value);
+uint32_t irNewFloatConst(IrFunction& function, MiniType type, double value);
+
+// 有效指令数（不含NOP）
+size_t irInstructionCount(const IrFunction& function);
+
+// 以文本形式输出中间代码
+std::string dumpIr(const IrModule& module);
+
+#endif /* IR_H */
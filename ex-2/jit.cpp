@@ -0,0 +1,1110 @@
+#include "jit.h"
+#include "opt.h"
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <cstddef>
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* INFO 运行上下文（生成的代码经 r15 访问） */
+
+struct JitContext {
+    int32_t depth;          // 当前调用深度（入口函数为0）
+    int32_t errorKind;      // 运行时错误，JIT_OK 表示没有
+    int32_t errorLine;      // 运行时错误的源码行号
+    int32_t reserved;
+    uint64_t savedRsp;      // 入口桩保存的 rsp
+    uint64_t stackTop;      // 执行栈的栈顶（16字节对齐）
+    uint64_t resultInt;     // 返回值（rax）
+    uint64_t resultXmm;     // 返回值（xmm0）
+};
+
+enum JitErrorKind : int32_t { JIT_OK, JIT_DIVIDE_BY_ZERO, JIT_STACK_OVERFLOW };
+
+static const int32_t kDepthOffset = offsetof(JitContext, depth);
+static const int32_t kErrorKindOffset = offsetof(JitContext, errorKind);
+static const int32_t kErrorLineOffset = offsetof(JitContext, errorLine);
+static const int32_t kSavedRspOffset = offsetof(JitContext, savedRsp);
+static const int32_t kStackTopOffset = offsetof(JitContext, stackTop);
+static const int32_t kResultIntOffset = offsetof(JitContext, resultInt);
+static const int32_t kResultXmmOffset = offsetof(JitContext, resultXmm);
+
+/* INFO x86-64 指令编码 */
+
+enum X86Reg : int { RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI, R8, R9, R10, R11, R12, R13, R14, R15 };
+
+// 分配用的寄存器编号：0~15 为通用寄存器，kXmm+n 为 xmmN
+static const int kXmm = 16;
+static const int kXmmAllocatable = 14;              // xmm0~xmm13 参与分配
+static const int kXmmZero = 14, kXmmScratch = 15;   // 比较用的0与暂存
+// rax rcx rdx 为暂存（除法、比较结果、内存间复制），r15 指向运行上下文
+static const int kCallerSavedGprs[] = { RSI, RDI, R8, R9, R10, R11 };
+static const int kCalleeSavedGprs[] = { RBX, R12, R13, R14 };
+static const int kArgGprs[] = { RDI, RSI, RDX, RCX, R8, R9 };
+
+static const char* const kRegNames[32] = {
+    "rax",  "rcx",  "rdx",  "rbx",  "rsp",   "rbp",   "rsi",   "rdi",   "r8",    "r9",    "r10",
+    "r11",  "r12",  "r13",  "r14",  "r15",   "xmm0",  "xmm1",  "xmm2",  "xmm3",  "xmm4",  "xmm5",
+    "xmm6", "xmm7", "xmm8", "xmm9", "xmm10", "xmm11", "xmm12", "xmm13", "xmm14", "xmm15",
+};
+
+enum X86Cond : uint8_t {
+    CC_B = 2, CC_AE = 3, CC_E = 4, CC_NE = 5, CC_A = 7, CC_P = 10, CC_NP = 11,
+    CC_L = 12, CC_GE = 13, CC_LE = 14, CC_G = 15
+};
+
+// r/m 操作数：寄存器、[基址 + 偏移]，或常量池中的常量（rip 相对寻址）
+struct Rm {
+    enum Kind : uint8_t { REG, MEM, RIP } kind;
+    uint8_t reg;      // REG 的寄存器，MEM 的基址寄存器
+    int32_t disp;     // MEM 的偏移，RIP 的常量池下标
+};
+
+static Rm reg(int r) {
+    return Rm{ Rm::REG, (uint8_t)(r & 15), 0 };
+}
+
+static Rm mem(int base, int32_t disp) {
+    return Rm{ Rm::MEM, (uint8_t)base, disp };
+}
+
+static Rm pooled(uint32_t index) {
+    return Rm{ Rm::RIP, 0, (int32_t)index };
+}
+
+struct X86Emitter {
+    std::vector<uint8_t> code;
+    std::vector<std::pair<size_t, uint32_t>> poolFixups;   // rip 相对偏移的位置与常量下标
+
+    size_t size() const { return code.size(); }
+    void byte(uint8_t b) { code.push_back(b); }
+
+    void imm32(int32_t value) {
+        uint8_t bytes[4];
+        memcpy(bytes, &value, 4);
+        code.insert(code.end(), bytes, bytes + 4);
+    }
+
+    // [前缀] [REX] 操作码 ModRM [SIB] [偏移]；r 为 ModRM 的 reg 字段（寄存器或扩展操作码）
+    void op(uint8_t prefix, bool wide, std::initializer_list<uint8_t> opcode, int r, const Rm& rm) {
+        if (prefix) byte(prefix);
+        uint8_t rex = 0x40 | (wide ? 8 : 0) | ((r & 8) ? 4 : 0) | (rm.kind != Rm::RIP && (rm.reg & 8) ? 1 : 0);
+        if (rex != 0x40) byte(rex);
+        for (uint8_t b : opcode) byte(b);
+        uint8_t field = (uint8_t)((r & 7) << 3);
+        if (rm.kind == Rm::REG) {
+            byte(0xC0 | field | (rm.reg & 7));
+        } else if (rm.kind == Rm::RIP) {
+            byte(0x05 | field);
+            poolFixups.push_back({ size(), (uint32_t)rm.disp });
+            imm32(0);
+        } else {
+            bool small = rm.disp >= -128 && rm.disp <= 127;
+            byte((small ? 0x40 : 0x80) | field | (rm.reg & 7));
+            if ((rm.reg & 7) == RSP) byte(0x24);
+            if (small) byte((uint8_t)rm.disp);
+            else imm32(rm.disp);
+        }
+    }
+
+    // 相对跳转与调用，返回待填写的 rel32 的位置
+    size_t jump(X86Cond cc) {
+        byte(0x0F);
+        byte(0x80 | cc);
+        imm32(0);
+        return size() - 4;
+    }
+
+    size_t jump() {
+        byte(0xE9);
+        imm32(0);
+        return size() - 4;
+    }
+
+    size_t call() {
+        byte(0xE8);
+        imm32(0);
+        return size() - 4;
+    }
+
+    void patch(size_t at, size_t target) {
+        int32_t rel = (int32_t)((int64_t)target - (int64_t)(at + 4));
+        memcpy(&code[at], &rel, 4);
+    }
+
+    void load32(int r, const Rm& rm) { op(0, false, { 0x8B }, r, rm); }
+    void store32(const Rm& rm, int r) { op(0, false, { 0x89 }, r, rm); }
+    void load64(int r, const Rm& rm) { op(0, true, { 0x8B }, r, rm); }
+    void store64(const Rm& rm, int r) { op(0, true, { 0x89 }, r, rm); }
+
+    void moveImm32(const Rm& rm, int32_t value, bool wide = false) {
+        op(0, wide, { 0xC7 }, 0, rm);
+        imm32(value);
+    }
+
+    // 81 /digit：add 0，or 1，and 4，sub 5，cmp 7
+    void aluImm(int digit, const Rm& rm, int32_t value, bool wide = false) {
+        op(0, wide, { 0x81 }, digit, rm);
+        imm32(value);
+    }
+
+    void setcc(X86Cond cc, int r) { op(0, false, { 0x0F, (uint8_t)(0x90 | cc) }, 0, reg(r)); }
+    void sse(uint8_t prefix, uint8_t opcode, int x, const Rm& rm) { op(prefix, false, { 0x0F, opcode }, x, rm); }
+
+    void push(int r) {
+        if (r & 8) byte(0x41);
+        byte(0x50 | (r & 7));
+    }
+
+    void pop(int r) {
+        if (r & 8) byte(0x41);
+        byte(0x58 | (r & 7));
+    }
+
+    // 用 int3 填充到16字节边界
+    void align() {
+        while (code.size() % 16) byte(0xCC);
+    }
+};
+
+// 常量池：float/double 常量，每项8字节，按位模式去重
+struct JitConstPool {
+    std::vector<uint64_t> entries;
+    std::unordered_map<uint64_t, uint32_t> index[2];
+
+    uint32_t add(MiniType type, double value) {
+        uint64_t bits = 0;
+        if (type == TYPE_FLOAT) {
+            float f = (float)value;
+            memcpy(&bits, &f, 4);
+        } else {
+            memcpy(&bits, &value, 8);
+        }
+        auto inserted = index[type == TYPE_DOUBLE].emplace(bits, (uint32_t)entries.size());
+        if (inserted.second) entries.push_back(bits);
+        return inserted.first->second;
+    }
+};
+
+/* INFO 调用约定 */
+
+// 各参数的传递位置：寄存器编号，或栈上第k个槽位（~k）
+static std::vector<int> argLocations(const IrFunction& callee, uint32_t& stackCount) {
+    std::vector<int> where;
+    int gprs = 0, xmms = 0;
+    stackCount = 0;
+    for (uint32_t p = 0; p < callee.paramCount; p++) {
+        if (callee.values[p].type == TYPE_INT) {
+            where.push_back(gprs < 6 ? kArgGprs[gprs++] : ~(int)stackCount++);
+        } else {
+            where.push_back(xmms < 8 ? kXmm + xmms++ : ~(int)stackCount++);
+        }
+    }
+    return where;
+}
+
+// 入口桩：void enter(JitContext* context, const void* function)
+// 保存被调用者保存的寄存器与 rsp，切换到执行栈，实参寄存器清零后调用 function，返回值写入上下文。
+// 返回 exit 的偏移：运行时错误跳到这里，由保存的 rsp 直接返回调用者。
+static size_t emitEnterStub(X86Emitter& out) {
+    static const int saved[] = { RBP, RBX, R12, R13, R14, R15 };
+    for (int r : saved) out.push(r);
+    out.aluImm(5, reg(RSP), 8, true);                          // sub rsp, 8
+    out.op(0, true, { 0x8B }, R15, reg(RDI));                  // mov r15, rdi
+    out.store64(mem(R15, kSavedRspOffset), RSP);
+    out.load64(RSP, mem(R15, kStackTopOffset));
+    out.op(0, true, { 0x8B }, RAX, reg(RSI));                  // mov rax, rsi
+    for (int r : kArgGprs) out.op(0, false, { 0x31 }, r, reg(r));
+    for (int x = 0; x < 8; x++) out.sse(0, 0x57, x, reg(x));
+    out.op(0, false, { 0xFF }, 2, reg(RAX));                   // call rax
+    out.store64(mem(R15, kResultIntOffset), RAX);
+    out.sse(0xF2, 0x11, 0, mem(R15, kResultXmmOffset));        // movsd [r15+...], xmm0
+    size_t exit = out.size();
+    out.load64(RSP, mem(R15, kSavedRspOffset));
+    out.aluImm(0, reg(RSP), 8, true);                          // add rsp, 8
+    for (int k = 5; k >= 0; k--) out.pop(saved[k]);
+    out.byte(0xC3);
+    return exit;
+}
+
+/* INFO 单个函数的编译 */
+
+enum JitLocKind : uint8_t { LOC_NONE, LOC_REG, LOC_STACK };
+
+// 值的位置：寄存器，或 [rbp + disp] 的8字节槽位
+struct JitLoc {
+    JitLocKind kind = LOC_NONE;
+    int8_t reg = 0;
+    int32_t disp = 0;
+};
+
+// 活跃区间 [start, end]
+struct JitInterval {
+    uint32_t value;
+    uint32_t start, end;
+    bool xmm;            // float/double
+    bool crossesCall;    // 区间内有调用
+};
+
+static bool definesValue(const IrInst& inst) {
+    return (inst.op >= IR_MOV && inst.op <= IR_GE) || (inst.op == IR_CALL && inst.dst != kNoValue);
+}
+
+struct JitFunctionCompiler {
+    const IrModule& module;
+    IrFunction function;                                  // 副本：活跃分析需要重建控制流图
+    X86Emitter& out;
+    JitConstPool& pool;
+    std::vector<std::pair<size_t, uint32_t>>& calls;      // 待填写的 call 与被调函数
+    size_t exitOffset;                                    // 入口桩的错误返回处
+
+    std::vector<JitLoc> loc;                              // 值 -> 位置
+    std::vector<uint32_t> uses;                           // 各值被使用的次数
+    std::vector<bool> entryLive;                          // 函数入口处活跃的值
+    std::vector<uint32_t> callPos;                        // 各调用指令的位置
+    std::vector<std::vector<int>> callSaves;              // 各调用前后保存的寄存器
+    int32_t saveSlot[32] = {};                            // 寄存器 -> 调用前保存的槽位
+    std::vector<int> calleeSaved;                         // 用到的被调用者保存的寄存器
+    int32_t calleeSlot[16] = {};
+    std::vector<int32_t> staging;                         // 实参与参数的暂存槽位
+    uint32_t slots = 0;                                   // rbp 之下的8字节槽位数
+    uint32_t outgoing = 0;                                // 栈上传递的实参槽位数（rsp 之上）
+    uint32_t frameBytes = 0;
+    uint32_t spills = 0;
+
+    std::vector<size_t> blockOffset;
+    std::vector<std::pair<size_t, uint32_t>> jumps;       // 待填写的跳转与目标块
+    struct ErrorSite {
+        size_t patch;
+        int32_t kind;
+        int32_t line;
+    };
+    std::vector<ErrorSite> errors;
+    uint32_t current = 0;
+    size_t callIndex = 0;
+    int32_t line = 0;
+
+    JitFunctionCompiler(const IrModule& module, const IrFunction& function, X86Emitter& out, JitConstPool& pool,
+                        std::vector<std::pair<size_t, uint32_t>>& calls, size_t exitOffset)
+        : module(module), function(function), out(out), pool(pool), calls(calls), exitOffset(exitOffset),
+          loc(function.values.size()), uses(function.values.size(), 0) {}
+
+    bool isConst(uint32_t value) const { return function.values[value].kind == IRV_CONST; }
+    MiniType typeOf(uint32_t value) const { return function.values[value].type; }
+    int32_t intValue(uint32_t value) const { return function.values[value].intValue; }
+    bool inReg(uint32_t value) const { return !isConst(value) && loc[value].kind == LOC_REG; }
+    int regOf(uint32_t value) const { return loc[value].reg; }
+
+    int32_t newSlot() { return -8 * (int32_t)++slots; }
+
+    template <typename Fn>
+    void forEachUse(const IrInst& inst, Fn fn) const {
+        if (inst.op == IR_CALL) {
+            for (uint32_t k = 0; k < inst.c; k++) fn(function.args[inst.b + k]);
+        } else if (inst.op >= IR_MOV && inst.op <= IR_GE) {
+            fn(inst.a);
+            if (inst.op != IR_MOV && inst.op != IR_CONV) fn(inst.b);
+        } else if (inst.op == IR_BR || inst.op == IR_RET) {
+            fn(inst.a);
+        }
+    }
+
+    // 活跃区间与线性扫描分配
+    void allocate() {
+        irComputeCfg(function);
+        IrLiveness liveness;
+        irComputeLiveness(function, liveness);
+        size_t count = function.values.size();
+        uint32_t blockCount = (uint32_t)function.blocks.size();
+
+        // 指令位置：依次为 4、8、12……，使用在该位置，定义在其后一个位置；
+        // 块的入口与出口各占一个奇数位置，使只在相邻块间“接触”的两个值可以共用寄存器
+        std::vector<uint32_t> pos(function.insts.size(), 0), blockIn(blockCount), blockOut(blockCount);
+        uint32_t p = 4;
+        for (uint32_t b = 0; b < blockCount; b++) {
+            const IrBlock& block = function.blocks[b];
+            blockIn[b] = p - 1;
+            for (uint32_t i = block.begin; i < block.end; i++) {
+                if (function.insts[i].op == IR_NOP) continue;
+                pos[i] = p;
+                if (function.insts[i].op == IR_CALL) callPos.push_back(p);
+                p += 4;
+            }
+            blockOut[b] = p - 2;
+        }
+
+        std::vector<uint32_t> start(count, UINT32_MAX), end(count, 0);
+        auto touch = [&](uint32_t v, uint32_t at) {
+            start[v] = std::min(start[v], at);
+            end[v] = std::max(end[v], at);
+        };
+        // 逐块从出口活跃集合向前扫描，得到块内的活跃范围与入口活跃集合
+        std::vector<uint8_t> live(count, 0);
+        std::vector<uint32_t> liveList;
+        entryLive.assign(count, false);
+        for (uint32_t b = 0; b < blockCount; b++) {
+            const IrBlock& block = function.blocks[b];
+            liveList.clear();
+            liveness.forEachLiveOut(b, [&](uint32_t v) {
+                touch(v, blockOut[b]);
+                live[v] = 1;
+                liveList.push_back(v);
+            });
+            for (uint32_t i = block.end; i-- > block.begin;) {
+                const IrInst& inst = function.insts[i];
+                if (inst.op == IR_NOP) continue;
+                if (definesValue(inst)) {
+                    touch(inst.dst, pos[i] + 1);
+                    live[inst.dst] = 0;
+                }
+                forEachUse(inst, [&](uint32_t v) {
+                    uses[v]++;
+                    if (isConst(v)) return;
+                    touch(v, pos[i]);
+                    if (!live[v]) {
+                        live[v] = 1;
+                        liveList.push_back(v);
+                    }
+                });
+            }
+            for (uint32_t v : liveList) {
+                if (!live[v]) continue;
+                live[v] = 0;
+                touch(v, blockIn[b]);
+                if (b == 0) entryLive[v] = true;
+            }
+        }
+
+        std::vector<JitInterval> intervals;
+        for (uint32_t v = 0; v < count; v++) {
+            if (start[v] == UINT32_MAX) continue;
+            auto next = std::upper_bound(callPos.begin(), callPos.end(), start[v]);
+            intervals.push_back(
+                JitInterval{ v, start[v], end[v], typeOf(v) != TYPE_INT, next != callPos.end() && *next < end[v] });
+        }
+        std::sort(intervals.begin(), intervals.end(), [](const JitInterval& x, const JitInterval& y) {
+            return x.start != y.start ? x.start < y.start : x.value < y.value;
+        });
+
+        // 线性扫描：按起点处理区间，active 为占用寄存器的区间
+        std::vector<uint32_t> active;
+        bool busy[32] = {};
+        auto pick = [&](const JitInterval& cur) {
+            if (cur.xmm) {
+                for (int x = 0; x < kXmmAllocatable; x++) {
+                    if (!busy[kXmm + x]) return kXmm + x;
+                }
+                return -1;
+            }
+            // 跨越调用的值先用被调用者保存的寄存器，其余的先用调用者保存的
+            const int* first = cur.crossesCall ? kCalleeSavedGprs : kCallerSavedGprs;
+            const int* second = cur.crossesCall ? kCallerSavedGprs : kCalleeSavedGprs;
+            size_t firstCount = cur.crossesCall ? 4 : 6, secondCount = 10 - firstCount;
+            for (size_t k = 0; k < firstCount; k++) {
+                if (!busy[first[k]]) return first[k];
+            }
+            for (size_t k = 0; k < secondCount; k++) {
+                if (!busy[second[k]]) return second[k];
+            }
+            return -1;
+        };
+        auto spill = [&](uint32_t value) {
+            loc[value].kind = LOC_STACK;
+            loc[value].disp = newSlot();
+            spills++;
+        };
+        for (uint32_t k = 0; k < intervals.size(); k++) {
+            const JitInterval& cur = intervals[k];
+            for (size_t j = 0; j < active.size();) {
+                const JitInterval& other = intervals[active[j]];
+                if (other.end < cur.start) {
+                    busy[regOf(other.value)] = false;
+                    active[j] = active.back();
+                    active.pop_back();
+                } else {
+                    j++;
+                }
+            }
+            int r = pick(cur);
+            if (r < 0) {
+                // 溢出同类区间中结束最晚的一个
+                size_t victim = SIZE_MAX;
+                for (size_t j = 0; j < active.size(); j++) {
+                    const JitInterval& other = intervals[active[j]];
+                    if (other.xmm == cur.xmm && (victim == SIZE_MAX || other.end > intervals[active[victim]].end)) {
+                        victim = j;
+                    }
+                }
+                if (victim == SIZE_MAX || intervals[active[victim]].end <= cur.end) {
+                    spill(cur.value);
+                    continue;
+                }
+                uint32_t stolen = intervals[active[victim]].value;
+                r = regOf(stolen);
+                spill(stolen);
+                active[victim] = active.back();
+                active.pop_back();
+            }
+            busy[r] = true;
+            loc[cur.value].kind = LOC_REG;
+            loc[cur.value].reg = (int8_t)r;
+            active.push_back(k);
+        }
+
+        // 各调用前后需要保存的调用者保存寄存器：同一寄存器中的区间互不重叠，
+        // 只需看起点在调用之前的最后一个区间是否延续到调用之后
+        std::vector<std::vector<const JitInterval*>> byReg(32);
+        for (const JitInterval& interval : intervals) {
+            if (loc[interval.value].kind == LOC_REG) byReg[regOf(interval.value)].push_back(&interval);
+        }
+        std::vector<int> callerSaved(kCallerSavedGprs, kCallerSavedGprs + 6);
+        for (int x = 0; x < kXmmAllocatable; x++) callerSaved.push_back(kXmm + x);
+        for (uint32_t c : callPos) {
+            callSaves.emplace_back();
+            for (int r : callerSaved) {
+                const std::vector<const JitInterval*>& list = byReg[r];
+                auto it = std::lower_bound(list.begin(), list.end(), c,
+                                           [](const JitInterval* x, uint32_t at) { return x->start < at; });
+                if (it == list.begin() || (*(it - 1))->end <= c) continue;
+                callSaves.back().push_back(r);
+                if (!saveSlot[r]) saveSlot[r] = newSlot();
+            }
+        }
+        for (int r : kCalleeSavedGprs) {
+            if (byReg[r].empty()) continue;
+            calleeSaved.push_back(r);
+            calleeSlot[r] = newSlot();
+        }
+
+        // 暂存槽位：参数与各调用的实参先逐个存入，再装入目标位置（避免寄存器之间的循环移动）
+        uint32_t stagingCount = function.paramCount;
+        for (const IrInst& inst : function.insts) {
+            if (inst.op != IR_CALL) continue;
+            uint32_t stackCount;
+            argLocations(module.functions[inst.a], stackCount);
+            stagingCount = std::max(stagingCount, inst.c);
+            outgoing = std::max(outgoing, stackCount);
+        }
+        for (uint32_t k = 0; k < stagingCount; k++) staging.push_back(newSlot());
+        frameBytes = (8 * (slots + outgoing) + 15) & ~15u;
+    }
+
+    Rm rmOf(uint32_t value) {
+        const IrValue& v = function.values[value];
+        if (v.kind == IRV_CONST) return pooled(pool.add(v.type, v.doubleValue));
+        if (loc[value].kind == LOC_REG) return reg(loc[value].reg);
+        return mem(RBP, loc[value].disp);
+    }
+
+    static uint8_t ssePrefix(MiniType type) { return type == TYPE_FLOAT ? 0xF3 : 0xF2; }
+
+    // int 值装入通用寄存器 r（不改变标志位）
+    void loadInt(int r, uint32_t value) {
+        if (isConst(value)) {
+            out.moveImm32(reg(r), intValue(value));
+        } else if (!(inReg(value) && regOf(value) == r)) {
+            out.load32(r, rmOf(value));
+        }
+    }
+
+    void storeInt(uint32_t dst, int r) {
+        if (loc[dst].kind == LOC_NONE || (inReg(dst) && regOf(dst) == r)) return;
+        out.store32(rmOf(dst), r);
+    }
+
+    // float/double 值装入 xmmX
+    void loadReal(int x, uint32_t value) {
+        if (inReg(value)) {
+            if (regOf(value) != kXmm + x) out.sse(0, 0x28, x, reg(regOf(value)));   // movaps
+            return;
+        }
+        out.sse(ssePrefix(typeOf(value)), 0x10, x, rmOf(value));
+    }
+
+    void storeReal(uint32_t dst, int x) {
+        if (loc[dst].kind == LOC_NONE) return;
+        if (inReg(dst)) {
+            if (regOf(dst) != kXmm + x) out.sse(0, 0x28, regOf(dst) - kXmm, reg(x));
+            return;
+        }
+        out.sse(ssePrefix(typeOf(dst)), 0x11, x, rmOf(dst));
+    }
+
+    // 寄存器 r（通用或 xmm）与内存之间按类型传送
+    void storeRaw(const Rm& target, int r, MiniType type) {
+        if (r < kXmm) out.store32(target, r);
+        else out.sse(ssePrefix(type), 0x11, r - kXmm, target);
+    }
+
+    void loadRaw(int r, const Rm& source, MiniType type) {
+        if (r < kXmm) out.load32(r, source);
+        else out.sse(ssePrefix(type), 0x10, r - kXmm, source);
+    }
+
+    // 把值写入内存 target（实参与暂存槽位）
+    void storeValue(const Rm& target, uint32_t value) {
+        const IrValue& v = function.values[value];
+        if (v.kind == IRV_CONST) {
+            if (v.type == TYPE_INT) {
+                out.moveImm32(target, v.intValue);
+            } else if (v.type == TYPE_FLOAT) {
+                float f = (float)v.doubleValue;
+                int32_t bits;
+                memcpy(&bits, &f, 4);
+                out.moveImm32(target, bits);
+            } else {
+                out.sse(0xF2, 0x10, kXmmScratch, rmOf(value));
+                out.sse(0xF2, 0x11, kXmmScratch, target);
+            }
+        } else if (inReg(value)) {
+            storeRaw(target, regOf(value), v.type);
+        } else {
+            out.load64(RAX, rmOf(value));
+            out.store64(target, RAX);
+        }
+    }
+
+    // 从内存 source 装入值的位置（参数）
+    void loadValue(uint32_t value, const Rm& source) {
+        if (inReg(value)) {
+            loadRaw(regOf(value), source, typeOf(value));
+        } else if (loc[value].kind == LOC_STACK) {
+            out.load64(RAX, source);
+            out.store64(rmOf(value), RAX);
+        }
+    }
+
+    void move(uint32_t dst, uint32_t src) {
+        if (!isConst(src) && loc[src].kind == loc[dst].kind && loc[src].reg == loc[dst].reg &&
+            loc[src].disp == loc[dst].disp) {
+            return;
+        }
+        if (typeOf(dst) == TYPE_INT) {
+            if (inReg(dst)) {
+                loadInt(regOf(dst), src);
+            } else if (isConst(src)) {
+                out.moveImm32(rmOf(dst), intValue(src));
+            } else {
+                int r = inReg(src) ? regOf(src) : RAX;
+                loadInt(r, src);
+                storeInt(dst, r);
+            }
+            return;
+        }
+        int x = inReg(dst) ? regOf(dst) - kXmm : inReg(src) ? regOf(src) - kXmm : kXmmScratch;
+        loadReal(x, src);
+        storeReal(dst, x);
+    }
+
+    size_t labelHere() { return out.size(); }
+
+    void jumpTo(uint32_t block) { jumps.push_back({ out.jump(), block }); }
+
+    void jumpUnlessNext(uint32_t block) {
+        if (block != current + 1) jumpTo(block);
+    }
+
+    // cc 成立时跳到 yes，否则跳到 no；yes 是下一个块时把条件取反
+    void conditional(X86Cond cc, uint32_t yes, uint32_t no) {
+        if (yes == current + 1) {
+            jumps.push_back({ out.jump((X86Cond)(cc ^ 1)), no });
+            return;
+        }
+        jumps.push_back({ out.jump(cc), yes });
+        jumpUnlessNext(no);
+    }
+
+    void runtimeError(size_t patch, JitErrorKind kind) { errors.push_back({ patch, kind, line }); }
+
+    static bool commutative(IrOp op) {
+        return op == IR_ADD || op == IR_MUL || op == IR_AND || op == IR_OR || op == IR_EQ || op == IR_NE;
+    }
+
+    // a op b 等价于 b flip(op) a
+    static IrOp flip(IrOp op) {
+        switch (op) {
+            case IR_LT: return IR_GT;
+            case IR_LE: return IR_GE;
+            case IR_GT: return IR_LT;
+            case IR_GE: return IR_LE;
+            default: return op;
+        }
+    }
+
+    static X86Cond intCondition(IrOp op) {
+        switch (op) {
+            case IR_EQ: return CC_E;
+            case IR_NE: return CC_NE;
+            case IR_LT: return CC_L;
+            case IR_LE: return CC_LE;
+            case IR_GT: return CC_G;
+            default: return CC_GE;
+        }
+    }
+
+    void binaryInt(const IrInst& inst) {
+        IrOp op = inst.op;
+        uint32_t a = inst.a, b = inst.b;
+        if (isConst(a) && !isConst(b) && commutative(op)) std::swap(a, b);
+        // 目标在寄存器中且不与右操作数冲突时直接在目标上运算
+        int r = inReg(inst.dst) && !(inReg(b) && regOf(b) == regOf(inst.dst)) ? regOf(inst.dst) : RAX;
+        loadInt(r, a);
+        if (isConst(b)) {
+            int32_t k = intValue(b);
+            switch (op) {
+                case IR_ADD: out.aluImm(0, reg(r), k); break;
+                case IR_SUB: out.aluImm(5, reg(r), k); break;
+                case IR_AND: out.aluImm(4, reg(r), k); break;
+                case IR_OR: out.aluImm(1, reg(r), k); break;
+                default:
+                    out.op(0, false, { 0x69 }, r, reg(r));    // imul r, r, imm32
+                    out.imm32(k);
+                    break;
+            }
+        } else {
+            switch (op) {
+                case IR_ADD: out.op(0, false, { 0x03 }, r, rmOf(b)); break;
+                case IR_SUB: out.op(0, false, { 0x2B }, r, rmOf(b)); break;
+                case IR_AND: out.op(0, false, { 0x23 }, r, rmOf(b)); break;
+                case IR_OR: out.op(0, false, { 0x0B }, r, rmOf(b)); break;
+                default: out.op(0, false, { 0x0F, 0xAF }, r, rmOf(b)); break;
+            }
+        }
+        storeInt(inst.dst, r);
+    }
+
+    // int 除法：除数为0时报错，除数为 -1 时取负（INT_MIN / -1 为 INT_MIN，idiv 会产生异常）
+    void divideInt(const IrInst& inst) {
+        if (isConst(inst.b)) {
+            int32_t k = intValue(inst.b);
+            if (k == 0) {
+                runtimeError(out.jump(), JIT_DIVIDE_BY_ZERO);
+                return;
+            }
+            loadInt(RAX, inst.a);
+            if (k == -1) {
+                out.op(0, false, { 0xF7 }, 3, reg(RAX));      // neg eax
+            } else {
+                out.byte(0x99);                               // cdq
+                out.moveImm32(reg(RCX), k);
+                out.op(0, false, { 0xF7 }, 7, reg(RCX));      // idiv ecx
+            }
+        } else {
+            loadInt(RCX, inst.b);
+            out.op(0, false, { 0x85 }, RCX, reg(RCX));        // test ecx, ecx
+            runtimeError(out.jump(CC_E), JIT_DIVIDE_BY_ZERO);
+            loadInt(RAX, inst.a);
+            out.aluImm(7, reg(RCX), -1);
+            size_t minusOne = out.jump(CC_E);
+            out.byte(0x99);
+            out.op(0, false, { 0xF7 }, 7, reg(RCX));
+            size_t done = out.jump();
+            out.patch(minusOne, labelHere());
+            out.op(0, false, { 0xF7 }, 3, reg(RAX));
+            out.patch(done, labelHere());
+        }
+        storeInt(inst.dst, RAX);
+    }
+
+    // 比较两个 int 值，设置标志位，返回 op 成立时的条件码
+    X86Cond compareInt(IrOp op, uint32_t a, uint32_t b) {
+        if (isConst(a) && !isConst(b)) {
+            std::swap(a, b);
+            op = flip(op);
+        }
+        int r = inReg(a) ? regOf(a) : RAX;
+        loadInt(r, a);
+        if (isConst(b)) out.aluImm(7, reg(r), intValue(b));
+        else out.op(0, false, { 0x3B }, r, rmOf(b));
+        return intCondition(op);
+    }
+
+    void compareIntValue(const IrInst& inst) {
+        X86Cond cc = compareInt(inst.op, inst.a, inst.b);
+        out.setcc(cc, RAX);
+        out.op(0, false, { 0x0F, 0xB6 }, RAX, reg(RAX));      // movzx eax, al
+        storeInt(inst.dst, RAX);
+    }
+
+    // 浮点比较：ucomiss/ucomisd 的无序结果（NaN）置 ZF PF CF，a < b 按 b > a 比较使 NaN 为假
+    void compareReal(const IrInst& inst) {
+        IrOp op = inst.op;
+        uint32_t a = inst.a, b = inst.b;
+        if (op == IR_LT || op == IR_LE) {
+            std::swap(a, b);
+            op = flip(op);
+        }
+        loadReal(kXmmScratch, a);
+        out.sse(typeOf(a) == TYPE_FLOAT ? 0 : 0x66, 0x2E, kXmmScratch, rmOf(b));
+        switch (op) {
+            case IR_EQ:
+                out.setcc(CC_E, RAX);
+                out.setcc(CC_NP, RCX);
+                out.op(0, false, { 0x20 }, RCX, reg(RAX));    // and al, cl
+                break;
+            case IR_NE:
+                out.setcc(CC_NE, RAX);
+                out.setcc(CC_P, RCX);
+                out.op(0, false, { 0x08 }, RCX, reg(RAX));    // or al, cl
+                break;
+            case IR_GT: out.setcc(CC_A, RAX); break;
+            default: out.setcc(CC_AE, RAX); break;
+        }
+        out.op(0, false, { 0x0F, 0xB6 }, RAX, reg(RAX));
+        storeInt(inst.dst, RAX);
+    }
+
+    void binaryReal(const IrInst& inst) {
+        static const uint8_t opcodes[] = { 0x58, 0x5C, 0x59, 0x5E };   // add sub mul div
+        uint32_t dst = inst.dst;
+        int x = inReg(dst) && !(inReg(inst.b) && regOf(inst.b) == regOf(dst)) ? regOf(dst) - kXmm : kXmmScratch;
+        loadReal(x, inst.a);
+        out.sse(ssePrefix(typeOf(dst)), opcodes[inst.op - IR_ADD], x, rmOf(inst.b));
+        storeReal(dst, x);
+    }
+
+    void conv(const IrInst& inst) {
+        MiniType from = typeOf(inst.a), to = typeOf(inst.dst);
+        if (from == to) {
+            move(inst.dst, inst.a);
+            return;
+        }
+        if (from == TYPE_INT) {
+            int x = inReg(inst.dst) ? regOf(inst.dst) - kXmm : kXmmScratch;
+            Rm source = reg(RAX);
+            if (isConst(inst.a)) loadInt(RAX, inst.a);
+            else source = rmOf(inst.a);
+            out.sse(0, 0x57, x, reg(x));                           // xorps：断开对原值的依赖
+            out.sse(ssePrefix(to), 0x2A, x, source);               // cvtsi2ss/cvtsi2sd
+            storeReal(inst.dst, x);
+        } else if (to == TYPE_INT) {
+            int r = inReg(inst.dst) ? regOf(inst.dst) : RAX;
+            out.sse(ssePrefix(from), 0x2C, r, rmOf(inst.a));       // cvttss2si/cvttsd2si
+            storeInt(inst.dst, r);
+        } else {
+            int x = inReg(inst.dst) ? regOf(inst.dst) - kXmm : kXmmScratch;
+            out.sse(ssePrefix(from), 0x5A, x, rmOf(inst.a));       // cvtss2sd/cvtsd2ss
+            storeReal(inst.dst, x);
+        }
+    }
+
+    void branch(const IrInst& br) {
+        const IrValue& condition = function.values[br.a];
+        if (condition.kind == IRV_CONST) {
+            bool taken = condition.type == TYPE_INT ? condition.intValue != 0 : condition.doubleValue != 0;
+            jumpUnlessNext(taken ? br.b : br.c);
+            return;
+        }
+        if (condition.type == TYPE_INT) {
+            if (inReg(br.a)) out.op(0, false, { 0x85 }, regOf(br.a), reg(regOf(br.a)));   // test r, r
+            else out.aluImm(7, rmOf(br.a), 0);
+            conditional(CC_NE, br.b, br.c);
+            return;
+        }
+        // 不等于0或无序（NaN）时为真
+        loadReal(kXmmScratch, br.a);
+        out.sse(0, 0x57, kXmmZero, reg(kXmmZero));
+        out.sse(condition.type == TYPE_FLOAT ? 0 : 0x66, 0x2E, kXmmScratch, reg(kXmmZero));
+        jumps.push_back({ out.jump(CC_P), br.b });
+        conditional(CC_NE, br.b, br.c);
+    }
+
+    // 比较后紧跟只以其结果为条件的 br（int 操作数）时合并为比较跳转
+    bool fusable(const IrInst& compare, const IrInst& next) const {
+        return compare.op >= IR_EQ && compare.op <= IR_GE && next.op == IR_BR && next.a == compare.dst &&
+               function.values[compare.dst].kind == IRV_TEMP && uses[compare.dst] == 1 &&
+               typeOf(compare.a) == TYPE_INT;
+    }
+
+    void call(const IrInst& inst) {
+        const IrFunction& callee = module.functions[inst.a];
+        uint32_t stackCount;
+        std::vector<int> where = argLocations(callee, stackCount);
+        out.aluImm(7, mem(R15, kDepthOffset), (int32_t)kVmMaxDepth);
+        runtimeError(out.jump(CC_AE), JIT_STACK_OVERFLOW);
+        out.op(0, false, { 0xFF }, 0, mem(R15, kDepthOffset));    // inc dword [r15]
+
+        const std::vector<int>& saves = callSaves[callIndex++];
+        for (int r : saves) {
+            if (r < kXmm) out.store64(mem(RBP, saveSlot[r]), r);
+            else out.sse(0xF2, 0x11, r - kXmm, mem(RBP, saveSlot[r]));
+        }
+        for (uint32_t k = 0; k < inst.c; k++) {
+            uint32_t arg = function.args[inst.b + k];
+            storeValue(where[k] >= 0 ? mem(RBP, staging[k]) : mem(RSP, 8 * ~where[k]), arg);
+        }
+        for (uint32_t k = 0; k < inst.c; k++) {
+            if (where[k] >= 0) loadRaw(where[k], mem(RBP, staging[k]), callee.values[k].type);
+        }
+        calls.push_back({ out.call(), inst.a });
+        out.op(0, false, { 0xFF }, 1, mem(R15, kDepthOffset));    // dec dword [r15]
+
+        bool real = inst.dst != kNoValue && typeOf(inst.dst) != TYPE_INT;
+        if (real && !saves.empty()) out.sse(0, 0x28, kXmmScratch, reg(0));   // 恢复 xmm0 之前先取出返回值
+        for (int r : saves) {
+            if (r < kXmm) out.load64(r, mem(RBP, saveSlot[r]));
+            else out.sse(0xF2, 0x10, r - kXmm, mem(RBP, saveSlot[r]));
+        }
+        if (inst.dst == kNoValue) return;
+        if (real) storeReal(inst.dst, saves.empty() ? 0 : kXmmScratch);
+        else storeInt(inst.dst, RAX);
+    }
+
+    void ret(const IrInst& inst) {
+        if (function.returnType == TYPE_INT) loadInt(RAX, inst.a);
+        else loadReal(0, inst.a);
+        for (int r : calleeSaved) out.load64(r, mem(RBP, calleeSlot[r]));
+        out.byte(0xC9);    // leave
+        out.byte(0xC3);    // ret
+    }
+
+    void prologue() {
+        out.push(RBP);
+        out.op(0, true, { 0x89 }, RSP, reg(RBP));                  // mov rbp, rsp
+        if (frameBytes) out.aluImm(5, reg(RSP), (int32_t)frameBytes, true);
+        for (int r : calleeSaved) out.store64(mem(RBP, calleeSlot[r]), r);
+
+        // 寄存器传入的参数先存入暂存槽位，再装入各自的位置；栈上的参数在返回地址之上
+        uint32_t stackCount;
+        std::vector<int> where = argLocations(function, stackCount);
+        for (uint32_t p = 0; p < function.paramCount; p++) {
+            if (where[p] >= 0 && loc[p].kind != LOC_NONE) storeRaw(mem(RBP, staging[p]), where[p], typeOf(p));
+        }
+        for (uint32_t p = 0; p < function.paramCount; p++) {
+            if (loc[p].kind == LOC_NONE) continue;
+            loadValue(p, where[p] >= 0 ? mem(RBP, staging[p]) : mem(RBP, 16 + 8 * ~where[p]));
+        }
+        // 入口处活跃的变量清零
+        for (uint32_t v = function.paramCount; v < function.slotCount; v++) {
+            if (!entryLive[v] || loc[v].kind == LOC_NONE) continue;
+            if (loc[v].kind == LOC_STACK) out.moveImm32(rmOf(v), 0, true);
+            else if (regOf(v) < kXmm) out.op(0, false, { 0x31 }, regOf(v), reg(regOf(v)));   // xor r, r
+            else out.sse(0, 0x57, regOf(v) - kXmm, reg(regOf(v)));
+        }
+    }
+
+    void emit() {
+        prologue();
+        blockOffset.assign(function.blocks.size(), 0);
+        for (current = 0; current < function.blocks.size(); current++) {
+            const IrBlock& block = function.blocks[current];
+            blockOffset[current] = labelHere();
+            for (uint32_t i = block.begin; i < block.end; i++) {
+                const IrInst& inst = function.insts[i];
+                line = inst.line;
+                switch (inst.op) {
+                    case IR_NOP:
+                        break;
+                    case IR_MOV:
+                        move(inst.dst, inst.a);
+                        break;
+                    case IR_CONV:
+                        conv(inst);
+                        break;
+                    case IR_CALL:
+                        call(inst);
+                        break;
+                    case IR_JMP:
+                        jumpUnlessNext(inst.b);
+                        break;
+                    case IR_BR:
+                        branch(inst);
+                        break;
+                    case IR_RET:
+                        ret(inst);
+                        break;
+                    default:
+                        if (typeOf(inst.a) != TYPE_INT) {
+                            if (inst.op >= IR_EQ) compareReal(inst);
+                            else binaryReal(inst);
+                        } else if (inst.op >= IR_EQ) {
+                            if (i + 1 < block.end && fusable(inst, function.insts[i + 1])) {
+                                const IrInst& br = function.insts[i + 1];
+                                conditional(compareInt(inst.op, inst.a, inst.b), br.b, br.c);
+                                i++;
+                            } else {
+                                compareIntValue(inst);
+                            }
+                        } else if (inst.op == IR_DIV) {
+                            divideInt(inst);
+                        } else {
+                            binaryInt(inst);
+                        }
+                        break;
+                }
+            }
+        }
+        for (const auto& jump : jumps) out.patch(jump.first, blockOffset[jump.second]);
+
+        // 运行时错误：记录错误与行号后跳到入口桩的返回处（相同的错误共用一段代码）
+        std::map<std::pair<int32_t, int32_t>, size_t> stubs;
+        for (const ErrorSite& site : errors) {
+            auto inserted = stubs.emplace(std::make_pair(site.kind, site.line), labelHere());
+            if (inserted.second) {
+                out.moveImm32(mem(R15, kErrorKindOffset), site.kind);
+                out.moveImm32(mem(R15, kErrorLineOffset), site.line);
+                out.patch(out.jump(), exitOffset);
+            }
+            out.patch(site.patch, inserted.first->second);
+        }
+    }
+
+    // 帧与寄存器分配的文本
+    std::string listing(uint32_t entry, size_t bytes) const {
+        std::string text = std::string(miniTypeName(function.returnType)) + " " + function.name + "    ; 偏移 " +
+                           std::to_string(entry) + "，机器码 " + std::to_string(bytes) + " 字节，帧 " +
+                           std::to_string(frameBytes) + " 字节，溢出 " + std::to_string(spills) + " 个值\n";
+        for (uint32_t v = 0; v < function.values.size(); v++) {
+            if (loc[v].kind == LOC_NONE) continue;
+            const IrValue& value = function.values[v];
+            std::string name = value.kind == IRV_VAR ? module.names.name(value.name)
+                               : value.name == kNoName ? "%" + std::to_string(v)
+                                                       : "%" + module.names.name(value.name) + "." + std::to_string(v);
+            text += "    " + name + " -> " +
+                    (loc[v].kind == LOC_REG ? std::string(kRegNames[(int)loc[v].reg])
+                                            : "[rbp" + std::to_string(loc[v].disp) + "]") + "\n";
+        }
+        return text + "\n";
+    }
+};
+
+/* 接口实现 */
+
+JitProgram::~JitProgram() {
+    if (code) munmap(code, mapSize);
+    if (stack) munmap(stack, stackSize);
+}
+
+static size_t pageRound(size_t bytes) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    return (bytes + page - 1) / page * page;
+}
+
+bool compileJit(const IrModule& module, JitProgram& program, std::string& error) {
+#if !defined(__x86_64__)
+    (void)module;
+    (void)program;
+    error = "JIT 只支持 x86-64";
+    return false;
+#else
+    X86Emitter out;
+    JitConstPool pool;
+    std::vector<std::pair<size_t, uint32_t>> calls;
+    std::vector<uint32_t> entries, sizes, stackArgs;
+    std::string listing;
+    size_t exitOffset = emitEnterStub(out);
+    uint32_t maxFrame = 0;
+    for (const IrFunction& function : module.functions) {
+        out.align();
+        JitFunctionCompiler compiler(module, function, out, pool, calls, exitOffset);
+        compiler.allocate();
+        uint32_t entry = (uint32_t)out.size();
+        compiler.emit();
+        entries.push_back(entry);
+        sizes.push_back((uint32_t)(out.size() - entry));
+        uint32_t stackCount;
+        argLocations(function, stackCount);
+        stackArgs.push_back(stackCount);
+        maxFrame = std::max(maxFrame, compiler.frameBytes + 16);   // 另加返回地址与 rbp
+        listing += compiler.listing(entry, out.size() - entry);
+    }
+    for (const auto& call : calls) out.patch(call.first, entries[call.second]);
+    size_t codeSize = out.size();
+    out.align();
+    size_t poolOffset = out.size();
+    for (uint64_t bits : pool.entries) {
+        for (int k = 0; k < 8; k++) out.byte((uint8_t)(bits >> (8 * k)));
+    }
+    for (const auto& fixup : out.poolFixups) out.patch(fixup.first, poolOffset + 8 * fixup.second);
+
+    // 先以读写映射写入，再改为只读可执行
+    size_t mapSize = pageRound(out.size());
+    void* memory = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        error = "无法映射可执行内存";
+        return false;
+    }
+    memcpy(memory, out.code.data(), out.size());
+    if (mprotect(memory, mapSize, PROT_READ | PROT_EXEC) != 0) {
+        munmap(memory, mapSize);
+        error = "无法把内存设为可执行";
+        return false;
+    }
+
+    if (program.code) munmap(program.code, program.mapSize);
+    if (program.stack) munmap(program.stack, program.stackSize);
+    program.code = (uint8_t*)memory;
+    program.codeSize = codeSize;
+    program.mapSize = mapSize;
+    program.stack = nullptr;
+    // 调用深度不超过 kVmMaxDepth，每层不超过最大的帧；另留入口桩与栈上实参的空间
+    program.stackSize = pageRound((kVmMaxDepth + 2) * (size_t)maxFrame + (64u << 10));
+    program.enter = 0;
+    program.names.clear();
+    program.returnTypes.clear();
+    for (const IrFunction& function : module.functions) {
+        program.names.push_back(function.name);
+        program.returnTypes.push_back(function.returnType);
+    }
+    program.stackArgs = stackArgs;
+    program.entries = entries;
+    program.sizes = sizes;
+    program.listing = listing;
+    return true;
+#endif
+}
+
+uint32_t jitFindFunction(const JitProgram& program, const std::string& name) {
+    for (uint32_t f = 0; f < program.names.size(); f++) {
+        if (program.names[f] == name) return f;
+    }
+    return UINT32_MAX;
+}
+
+bool jitRun(JitProgram& program, uint32_t function, VmResult& result) {
+    result = VmResult();
+    result.type = program.returnTypes[function];
+    result.value.bits = 0;
+#if !defined(__x86_64__)
+    result.error = "JIT 只支持 x86-64";
+    return false;
+#else
+    if (!program.stack) {
+        void* memory = mmap(nullptr, program.stackSize, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (memory == MAP_FAILED) {
+            result.error = "无法映射执行栈";
+            return false;
+        }
+        program.stack = (uint8_t*)memory;
+    }
+    // 栈上传递的参数为0
+    size_t argBytes = (8 * (size_t)program.stackArgs[function] + 15) & ~(size_t)15;
+    uint8_t* top = program.stack + program.stackSize - argBytes;
+    memset(top, 0, argBytes);
+    JitContext context = {};
+    context.stackTop = (uint64_t)top;
+
+    typedef void (*JitEnter)(JitContext*, const void*);
+    JitEnter enter = reinterpret_cast<JitEnter>(program.code + program.enter);
+    enter(&context, program.code + program.entries[function]);
+
+    if (context.errorKind != JIT_OK) {
+        result.errorLine = context.errorLine;
+        result.error = context.errorKind == JIT_DIVIDE_BY_ZERO
+                           ? "int 除以0"
+                           : "调用栈溢出（深度 " + std::to_string(context.depth) + "）";
+        return false;
+    }
+    if (result.type == TYPE_INT) result.value.i = (int32_t)context.resultInt;
+    else result.value.bits = context.resultXmm;
+    result.ok = true;
+    return true;
+#endif
+}
+
+std::string dumpJit(const JitProgram& program) {
+    return program.listing;
+}
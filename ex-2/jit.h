@@ -0,0 +1,64 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include "ir.h"
+#include "vm.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/*
+ * x86-64 即时编译
+ * ===========================
+ * 把中间代码（可先经 opt.h 优化）逐函数编译为 x86-64 机器码，放在 mmap 映射的内存中直接执行，
+ * 返回值与运行时错误和 vm.h 的虚拟机相同（结果类型 VmResult，instructions 为0）：
+ *   - 寄存器分配：线性扫描。按块的排列顺序给指令编号，由活跃变量分析（opt.h）得到每个值的活跃区间；
+ *     int 值用通用寄存器，float/double 值用 xmm 寄存器，不够时把区间结束最晚的值溢出到栈帧。
+ *     跨越调用的 int 值优先用被调用者保存的寄存器，仍在调用者保存的寄存器中的值在调用前后保存与恢复。
+ *   - 浮点：SSE2 标量指令，float 按单精度（addss 等），double 按双精度（addsd 等）；
+ *     cvttss2si/cvttsd2si 越界与 NaN 时的结果恰为 INT_MIN，与 ir.h 的转换规则一致。
+ *   - 调用约定：System V AMD64。int 实参依次用 rdi rsi rdx rcx r8 r9，float/double 用 xmm0~xmm7，
+ *     其余在栈上；返回值在 eax/xmm0。生成的函数之间直接 call。
+ *     r15 在生成的代码中固定指向运行上下文（被调用者保存的寄存器，不违反约定）。
+ *   - 运行时错误：int 除以0、调用深度超过 kVmMaxDepth 时把错误写入上下文，恢复入口桩保存的 rsp 后返回。
+ *     生成的代码在独立映射的栈上执行，栈的大小按最大帧与调用深度上限计算。
+ *   - 可执行内存先以读写映射，写入机器码与常量池后改为只读可执行。
+ * 只支持 x86-64，其他平台上 compileJit 返回 false。
+ */
+
+// 编译好的程序（不可复制，析构时解除映射）
+struct JitProgram {
+    uint8_t* code = nullptr;             // 机器码与常量池
+    size_t codeSize = 0;                 // 机器码字节数（不含常量池）
+    size_t mapSize = 0;
+    uint8_t* stack = nullptr;            // 执行栈（首次执行时映射）
+    size_t stackSize = 0;
+    uint32_t enter = 0;                  // 入口桩的偏移
+    std::vector<std::string> names;      // 与 IrModule::functions 一一对应
+    std::vector<MiniType> returnTypes;
+    std::vector<uint32_t> stackArgs;     // 各函数在栈上传递的参数个数
+    std::vector<uint32_t> entries;       // 各函数首条指令的偏移
+    std::vector<uint32_t> sizes;         // 各函数的机器码字节数
+    std::string listing;                 // 各函数的帧与寄存器分配（dumpJit）
+
+    JitProgram() = default;
+    JitProgram(const JitProgram&) = delete;
+    JitProgram& operator=(const JitProgram&) = delete;
+    ~JitProgram();
+};
+
+/* INFO 编译与执行接口 */
+
+// 由中间代码生成机器码；失败（不支持的平台、无法映射内存）时返回false并给出原因
+bool compileJit(const IrModule& module, JitProgram& program, std::string& error);
+
+// 函数编号，不存在时返回 UINT32_MAX
+uint32_t jitFindFunction(const JitProgram& program, const std::string& name);
+
+// 以全0的实参执行第function个函数，返回是否正常结束
+bool jitRun(JitProgram& program, uint32_t function, VmResult& result);
+
+// 以文本形式输出各函数的位置、帧大小与寄存器分配
+std::string dumpJit(const JitProgram& program);
+
+#endif /* JIT_H */
@@ -0,0 +1,265 @@
+#include "json.h"
+#include <cstdlib>
+#include <cstdio>
+
+/* 解析器状态 */
+struct JsonReader {
+    const std::string& text;
+    size_t pos;
+};
+
+static bool parseValue(JsonReader& r, JsonValue& out, int depth);
+
+/* 辅助函数 */
+static void skipSpace(JsonReader& r) {
+    while (r.pos < r.text.size()) {
+        char c = r.text[r.pos];
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') break;
+        r.pos++;
+    }
+}
+
+// 将码点以UTF-8编码追加到out
+static void appendUtf8(std::string& out, unsigned cp) {
+    if (cp < 0x80) {
+        out += (char)cp;
+    } else if (cp < 0x800) {
+        out += (char)(0xC0 | (cp >> 6));
+        out += (char)(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += (char)(0xE0 | (cp >> 12));
+        out += (char)(0x80 | ((cp >> 6) & 0x3F));
+        out += (char)(0x80 | (cp & 0x3F));
+    } else {
+        out += (char)(0xF0 | (cp >> 18));
+        out += (char)(0x80 | ((cp >> 12) & 0x3F));
+        out += (char)(0x80 | ((cp >> 6) & 0x3F));
+        out += (char)(0x80 | (cp & 0x3F));
+    }
+}
+
+static bool parseHex4(JsonReader& r, unsigned& cp) {
+    if (r.pos + 4 > r.text.size()) return false;
+    cp = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = r.text[r.pos++];
+        cp <<= 4;
+        if (c >= '0' && c <= '9') cp |= c - '0';
+        else if (c >= 'a' && c <= 'f') cp |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') cp |= c - 'A' + 10;
+        else return false;
+    }
+    return true;
+}
+
+static bool parseString(JsonReader& r, std::string& out) {
+    if (r.text[r.pos] != '"') return false;
+    r.pos++;
+    out.clear();
+    while (r.pos < r.text.size()) {
+        char c = r.text[r.pos++];
+        if (c == '"') return true;
+        if (c != '\\') {
+            out += c;
+            continue;
+        }
+        if (r.pos >= r.text.size()) return false;
+        char e = r.text[r.pos++];
+        switch (e) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                unsigned cp;
+                if (!parseHex4(r, cp)) return false;
+                // 代理对
+                if (cp >= 0xD800 && cp < 0xDC00 && r.pos + 1 < r.text.size() &&
+                    r.text[r.pos] == '\\' && r.text[r.pos + 1] == 'u') {
+                    r.pos += 2;
+                    unsigned low;
+                    if (!parseHex4(r, low)) return false;
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                }
+                appendUtf8(out, cp);
+                break;
+            }
+            default: return false;
+        }
+    }
+    return false;
+}
+
+static bool parseLiteral(JsonReader& r, const char* word) {
+    size_t i = 0;
+    while (word[i]) {
+        if (r.pos + i >= r.text.size() || r.text[r.pos + i] != word[i]) return false;
+        i++;
+    }
+    r.pos += i;
+    return true;
+}
+
+static bool parseValue(JsonReader& r, JsonValue& out, int depth) {
+    if (depth > 256) return false;  // 防止恶意输入导致栈溢出
+    skipSpace(r);
+    if (r.pos >= r.text.size()) return false;
+    char c = r.text[r.pos];
+
+    if (c == '{') {
+        out.type = JSON_OBJECT;
+        r.pos++;
+        skipSpace(r);
+        if (r.pos < r.text.size() && r.text[r.pos] == '}') { r.pos++; return true; }
+        while (true) {
+            skipSpace(r);
+            std::pair<std::string, JsonValue> member;
+            if (r.pos >= r.text.size() || !parseString(r, member.first)) return false;
+            skipSpace(r);
+            if (r.pos >= r.text.size() || r.text[r.pos] != ':') return false;
+            r.pos++;
+            if (!parseValue(r, member.second, depth + 1)) return false;
+            out.members.push_back(std::move(member));
+            skipSpace(r);
+            if (r.pos >= r.text.size()) return false;
+            if (r.text[r.pos] == ',') { r.pos++; continue; }
+            if (r.text[r.pos] == '}') { r.pos++; return true; }
+            return false;
+        }
+    }
+    if (c == '[') {
+        out.type = JSON_ARRAY;
+        r.pos++;
+        skipSpace(r);
+        if (r.pos < r.text.size() && r.text[r.pos] == ']') { r.pos++; return true; }
+        while (true) {
+            JsonValue item;
+            if (!parseValue(r, item, depth + 1)) return false;
+            out.items.push_back(std::move(item));
+            skipSpace(r);
+            if (r.pos >= r.text.size()) return false;
+            if (r.text[r.pos] == ',') { r.pos++; continue; }
+            if (r.text[r.pos] == ']') { r.pos++; return true; }
+            return false;
+        }
+    }
+    if (c == '"') {
+        out.type = JSON_STRING;
+        return parseString(r, out.str);
+    }
+    if (c == 't' || c == 'f') {
+        out.type = JSON_BOOL;
+        out.boolean = (c == 't');
+        return parseLiteral(r, out.boolean ? "true" : "false");
+    }
+    if (c == 'n') {
+        out.type = JSON_NULL;
+        return parseLiteral(r, "null");
+    }
+    // 数字
+    size_t start = r.pos;
+    while (r.pos < r.text.size()) {
+        char d = r.text[r.pos];
+        if ((d >= '0' && d <= '9') || d == '-' || d == '+' || d == '.' || d == 'e' || d == 'E') r.pos++;
+        else break;
+    }
+    if (start == r.pos) return false;
+    out.type = JSON_NUMBER;
+    out.str = r.text.substr(start, r.pos - start);
+    out.number = strtod(out.str.c_str(), nullptr);
+    return true;
+}
+
+/* 接口实现 */
+const JsonValue* JsonValue::get(const std::string& key) const {
+    if (type != JSON_OBJECT) return nullptr;
+    for (const auto& member : members) {
+        if (member.first == key) return &member.second;
+    }
+    return nullptr;
+}
+
+std::string JsonValue::getString(const std::string& key, const std::string& def) const {
+    const JsonValue* v = get(key);
+    return (v && v->type == JSON_STRING) ? v->str : def;
+}
+
+double JsonValue::getNumber(const std::string& key, double def) const {
+    const JsonValue* v = get(key);
+    return (v && v->type == JSON_NUMBER) ? v->number : def;
+}
+
+bool parseJson(const std::string& text, JsonValue& out) {
+    JsonReader r = { text, 0 };
+    out = JsonValue();
+    if (!parseValue(r, out, 0)) return false;
+    skipSpace(r);
+    return r.pos == text.size();
+}
+
+void appendJsonString(std::string& out, const std::string& s) {
+    out += '"';
+    for (unsigned char c : s) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += (char)c;
+                }
+        }
+    }
+    out += '"';
+}
+
+static void appendJson(std::string& out, const JsonValue& v) {
+    switch (v.type) {
+        case JSON_NULL: out += "null"; break;
+        case JSON_BOOL: out += v.boolean ? "true" : "false"; break;
+        case JSON_NUMBER:
+            if (!v.str.empty()) {
+                out += v.str;
+            } else {
+                char buf[32];
+                snprintf(buf, sizeof(buf), "%.17g", v.number);
+                out += buf;
+            }
+            break;
+        case JSON_STRING: appendJsonString(out, v.str); break;
+        case JSON_ARRAY:
+            out += '[';
+            for (size_t i = 0; i < v.items.size(); i++) {
+                if (i) out += ',';
+                appendJson(out, v.items[i]);
+            }
+            out += ']';
+            break;
+        case JSON_OBJECT:
+            out += '{';
+            for (size_t i = 0; i < v.members.size(); i++) {
+                if (i) out += ',';
+                appendJsonString(out, v.members[i].first);
+                out += ':';
+                appendJson(out, v.members[i].second);
+            }
+            out += '}';
+            break;
+    }
+}
+
+std::string toJson(const JsonValue& value) {
+    std::string out;
+    appendJson(out, value);
+    return out;
+}
@@ -0,0 +1,45 @@
+#ifndef JSON_H
+#define JSON_H
+
+#include <string>
+#include <vector>
+#include <utility>
+
+/* 最小JSON实现，仅供LSP等内部协议使用 */
+
+/* JSON值类型 */
+enum JsonType {
+    JSON_NULL = 0,
+    JSON_BOOL,
+    JSON_NUMBER,
+    JSON_STRING,
+    JSON_ARRAY,
+    JSON_OBJECT
+};
+
+/* JSON值 */
+struct JsonValue {
+    JsonType type = JSON_NULL;
+    bool boolean = false;
+    double number = 0.0;
+    std::string str;                                       // 字符串值，数字的原始文本
+    std::vector<JsonValue> items;                          // 数组元素
+    std::vector<std::pair<std::string, JsonValue>> members; // 对象成员（保持原有顺序）
+
+    // 查找对象成员，不存在时返回nullptr
+    const JsonValue* get(const std::string& key) const;
+    // 便捷访问，类型不符时返回默认值
+    std::string getString(const std::string& key, const std::string& def = "") const;
+    double getNumber(const std::string& key, double def = 0.0) const;
+};
+
+// 解析JSON文本，失败返回false
+bool parseJson(const std::string& text, JsonValue& out);
+
+// 序列化JSON值（紧凑格式）
+std::string toJson(const JsonValue& value);
+
+// 将字符串转义为JSON字符串字面量（含两侧引号），追加到out
+void appendJsonString(std::string& out, const std::string& s);
+
+#endif /* JSON_H */
@@ -0,0 +1,88 @@
+#include "lalr.h"
+#include "lalr_tables.h"
+
+static_assert(kLalrTerminalCount == TK_EOF + 1, "分析表与Token编码不一致，请重新生成 lalr_tables.h");
+
+/* 全局变量（按线程独立） */
+static thread_local std::vector<int16_t> g_stack;         // 状态栈，容量在多次分析间复用
+static thread_local std::vector<ParserError> g_errors;
+static thread_local long g_shifts = 0;
+static thread_local long g_reduces = 0;
+
+static const int kError = 1 << 20;   // 查表结果：出错
+
+/* INFO 查表 */
+
+// 动作：正数移进，负数归约，0接受，kError出错
+static inline int lookupAction(int state, int terminal) {
+    int index = kLalrActionBase[state] + terminal;
+    if (kLalrActionCheck[index] == state) {
+        return kLalrActionValue[index];
+    }
+    int rule = kLalrDefaultReduce[state];
+    return rule != 0 ? -rule : kError;
+}
+
+static inline int lookupGoto(int state, int nonterminal) {
+    int index = kLalrGotoBase[nonterminal] + state;
+    if (kLalrGotoCheck[index] == nonterminal) {
+        return kLalrGotoValue[index];
+    }
+    return kLalrDefaultGoto[nonterminal];
+}
+
+// 出错状态下期望的Token
+static std::string expectedTokens(int state) {
+    std::string expected;
+    for (int terminal = 0; terminal < kLalrTerminalCount; terminal++) {
+        if (kLalrActionCheck[kLalrActionBase[state] + terminal] == state) {
+            if (!expected.empty()) expected += ", ";
+            expected += getTokenName((TokenCode)terminal);
+        }
+    }
+    return expected;
+}
+
+/* 接口实现 */
+
+ParserResult parseLalr() {
+    g_errors.clear();
+    g_shifts = 0;
+    g_reduces = 0;
+    g_stack.clear();
+    g_stack.push_back(0);
+
+    TokenAttr token = getNextToken();
+    while (true) {
+        int action = lookupAction(g_stack.back(), token.code);
+        if (action > 0 && action != kError) {
+            g_stack.push_back((int16_t)action);
+            token = getNextToken();
+            g_shifts++;
+        } else if (action < 0) {
+            int rule = -action;
+            g_stack.resize(g_stack.size() - kLalrRuleLength[rule]);
+            g_stack.push_back((int16_t)lookupGoto(g_stack.back(), kLalrRuleLhs[rule]));
+            g_reduces++;
+        } else if (action == 0) {
+            return RESULT_SUCCESS;
+        } else {
+            ParserError error = { token.line, "语法错误: 意外的标记 '" + token.value + "'，期望: " +
+                                              expectedTokens(g_stack.back()) };
+            g_errors.push_back(error);
+            return RESULT_ERROR;
+        }
+    }
+}
+
+const std::vector<ParserError>& getLalrErrors() {
+    return g_errors;
+}
+
+long getLalrShiftCount() {
+    return g_shifts;
+}
+
+long getLalrReduceCount() {
+    return g_reduces;
+}
@@ -0,0 +1,29 @@
+#ifndef LALR_H
+#define LALR_H
+
+#include "lexer.h"
+#include "parser.h"
+#include <vector>
+
+/*
+ * 表驱动的 LALR(1) 语法分析器
+ * ===========================
+ * 运行 tools/lalr_gen 生成的压缩分析表（lalr_tables.h），以非递归的移进-归约循环
+ * 分析当前线程词法分析器给出的Token。状态栈是可增长的数组，嵌套深度只受内存限制，
+ * 不需要递归下降分析器的嵌套层数上限。
+ *
+ * 与 parse() 接受完全相同的语言（文法取自 parser.cpp 的注释）；只做识别，不做错误恢复：
+ * 遇到第一个语法错误即停止，并给出该状态下期望的Token。
+ */
+
+// 分析当前线程词法分析器的输入（调用前以 initLexerBuffer 等初始化）
+ParserResult parseLalr();
+
+// 获取最近一次 parseLalr 的语法错误（最多一条）
+const std::vector<ParserError>& getLalrErrors();
+
+// 获取最近一次 parseLalr 的移进次数与归约次数
+long getLalrShiftCount();
+long getLalrReduceCount();
+
+#endif /* LALR_H */
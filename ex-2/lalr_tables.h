@@ -0,0 +1,251 @@
+#ifndef LALR_TABLES_H
+#define LALR_TABLES_H
+
+#include <cstdint>
+
+/*
+ * Mini 文法的 LALR(1) 分析表
+ * ===========================
+ * 由 tools/lalr_gen 根据 parser.cpp 中的文法注释生成，请勿手工修改
+ * （修改文法后运行 ./run_tests.sh lalr 重新生成）。
+ *
+ * 117 个状态，75 条规则，2 个移进/归约冲突（按移进解决），0 个归约/归约冲突
+ * 动作表：未压缩 4095 个单元，去掉默认归约后剩 246 项，压缩为 297 个单元
+ * 转移表：未压缩 4329 个单元，去掉默认转移后剩 34 项，压缩为 189 个单元
+ *
+ * 查表：动作 i = kLalrActionBase[s] + t，kLalrActionCheck[i] == s 时为 kLalrActionValue[i]
+ *      （正数移进到该状态，负数按规则 -v 归约，0 接受），否则按 kLalrDefaultReduce[s] 归约（0为出错）；
+ *      转移 i = kLalrGotoBase[A] + s，kLalrGotoCheck[i] == A 时为 kLalrGotoValue[i]，否则为 kLalrDefaultGoto[A]
+ *
+ * 规则：
+ *   0: <$accept> ::= <program>
+ *   1: <constant> ::= CONSTANT_INTEGER
+ *   2: <constant> ::= CONSTANT_DOUBLE
+ *   3: <program$1> ::= <function-definition>
+ *   4: <program$1> ::= <program$1> <function-definition>
+ *   5: <program> ::= <program$1>
+ *   6: <function-definition$2> ::= ε
+ *   7: <function-definition$2> ::= <parameter-list>
+ *   8: <function-definition> ::= <type-specifier> IDENTIFIER DELIMITER_OPEN_PARENTHESIS <function-definition$2> DELIMITER_CLOSE_PARENTHESIS <compound-statement>
+ *   9: <type-specifier> ::= KEYWORD_INT
+ *   10: <type-specifier> ::= KEYWORD_DOUBLE
+ *   11: <type-specifier> ::= KEYWORD_FLOAT
+ *   12: <parameter-list> ::= <parameter-declaration>
+ *   13: <parameter-list> ::= <parameter-list> DELIMITER_COMMA <parameter-declaration>
+ *   14: <parameter-declaration> ::= <type-specifier> IDENTIFIER
+ *   15: <compound-statement$3> ::= ε
+ *   16: <compound-statement$3> ::= <statement-list>
+ *   17: <compound-statement> ::= DELIMITER_BEGIN_BRACE <compound-statement$3> DELIMITER_END_BRACE
+ *   18: <statement-list> ::= <statement>
+ *   19: <statement-list> ::= <statement-list> <statement>
+ *   20: <statement> ::= <expression-statement>
+ *   21: <statement> ::= <compound-statement>
+ *   22: <statement> ::= <selection-statement>
+ *   23: <statement> ::= <iteration-statement>
+ *   24: <statement> ::= <return-statement>
+ *   25: <statement> ::= <variable-declaration>
+ *   26: <expression-statement$4> ::= ε
+ *   27: <expression-statement$4> ::= <expression>
+ *   28: <expression-statement> ::= <expression-statement$4> DELIMITER_SEMICOLON
+ *   29: <selection-statement$5> ::= KEYWORD_ELSE <statement>
+ *   30: <selection-statement$6> ::= ε
+ *   31: <selection-statement$6> ::= <selection-statement$5>
+ *   32: <selection-statement> ::= KEYWORD_IF DELIMITER_OPEN_PARENTHESIS <expression> DELIMITER_CLOSE_PARENTHESIS <statement> <selection-statement$6>
+ *   33: <selection-statement$7> ::= KEYWORD_ELSE <statement>
+ *   34: <selection-statement$8> ::= ε
+ *   35: <selection-statement$8> ::= <selection-statement$7>
+ *   36: <selection-statement> ::= KEYWORD_IF DELIMITER_OPEN_PARENTHESIS <expression> DELIMITER_CLOSE_PARENTHESIS KEYWORD_THEN <statement> <selection-statement$8>
+ *   37: <iteration-statement> ::= KEYWORD_WHILE DELIMITER_OPEN_PARENTHESIS <expression> DELIMITER_CLOSE_PARENTHESIS <statement>
+ *   38: <return-statement$9> ::= ε
+ *   39: <return-statement$9> ::= <expression>
+ *   40: <return-statement> ::= KEYWORD_RETURN <return-statement$9> DELIMITER_SEMICOLON
+ *   41: <variable-declaration$10> ::= OPERATOR_ASSIGN <logical-or-expression>
+ *   42: <variable-declaration$11> ::= ε
+ *   43: <variable-declaration$11> ::= <variable-declaration$10>
+ *   44: <variable-declaration> ::= <type-specifier> IDENTIFIER <variable-declaration$11> DELIMITER_SEMICOLON
+ *   45: <expression> ::= <assignment-expression>
+ *   46: <assignment-expression> ::= IDENTIFIER OPERATOR_ASSIGN <logical-or-expression>
+ *   47: <assignment-expression> ::= <logical-or-expression>
+ *   48: <logical-or-expression> ::= <logical-and-expression>
+ *   49: <logical-or-expression> ::= <logical-or-expression> OPERATOR_OR <logical-and-expression>
+ *   50: <logical-and-expression> ::= <equality-expression>
+ *   51: <logical-and-expression> ::= <logical-and-expression> OPERATOR_AND <equality-expression>
+ *   52: <equality-expression> ::= <relational-expression>
+ *   53: <equality-expression> ::= <equality-expression> OPERATOR_EQUAL <relational-expression>
+ *   54: <relational-expression> ::= <additive-expression>
+ *   55: <relational-expression> ::= <relational-expression> OPERATOR_LESS_THAN <additive-expression>
+ *   56: <relational-expression> ::= <relational-expression> OPERATOR_GREATER_THAN <additive-expression>
+ *   57: <relational-expression> ::= <relational-expression> OPERATOR_LESS_EQUAL <additive-expression>
+ *   58: <relational-expression> ::= <relational-expression> OPERATOR_GREATER_EQUAL <additive-expression>
+ *   59: <additive-expression> ::= <multiplicative-expression>
+ *   60: <additive-expression> ::= <additive-expression> OPERATOR_PLUS <multiplicative-expression>
+ *   61: <additive-expression> ::= <additive-expression> OPERATOR_MINUS <multiplicative-expression>
+ *   62: <additive-expression> ::= <additive-expression> OPERATOR_BITOR <multiplicative-expression>
+ *   63: <additive-expression> ::= <additive-expression> OPERATOR_BITAND <multiplicative-expression>
+ *   64: <multiplicative-expression> ::= <primary-expression>
+ *   65: <multiplicative-expression> ::= <multiplicative-expression> OPERATOR_MULTIPLY <primary-expression>
+ *   66: <multiplicative-expression> ::= <multiplicative-expression> OPERATOR_DIVIDE <primary-expression>
+ *   67: <primary-expression> ::= IDENTIFIER
+ *   68: <primary-expression> ::= <constant>
+ *   69: <primary-expression> ::= DELIMITER_OPEN_PARENTHESIS <expression> DELIMITER_CLOSE_PARENTHESIS
+ *   70: <primary-expression$12> ::= ε
+ *   71: <primary-expression$12> ::= <argument-list>
+ *   72: <primary-expression> ::= IDENTIFIER DELIMITER_OPEN_PARENTHESIS <primary-expression$12> DELIMITER_CLOSE_PARENTHESIS
+ *   73: <argument-list> ::= <expression>
+ *   74: <argument-list> ::= <argument-list> DELIMITER_COMMA <expression>
+ */
+
+static constexpr int kLalrStateCount = 117;
+static constexpr int kLalrTerminalCount = 35;
+static constexpr int kLalrNonterminalCount = 37;
+static constexpr int kLalrRuleCount = 75;
+
+// 规则左部的非终结符编号
+static constexpr int16_t kLalrRuleLhs[75] = {
+    0, 1, 1, 4, 4, 2, 7, 7, 3, 5, 5, 5, 6, 6, 9, 11,
+    11, 8, 10, 10, 12, 12, 12, 12, 12, 12, 19, 19, 13, 20, 21, 21,
+    14, 22, 23, 23, 14, 15, 24, 24, 16, 25, 27, 27, 17, 18, 28, 28,
+    26, 26, 29, 29, 30, 30, 31, 31, 31, 31, 31, 32, 32, 32, 32, 32,
+    33, 33, 33, 34, 34, 34, 36, 36, 34, 35, 35
+};
+
+// 规则右部的长度
+static constexpr uint8_t kLalrRuleLength[75] = {
+    1, 1, 1, 1, 2, 1, 0, 1, 6, 1, 1, 1, 1, 3, 2, 0,
+    1, 3, 1, 2, 1, 1, 1, 1, 1, 1, 0, 1, 2, 2, 0, 1,
+    6, 2, 0, 1, 7, 5, 0, 1, 3, 2, 0, 1, 4, 1, 3, 1,
+    1, 3, 1, 3, 1, 3, 1, 3, 3, 3, 3, 1, 3, 3, 3, 3,
+    1, 3, 3, 1, 1, 3, 0, 1, 4, 1, 3
+};
+
+// 各状态在动作表中的偏移
+static constexpr int32_t kLalrActionBase[117] = {
+    44, 26, 26, 26, 0, 26, 59, 3, 26, 30, 77, 32, 46, 62, 26, 26,
+    103, 83, 26, 25, 26, 99, 18, 101, 62, 26, 26, 41, 26, 117, 26, 36,
+    126, 26, 26, 26, 26, 26, 26, 26, 133, 152, 26, 160, 160, 149, 21, 79,
+    26, 66, 26, 148, 106, 155, 110, 139, 179, 26, 26, 26, 150, 154, 168, 171,
+    174, 185, 188, 191, 202, 205, 208, 219, 222, 169, 26, 171, 26, 173, 176, 26,
+    180, 186, 225, 26, 182, 198, 199, 242, 109, 254, 256, 262, 97, 123, 137, 141,
+    26, 26, 69, 80, 255, 26, 204, 26, 113, 221, 26, 26, 223, 124, 26, 26,
+    157, 26, 26, 26, 26
+};
+
+// 动作单元所属的状态
+static constexpr int16_t kLalrActionCheck[297] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 19, 19, 19, 19, 46, 46,
+    19, 19, 4, 46, 7, 31, 31, 31, 31, 22, 46, 31, 31, 0, 0, 0,
+    19, 22, 22, 22, 19, 9, 27, 19, 19, 19, 19, 31, 6, 6, 6, 31,
+    27, 11, 31, 31, 31, 31, 98, 98, 98, 98, 98, 12, 98, 98, 10, 10,
+    10, 99, 99, 99, 99, 24, 13, 99, 99, 49, 47, 47, 98, 24, 24, 24,
+    98, 49, 49, 49, 98, 98, 98, 99, 16, 16, 16, 99, 92, 92, 17, 99,
+    99, 99, 104, 104, 104, 104, 88, 88, 104, 104, 21, 88, 23, 109, 109, 109,
+    109, 52, 88, 109, 109, 54, 93, 93, 104, 52, 52, 52, 104, 54, 54, 54,
+    104, 104, 104, 109, 94, 94, 29, 109, 95, 95, 32, 109, 109, 109, 112, 112,
+    112, 112, 55, 40, 112, 112, 45, 45, 45, 45, 55, 55, 55, 60, 41, 43,
+    44, 61, 51, 53, 112, 60, 60, 60, 112, 61, 61, 61, 112, 112, 112, 62,
+    56, 73, 63, 75, 77, 64, 78, 62, 62, 62, 63, 63, 63, 64, 64, 64,
+    65, 80, 81, 66, 84, 85, 67, 86, 65, 65, 65, 66, 66, 66, 67, 67,
+    67, 68, 102, 105, 69, 108, -1, 70, -1, 68, 68, 68, 69, 69, 69, 70,
+    70, 70, 71, -1, -1, 72, -1, -1, 82, -1, 71, 71, 71, 72, 72, 72,
+    82, 82, 82, 87, 87, 87, 87, 89, 89, 90, 90, -1, 89, -1, 90, 91,
+    91, -1, -1, 89, 91, 90, 100, -1, -1, -1, -1, 91, -1, -1, 100, 100,
+    100, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+// 动作
+static constexpr int16_t kLalrActionValue[297] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 21, 67, 68,
+    22, 23, 0, 69, 9, 1, 2, 3, 21, 24, 70, 22, 23, 1, 2, 3,
+    24, 25, 26, 27, 19, 10, 54, -26, 25, 26, 27, 24, 1, 2, 3, 19,
+    55, 15, -26, 25, 26, 27, 1, 2, 3, 21, 104, 16, 22, 23, 1, 2,
+    3, 1, 2, 3, 21, 24, 17, 22, 23, 24, 71, 72, 24, 25, 26, 27,
+    19, 25, 26, 27, 25, 26, 27, 24, 1, 2, 3, 19, 71, 72, 19, 25,
+    26, 27, 1, 2, 3, 21, 67, 68, 22, 23, 49, 69, 52, 1, 2, 3,
+    21, 24, 70, 22, 23, 24, 71, 72, 24, 25, 26, 27, 19, 25, 26, 77,
+    25, 26, 27, 24, 71, 72, 56, 19, 71, 72, 58, 25, 26, 27, 1, 2,
+    3, 21, 24, 59, 22, 23, 63, 64, 65, 66, 25, 26, 27, 24, 60, 61,
+    62, 24, 74, 76, 24, 25, 26, 77, 19, 25, 26, 77, 25, 26, 27, 24,
+    82, 98, 24, 99, 55, 24, 60, 25, 26, 77, 25, 26, 77, 25, 26, 77,
+    24, 100, 101, 24, 103, 61, 24, 62, 25, 26, 77, 25, 26, 77, 25, 26,
+    77, 24, 60, 109, 24, 112, 0, 24, 0, 25, 26, 77, 25, 26, 77, 25,
+    26, 77, 24, 0, 0, 24, 0, 0, 24, 0, 25, 26, 77, 25, 26, 77,
+    25, 26, 77, 63, 64, 65, 66, 67, 68, 67, 68, 0, 69, 0, 69, 67,
+    68, 0, 0, 70, 69, 70, 24, 0, 0, 0, 0, 70, 0, 0, 25, 26,
+    27, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+// 各状态的默认归约规则
+static constexpr int16_t kLalrDefaultReduce[117] = {
+    0, 9, 10, 11, 0, 3, 5, 0, 4, 0, 6, 0, 7, 0, 12, 14,
+    0, 0, 13, 15, 8, 0, 38, 0, 0, 1, 2, 67, 68, 0, 21, 16,
+    0, 18, 20, 22, 23, 24, 25, 27, 0, 47, 45, 48, 50, 52, 54, 59,
+    64, 0, 39, 0, 0, 0, 0, 70, 42, 19, 17, 28, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 40, 0, 69, 67, 46, 73,
+    71, 0, 0, 43, 0, 49, 51, 53, 55, 57, 56, 58, 60, 61, 63, 62,
+    65, 66, 26, 26, 0, 72, 41, 44, 26, 30, 37, 74, 34, 26, 31, 32,
+    26, 35, 36, 29, 33
+};
+
+// 各非终结符在转移表中的偏移
+static constexpr int32_t kLalrGotoBase[37] = {
+    61, 61, 61, 72, 61, 63, 61, 61, 63, 65, 61, 61, 30, 61, 61, 61,
+    61, 61, 40, 61, 61, 61, 61, 61, 61, 61, 16, 61, 61, 22, 22, 22,
+    2, 7, 0, 61, 61
+};
+
+// 转移单元所属的非终结符
+static constexpr int16_t kLalrGotoCheck[189] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 12, 18, 5,
+    18, 32, 32, 32, 32, 5, 26, 34, 34, 5, 33, 33, 33, 33, 3, 5,
+    8, 9, 29, 30, 31, -1, -1, -1, -1, 18, -1, -1, 18, -1, -1, 18,
+    -1, -1, 26, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    12, 12, -1, -1, -1, -1, 12, -1, -1, -1, -1, 12, 18, -1, 12, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+// 转移目标状态
+static constexpr int16_t kLalrGotoValue[189] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 57, 50, 7,
+    53, 88, 89, 90, 91, 7, 78, 96, 97, 11, 92, 93, 94, 95, 8, 11,
+    20, 18, 85, 86, 87, 0, 0, 0, 0, 73, 0, 0, 75, 0, 0, 79,
+    0, 0, 102, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    105, 106, 0, 0, 0, 0, 108, 0, 0, 0, 0, 115, 107, 0, 116, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+// 各非终结符的默认转移目标
+static constexpr int16_t kLalrDefaultGoto[37] = {
+    0, 28, 4, 5, 6, 29, 12, 13, 30, 14, 31, 32, 33, 34, 35, 36,
+    37, 38, 39, 40, 110, 111, 113, 114, 51, 83, 41, 84, 42, 43, 44, 45,
+    46, 47, 48, 80, 81
+};
+
+// 非终结符名称
+static constexpr const char* kLalrNonterminalNames[37] = {
+    "$accept", "constant", "program", "function-definition",
+    "program$1", "type-specifier", "parameter-list", "function-definition$2",
+    "compound-statement", "parameter-declaration", "statement-list", "compound-statement$3",
+    "statement", "expression-statement", "selection-statement", "iteration-statement",
+    "return-statement", "variable-declaration", "expression", "expression-statement$4",
+    "selection-statement$5", "selection-statement$6", "selection-statement$7", "selection-statement$8",
+    "return-statement$9", "variable-declaration$10", "logical-or-expression", "variable-declaration$11",
+    "assignment-expression", "logical-and-expression", "equality-expression", "relational-expression",
+    "additive-expression", "multiplicative-expression", "primary-expression", "argument-list",
+    "primary-expression$12"
+};
+
+#endif /* LALR_TABLES_H */
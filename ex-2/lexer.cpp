@@ -5,13 +5,25 @@
 #include <vector>
 #include <algorithm>
 #include <cstdlib>
+#include <functional>
 
 /* 全局变量 */
-static FILE* g_fp = nullptr;              // 文件指针
-static int g_row = 1;                     // 当前行号
-static TokenAttr g_lastToken;             // 上一个Token（用于回退）
-static bool g_hasUnget = false;           // 是否有回退的Token
-static std::vector<ErrorInfo> g_errors;   // 错误信息列表
+// 分析状态按线程独立（thread_local），多个线程可以同时分析不同的文件
+static thread_local FILE* g_fp = nullptr;              // 文件指针
+static thread_local const char* g_buf = nullptr;       // 内存缓冲区（与g_fp二选一）
+static thread_local size_t g_bufLen = 0;               // 缓冲区长度
+static thread_local size_t g_bufPos = 0;               // 缓冲区读取位置
+static thread_local long g_ungetCount = 0;             // 回退Token的次数（统计用）
+static thread_local int g_row = 1;                     // 当前行号
+static thread_local TokenAttr g_lastToken;             // 上一个Token（用于回退）
+static thread_local bool g_hasUnget = false;           // 是否有回退的Token
+static thread_local std::vector<ErrorInfo> g_errors;   // 错误信息列表
+static thread_local bool g_echoErrors = true;          // 是否将错误回显到标准错误流（按线程设置）
+static thread_local std::ostream* g_echoStream = &std::cerr; // 错误回显的目标流
+static thread_local std::function<TokenAttr()> g_source; // 外部Token来源（流水线模式）
+static thread_local std::function<bool(const char*&, size_t&)> g_refill; // 输入补充函数（推送模式）
+static thread_local std::vector<TokenAttr>* g_tokenSink = nullptr; // 新扫描出的Token追加到此处
+static thread_local long g_scannedTokens = 0;          // 扫描出的Token数（不含回退后再次返回的）
 
 /* 关键字表 */
 static const int keyWordTokenNum = 8;
@@ -36,10 +48,53 @@ static const char numberNextPass[100] = {
 };
 
 /* INFO 符号表 */
-static std::map<TokenCode, int> tokenCodeMap;
-static std::map<std::string, int> constantsMap;
+static thread_local std::map<TokenCode, int> tokenCodeMap;
+static thread_local std::map<std::string, int> constantsMap;
 
 /* 辅助函数 */
+// 读取一个字符
+// 统一文件与内存缓冲区两种输入源，语义与fgetc一致
+static int refillChar();
+
+static inline int readChar() {
+    if (g_buf) {
+        if (g_bufPos < g_bufLen) {
+            return (unsigned char)g_buf[g_bufPos++];
+        }
+        return g_refill ? refillChar() : EOF;
+    }
+    return fgetc(g_fp);
+}
+
+// 缓冲区读完：向补充函数索取下一段输入，输入结束后不再调用
+// 回退只涉及最近读出的一个字符，因此切换缓冲区后不再需要旧的缓冲区
+static int refillChar() {
+    const char* data = nullptr;
+    size_t len = 0;
+    while (g_refill(data, len)) {
+        if (len > 0) {
+            g_buf = data;
+            g_bufLen = len;
+            g_bufPos = 1;
+            return (unsigned char)data[0];
+        }
+    }
+    g_refill = nullptr;
+    g_bufPos = g_bufLen;
+    return EOF;
+}
+
+// 回退一个字符
+// 与ungetc一致：回退EOF不产生任何效果
+static inline void unreadChar(int ch) {
+    if (ch == EOF) return;
+    if (g_buf) {
+        g_bufPos--;
+        return;
+    }
+    ungetc(ch, g_fp);
+}
+
 // 判断是否为字母
 static bool isLetter(char ch) {
     return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z');
@@ -78,7 +133,8 @@ static int tryGetKeyWordID(const std::string& token) {
 static void addError(const std::string& message) {
     ErrorInfo error = { g_row, message };
     g_errors.push_back(error);
-    std::cerr << "Error at line " << g_row << ": " << message << std::endl;
+    if (g_echoErrors)
+        *g_echoStream << "Error at line " << g_row << ": " << message << std::endl;
 }
 
 // 处理一个Token
@@ -95,16 +151,18 @@ static TokenAttr processToken() {
     
     // 跳过空白字符（空格、制表符、换行符等）
     while (true) {
-        ch = fgetc(g_fp);
+        ch = readChar();
         if (ch == EOF) {
             result.code = TK_EOF;
             result.value = "EOF";
+            result.startLine = g_row;
             return result;
         }
         
         if (ch == '#')  { // 特殊终止符
             result.code = TK_EOF;
             result.value = "#";
+            result.startLine = g_row;
             return result;
         }
         
@@ -115,18 +173,50 @@ static TokenAttr processToken() {
         
         if (ch == ' ' || ch == '\t' || ch == '\r')
             continue;
+        
+        // 单行注释：读取直到行尾，之后从新的位置重新开始识别
+        if (ch == '/') {
+            char next = readChar();
+            if (next != '/') {
+                unreadChar(next);
+                break;  // 不是注释，是除号
+            }
+            while ((ch = readChar()) != EOF && ch != '\n');
+            if (ch == '\n') {
+                g_row++; // 增加行号
+            }
+            result.line = g_row;
+            continue;
+        }
+        
+        // 跳过非ASCII字符（如中文），不报错
+        if (isNonAscii((unsigned char)ch)) {
+            // 读取此UTF-8字符的剩余字节
+            int byteCount = 0;
+            if ((ch & 0xE0) == 0xC0) byteCount = 1;      // 2字节字符
+            else if ((ch & 0xF0) == 0xE0) byteCount = 2; // 3字节字符
+            else if ((ch & 0xF8) == 0xF0) byteCount = 3; // 4字节字符
+            
+            // 跳过剩余字节
+            for (int i = 0; i < byteCount; i++) {
+                readChar();
+            }
+            result.line = g_row;
+            continue;
+        }
             
         break;  // 找到非空白字符，退出循环
     }
+    result.startLine = g_row;
     
     // 处理各种Token类型
     if (isLetter(ch)) {  // 标识符或关键字
         token = ch;
         // 读取标识符或关键字的剩余部分
         while (true) {
-            ch = fgetc(g_fp);
+            ch = readChar();
             if (!(isLetter(ch) || isdigit(ch))) {
-                ungetc(ch, g_fp);  // 回退一个字符
+                unreadChar(ch);  // 回退一个字符
                 break;
             }
             token += ch;
@@ -145,7 +235,7 @@ static TokenAttr processToken() {
         int dotCount = 0;
         
         while (true) {
-            ch = fgetc(g_fp);
+            ch = readChar();
             if (!(isdigit(ch) || ch == '.')) {
                 break;
             }
@@ -162,9 +252,9 @@ static TokenAttr processToken() {
             // 非法后缀，继续读取错误标记
             token += ch;
             while (true) {
-                ch = fgetc(g_fp);
+                ch = readChar();
                 if (!(isLetter(ch) || isdigit(ch))) {
-                    ungetc(ch, g_fp);
+                    unreadChar(ch);
                     break;
                 }
                 token += ch;
@@ -177,7 +267,7 @@ static TokenAttr processToken() {
             addError("Invalid number format (multiple decimal points): " + token);
         }
         else {
-            ungetc(ch, g_fp);  // 回退用于检查的字符
+            unreadChar(ch);  // 回退用于检查的字符
             code = (dotCount == 1) ? TK_DOUBLE : TK_INT;  // 有小数点是浮点数，否则是整数
         }
     }
@@ -188,14 +278,14 @@ static TokenAttr processToken() {
             case '+': code = TK_PLUS; break;
             case '-': 
                 // 检查是否为负数（如-10）或减号运算符
-                ch = fgetc(g_fp);
+                ch = readChar();
                 if (isdigit(ch)) {
                     // 处理负数
                     token += ch;  // 添加数字到token
                     int dotCount = 0;
                     
                     while (true) {
-                        ch = fgetc(g_fp);
+                        ch = readChar();
                         if (!(isdigit(ch) || ch == '.')) {
                             break;
                         }
@@ -212,9 +302,9 @@ static TokenAttr processToken() {
                         // 非法后缀，继续读取错误标记
                         token += ch;
                         while (true) {
-                            ch = fgetc(g_fp);
+                            ch = readChar();
                             if (!(isLetter(ch) || isdigit(ch))) {
-                                ungetc(ch, g_fp);
+                                unreadChar(ch);
                                 break;
                             }
                             token += ch;
@@ -227,34 +317,17 @@ static TokenAttr processToken() {
                         addError("Invalid number format (multiple decimal points): " + token);
                     }
                     else {
-                        ungetc(ch, g_fp);  // 回退用于检查的字符
+                        unreadChar(ch);  // 回退用于检查的字符
                         code = (dotCount == 1) ? TK_DOUBLE : TK_INT;  // 有小数点是浮点数，否则是整数
                     }
                 } else {
                     // 不是负数，是减号运算符
-                    ungetc(ch, g_fp);
+                    unreadChar(ch);
                     code = TK_MINUS;
                 }
                 break;
             case '*': code = TK_STAR; break;
-            case '/': {
-                // 检查是否为注释
-                ch = fgetc(g_fp);
-                if (ch == '/') {
-                    // 处理单行注释，读取直到行尾
-                    while ((ch = fgetc(g_fp)) != EOF && ch != '\n');
-                    if (ch == '\n') {
-                        g_row++; // 增加行号
-                    }
-                    // 递归调用以获取下一个真正的token
-                    return processToken();
-                } else {
-                    // 不是注释，回退字符
-                    ungetc(ch, g_fp);
-                    code = TK_DIVIDE;
-                }
-                break;
-            }
+            case '/': code = TK_DIVIDE; break;  // 注释已在跳过空白时处理
             // 处理各种分隔符
             case '(': code = TK_OPENPA; break;
             case ')': code = TK_CLOSEPA; break;
@@ -266,85 +339,68 @@ static TokenAttr processToken() {
             case ';': code = TK_SEMOCOLOM; break;
             
             case '=': {  // 处理 = 或 ==
-                ch = fgetc(g_fp);
+                ch = readChar();
                 if (ch == '=') {
                     token += ch;
                     code = TK_EQ;  // 等于运算符 ==
                 } else {
-                    ungetc(ch, g_fp);
+                    unreadChar(ch);
                     code = TK_ASSIGN;  // 赋值运算符 =
                 }
                 break;
             }
             
             case '<': {  // 处理 < 或 <=
-                ch = fgetc(g_fp);
+                ch = readChar();
                 if (ch == '=') {
                     token += ch;
                     code = TK_LEQ;  // 小于等于运算符 <=
                 } else {
-                    ungetc(ch, g_fp);
+                    unreadChar(ch);
                     code = TK_LT;  // 小于运算符 <
                 }
                 break;
             }
             
             case '>': {  // 处理 > 或 >=
-                ch = fgetc(g_fp);
+                ch = readChar();
                 if (ch == '=') {
                     token += ch;
                     code = TK_GEQ;  // 大于等于运算符 >=
                 } else {
-                    ungetc(ch, g_fp);
+                    unreadChar(ch);
                     code = TK_GT;  // 大于运算符 >
                 }
                 break;
             }
             
             case '&': {  // 处理 &&
-                ch = fgetc(g_fp);
+                ch = readChar();
                 if (ch == '&') {
                     token += ch;
                     code = TK_AND;  // 逻辑与运算符 &&
                 } else {
-                    ungetc(ch, g_fp);
+                    unreadChar(ch);
                     code = TK_BITAND;
                 }
                 break;
             }
             
             case '|': {  // 处理 ||
-                ch = fgetc(g_fp);
+                ch = readChar();
                 if (ch == '|') {
                     token += ch;
                     code = TK_OR;  // 逻辑或运算符 ||
                 } else {
-                    ungetc(ch, g_fp);
+                    unreadChar(ch);
                     code = TK_BITOR;
                 }
                 break;
             }
             
             default: 
-                if (isNonAscii((unsigned char)ch)) {
-                    // 跳过非ASCII字符（如中文），不报错
-                    // 读取此UTF-8字符的剩余字节
-                    int byteCount = 0;
-                    if ((ch & 0xE0) == 0xC0) byteCount = 1;      // 2字节字符
-                    else if ((ch & 0xF0) == 0xE0) byteCount = 2; // 3字节字符
-                    else if ((ch & 0xF8) == 0xF0) byteCount = 3; // 4字节字符
-                    
-                    // 跳过剩余字节
-                    for (int i = 0; i < byteCount; i++) {
-                        fgetc(g_fp);
-                    }
-                    
-                    // 递归调用以获取下一个真正的token
-                    return processToken();
-                } else {
-                    code = TK_UNDEF;
-                    addError("Unknown symbol: " + token);
-                }
+                code = TK_UNDEF;
+                addError("Unknown symbol: " + token);
                 break;
         }
     }
@@ -372,16 +428,74 @@ static TokenAttr processToken() {
 }
 
 /* 接口实现 */
+// 输出TokenCode对应的字符串描述
+std::string getTokenName(TokenCode code) {
+    switch (code) {
+        case TK_UNDEF: return "UNDEFINED";
+        case KW_INT: return "KEYWORD_INT";
+        case KW_DOUBLE: return "KEYWORD_DOUBLE";
+        case KW_FLOAT: return "KEYWORD_FLOAT";
+        case KW_IF: return "KEYWORD_IF";
+        case KW_THEN: return "KEYWORD_THEN";
+        case KW_ELSE: return "KEYWORD_ELSE";
+        case KW_RETURN: return "KEYWORD_RETURN";
+        case KW_WHILE: return "KEYWORD_WHILE";
+        case TK_PLUS: return "OPERATOR_PLUS";
+        case TK_MINUS: return "OPERATOR_MINUS";
+        case TK_STAR: return "OPERATOR_MULTIPLY";
+        case TK_DIVIDE: return "OPERATOR_DIVIDE";
+        case TK_ASSIGN: return "OPERATOR_ASSIGN";
+        case TK_EQ: return "OPERATOR_EQUAL";
+        case TK_BITOR: return "OPERATOR_BITOR";
+        case TK_BITAND: return "OPERATOR_BITAND";
+        case TK_AND: return "OPERATOR_AND";
+        case TK_OR: return "OPERATOR_OR";
+        case TK_LT: return "OPERATOR_LESS_THAN";
+        case TK_LEQ: return "OPERATOR_LESS_EQUAL";
+        case TK_GT: return "OPERATOR_GREATER_THAN";
+        case TK_GEQ: return "OPERATOR_GREATER_EQUAL";
+        case TK_OPENPA: return "DELIMITER_OPEN_PARENTHESIS";
+        case TK_CLOSEPA: return "DELIMITER_CLOSE_PARENTHESIS";
+        case TK_OPENBR: return "DELIMITER_OPEN_BRACKET";
+        case TK_CLOSEBR: return "DELIMITER_CLOSE_BRACKET";
+        case TK_BEGIN: return "DELIMITER_BEGIN_BRACE";
+        case TK_END: return "DELIMITER_END_BRACE";
+        case TK_COMMA: return "DELIMITER_COMMA";
+        case TK_SEMOCOLOM: return "DELIMITER_SEMICOLON";
+        case TK_INT: return "CONSTANT_INTEGER";
+        case TK_DOUBLE: return "CONSTANT_DOUBLE";
+        case TK_IDENT: return "IDENTIFIER";
+        case TK_EOF: return "END_OF_FILE";
+        default: return "UNKNOWN";
+    }
+}
+
 // 初始化词法分析器
 void initLexer(FILE* fp) {
     g_fp = fp;
+    g_buf = nullptr;
+    g_bufLen = 0;
+    g_bufPos = 0;
     g_row = 1;
     g_hasUnget = false;
+    g_ungetCount = 0;
     g_errors.clear();
+    g_source = nullptr;
+    g_refill = nullptr;
+    g_tokenSink = nullptr;
+    g_scannedTokens = 0;
     tokenCodeMap.clear();
     constantsMap.clear();
 }
 
+// 以内存缓冲区初始化词法分析器
+// 缓冲区由调用者持有，在分析结束前必须保持有效
+void initLexerBuffer(const char* data, size_t len) {
+    initLexer(nullptr);
+    g_buf = data ? data : "";
+    g_bufLen = data ? len : 0;
+}
+
 // 获取下一个Token
 // 如果有回退的Token，则直接返回；否则处理并返回新的Token
 TokenAttr getNextToken() {
@@ -390,14 +504,56 @@ TokenAttr getNextToken() {
         return g_lastToken;
     }
     
+    if (g_source) {
+        g_lastToken = g_source();
+        return g_lastToken;
+    }
+    
     g_lastToken = processToken();
+    g_scannedTokens++;
+    if (g_tokenSink) {
+        g_tokenSink->push_back(g_lastToken);
+    }
     return g_lastToken;
 }
 
+// 设置外部Token来源
+void setTokenSource(std::function<TokenAttr()> source) {
+    g_source = source;
+}
+
+// 设置输入补充函数
+void setLexerRefill(std::function<bool(const char*&, size_t&)> refill) {
+    g_refill = refill;
+}
+
+// 设置Token收集位置
+void setTokenSink(std::vector<TokenAttr>* sink) {
+    g_tokenSink = sink;
+}
+
+// 获取自初始化以来扫描出的Token数
+long getScannedTokenCount() {
+    return g_scannedTokens;
+}
+
+// 记录由外部Token来源转交的词法错误
+void recordLexError(const ErrorInfo& error) {
+    g_errors.push_back(error);
+    if (g_echoErrors)
+        *g_echoStream << "Error at line " << error.line << ": " << error.message << std::endl;
+}
+
 // 回退一个Token
 // 标记有回退的Token，下次调用getNextToken时将返回此Token
 void ungetToken() {
     g_hasUnget = true;
+    g_ungetCount++;
+}
+
+// 获取自初始化以来的回退次数
+long getUngetCount() {
+    return g_ungetCount;
 }
 
 // 获取当前行号
@@ -413,15 +569,43 @@ const std::vector<ErrorInfo>& getErrors() {
 // 重置词法分析器
 // 将文件指针重置到文件开头，重新开始词法分析
 void resetLexer() {
-    if (g_fp) {
+    if (g_buf) {
+        g_bufPos = 0;
+        g_row = 1;
+        g_hasUnget = false;
+    } else if (g_fp) {
         rewind(g_fp);
         g_row = 1;
         g_hasUnget = false;
     }
 }
 
+// 设置是否将词法错误回显到标准错误流
+void setLexerErrorEcho(bool echo) {
+    g_echoErrors = echo;
+}
+
+bool getLexerErrorEcho() {
+    return g_echoErrors;
+}
+
+// 设置错误回显的目标流（nullptr恢复为标准错误流）
+void setLexerErrorStream(std::ostream* stream) {
+    g_echoStream = stream ? stream : &std::cerr;
+}
+
+std::ostream& getLexerErrorStream() {
+    return *g_echoStream;
+}
+
 // 关闭词法分析器
 void closeLexer() {
     g_fp = nullptr;
+    g_buf = nullptr;
+    g_bufLen = 0;
+    g_bufPos = 0;
     g_hasUnget = false;
+    g_source = nullptr;
+    g_refill = nullptr;
+    g_tokenSink = nullptr;
 }
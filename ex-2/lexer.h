@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 #include <cstdio>
+#include <functional>
+#include <iosfwd>
 
 /* 单词编码 */
 enum TokenCode
@@ -61,7 +63,8 @@ enum TableTypeId {
 /* Token属性结构体 */
 struct TokenAttr {
     TokenCode code;      // Token类型
-    int line;            // 行号
+    int line;            // 行号（行首的Token为前一个Token所在的行，tokens.txt 与语法错误使用）
+    int startLine;       // Token首字符所在的行号（跳过空白与注释之后，语法树使用）
     TableTypeId type;    // 符号表类型
     int table_row;       // 符号表行号
     std::string value;   // Token的值
@@ -78,12 +81,18 @@ struct ErrorInfo {
 // 初始化词法分析器
 void initLexer(FILE* fp);
 
+// 以内存缓冲区初始化词法分析器（不经过文件系统）
+void initLexerBuffer(const char* data, size_t len);
+
 // 获取下一个Token
 TokenAttr getNextToken();
 
 // 回退一个Token（用于预读）
 void ungetToken();
 
+// 获取自初始化以来ungetToken的调用次数
+long getUngetCount();
+
 // 获取当前行号
 int getCurrentLine();
 
@@ -96,6 +105,32 @@ void resetLexer();
 // 关闭词法分析器
 void closeLexer();
 
+// 设置/查询当前线程是否将错误回显到标准错误流（默认开启）
+void setLexerErrorEcho(bool echo);
+bool getLexerErrorEcho();
+
+// 设置/获取当前线程错误回显的目标流（默认std::cerr，nullptr恢复默认）
+void setLexerErrorStream(std::ostream* stream);
+std::ostream& getLexerErrorStream();
+
+// 设置当前线程的外部Token来源：设置后getNextToken从source取Token而不扫描输入，
+// 传入nullptr恢复；初始化或关闭词法分析器时自动清除（流水线模式使用）
+void setTokenSource(std::function<TokenAttr()> source);
+
+// 设置当前线程的输入补充函数（推送模式）：以缓冲区初始化后，缓冲区读完时调用refill，
+// 返回true时由data/len给出下一段输入，返回false表示输入结束；初始化或关闭词法分析器时自动清除
+void setLexerRefill(std::function<bool(const char*& data, size_t& len)> refill);
+
+// 设置当前线程的Token收集位置：每个新扫描出的Token（不含回退后再次返回的）追加到sink，
+// 传入nullptr停止收集；初始化或关闭词法分析器时自动清除，须在初始化之后设置
+void setTokenSink(std::vector<TokenAttr>* sink);
+
+// 获取自初始化以来扫描出的Token数（不含回退后再次返回的）
+long getScannedTokenCount();
+
+// 记录一条由外部Token来源转交的词法错误（按当前线程的回显设置输出）
+void recordLexError(const ErrorInfo& error);
+
 std::string getTokenName(TokenCode code);
 
 #endif /* LEXER_H */ 
\ No newline at end of file
@@ -0,0 +1,352 @@
+#include "lsp.h"
+#include "json.h"
+#include "lexer.h"
+#include "parser.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <deque>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <poll.h>
+#include <unistd.h>
+
+/*
+ * LSP服务
+ * ===========================
+ * 打开的文档保存在内存中，didChange 只记录最新文本与修改时间；
+ * 文档静默 debounce 毫秒后才重新词法/语法分析并发布诊断。
+ * 分析前若标准输入上已有新消息，先处理新消息，因此连续输入时
+ * 过期版本的全文件分析永远不会被执行。
+ */
+
+typedef std::chrono::steady_clock Clock;
+
+/* 打开的文档 */
+struct Document {
+    std::string text;                       // 最新文本
+    int version = 0;                        // 客户端版本号
+    bool dirty = false;                     // 是否有未分析的修改
+    Clock::time_point changedAt;            // 最近一次修改时间
+    std::vector<FunctionInfo> functions;    // 最近一次分析得到的函数定义
+};
+
+static std::map<std::string, Document> g_documents;
+static std::string g_input;           // 标准输入缓冲区
+static bool g_inputClosed = false;    // 标准输入是否已关闭
+static bool g_shutdown = false;       // 是否已收到shutdown请求
+static int g_debounceMs = 150;
+
+/* INFO 消息收发 */
+
+// 写出一条LSP消息
+static void sendMessage(const std::string& body) {
+    std::string header = "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+    fwrite(header.data(), 1, header.size(), stdout);
+    fwrite(body.data(), 1, body.size(), stdout);
+    fflush(stdout);
+}
+
+static void sendResult(const JsonValue& id, const std::string& resultJson) {
+    sendMessage("{\"jsonrpc\":\"2.0\",\"id\":" + toJson(id) + ",\"result\":" + resultJson + "}");
+}
+
+static void sendError(const JsonValue& id, int code, const std::string& message) {
+    std::string body = "{\"jsonrpc\":\"2.0\",\"id\":" + toJson(id) + ",\"error\":{\"code\":" +
+                       std::to_string(code) + ",\"message\":";
+    appendJsonString(body, message);
+    body += "}}";
+    sendMessage(body);
+}
+
+// 从标准输入读取当前可用的数据，timeoutMs 为等待时间（-1表示一直等待）
+// 返回是否读到了新数据
+static bool pumpInput(int timeoutMs) {
+    if (g_inputClosed) return false;
+    pollfd pfd = { STDIN_FILENO, POLLIN, 0 };
+    int ready = poll(&pfd, 1, timeoutMs);
+    if (ready <= 0) return false;
+
+    char buf[65536];
+    ssize_t n = read(STDIN_FILENO, buf, sizeof(buf));
+    if (n < 0 && errno == EINTR) return false;
+    if (n <= 0) {
+        g_inputClosed = true;
+        return false;
+    }
+    g_input.append(buf, (size_t)n);
+    return true;
+}
+
+// 从输入缓冲区中取出一条完整消息
+static bool takeMessage(std::string& body) {
+    size_t headerEnd = g_input.find("\r\n\r\n");
+    if (headerEnd == std::string::npos) return false;
+
+    size_t length = 0;
+    size_t pos = 0;
+    while (pos < headerEnd) {
+        size_t eol = g_input.find("\r\n", pos);
+        std::string line = g_input.substr(pos, eol - pos);
+        if (line.compare(0, 15, "Content-Length:") == 0) {
+            length = (size_t)strtoul(line.c_str() + 15, nullptr, 10);
+        }
+        pos = eol + 2;
+    }
+    if (g_input.size() < headerEnd + 4 + length) return false;
+
+    body = g_input.substr(headerEnd + 4, length);
+    g_input.erase(0, headerEnd + 4 + length);
+    return true;
+}
+
+/* INFO 分析与诊断 */
+
+// 计算一行文本的UTF-16长度（LSP的列以UTF-16代码单元计）
+static int utf16Length(const std::string& text, size_t begin, size_t end) {
+    int length = 0;
+    for (size_t i = begin; i < end; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if ((c & 0xC0) == 0x80) continue;  // 续字节
+        length += ((c & 0xF8) == 0xF0) ? 2 : 1;
+    }
+    return length;
+}
+
+// 获取第line行（从0开始）的UTF-16长度
+static int lineLength(const std::string& text, int line) {
+    size_t begin = 0;
+    for (int i = 0; i < line; i++) {
+        begin = text.find('\n', begin);
+        if (begin == std::string::npos) return 0;
+        begin++;
+    }
+    size_t end = text.find('\n', begin);
+    if (end == std::string::npos) end = text.size();
+    if (end > begin && text[end - 1] == '\r') end--;
+    return utf16Length(text, begin, end);
+}
+
+// 生成覆盖整行的range
+static std::string lineRange(const std::string& text, int startLine, int endLine) {
+    if (startLine < 0) startLine = 0;
+    if (endLine < startLine) endLine = startLine;
+    return "{\"start\":{\"line\":" + std::to_string(startLine) + ",\"character\":0},"
+           "\"end\":{\"line\":" + std::to_string(endLine) + ",\"character\":" +
+           std::to_string(lineLength(text, endLine)) + "}}";
+}
+
+static void appendDiagnostic(std::string& out, const std::string& text, int line,
+                             const char* code, const std::string& message) {
+    if (out.back() != '[') out += ',';
+    out += "{\"range\":" + lineRange(text, line - 1, line - 1) +
+           ",\"severity\":1,\"source\":\"mini\",\"code\":\"" + code + "\",\"message\":";
+    appendJsonString(out, message);
+    out += '}';
+}
+
+// 分析文档并发布诊断
+static void analyzeDocument(const std::string& uri, Document& doc) {
+    initParserBuffer(doc.text.data(), doc.text.size());
+    parse();
+    doc.functions = getParsedFunctions();
+    doc.dirty = false;
+
+    std::string body = "{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/publishDiagnostics\",\"params\":{\"uri\":";
+    appendJsonString(body, uri);
+    body += ",\"version\":" + std::to_string(doc.version) + ",\"diagnostics\":[";
+    for (const auto& error : getErrors()) {
+        appendDiagnostic(body, doc.text, error.line, "lex", error.message);
+    }
+    for (const auto& error : getParserErrors()) {
+        appendDiagnostic(body, doc.text, error.line, "syntax", error.message);
+    }
+    body += "]}}";
+    closeParser();
+    sendMessage(body);
+}
+
+/* INFO 请求处理 */
+
+static const char* typeName(TokenCode code) {
+    switch (code) {
+        case KW_INT: return "int";
+        case KW_DOUBLE: return "double";
+        case KW_FLOAT: return "float";
+        default: return "?";
+    }
+}
+
+// textDocument/documentSymbol：以函数定义作为文档符号
+static std::string documentSymbols(const Document& doc) {
+    std::string out = "[";
+    for (const auto& fn : doc.functions) {
+        if (out.size() > 1) out += ',';
+        std::string detail = std::string(typeName(fn.returnType)) + " (";
+        for (size_t i = 0; i < fn.params.size(); i++) {
+            if (i) detail += ", ";
+            detail += std::string(typeName(fn.params[i].type)) + " " + fn.params[i].name;
+        }
+        detail += ")";
+        out += "{\"name\":";
+        appendJsonString(out, fn.name);
+        out += ",\"detail\":";
+        appendJsonString(out, detail);
+        out += ",\"kind\":12,\"range\":" + lineRange(doc.text, fn.line - 1, fn.endLine - 1) +
+               ",\"selectionRange\":" + lineRange(doc.text, fn.line - 1, fn.line - 1) + "}";
+    }
+    out += "]";
+    return out;
+}
+
+static std::string documentUri(const JsonValue* params) {
+    const JsonValue* td = params ? params->get("textDocument") : nullptr;
+    return td ? td->getString("uri") : "";
+}
+
+// 处理一条消息；返回false表示应退出
+static bool handleMessage(const JsonValue& msg, const std::set<std::string>& cancelled, int& exitCode) {
+    std::string method = msg.getString("method");
+    const JsonValue* id = msg.get("id");
+    const JsonValue* params = msg.get("params");
+
+    if (id && cancelled.count(toJson(*id))) {
+        sendError(*id, -32800, "请求已取消");
+        return true;
+    }
+
+    // 需要响应的请求必须带 id：缺少时按 JSON-RPC 以 null 为 id 回复 InvalidRequest，不执行
+    if (!id && (method == "initialize" || method == "shutdown" || method == "textDocument/documentSymbol")) {
+        sendError(JsonValue(), -32600, "请求缺少 id: " + method);
+        return true;
+    }
+
+    if (method == "initialize") {
+        sendResult(*id, "{\"capabilities\":{\"textDocumentSync\":{\"openClose\":true,\"change\":1},"
+                        "\"documentSymbolProvider\":true},"
+                        "\"serverInfo\":{\"name\":\"mini-compiler\",\"version\":\"1.0\"}}");
+    } else if (method == "textDocument/didOpen") {
+        const JsonValue* td = params ? params->get("textDocument") : nullptr;
+        if (td) {
+            Document& doc = g_documents[td->getString("uri")];
+            doc.text = td->getString("text");
+            doc.version = (int)td->getNumber("version");
+            doc.dirty = true;
+            doc.changedAt = Clock::now() - std::chrono::milliseconds(g_debounceMs);  // 打开时立即分析
+        }
+    } else if (method == "textDocument/didChange") {
+        auto it = g_documents.find(documentUri(params));
+        const JsonValue* changes = params ? params->get("contentChanges") : nullptr;
+        if (it != g_documents.end() && changes && changes->type == JSON_ARRAY && !changes->items.empty()) {
+            // 全量同步：最后一次变更即为完整文本
+            it->second.text = changes->items.back().getString("text");
+            const JsonValue* td = params->get("textDocument");
+            it->second.version = (int)td->getNumber("version", it->second.version + 1);
+            it->second.dirty = true;
+            it->second.changedAt = Clock::now();
+        }
+    } else if (method == "textDocument/didClose") {
+        std::string uri = documentUri(params);
+        g_documents.erase(uri);
+        std::string body = "{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/publishDiagnostics\",\"params\":{\"uri\":";
+        appendJsonString(body, uri);
+        body += ",\"diagnostics\":[]}}";
+        sendMessage(body);
+    } else if (method == "textDocument/documentSymbol") {
+        auto it = g_documents.find(documentUri(params));
+        if (it == g_documents.end()) {
+            sendResult(*id, "[]");
+        } else {
+            if (it->second.dirty) {
+                analyzeDocument(it->first, it->second);  // 符号须反映最新文本
+            }
+            sendResult(*id, documentSymbols(it->second));
+        }
+    } else if (method == "shutdown") {
+        g_shutdown = true;
+        sendResult(*id, "null");
+    } else if (method == "exit") {
+        exitCode = g_shutdown ? 0 : 1;
+        return false;
+    } else if (id && !method.empty()) {
+        sendError(*id, -32601, "未支持的方法: " + method);
+    }
+    // 其他通知（initialized、$/cancelRequest等）无需响应
+    return true;
+}
+
+// 处理输入缓冲区中所有完整消息
+// 先收集同一批中的取消请求，使被取消的请求不再执行
+static bool drainMessages(int& exitCode) {
+    std::deque<std::pair<bool, JsonValue>> batch;  // （消息体是否为合法JSON，消息）
+    std::string body;
+    while (takeMessage(body)) {
+        JsonValue msg;
+        bool valid = parseJson(body, msg);
+        batch.push_back({ valid, std::move(msg) });
+    }
+
+    std::set<std::string> cancelled;
+    for (const auto& entry : batch) {
+        if (entry.first && entry.second.getString("method") == "$/cancelRequest") {
+            const JsonValue* params = entry.second.get("params");
+            const JsonValue* id = params ? params->get("id") : nullptr;
+            if (id) cancelled.insert(toJson(*id));
+        }
+    }
+
+    for (const auto& entry : batch) {
+        // 消息体不是合法JSON时无法得知 id：按 JSON-RPC 以 null 为 id 回复 ParseError，按原顺序回复
+        if (!entry.first) {
+            sendError(JsonValue(), -32700, "消息体不是合法的JSON");
+            continue;
+        }
+        if (!handleMessage(entry.second, cancelled, exitCode)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* 接口实现 */
+int runLspServer(int debounceMs) {
+    g_debounceMs = debounceMs;
+    setParserErrorEcho(false);  // 标准输出为协议通道，诊断只通过消息发布
+    int exitCode = 1;
+
+    while (true) {
+        if (!drainMessages(exitCode)) {
+            return exitCode;
+        }
+        if (g_inputClosed) {
+            return exitCode;
+        }
+
+        // 计算最早到期的待分析文档
+        int timeoutMs = -1;
+        auto now = Clock::now();
+        for (auto& entry : g_documents) {
+            if (!entry.second.dirty) continue;
+            auto due = entry.second.changedAt + std::chrono::milliseconds(g_debounceMs);
+            int wait = (int)std::chrono::duration_cast<std::chrono::milliseconds>(due - now).count();
+            if (wait < 0) wait = 0;
+            if (timeoutMs < 0 || wait < timeoutMs) timeoutMs = wait;
+        }
+
+        if (pumpInput(timeoutMs)) {
+            continue;  // 有新消息：先处理，可能使待分析版本过期
+        }
+
+        // 静默期已过：逐个分析到期文档，每次分析前检查是否有新输入
+        now = Clock::now();
+        for (auto& entry : g_documents) {
+            Document& doc = entry.second;
+            if (!doc.dirty || now - doc.changedAt < std::chrono::milliseconds(g_debounceMs)) continue;
+            if (pumpInput(0)) break;
+            analyzeDocument(entry.first, doc);
+        }
+    }
+}
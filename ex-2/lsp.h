@@ -0,0 +1,11 @@
+#ifndef LSP_H
+#define LSP_H
+
+/* INFO 语言服务器（LSP）接口 */
+
+// 在标准输入/输出上运行LSP服务，直到收到exit通知
+// debounceMs 为文档修改后到重新分析之间的静默时间（毫秒）
+// 返回进程退出码
+int runLspServer(int debounceMs);
+
+#endif /* LSP_H */
@@ -1,158 +1,663 @@
 #include "lexer.h"
 #include "parser.h"
+#include "pipeline.h"
+#include "server.h"
+#include "lsp.h"
+#include "stats.h"
+#include "perf_counters.h"
+#include "trace.h"
+#include "alloc_stats.h"
+#include "output.h"
+#include "frame.h"
+#include "batch_io.h"
+#include "archive.h"
+#include "token_shm.h"
+#include "ast.h"
+#include "sema.h"
+#include "ir.h"
+#include "opt.h"
+#include "dataflow.h"
+#include "vm.h"
+#include "jit.h"
+#include "emitc.h"
 #include <iostream>
+#include <sstream>
 #include <string>
-#include <fstream>
-#include <sys/stat.h>
-#include <sys/types.h>
 #include <vector>
 #include <map>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
 
-// 符号表和常量表
-std::map<TokenCode, int> tokenCodeMap;
-std::map<std::string, int> constantsMap;
-std::vector<TokenAttr> tokenList;
+/* 运行统计输出格式 */
+enum StatsMode {
+    STATS_NONE,
+    STATS_TEXT,
+    STATS_JSON
+};
+
+/* 单个文件的分析选项 */
+struct AnalyzeOptions {
+    bool showProcess = true;   // 是否显示分析过程
+    bool lexOnly = false;      // 是否仅进行词法分析
+    bool pipeline = false;     // 词法与语法分析是否在两个线程中流水线执行
+    std::string exportShm;     // Token流共享内存段名，空表示不导出
+    bool shmPerFile = false;   // 多个输入时每个文件一个段：<段名>-<文件路径，'/'换为'_'>
+    bool semantic = false;     // 语法分析成功后是否进行语义分析
+    bool ir = false;           // 语义分析成功后是否生成中间代码（ir.txt）
+    int optLevel = 0;          // 中间代码的优化级别（-O1/-O2，0表示不优化）
+    bool run = false;          // 生成中间代码后编译为字节码并执行 main（bytecode.txt）
+    bool jit = false;          // 生成中间代码后编译为 x86-64 机器码并执行 main（jit.txt）
+    bool emitC = false;        // 语义分析成功后把程序翻译为 C 源码（program.c）
+    StatsMode statsMode = STATS_NONE;
+};
+
+/* 批量I/O模式下的单个文件：源文件由批量读取填入，结果文件由批量写出 */
+struct BatchFile {
+    ReadRequest source;                // 已读入的源文件
+    int dirError = 0;                  // 输出目录的创建结果（errno）
+    std::vector<OutputFile> outputs;   // 待写出的结果文件
+    std::string summary;               // 过程与摘要，写出完成后按输入顺序打印
+    bool opened = false;               // analyzeFile的返回值
+};
+
+/* 语法分析之后各阶段的附加结果 */
+struct ExtraResults {
+    std::vector<OutputFile> files;     // 附加的结果文件，写在输出目录中
+    std::string summary;               // 附加的摘要行
+};
+
+// 批量I/O模式下每批处理的文件数
+static const size_t kBatchFiles = 256;
+
+// 硬件计数器（仅在 --perf-counters 时打开，每个线程一份）
+static thread_local PerfCounters g_perf;
+static bool g_perfEnabled = false;
 
 // 函数声明
 void showUsage(const char* programName);
 
-// 输出TokenCode对应的字符串描述
-std::string getTokenName(TokenCode code) {
-    switch (code) {
-        case TK_UNDEF: return "UNDEFINED";
-        case KW_INT: return "KEYWORD_INT";
-        case KW_DOUBLE: return "KEYWORD_DOUBLE";
-        case KW_FLOAT: return "KEYWORD_FLOAT";
-        case KW_IF: return "KEYWORD_IF";
-        case KW_THEN: return "KEYWORD_THEN";
-        case KW_ELSE: return "KEYWORD_ELSE";
-        case KW_RETURN: return "KEYWORD_RETURN";
-        case KW_WHILE: return "KEYWORD_WHILE";
-        case TK_PLUS: return "OPERATOR_PLUS";
-        case TK_MINUS: return "OPERATOR_MINUS";
-        case TK_STAR: return "OPERATOR_MULTIPLY";
-        case TK_DIVIDE: return "OPERATOR_DIVIDE";
-        case TK_ASSIGN: return "OPERATOR_ASSIGN";
-        case TK_EQ: return "OPERATOR_EQUAL";
-        case TK_BITOR: return "OPERATOR_BITOR";
-        case TK_BITAND: return "OPERATOR_BITAND";
-        case TK_AND: return "OPERATOR_AND";
-        case TK_OR: return "OPERATOR_OR";
-        case TK_LT: return "OPERATOR_LESS_THAN";
-        case TK_LEQ: return "OPERATOR_LESS_EQUAL";
-        case TK_GT: return "OPERATOR_GREATER_THAN";
-        case TK_GEQ: return "OPERATOR_GREATER_EQUAL";
-        case TK_OPENPA: return "DELIMITER_OPEN_PARENTHESIS";
-        case TK_CLOSEPA: return "DELIMITER_CLOSE_PARENTHESIS";
-        case TK_OPENBR: return "DELIMITER_OPEN_BRACKET";
-        case TK_CLOSEBR: return "DELIMITER_CLOSE_BRACKET";
-        case TK_BEGIN: return "DELIMITER_BEGIN_BRACE";
-        case TK_END: return "DELIMITER_END_BRACE";
-        case TK_COMMA: return "DELIMITER_COMMA";
-        case TK_SEMOCOLOM: return "DELIMITER_SEMICOLON";
-        case TK_INT: return "CONSTANT_INTEGER";
-        case TK_DOUBLE: return "CONSTANT_DOUBLE";
-        case TK_IDENT: return "IDENTIFIER";
-        case TK_EOF: return "END_OF_FILE";
-        default: return "UNKNOWN";
+/* 阶段开始时刻 */
+struct PhaseStart {
+    PhaseClock clock;          // 统计用时间点
+    double traceUs;            // 追踪用时间点
+    AllocSnapshot allocs;      // 分配计数（启用 --alloc-stats 时）
+};
+
+// 开始一个阶段：记录时间点，启用时同时读取硬件计数器
+static PhaseStart beginPhase() {
+    PhaseStart start = {};
+    if (allocTrackingEnabled()) {
+        allocResetPeak();
+        start.allocs = allocSnapshot();
     }
+    if (g_perfEnabled) perfBegin(g_perf);
+    start.traceUs = traceEnabled() ? traceNowUs() : 0;
+    start.clock = phaseNow();
+    return start;
+}
+
+// 结束一个阶段：累加耗时与硬件计数，启用追踪时记录阶段跨度
+static void endPhase(RunStats& stats, StatsPhase phase, const PhaseStart& start) {
+    addPhase(stats, phase, start.clock);
+    if (g_perfEnabled) perfEnd(g_perf, phase);
+    if (allocTrackingEnabled()) addPhaseAllocs(stats, phase, start.allocs);
+    if (traceEnabled()) traceSpan("phase", kPhaseNames[phase], start.traceUs);
 }
 
 // 输出结果到文件
-void outputResults(const std::string& filename, bool lexOnly, bool parseSuccess = true, const std::vector<ParserError>& savedParseErrors = std::vector<ParserError>()) {
-    // 创建输出目录
+// 摘要写入out，多线程分析时为每个文件各自的缓冲区
+// batch非空时只生成结果文件的内容，由调用者批量写出（输出目录已预先创建）
+// 启用 --archive 时结果追加到归档，不创建输出目录
+void outputResults(const std::string& filename, const std::vector<TokenAttr>& tokenList, bool lexOnly, bool parseSuccess, const std::vector<ParserError>& savedParseErrors, const ExtraResults& extra, std::ostream& out, BatchFile* batch) {
+    // 写出结果文件
     std::string dirName = filename + "-output";
-    struct stat info;
-    
-    if (stat(dirName.c_str(), &info) != 0) { // 检查目录是否存在
-        if (mkdir(dirName.c_str(), 0777) == -1) {
+    const std::vector<ErrorInfo>& lexErrors = getErrors();
+    auto render = [&]() {
+        std::vector<OutputFile> files = renderOutputFiles(tokenList, lexErrors, lexOnly ? nullptr : &savedParseErrors);
+        files.insert(files.end(), extra.files.begin(), extra.files.end());
+        return files;
+    };
+    if (archiveEnabled()) {
+        if (!archiveAppend(filename, render())) {
+            std::cerr << "错误: 无法写入归档 " << archivePath() << std::endl;
+            return;
+        }
+        dirName = archivePath() + " (" + filename + ")";
+    } else if (batch != nullptr) {
+        if (batch->dirError == ENOTDIR) {
+            std::cerr << "错误: " << dirName << " 已存在但不是目录" << std::endl;
+            return;
+        } else if (batch->dirError != 0) {
             std::cerr << "错误: 无法创建目录 " << dirName << std::endl;
             return;
         }
-    } else if (!(info.st_mode & S_IFDIR)) { // 如果存在但不是目录
-        std::cerr << "错误: " << dirName << " 已存在但不是目录" << std::endl;
+        batch->outputs = render();
+    } else if (!writeOutputFiles(dirName, tokenList, lexErrors, lexOnly ? nullptr : &savedParseErrors, extra.files)) {
         return;
     }
     
-    // 输出Token列表
-    std::ofstream tokenFile(dirName + "/tokens.txt");
-    if (tokenFile.is_open()) {
-        tokenFile << "行号\t类型\t\t值\n";
-        tokenFile << "-------------------------------------\n";
-        
-        for (const auto& token : tokenList) {
-            tokenFile << token.line << "\t" 
-                     << getTokenName(token.code) << "\t" 
-                     << token.value << "\n";
+    // 简洁的摘要输出
+    out << "\n=== 分析完成 ===\n";
+    out << "文件: " << filename << "\n";
+    
+    if (lexOnly) {
+        out << "词法分析结果: " << (lexErrors.empty() ? "成功" : "有错误") << "\n";
+        out << "Token总数: " << tokenList.size() << "\n";
+        out << "词法错误总数: " << lexErrors.size() << "\n";
+    } else {
+        const std::vector<ParserError>& parseErrors = savedParseErrors;
+        out << "词法分析结果: " << (lexErrors.empty() ? "成功" : "有错误") << "\n";
+        out << "语法分析结果: " << (parseSuccess ? "成功" : "有错误") << "\n";
+        out << "Token总数: " << tokenList.size() << "\n";
+        out << "词法错误总数: " << lexErrors.size() << "\n";
+        out << "语法错误总数: " << parseErrors.size() << "\n";
+    }
+    out << extra.summary;
+    
+    out << "结果已输出到: " << dirName << "\n";
+}
+
+
+// 把中间代码编译为字节码并执行 main；字节码写入 bytecode.txt，结果加入摘要
+static void runProgram(const IrModule& module, RunStats& stats, ExtraResults& extra) {
+    PhaseStart clock = beginPhase();
+    VmProgram bytecode;
+    compileBytecode(module, bytecode);
+    extra.files.push_back({ "bytecode.txt", dumpBytecode(bytecode) });
+    stats.bytecodeInsts = bytecode.code.size();
+    uint32_t entry = vmFindFunction(bytecode, "main");
+    if (entry == UINT32_MAX) {
+        endPhase(stats, PHASE_RUN, clock);
+        extra.summary += "运行: 未执行（没有 main 函数）\n";
+        return;
+    }
+    VmMachine machine;
+    VmResult result;
+    PhaseClock start = phaseNow();
+    bool ok = vmRun(bytecode, machine, entry, result);
+    double seconds = phaseNow().wall - start.wall;
+    endPhase(stats, PHASE_RUN, clock);
+    stats.ran = true;
+    stats.executedInsts = result.instructions;
+    stats.runSeconds = seconds;
+    if (ok) {
+        stats.runResult = vmValueText(result.type, result.value);
+        extra.summary += "运行: main 返回 " + stats.runResult + "（执行 " + std::to_string(result.instructions) +
+                         " 条字节码指令）\n";
+    } else {
+        stats.runResult = "运行时错误（第 " + std::to_string(result.errorLine) + " 行）: " + result.error;
+        extra.summary += "运行: " + stats.runResult + "（已执行 " + std::to_string(result.instructions) +
+                         " 条字节码指令）\n";
+    }
+}
+
+// 把中间代码编译为 x86-64 机器码并执行 main；寄存器分配写入 jit.txt，结果加入摘要。
+// 同时用 --run 执行过字节码时比较两者的结果
+static void jitProgram(const IrModule& module, RunStats& stats, ExtraResults& extra) {
+    PhaseStart clock = beginPhase();
+    JitProgram program;
+    std::string error;
+    PhaseClock start = phaseNow();
+    bool compiled = compileJit(module, program, error);
+    stats.jitCompileSeconds = phaseNow().wall - start.wall;
+    if (!compiled) {
+        endPhase(stats, PHASE_RUN, clock);
+        extra.summary += "JIT: 未执行（" + error + "）\n";
+        return;
+    }
+    extra.files.push_back({ "jit.txt", dumpJit(program) });
+    stats.jitBytes = program.codeSize;
+    uint32_t entry = jitFindFunction(program, "main");
+    if (entry == UINT32_MAX) {
+        endPhase(stats, PHASE_RUN, clock);
+        extra.summary += "JIT: 未执行（没有 main 函数）\n";
+        return;
+    }
+    VmResult result;
+    start = phaseNow();
+    bool ok = jitRun(program, entry, result);
+    stats.jitSeconds = phaseNow().wall - start.wall;
+    endPhase(stats, PHASE_RUN, clock);
+    stats.jitRan = true;
+    if (ok) {
+        stats.jitResult = vmValueText(result.type, result.value);
+        extra.summary += "JIT: main 返回 " + stats.jitResult + "（机器码 " + std::to_string(program.codeSize) +
+                         " 字节）\n";
+    } else {
+        stats.jitResult = "运行时错误（第 " + std::to_string(result.errorLine) + " 行）: " + result.error;
+        extra.summary += "JIT: " + stats.jitResult + "\n";
+    }
+    if (stats.ran && stats.jitResult != stats.runResult) {
+        extra.summary += "JIT: 结果与字节码虚拟机不同\n";
+    }
+}
+
+// 把语法树翻译为 C 源码，写入 program.c；#line 指向源文件 filename
+static void emitProgramC(const AstProgram& program, const SemaResult& sema, const std::string& filename,
+                         RunStats& stats, ExtraResults& extra) {
+    PhaseStart clock = beginPhase();
+    PhaseClock start = phaseNow();
+    std::ostringstream c;
+    emitC(program, sema, filename, c);
+    extra.files.push_back({ "program.c", c.str() });
+    stats.cSeconds = phaseNow().wall - start.wall;
+    endPhase(stats, PHASE_IR, clock);
+    stats.emittedC = true;
+    stats.cBytes = extra.files.back().content.size();
+    extra.summary += "C 代码: " + std::to_string(stats.cBytes) + " 字节，写入 program.c\n";
+}
+
+// 语法分析之后的各阶段：构造语法树、语义分析，以及按选项生成中间代码或 C 代码；结果文件与摘要加入extra
+static void compileProgram(const std::string& filename, const std::vector<TokenAttr>& tokenList,
+                           const AnalyzeOptions& options, RunStats& stats, ExtraResults& extra) {
+    PhaseStart clock = beginPhase();
+    AstProgram program;
+    SemaResult sema;
+    if (buildAst(tokenList, program)) {
+        analyzeSemantics(program, sema);
+    } else {
+        sema.diagnostics.push_back({ 0, "内部错误: Token序列与文法不符，无法构造语法树" });
+        sema.errorCount = 1;
+    }
+    endPhase(stats, PHASE_SEMA, clock);
+
+    // 没有语义错误时在未优化的中间代码上做数据流检查，警告并入语义分析的结果；--ir 时沿用这份中间代码
+    IrModule module;
+    if (sema.errorCount == 0) {
+        clock = beginPhase();
+        lowerToIr(program, sema, module);
+        endPhase(stats, PHASE_IR, clock);
+        clock = beginPhase();
+        DataflowStats dataflow;
+        checkDataflow(module, sema, dataflow);
+        endPhase(stats, PHASE_SEMA, clock);
+    }
+    stats.semantic = true;
+    stats.astNodes = program.nodes.size();
+    stats.semaErrors = sema.errorCount;
+    stats.semaWarnings = sema.warningCount;
+    extra.files.push_back(renderDiagnosticsFile("semantic_errors.txt", sema.diagnostics, "无语义错误"));
+    extra.summary += std::string("语义分析结果: ") + (sema.errorCount == 0 ? "成功" : "有错误") + "\n";
+    extra.summary += "语义错误总数: " + std::to_string(sema.errorCount) + "\n";
+    extra.summary += "语义警告总数: " + std::to_string(sema.warningCount) + "\n";
+    if (options.emitC) {
+        if (sema.errorCount > 0) {
+            extra.summary += "C 代码: 未生成（存在语义错误）\n";
+        } else {
+            emitProgramC(program, sema, filename, stats, extra);
         }
-        tokenFile.close();
     }
+    if (!options.ir) {
+        return;
+    }
+    if (sema.errorCount > 0) {
+        extra.summary += "中间代码: 未生成（存在语义错误）\n";
+        return;
+    }
+
+    // 中间代码已在数据流检查之前生成
+    stats.ir = true;
+    if (options.optLevel > 0) {
+        clock = beginPhase();
+        OptStats opt;
+        optimizeModule(module, opt, options.optLevel);
+        endPhase(stats, PHASE_OPT, clock);
+        stats.optLevel = options.optLevel;
+        stats.optBefore = opt.before;
+        stats.optRemoved[0] = opt.folded;
+        stats.optRemoved[1] = opt.copies;
+        stats.optRemoved[2] = opt.unreachable;
+        stats.optRemoved[3] = opt.deadStores;
+        stats.optRemoved[4] = opt.gvn;
+        stats.optHoisted = opt.hoisted;
+        stats.optInlined = opt.inlined;
+        stats.optDeadFunctions = opt.deadFunctions;
+        extra.summary += "优化: " + std::to_string(opt.before) + " -> " + std::to_string(opt.after) +
+                         " 条指令（常量折叠 -" + std::to_string(opt.folded) + "，复制传播 -" +
+                         std::to_string(opt.copies) + "，不可达块 -" + std::to_string(opt.unreachable) +
+                         "，死存储 -" + std::to_string(opt.deadStores);
+        if (options.optLevel >= 2) {
+            extra.summary += "，全局值编号 -" + std::to_string(opt.gvn) + "；外提循环不变量 " +
+                             std::to_string(opt.hoisted) + " 条";
+        }
+        extra.summary += "）\n";
+        if (options.optLevel >= 2) {
+            extra.summary += "内联: " + std::to_string(opt.inlined) + " 处调用，删除无用函数 " +
+                             std::to_string(opt.deadFunctions) + " 个（调用图中递归函数 " +
+                             std::to_string(opt.recursive) + " 个，不内联）\n";
+        }
+    }
+    size_t instructions = 0;
+    for (const auto& function : module.functions) {
+        stats.irFunctionInsts.push_back({ function.name, irInstructionCount(function) });
+        stats.irBlocks += function.blocks.size();
+        instructions += stats.irFunctionInsts.back().second;
+    }
+    extra.files.push_back({ "ir.txt", dumpIr(module) });
+    extra.summary += "中间代码: " + std::to_string(instructions) + " 条指令，" + std::to_string(stats.irBlocks) +
+                     " 个基本块\n";
+    if (options.run) {
+        runProgram(module, stats, extra);
+    }
+    if (options.jit) {
+        jitProgram(module, stats, extra);
+    }
+}
+
+// 解析选项的非负整数值（不超过limit），格式错误或超出范围时返回false
+static bool parseCount(const char* text, unsigned long limit, unsigned long& value) {
+    if (text[0] < '0' || text[0] > '9') return false;
+    char* end = nullptr;
+    errno = 0;
+    value = strtoul(text, &end, 10);
+    return errno == 0 && *end == '\0' && value <= limit;
+}
+
+// 分析单个文件：读取、词法分析、语法分析并输出结果
+// 过程与摘要写入out，返回是否成功打开文件
+// batch非空时源文件已由批量读取读入，结果文件交由批量写出
+static bool analyzeFile(const std::string& filename, const AnalyzeOptions& options, std::ostream& out,
+                        BatchFile* batch = nullptr) {
+    double fileTraceStart = traceEnabled() ? traceNowUs() : 0;
+    bool parseSuccess = true;  // 语法分析是否成功
+    std::vector<ParserError> parseErrors; // 保存语法错误
+    std::vector<TokenAttr> tokenList;     // Token列表
+    RunStats stats;            // 运行统计
     
-    // 输出词法错误信息
-    const std::vector<ErrorInfo>& lexErrors = getErrors();
-    if (!lexErrors.empty()) {
-        std::ofstream errorFile(dirName + "/lex_errors.txt");
-        if (errorFile.is_open()) {
-            errorFile << "行号\t错误信息\n";
-            errorFile << "-------------------------------------\n";
-            
-            for (const auto& error : lexErrors) {
-                errorFile << error.line << "\t" << error.message << "\n";
-            }
-            errorFile.close();
+    if (g_perfEnabled) {
+        memset(g_perf.counts, 0, sizeof(g_perf.counts));  // 每个文件单独报告
+    }
+    
+    // 读取整个文件到内存
+    PhaseStart clock = beginPhase();
+    std::string source;
+    if (batch != nullptr) {
+        if (batch->source.error != 0) {
+            std::cerr << "错误: 无法打开文件 " << filename << std::endl;
+            return false;
+        }
+        source.swap(batch->source.data);
+    } else {
+        FILE* fp = fopen(filename.c_str(), "r");
+        if (fp == nullptr) {
+            std::cerr << "错误: 无法打开文件 " << filename << std::endl;
+            return false;
+        }
+        char chunk[65536];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), fp)) > 0) {
+            source.append(chunk, n);
         }
+        // 关闭文件
+        fclose(fp);
     }
+    stats.filename = filename;
+    stats.bytes = source.size();
+    endPhase(stats, PHASE_READ, clock);
     
-    // 输出语法错误信息
-    if (!lexOnly) {
-        const std::vector<ParserError>& parseErrors = savedParseErrors.empty() ? getParserErrors() : savedParseErrors;
-        // 始终创建语法错误文件，即使没有错误
-        std::ofstream parseErrorFile(dirName + "/parse_errors.txt");
-        if (parseErrorFile.is_open()) {
-            parseErrorFile << "行号\t错误信息\n";
-            parseErrorFile << "-------------------------------------\n";
+    // INFO 仅进行词法分析
+    if (options.lexOnly) {
+        // 初始化词法分析器
+        initLexerBuffer(source.data(), source.size());
+        
+        // 进行词法分析
+        TokenAttr token;
+        if (options.showProcess) {
+            out << "开始词法分析...\n";
+        }
+        
+        clock = beginPhase();
+        do {
+            token = getNextToken();
+            tokenList.push_back(token);
             
-            for (const auto& error : parseErrors) {
-                parseErrorFile << error.line << "\t" << error.message << "\n";
+            // 显示分析过程（可选）
+            if (options.showProcess && token.code != TK_EOF) {
+                out << "行 " << token.line << ": [" 
+                    << getTokenName(token.code) << "] " 
+                    << token.value << std::endl;
             }
-            
-            if (parseErrors.empty()) {
-                parseErrorFile << "无语法错误\n";
+        } while (token.code != TK_EOF);
+        endPhase(stats, PHASE_LEX, clock);
+        
+        // 输出分析结果
+        clock = beginPhase();
+        outputResults(filename, tokenList, true, true, parseErrors, ExtraResults(), out, batch);
+        endPhase(stats, PHASE_OUTPUT, clock);
+    } else { // 进行词法和语法分析
+        if (options.showProcess) {
+            out << "开始分析...\n";
+        }
+        
+        ParserResult result;
+        if (options.pipeline) {
+            // 词法线程与语法分析并行，一遍完成Token收集与语法分析（耗时计入语法分析阶段）
+            clock = beginPhase();
+            result = parsePipelined(source.data(), source.size(), &tokenList);
+            endPhase(stats, PHASE_PARSE, clock);
+        } else {
+            // 首先收集所有token用于输出
+            clock = beginPhase();
+            initLexerBuffer(source.data(), source.size());
+            {
+                TokenAttr token;
+                do {
+                    token = getNextToken();
+                    tokenList.push_back(token);
+                } while (token.code != TK_EOF);
             }
+            endPhase(stats, PHASE_LEX, clock);
             
-            parseErrorFile.close();
+            // 执行语法分析
+            clock = beginPhase();
+            initParserBuffer(source.data(), source.size());
+            result = parse();
+            endPhase(stats, PHASE_PARSE, clock);
+        }
+        parseSuccess = (result == RESULT_SUCCESS);
+
+        // 保存语法错误信息
+        parseErrors = getParserErrors();
+        stats.backtracks = getUngetCount();
+        stats.skippedTokens = getSkippedTokenCount();
+        
+        // 输出分析结果
+        if (options.showProcess) {
+            if (parseSuccess) {
+                out << "语法分析成功！\n";
+            } else {
+                out << "语法分析失败。\n";
+            }
+        }
+        
+        // 语义分析及之后的阶段：只在词法与语法分析都没有错误时进行
+        ExtraResults extra;
+        if (options.semantic) {
+            if (parseSuccess && getErrors().empty()) {
+                compileProgram(filename, tokenList, options, stats, extra);
+            } else {
+                extra.summary += "语义分析结果: 未进行（存在词法或语法错误）\n";
+            }
         }
+        
+        clock = beginPhase();
+        outputResults(filename, tokenList, false, parseSuccess, parseErrors, extra, out, batch);
+        endPhase(stats, PHASE_OUTPUT, clock);
+        stats.parseErrors = parseErrors.size();
     }
     
-    // 简洁的摘要输出
-    std::cout << "\n=== 分析完成 ===\n";
-    std::cout << "文件: " << filename << "\n";
+    // 导出Token流到共享内存（计入输出阶段）
+    if (!options.exportShm.empty()) {
+        clock = beginPhase();
+        std::string segment = options.exportShm;
+        if (options.shmPerFile) {
+            std::string suffix = filename;
+            std::replace(suffix.begin(), suffix.end(), '/', '_');
+            segment += "-" + suffix;
+        }
+        std::string error;
+        if (!tokenShmPublish(segment, filename, stats.bytes, tokenList, getErrors(),
+                             options.lexOnly ? nullptr : &parseErrors, parseSuccess, error)) {
+            std::cerr << "错误: 无法导出共享内存段 " << segment << ": " << error << std::endl;
+        } else if (options.showProcess) {
+            out << "Token流已导出到共享内存段: " << segment << "\n";
+        }
+        endPhase(stats, PHASE_OUTPUT, clock);
+    }
     
-    if (lexOnly) {
-        std::cout << "词法分析结果: " << (lexErrors.empty() ? "成功" : "有错误") << "\n";
-        std::cout << "Token总数: " << tokenList.size() << "\n";
-        std::cout << "词法错误总数: " << lexErrors.size() << "\n";
-    } else {
-        const std::vector<ParserError>& parseErrors = savedParseErrors.empty() ? getParserErrors() : savedParseErrors;
-        std::cout << "词法分析结果: " << (lexErrors.empty() ? "成功" : "有错误") << "\n";
-        std::cout << "语法分析结果: " << (parseSuccess ? "成功" : "有错误") << "\n";
-        std::cout << "Token总数: " << tokenList.size() << "\n";
-        std::cout << "词法错误总数: " << lexErrors.size() << "\n";
-        std::cout << "语法错误总数: " << parseErrors.size() << "\n";
+    // 输出运行统计
+    if (options.statsMode != STATS_NONE) {
+        stats.tokens = tokenList.size();
+        for (const auto& token : tokenList) {
+            stats.tokenCounts[token.code]++;
+        }
+        stats.lexErrors = getErrors().size();
+        samplePeakRss(stats);
+        if (options.statsMode == STATS_JSON) {
+            printStatsJson(stats, out);
+        } else {
+            printStatsText(stats, out);
+        }
     }
     
-    std::cout << "结果已输出到: " << dirName << "\n";
+    // 输出硬件计数器报告
+    if (g_perfEnabled) {
+        printPerfReport(g_perf, tokenList.size(), out);
+    }
+    
+    if (traceEnabled()) {
+        traceSpan("file", filename, fileTraceStart);
+    }
+    return true;
+}
+
+// 工作线程：从共享下标依次领取文件，结果整体写到标准输出，避免不同文件的输出交错
+static void analyzeWorker(int workerId, const std::vector<std::string>& files, const AnalyzeOptions& options,
+                          std::atomic<size_t>& next, std::atomic<bool>& failed, std::mutex& outMutex) {
+    traceThreadName("worker " + std::to_string(workerId));
+    if (g_perfEnabled) perfOpen(g_perf);
+    
+    size_t index;
+    while ((index = next.fetch_add(1)) < files.size()) {
+        std::ostringstream out;
+        if (!analyzeFile(files[index], options, out)) {
+            failed = true;
+        }
+        std::lock_guard<std::mutex> lock(outMutex);
+        std::cout << out.str();
+        std::cout.flush();
+    }
+    
+    if (g_perfEnabled) perfClose(g_perf);
+}
+
+// 批量I/O模式：每批文件先一次读入全部源文件并创建输出目录，
+// 分析（jobs个线程）只在内存中进行，最后一次写出全部结果文件，再按输入顺序打印摘要
+static bool analyzeBatched(const std::vector<std::string>& files, const AnalyzeOptions& options, int jobs) {
+    bool failed = false;
+    if (jobs == 1 || files.size() == 1) {
+        traceThreadName("main");
+    }
+    for (size_t first = 0; first < files.size(); first += kBatchFiles) {
+        size_t count = std::min(kBatchFiles, files.size() - first);
+        std::vector<BatchFile> batch(count);
+        
+        // 批量读取
+        std::vector<ReadRequest> reads(count);
+        for (size_t i = 0; i < count; i++) {
+            reads[i].path = files[first + i];
+        }
+        batchRead(reads);
+        
+        // 为成功读取的文件批量创建输出目录
+        std::vector<std::string> dirs;
+        std::vector<size_t> dirOwners;
+        for (size_t i = 0; i < count; i++) {
+            batch[i].source = std::move(reads[i]);
+            if (batch[i].source.error == 0 && !archiveEnabled()) {
+                dirs.push_back(files[first + i] + "-output");
+                dirOwners.push_back(i);
+            }
+        }
+        std::vector<int> dirErrors;
+        batchEnsureDirs(dirs, dirErrors);
+        for (size_t k = 0; k < dirOwners.size(); k++) {
+            batch[dirOwners[k]].dirError = dirErrors[k];
+        }
+        
+        // 在内存中分析
+        std::atomic<size_t> next(0);
+        auto worker = [&](int workerId) {
+            if (workerId > 0) traceThreadName("worker " + std::to_string(workerId));
+            if (g_perfEnabled) perfOpen(g_perf);
+            size_t index;
+            while ((index = next.fetch_add(1)) < count) {
+                std::ostringstream out;
+                batch[index].opened = analyzeFile(files[first + index], options, out, &batch[index]);
+                batch[index].summary = out.str();
+            }
+            if (g_perfEnabled) perfClose(g_perf);
+        };
+        int workerCount = (int)std::min<size_t>((size_t)jobs, count);
+        if (workerCount <= 1) {
+            worker(0);
+        } else {
+            std::vector<std::thread> workers;
+            for (int i = 0; i < workerCount; i++) {
+                workers.emplace_back(worker, i + 1);
+            }
+            for (auto& thread : workers) {
+                thread.join();
+            }
+        }
+        
+        // 批量写出结果文件
+        std::vector<WriteRequest> writes;
+        for (size_t i = 0; i < count; i++) {
+            std::string dirName = files[first + i] + "-output/";
+            for (auto& output : batch[i].outputs) {
+                writes.push_back({ dirName + output.name, std::move(output.content), 0 });
+            }
+        }
+        batchWrite(writes);
+        for (const auto& write : writes) {
+            if (write.error != 0) {
+                std::cerr << "错误: 无法写入文件 " << write.path << ": " << strerror(write.error) << std::endl;
+            }
+        }
+        
+        for (size_t i = 0; i < count; i++) {
+            std::cout << batch[i].summary;
+            if (!batch[i].opened) {
+                failed = true;
+            }
+        }
+        std::cout.flush();
+    }
+    return failed;
 }
 
 int main(int argc, char* argv[]) {
     // 输入文件路径
-    std::string filename;
-    FILE* fp;
-    bool showProcess = true;   // 是否显示分析过程
-    bool lexOnly = false;      // 是否仅进行词法分析
-    bool parseSuccess = true;  // 语法分析是否成功
-    std::vector<ParserError> parseErrors; // 保存语法错误
+    std::vector<std::string> files;
+    AnalyzeOptions options;
+    int jobs = 1;              // 并行分析的线程数
+    bool jobsGiven = false;    // 是否指定了 -j（服务模式默认按处理器数）
+    std::string tracePath;     // 追踪输出文件
+    bool traceFunctions = false; // 是否追踪每个函数定义
+    bool serveMode = false;    // 是否以常驻服务模式运行
+    std::string socketPath = kDefaultSocketPath; // 服务监听的套接字路径
+    size_t cacheSize = 64;     // 服务的结果缓存条目数
+    bool lspMode = false;      // 是否以LSP服务模式运行
+    int debounceMs = 150;      // LSP模式下重新分析前的静默时间
+    bool batchIo = false;      // 是否批量读写文件
+    bool preferUring = true;   // 批量I/O是否优先使用io_uring
+    std::string archiveFile;   // 结果归档文件，空表示每个输入一个输出目录
     
     // 检查命令行参数
     if (argc < 2) {
@@ -171,122 +676,209 @@ int main(int argc, char* argv[]) {
             std::cout << "Mini语言编译器 v1.0\n";
             return 0;
         } else if (arg == "-q" || arg == "--quiet") {
-            showProcess = false;
+            options.showProcess = false;
         } else if (arg == "-l" || arg == "--lex-only") {
-            lexOnly = true;
+            options.lexOnly = true;
+        } else if (arg == "-j" && i + 1 < argc) {
+            unsigned long value;
+            if (!parseCount(argv[++i], 1024, value)) {
+                std::cerr << "错误: -j 需要不超过1024的非负整数，收到 '" << argv[i] << "'\n";
+                showUsage(argv[0]);
+                return 1;
+            }
+            jobs = std::max(1, (int)value);
+            jobsGiven = true;
+        } else if (arg == "--pipeline") {
+            options.pipeline = true;
+        } else if (arg == "--batch-io" || arg == "--batch-io=uring") {
+            batchIo = true;
+            preferUring = true;
+        } else if (arg == "--batch-io=threads") {
+            batchIo = true;
+            preferUring = false;
+        } else if (arg == "--archive" && i + 1 < argc) {
+            archiveFile = argv[++i];
+        } else if (arg == "--sema") {
+            options.semantic = true;
+        } else if (arg == "--ir") {
+            options.semantic = true;
+            options.ir = true;
+        } else if (arg == "--run") {
+            options.semantic = true;
+            options.ir = true;
+            options.run = true;
+        } else if (arg == "--jit") {
+            options.semantic = true;
+            options.ir = true;
+            options.jit = true;
+        } else if (arg == "--emit-c") {
+            options.semantic = true;
+            options.emitC = true;
+        } else if (arg == "-O" || arg == "-O1" || arg == "-O2" || arg == "--opt") {
+            options.semantic = true;
+            options.ir = true;
+            options.optLevel = arg == "-O1" ? 1 : 2;
+        } else if (arg == "--export-shm" && i + 1 < argc) {
+            options.exportShm = argv[++i];
+        } else if (arg == "--serve") {
+            serveMode = true;
+        } else if (arg == "--stats" || arg == "--stats=text") {
+            options.statsMode = STATS_TEXT;
+        } else if (arg == "--stats=json") {
+            options.statsMode = STATS_JSON;
+        } else if (arg == "--alloc-stats") {
+            allocTrackingEnable();
+            if (options.statsMode == STATS_NONE) {
+                options.statsMode = STATS_TEXT;
+            }
+        } else if (arg == "--perf-counters") {
+            g_perfEnabled = true;
+        } else if (arg == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (arg == "--trace-functions") {
+            traceFunctions = true;
+        } else if (arg == "--lsp") {
+            lspMode = true;
+        } else if (arg == "--debounce" && i + 1 < argc) {
+            unsigned long value;
+            if (!parseCount(argv[++i], 60000, value)) {
+                std::cerr << "错误: --debounce 需要不超过60000的毫秒数，收到 '" << argv[i] << "'\n";
+                showUsage(argv[0]);
+                return 1;
+            }
+            debounceMs = (int)value;
+        } else if (arg == "--socket" && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (arg == "--cache" && i + 1 < argc) {
+            unsigned long value;
+            if (!parseCount(argv[++i], 1000000, value)) {
+                std::cerr << "错误: --cache 需要不超过1000000的条目数，收到 '" << argv[i] << "'\n";
+                showUsage(argv[0]);
+                return 1;
+            }
+            cacheSize = (size_t)value;
         } else if (arg[0] == '-') {
             std::cerr << "错误: 未知选项 " << arg << "\n";
             showUsage(argv[0]);
             return 1;
         } else {
-            filename = arg;
+            files.push_back(arg);
         }
     }
     
-    if (filename.empty()) {
+    if (lspMode) {
+        return runLspServer(debounceMs);
+    }
+    
+    if (serveMode) {
+        int workers = jobsGiven ? jobs : (int)std::min(8u, std::max(1u, std::thread::hardware_concurrency()));
+        return runServer(socketPath, cacheSize, workers);
+    }
+    
+    if (files.empty()) {
         std::cerr << "错误: 未指定输入文件\n";
         showUsage(argv[0]);
         return 1;
     }
     
-    // 尝试打开文件
-    fp = fopen(filename.c_str(), "r");
-    if (fp == nullptr) {
-        std::cerr << "错误: 无法打开文件 " << filename << std::endl;
+    if (!tracePath.empty()) {
+        traceEnable(traceFunctions);
+    }
+    
+    options.shmPerFile = files.size() > 1;
+    
+    if (!archiveFile.empty() && !archiveOpen(archiveFile)) {
+        std::cerr << "错误: 无法创建归档 " << archiveFile << ": " << strerror(errno) << std::endl;
         return 1;
     }
     
-    // INFO 仅进行词法分析
-    if (lexOnly) {
-        // 初始化词法分析器
-        initLexer(fp);
-        
-        // 进行词法分析
-        TokenAttr token;
-        if (showProcess) {
-            std::cout << "开始词法分析...\n";
+    bool failed = false;
+    if (batchIo) {
+        // I/O线程数与分析线程数无关：小文件的读写主要是等待
+        batchIoInit(preferUring, 8);
+        failed = analyzeBatched(files, options, jobs);
+        batchIoClose();
+    } else if (jobs == 1 || files.size() == 1) {
+        // 单线程：直接输出到标准输出
+        traceThreadName("main");
+        if (g_perfEnabled) {
+            perfOpen(g_perf);  // 计数器不可用时各项读数为0，报告中注明原因
         }
-        
-        do {
-            token = getNextToken();
-            tokenList.push_back(token);
-            
-            // 显示分析过程（可选）
-            if (showProcess && token.code != TK_EOF) {
-                std::cout << "行 " << token.line << ": [" 
-                         << getTokenName(token.code) << "] " 
-                         << token.value << std::endl;
+        for (const auto& filename : files) {
+            if (!analyzeFile(filename, options, std::cout)) {
+                failed = true;
             }
-        } while (token.code != TK_EOF);
-        
-        // 关闭文件
-        fclose(fp);
-        
-        // 输出分析结果
-        outputResults(filename, true);
-    } else { // 进行词法和语法分析
-        // 初始化解析器
-        initParser(fp);
-        
-        if (showProcess) {
-            std::cout << "开始分析...\n";
         }
-        
-        // 首先收集所有token用于输出
-        {
-            // 保存当前文件位置
-            long filePos = ftell(fp);
-            // 重置文件指针到开头
-            rewind(fp);
-            // 重新初始化词法分析器
-            initLexer(fp);
-            
-            TokenAttr token;
-            do {
-                token = getNextToken();
-                tokenList.push_back(token);
-            } while (token.code != TK_EOF);
-            
-            // 恢复文件位置
-            fseek(fp, filePos, SEEK_SET);
-            // 重新初始化解析器
-            initParser(fp);
+        if (g_perfEnabled) {
+            perfClose(g_perf);
         }
-        
-        // 执行语法分析
-        ParserResult result = parse();
-        parseSuccess = (result == RESULT_SUCCESS);
-
-        // 保存语法错误信息
-        parseErrors = getParserErrors();
-        
-        // 关闭文件
-        fclose(fp);
-        
-        // 输出分析结果
-        if (showProcess) {
-            if (parseSuccess) {
-                std::cout << "语法分析成功！\n";
-            } else {
-                std::cout << "语法分析失败。\n";
-            }
+    } else {
+        // 多线程：每个工作线程独立完成文件的全部阶段
+        std::atomic<size_t> next(0);
+        std::atomic<bool> anyFailed(false);
+        std::mutex outMutex;
+        std::vector<std::thread> workers;
+        int workerCount = (int)std::min<size_t>((size_t)jobs, files.size());
+        for (int i = 0; i < workerCount; i++) {
+            workers.emplace_back(analyzeWorker, i + 1, std::cref(files), std::cref(options),
+                                 std::ref(next), std::ref(anyFailed), std::ref(outMutex));
         }
-        
-        outputResults(filename, false, parseSuccess, parseErrors);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        failed = anyFailed;
+    }
+    
+    if (!archiveFile.empty() && !archiveClose()) {
+        std::cerr << "错误: 无法写入归档 " << archiveFile << std::endl;
+        failed = true;
+    }
+    
+    if (!tracePath.empty() && !traceWrite(tracePath)) {
+        std::cerr << "错误: 无法写入追踪文件 " << tracePath << std::endl;
     }
     
-    return 0;
+    return failed ? 1 : 0;
 }
 
 // 显示使用说明
 void showUsage(const char* programName) {
-    std::cout << "用法: " << programName << " [选项] <文件路径>\n\n";
+    std::cout << "用法: " << programName << " [选项] <文件路径>...\n\n";
     std::cout << "选项:\n";
     std::cout << "  -h, --help      显示此帮助信息\n";
     std::cout << "  -v, --version   显示版本信息\n";
     std::cout << "  -q, --quiet     安静模式，不显示分析过程\n";
-    std::cout << "  -l, --lex-only  仅进行词法分析，不进行语法分析\n\n";
+    std::cout << "  -l, --lex-only  仅进行词法分析，不进行语法分析\n";
+    std::cout << "  -j <线程数>     并行分析多个文件\n";
+    std::cout << "  --sema          语法分析成功后进行语义分析（标识符解析、类型检查与数据流检查），结果写入 semantic_errors.txt\n";
+    std::cout << "  --ir            语义分析成功后生成三地址码中间代码（基本块与控制流图），写入 ir.txt\n";
+    std::cout << "  -O1             生成中间代码并优化（常量折叠、复制传播、不可达块删除、死存储删除），\n"
+              << "                  ir.txt 为优化后的代码\n";
+    std::cout << "  -O, -O2, --opt  在 -O1 的基础上构造 SSA，做全局值编号与循环不变量外提\n";
+    std::cout << "  --run           生成中间代码（可与 -O 同用）后编译为寄存器字节码，在虚拟机中执行 main，\n"
+              << "                  报告返回值与执行的指令数，字节码写入 bytecode.txt\n";
+    std::cout << "  --jit           生成中间代码后编译为 x86-64 机器码并执行 main（线性扫描寄存器分配、SSE2），\n"
+              << "                  寄存器分配写入 jit.txt；与 --run 同用时比较两者的结果\n";
+    std::cout << "  --emit-c        语义分析成功后把程序翻译为可移植的 C 源码（带 #line），写入 program.c，\n"
+              << "                  可用系统的 C 编译器编译执行（cc -std=c99 -O2 program.c）\n";
+    std::cout << "  --pipeline      词法分析线程经无锁环形缓冲区向语法分析器供给Token（结果与串行相同）\n";
+    std::cout << "  --batch-io[=uring|threads] 批量读取源文件、批量写出结果（默认io_uring，不可用时退回线程池）\n";
+    std::cout << "  --archive <文件> 所有结果写入同一个带索引的归档文件，不创建 -output 目录（用 tools/mini_arc 查询）\n";
+    std::cout << "  --export-shm <段名> 把Token流、词素表与诊断发布到POSIX共享内存段（用 tools/mini_tokview 读取）\n";
+    std::cout << "  --trace <文件>  输出 Chrome/Perfetto trace-event JSON（文件与阶段跨度）\n";
+    std::cout << "  --trace-functions 与 --trace 一起使用，额外记录每个函数定义的解析跨度\n";
+    std::cout << "  --stats[=json]  输出各阶段耗时、吞吐量、Token分布与峰值内存（文本或JSON）\n";
+    std::cout << "  --alloc-stats   统计各阶段的内存分配次数、字节数与峰值存活字节（随 --stats 输出）\n";
+    std::cout << "  --perf-counters 用 perf_event_open 统计各阶段的周期、指令、分支预测失败与缓存缺失\n";
+    std::cout << "  --serve         以常驻服务模式运行，在Unix域套接字上接受分析请求\n";
+    std::cout << "  --socket <路径> 服务监听的套接字路径（默认 " << kDefaultSocketPath << "）\n";
+    std::cout << "  --cache <条目数> 服务缓存的最近结果数（默认 64，0 表示不缓存）\n";
+    std::cout << "                  服务模式下 -j 为分析线程数（默认为处理器数，最多 8）\n";
+    std::cout << "  --lsp           以LSP服务模式运行（标准输入/输出）\n";
+    std::cout << "  --debounce <毫秒> LSP模式下修改后重新分析前的静默时间（默认 150）\n\n";
     std::cout << "示例: " << programName << " ./example.txt\n";
     std::cout << "      " << programName << " -q ./example.txt\n";
     std::cout << "      " << programName << " -l ./example.txt\n";
+    std::cout << "      " << programName << " -q -j 8 --trace out.json tests/*.txt\n";
+    std::cout << "      " << programName << " --serve --socket /tmp/mini.sock\n";
 }
@@ -0,0 +1,267 @@
+#include "frame.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+/*
+ * 编译服务客户端
+ * ===========================
+ * 向 `compiler --serve` 发送分析请求并打印诊断信息；
+ * --bench 模式下对比常驻服务与冷启动进程的单次请求延迟（p50/p99）。
+ */
+
+// 函数声明
+void showUsage(const char* programName);
+
+// 连接服务端，失败返回-1
+static int connectServer(const std::string& socketPath) {
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(addr.sun_path)) {
+        return -1;
+    }
+    strcpy(addr.sun_path, socketPath.c_str());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// 发送一次请求并等待响应
+static bool request(int fd, char kind, const std::string& payload, char& respKind, std::string& response) {
+    return writeFrame(fd, kind, payload) && readFrame(fd, respKind, response);
+}
+
+// 还原服务端转义的诊断信息
+static std::string unescape(const std::string& text) {
+    std::string out;
+    for (size_t i = 0; i < text.size(); i++) {
+        if (text[i] == '\\' && i + 1 < text.size()) {
+            out += (text[++i] == 'n') ? '\n' : text[i];
+        } else {
+            out += text[i];
+        }
+    }
+    return out;
+}
+
+// 按 "文件:行号: 类别: 信息" 格式打印诊断
+static void printDiagnostics(const std::string& filename, const std::string& response) {
+    std::istringstream in(response);
+    std::string line;
+    std::getline(in, line);
+    int success = 0, cached = 0;
+    size_t tokens = 0, lexCount = 0, parseCount = 0;
+    std::istringstream header(line);
+    header >> success >> tokens >> lexCount >> parseCount >> cached;
+
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        size_t tab = line.find('\t');
+        std::string kind = (line[0] == 'L') ? "词法错误" : "语法错误";
+        std::cout << filename << ":" << line.substr(1, tab - 1) << ": " << kind << ": "
+                  << unescape(line.substr(tab + 1)) << "\n";
+    }
+    std::cout << "Token总数: " << tokens << "  词法错误: " << lexCount
+              << "  语法错误: " << parseCount << (cached ? "  (缓存)" : "") << "\n";
+}
+
+// 计算分位数（输入须已排序）
+static double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t idx = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(idx, sorted.size() - 1)];
+}
+
+static void reportLatency(const char* label, std::vector<double>& samples) {
+    std::sort(samples.begin(), samples.end());
+    std::cout << label << ": n=" << samples.size()
+              << "  p50=" << percentile(samples, 0.50) << "us"
+              << "  p99=" << percentile(samples, 0.99) << "us\n";
+}
+
+// 以冷启动方式运行一次编译器，输出丢弃
+static bool runCold(const std::string& compiler, const std::string& filename) {
+    pid_t pid = fork();
+    if (pid < 0) return false;
+    if (pid == 0) {
+        int devnull = open("/dev/null", O_WRONLY);
+        dup2(devnull, STDOUT_FILENO);
+        dup2(devnull, STDERR_FILENO);
+        execl(compiler.c_str(), compiler.c_str(), "-q", filename.c_str(), (char*)nullptr);
+        _exit(127);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// 延迟基准：服务模式（同一连接上重复请求）对比冷启动进程
+// 每次请求发送的内容末尾附加不同的注释，分析结果不变但不会命中服务端的结果缓存，
+// 测得的是完整分析的延迟，与每次都要分析的冷启动进程可比
+static int runBench(int fd, const std::string& filename, const std::string& source,
+                    int iterations, const std::string& compiler) {
+    typedef std::chrono::steady_clock Clock;
+    std::vector<double> warm, cold;
+    char respKind;
+    std::string response;
+    std::string payload;
+    int hits = 0;
+
+    for (int i = 0; i < iterations; i++) {
+        payload = source;
+        payload += "\n// bench " + std::to_string(i) + "\n";
+        auto start = Clock::now();
+        if (!request(fd, FRAME_BUFFER, payload, respKind, response) || respKind != FRAME_RESULT) {
+            std::cerr << "错误: 请求失败 " << response << std::endl;
+            return 1;
+        }
+        warm.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        int success = 0, cached = 0;
+        size_t tokens = 0, lexCount = 0, parseCount = 0;
+        std::istringstream header(response.substr(0, response.find('\n')));
+        header >> success >> tokens >> lexCount >> parseCount >> cached;
+        hits += cached;
+    }
+    if (hits > 0) {
+        std::cerr << "警告: " << hits << " 次请求命中了服务端缓存" << std::endl;
+    }
+    reportLatency("服务模式", warm);
+
+    if (!compiler.empty()) {
+        for (int i = 0; i < iterations; i++) {
+            auto start = Clock::now();
+            if (!runCold(compiler, filename)) {
+                std::cerr << "错误: 无法运行 " << compiler << std::endl;
+                return 1;
+            }
+            cold.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        }
+        reportLatency("冷启动进程", cold);
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    std::string socketPath = kDefaultSocketPath;
+    std::string filename;
+    std::string compiler;      // 冷启动对比使用的编译器路径
+    bool sendBuffer = false;   // 是否发送文件内容而非路径
+    bool quit = false;         // 是否请求服务退出
+    int benchIterations = 0;   // 基准迭代次数，0 表示不做基准
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            showUsage(argv[0]);
+            return 0;
+        } else if (arg == "--socket" && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (arg == "-b" || arg == "--buffer") {
+            sendBuffer = true;
+        } else if (arg == "--quit") {
+            quit = true;
+        } else if (arg == "--bench" && i + 1 < argc) {
+            char* end = nullptr;
+            long value = strtol(argv[++i], &end, 10);
+            if (*end != '\0' || value <= 0 || value > 10000000) {
+                std::cerr << "错误: --bench 需要正整数，收到 '" << argv[i] << "'\n";
+                showUsage(argv[0]);
+                return 1;
+            }
+            benchIterations = (int)value;
+        } else if (arg == "--cold" && i + 1 < argc) {
+            compiler = argv[++i];
+        } else if (arg[0] == '-') {
+            std::cerr << "错误: 未知选项 " << arg << "\n";
+            showUsage(argv[0]);
+            return 1;
+        } else {
+            filename = arg;
+        }
+    }
+
+    int fd = connectServer(socketPath);
+    if (fd < 0) {
+        std::cerr << "错误: 无法连接编译服务 " << socketPath << std::endl;
+        return 1;
+    }
+
+    if (quit) {
+        writeFrame(fd, FRAME_QUIT, "");
+        close(fd);
+        return 0;
+    }
+
+    if (filename.empty()) {
+        std::cerr << "错误: 未指定输入文件\n";
+        showUsage(argv[0]);
+        close(fd);
+        return 1;
+    }
+
+    std::string source;  // 发送内容或做基准时读入文件
+    if (sendBuffer || benchIterations > 0) {
+        std::ifstream in(filename, std::ios::binary);
+        if (!in) {
+            std::cerr << "错误: 无法打开文件 " << filename << std::endl;
+            close(fd);
+            return 1;
+        }
+        std::ostringstream ss;
+        ss << in.rdbuf();
+        source = ss.str();
+    }
+    char kind = sendBuffer ? FRAME_BUFFER : FRAME_PATH;
+
+    int ret = 0;
+    if (benchIterations > 0) {
+        ret = runBench(fd, filename, source, benchIterations, compiler);
+    } else {
+        char respKind;
+        std::string response;
+        if (!request(fd, kind, sendBuffer ? source : filename, respKind, response)) {
+            std::cerr << "错误: 与编译服务通信失败" << std::endl;
+            ret = 1;
+        } else if (respKind == FRAME_ERROR) {
+            std::cerr << "错误: " << response << std::endl;
+            ret = 1;
+        } else {
+            printDiagnostics(filename, response);
+        }
+    }
+    close(fd);
+    return ret;
+}
+
+// 显示使用说明
+void showUsage(const char* programName) {
+    std::cout << "用法: " << programName << " [选项] <文件路径>\n\n";
+    std::cout << "选项:\n";
+    std::cout << "  -h, --help        显示此帮助信息\n";
+    std::cout << "  --socket <路径>   编译服务的套接字路径（默认 " << kDefaultSocketPath << "）\n";
+    std::cout << "  -b, --buffer      发送文件内容而非路径\n";
+    std::cout << "  --bench <次数>    测量每次请求的延迟（p50/p99）；每次发送略有不同的文件内容，不命中结果缓存\n";
+    std::cout << "  --cold <编译器>   与 --bench 一起使用，同时测量冷启动进程的延迟\n";
+    std::cout << "  --quit            请求编译服务退出\n\n";
+    std::cout << "示例: " << programName << " tests/test1.txt\n";
+    std::cout << "      " << programName << " --bench 1000 --cold ./parser tests/test3.txt\n";
+}
@@ -0,0 +1,936 @@
+#include "opt.h"
+#include "ssa.h"
+#include "callgraph.h"
+#include <algorithm>
+#include <deque>
+#include <cstring>
+
+static const uint32_t kNoBlock = UINT32_MAX;
+
+/* INFO 公共工具 */
+
+static bool isConst(const IrFunction& function, uint32_t value) {
+    return function.values[value].kind == IRV_CONST;
+}
+
+// 指令是否定义一个值
+static bool definesValue(const IrInst& inst) {
+    return inst.op >= IR_MOV && inst.op <= IR_CALL && inst.dst != kNoValue;
+}
+
+// 对指令的每个操作数（可修改）调用fn
+template <typename Fn>
+static void forEachOperand(IrFunction& function, IrInst& inst, Fn fn) {
+    switch (inst.op) {
+        case IR_NOP:
+        case IR_JMP:
+            break;
+        case IR_MOV:
+        case IR_CONV:
+        case IR_BR:
+        case IR_RET:
+            fn(inst.a);
+            break;
+        case IR_CALL:
+            for (uint32_t k = 0; k < inst.c; k++) fn(function.args[inst.b + k]);
+            break;
+        default:
+            fn(inst.a);
+            fn(inst.b);
+            break;
+    }
+}
+
+// 每个值被定义的次数
+static std::vector<uint32_t> definitionCounts(const IrFunction& function) {
+    std::vector<uint32_t> counts(function.values.size(), 0);
+    for (const IrInst& inst : function.insts) {
+        if (definesValue(inst)) counts[inst.dst]++;
+    }
+    return counts;
+}
+
+// 只定义一次的临时值：定义支配全部使用，可以在整个函数内替换
+static bool singleDefinition(const IrFunction& function, const std::vector<uint32_t>& defs, uint32_t value) {
+    return function.values[value].kind == IRV_TEMP && defs[value] == 1;
+}
+
+// 删除指令不再引用的临时值与常量，其余的值按原顺序重新编号（变量 0..slotCount-1 不变）。
+// 折叠一长串运算后留下的大量无用的值不再使以后各遍按值数分配的数组随之增大
+static void compactValues(IrFunction& function) {
+    size_t count = function.values.size();
+    std::vector<uint32_t> newId(count, kNoValue);
+    auto mark = [&](uint32_t& value) {
+        if (value < count) newId[value] = 0;
+    };
+    for (uint32_t v = 0; v < function.slotCount; v++) newId[v] = 0;
+    for (const IrBlock& block : function.blocks) {
+        for (uint32_t i = block.begin; i < block.end; i++) {
+            IrInst& inst = function.insts[i];
+            forEachOperand(function, inst, mark);
+            if (definesValue(inst)) mark(inst.dst);
+        }
+    }
+    uint32_t next = 0;
+    for (uint32_t v = 0; v < count; v++) {
+        if (newId[v] == kNoValue) continue;
+        function.values[next] = function.values[v];
+        newId[v] = next++;
+    }
+    if (next == count) return;
+    function.values.resize(next);
+    auto rename = [&](uint32_t& value) {
+        if (value < count) value = newId[value];
+    };
+    for (const IrBlock& block : function.blocks) {
+        for (uint32_t i = block.begin; i < block.end; i++) {
+            IrInst& inst = function.insts[i];
+            if (inst.op != IR_CALL) forEachOperand(function, inst, rename);
+            if (definesValue(inst)) rename(inst.dst);
+        }
+    }
+    for (uint32_t& arg : function.args) rename(arg);   // 已删除的 call 的实参成为kNoValue
+}
+
+static bool truthy(const IrValue& value) {
+    return value.type == TYPE_INT ? value.intValue != 0 : value.doubleValue != 0;
+}
+
+// 函数内常量去重（包括已有的常量）：开放寻址表存常量的值编号+1，按类型与位模式查找，
+// 不为每个常量单独分配节点。已有常量的表在第一次取常量时才建立，大多数函数的折叠不产生新常量，不必为每一轮都建表
+struct ConstPool {
+    IrFunction& function;
+    bool indexed = false;
+    std::vector<uint32_t> slots;   // 0 表示空，装载因子不超过1/2
+    size_t used = 0;
+    uint32_t reuse = kNoValue;     // 没有同值的常量时原地改为常量的临时值，不新建值
+
+    explicit ConstPool(IrFunction& target) : function(target) {}
+
+    static uint64_t bits(double value) {
+        uint64_t result;
+        memcpy(&result, &value, sizeof(result));
+        return result;
+    }
+
+    static uint64_t key(const IrValue& value) {
+        return value.type == TYPE_INT ? (uint64_t)(uint32_t)value.intValue : bits(value.doubleValue);
+    }
+
+    // int 常量按值本身定位：折叠产生的常量多是相邻的值，落在相邻的槽中；浮点的位模式先打散
+    static size_t hash(MiniType type, uint64_t k) {
+        if (type == TYPE_INT) return (size_t)k;
+        uint64_t h = (k + type) * 0x9E3779B97F4A7C15ull;
+        return (size_t)(h ^ (h >> 32));
+    }
+
+    // 查找 (type, k)：返回所在的槽，不存在时为应当插入的空槽
+    size_t probe(MiniType type, uint64_t k) const {
+        size_t mask = slots.size() - 1;
+        size_t i = hash(type, k) & mask;
+        for (; slots[i] != 0; i = (i + 1) & mask) {
+            const IrValue& value = function.values[slots[i] - 1];
+            if (value.type == type && key(value) == k) break;
+        }
+        return i;
+    }
+
+    void reserve(size_t count) {
+        if (count * 2 <= slots.size()) return;
+        size_t size = 64;
+        while (size < count * 2) size *= 2;
+        std::vector<uint32_t> old;
+        old.swap(slots);
+        slots.assign(size, 0);
+        size_t mask = size - 1;
+        for (uint32_t entry : old) {
+            if (entry == 0) continue;
+            const IrValue& value = function.values[entry - 1];
+            size_t i = hash(value.type, key(value)) & mask;
+            while (slots[i] != 0) i = (i + 1) & mask;
+            slots[i] = entry;
+        }
+    }
+
+    // 返回值为 (type, k) 的常量，不存在时由 create 新建
+    template <typename Create>
+    uint32_t find(MiniType type, uint64_t k, Create create) {
+        if (!indexed) index();
+        reserve(used + 1);
+        size_t i = probe(type, k);
+        if (slots[i] == 0) {
+            if (reuse != kNoValue && function.values[reuse].type == type) {
+                IrValue& value = function.values[reuse];
+                value.kind = IRV_CONST;
+                value.name = kNoName;
+                value.doubleValue = 0;
+                if (type == TYPE_INT) {
+                    value.intValue = (int32_t)(uint32_t)k;
+                } else {
+                    memcpy(&value.doubleValue, &k, sizeof(k));
+                }
+                slots[i] = reuse + 1;
+                reuse = kNoValue;
+            } else {
+                slots[i] = create() + 1;
+            }
+            used++;
+        }
+        return slots[i] - 1;
+    }
+
+    // 同值的常量有多个时保留编号最小的
+    void index() {
+        indexed = true;
+        size_t count = 0;
+        for (const IrValue& value : function.values) count += value.kind == IRV_CONST;
+        reserve(count);
+        for (uint32_t id = 0; id < function.values.size(); id++) {
+            const IrValue& value = function.values[id];
+            if (value.kind != IRV_CONST) continue;
+            size_t i = probe(value.type, key(value));
+            if (slots[i] == 0) {
+                slots[i] = id + 1;
+                used++;
+            }
+        }
+    }
+
+    uint32_t intConst(int32_t value) {
+        return find(TYPE_INT, (uint64_t)(uint32_t)value, [&] { return irNewIntConst(function, value); });
+    }
+
+    uint32_t floatConst(MiniType type, double value) {
+        if (type == TYPE_FLOAT) value = (float)value;
+        return find(type, bits(value), [&] { return irNewFloatConst(function, type, value); });
+    }
+
+    // 入口处的变量置0只需要各类型的0：未建表时顺序查找一遍已有的常量，不为此建表
+    uint32_t zeros[TYPE_DOUBLE + 1] = { kNoValue, kNoValue, kNoValue, kNoValue };
+    bool zerosScanned = false;
+
+    uint32_t zero(MiniType type) {
+        if (indexed) return type == TYPE_INT ? intConst(0) : floatConst(type, 0.0);
+        if (!zerosScanned) {
+            zerosScanned = true;
+            for (uint32_t id = 0; id < function.values.size(); id++) {
+                const IrValue& value = function.values[id];
+                if (value.kind != IRV_CONST || zeros[value.type] != kNoValue) continue;
+                if (value.type == TYPE_INT ? value.intValue == 0 : bits(value.doubleValue) == bits(0.0)) {
+                    zeros[value.type] = id;
+                }
+            }
+        }
+        if (zeros[type] == kNoValue) {
+            zeros[type] = type == TYPE_INT ? irNewIntConst(function, 0) : irNewFloatConst(function, type, 0.0);
+        }
+        return zeros[type];
+    }
+};
+
+/* INFO 常量折叠 */
+
+static int32_t wrapInt(int64_t value) {
+    return (int32_t)(uint32_t)(uint64_t)value;
+}
+
+// 按运行时语义求值两个int常量的运算；不能在编译时求值时返回false
+static bool foldInt(IrOp op, int32_t x, int32_t y, int32_t& result) {
+    switch (op) {
+        case IR_ADD: result = wrapInt((int64_t)x + y); return true;
+        case IR_SUB: result = wrapInt((int64_t)x - y); return true;
+        case IR_MUL: result = wrapInt((int64_t)x * y); return true;
+        case IR_DIV:
+            if (y == 0) return false;  // 运行时错误，保留
+            result = (x == INT32_MIN && y == -1) ? INT32_MIN : x / y;
+            return true;
+        case IR_AND: result = x & y; return true;
+        case IR_OR: result = x | y; return true;
+        case IR_EQ: result = x == y; return true;
+        case IR_NE: result = x != y; return true;
+        case IR_LT: result = x < y; return true;
+        case IR_LE: result = x <= y; return true;
+        case IR_GT: result = x > y; return true;
+        case IR_GE: result = x >= y; return true;
+        default: return false;
+    }
+}
+
+// 浮点运算：T 为 float 或 double，算术结果按 T 舍入
+template <typename T>
+static bool foldFloat(IrOp op, T x, T y, double& value, bool& isInt) {
+    isInt = op >= IR_EQ;
+    switch (op) {
+        case IR_ADD: value = (T)(x + y); return true;
+        case IR_SUB: value = (T)(x - y); return true;
+        case IR_MUL: value = (T)(x * y); return true;
+        case IR_DIV: value = (T)(x / y); return true;
+        case IR_EQ: value = x == y; return true;
+        case IR_NE: value = x != y; return true;
+        case IR_LT: value = x < y; return true;
+        case IR_LE: value = x <= y; return true;
+        case IR_GT: value = x > y; return true;
+        case IR_GE: value = x >= y; return true;
+        default: return false;
+    }
+}
+
+// 操作数都是常量的指令在编译时求值，成功时result为结果常量
+static bool evaluate(ConstPool& pool, const IrInst& inst, uint32_t& result) {
+    IrFunction& function = pool.function;
+    const IrValue a = function.values[inst.a];
+    MiniType type = function.values[inst.dst].type;
+    if (inst.op == IR_MOV) {
+        result = inst.a;
+        return true;
+    }
+    if (inst.op == IR_CONV) {
+        if (type != TYPE_INT) {
+            result = pool.floatConst(type, a.type == TYPE_INT ? (double)a.intValue : a.doubleValue);
+            return true;
+        }
+        double d = a.type == TYPE_INT ? a.intValue : a.doubleValue;
+        result = pool.intConst(d > -2147483649.0 && d < 2147483648.0 ? (int32_t)d : INT32_MIN);
+        return true;
+    }
+    const IrValue b = function.values[inst.b];
+    if (a.type == TYPE_INT) {
+        int32_t value;
+        if (!foldInt(inst.op, a.intValue, b.intValue, value)) return false;
+        result = pool.intConst(value);
+        return true;
+    }
+    double value;
+    bool isInt;
+    bool folded = a.type == TYPE_FLOAT
+                      ? foldFloat<float>(inst.op, (float)a.doubleValue, (float)b.doubleValue, value, isInt)
+                      : foldFloat<double>(inst.op, a.doubleValue, b.doubleValue, value, isInt);
+    if (!folded) return false;
+    result = isInt ? pool.intConst((int32_t)value) : pool.floatConst(type, value);
+    return true;
+}
+
+/* INFO 不可达块删除 */
+
+// 每个块最终跳转到的块：只含一条 jmp 的块（入口除外）由其目标代替。
+// 沿链求值时记下路径，整条路径一次赋值，每个块只访问常数次
+static std::vector<uint32_t> forwardTargets(const IrFunction& function) {
+    uint32_t count = (uint32_t)function.blocks.size();
+    std::vector<uint32_t> next(count), result(count, kNoBlock), path;
+    std::vector<uint8_t> onPath(count, 0);
+    for (uint32_t b = 0; b < count; b++) {
+        const IrBlock& block = function.blocks[b];
+        next[b] = b;
+        if (b != 0 && block.end - block.begin == 1 && function.insts[block.begin].op == IR_JMP) {
+            next[b] = function.insts[block.begin].b;
+        }
+    }
+    for (uint32_t b = 0; b < count; b++) {
+        uint32_t cur = b;
+        while (result[cur] == kNoBlock && next[cur] != cur && !onPath[cur]) {
+            onPath[cur] = 1;
+            path.push_back(cur);
+            cur = next[cur];
+        }
+        // 停在已求值的块、不可转发的块，或空块组成的环（死循环）上
+        uint32_t target = result[cur] != kNoBlock ? result[cur] : cur;
+        result[cur] = target;
+        for (uint32_t p : path) {
+            result[p] = target;
+            onPath[p] = 0;
+        }
+        path.clear();
+    }
+    return result;
+}
+
+/* 接口实现 */
+
+size_t irFoldConstants(IrFunction& function) {
+    size_t before = irInstructionCount(function);
+    ConstPool pool(function);
+    std::vector<uint32_t> defs = definitionCounts(function);
+    size_t count = function.values.size();
+    uint32_t blockCount = (uint32_t)function.blocks.size();
+    std::vector<uint32_t> known(count, kNoValue);   // 值 -> 已知的常量
+    std::vector<uint32_t> scope(count, kNoBlock);   // known 的有效范围：链号，kNoBlock 表示全函数有效
+    uint32_t chain = 0;                             // 当前块所在的链
+    size_t branches = 0;                            // 改为 jmp 的条件分支
+    auto substitute = [&](uint32_t& value) {
+        if (value < count && known[value] != kNoValue && (scope[value] == kNoBlock || scope[value] == chain)) {
+            value = known[value];
+        }
+    };
+
+    // 可执行的块：入口，或有一条来自可执行块、没有被折叠掉的边。唯一的可执行前驱以跳转进入、
+    // 且没有回边进入的块接在前驱所在的链上，继承链上已知的常量；条件为常量的分支因此沿整条链连续折叠。
+    // 不可执行的块不处理，留给不可达块删除
+    std::vector<uint32_t> order = irReversePostorder(function);
+    std::vector<uint32_t> position(blockCount, kNoBlock), execCount(blockCount, 0), execPred(blockCount, kNoBlock);
+    std::vector<uint32_t> chainOf(blockCount, kNoBlock), chainTail;
+    for (uint32_t p = 0; p < order.size(); p++) position[order[p]] = p;
+    auto markExecutable = [&](uint32_t from, uint32_t to) {
+        execCount[to]++;
+        execPred[to] = from;
+    };
+
+    for (uint32_t p = 0; p < order.size(); p++) {
+        uint32_t b = order[p];
+        const IrBlock& block = function.blocks[b];
+        bool backEdge = false;
+        for (uint32_t pred : block.preds) backEdge = backEdge || (position[pred] != kNoBlock && position[pred] >= p);
+        if (b != 0 && execCount[b] == 0 && !backEdge) continue;
+        uint32_t from = execPred[b];
+        if (!backEdge && execCount[b] == 1 && chainTail[chainOf[from]] == from) {
+            chain = chainOf[from];
+            chainTail[chain] = b;
+        } else {
+            chain = (uint32_t)chainTail.size();
+            chainTail.push_back(b);
+        }
+        chainOf[b] = chain;
+        if (b == 0 && block.preds.empty()) {
+            // 入口处的变量（参数除外）为0
+            for (uint32_t slot = function.paramCount; slot < function.slotCount; slot++) {
+                known[slot] = pool.zero(function.values[slot].type);
+                scope[slot] = chain;
+            }
+        }
+        for (uint32_t i = block.begin; i < block.end; i++) {
+            IrInst& inst = function.insts[i];
+            if (inst.op == IR_NOP) continue;
+            if (inst.op == IR_JMP) {
+                markExecutable(b, inst.b);
+                continue;
+            }
+            forEachOperand(function, inst, substitute);
+            if (inst.op == IR_BR) {
+                if (isConst(function, inst.a)) {
+                    uint32_t target = truthy(function.values[inst.a]) ? inst.b : inst.c;
+                    inst = IrInst{ IR_JMP, inst.line, kNoValue, kNoValue, target, kNoValue };
+                    markExecutable(b, target);
+                    branches++;
+                } else {
+                    markExecutable(b, inst.b);
+                    if (inst.c != inst.b) markExecutable(b, inst.c);
+                }
+                continue;
+            }
+            if (!definesValue(inst)) continue;
+
+            uint32_t dst = inst.dst;
+            bool global = singleDefinition(function, defs, dst);
+            bool operandsConst = inst.op != IR_CALL && isConst(function, inst.a) &&
+                                 (inst.op == IR_MOV || inst.op == IR_CONV || isConst(function, inst.b));
+            uint32_t constant;
+            pool.reuse = global ? dst : kNoValue;  // 定义将被删除，可以原地成为常量
+            if (operandsConst && evaluate(pool, inst, constant)) {
+                known[dst] = constant;
+                scope[dst] = global ? kNoBlock : chain;
+                if (global) {
+                    inst.op = IR_NOP;  // 全部使用都会被替换为常量
+                } else {
+                    inst = IrInst{ IR_MOV, inst.line, dst, constant, kNoValue, kNoValue };
+                }
+            } else if (!global) {
+                known[dst] = kNoValue;
+            }
+            pool.reuse = kNoValue;
+        }
+    }
+    irCompact(function);
+    if (branches > 0) irComputeCfg(function);
+    return before - irInstructionCount(function) + branches;
+}
+
+size_t irPropagateCopies(IrFunction& function) {
+    size_t before = irInstructionCount(function);
+    std::vector<uint32_t> defs = definitionCounts(function);
+    size_t count = function.values.size();
+    std::vector<uint32_t> replace(count, kNoValue);     // 只定义一次的临时值 -> 全函数有效的替代值
+    std::vector<uint32_t> copyOf(count, kNoValue);      // 本块内 x = y 记录的 y
+    std::vector<uint32_t> copyVersion(count, 0);        // 记录复制时 y 的版本
+    std::vector<uint32_t> version(count, 0);            // 每次定义加1
+    std::vector<uint32_t> local;
+    auto substitute = [&](uint32_t& value) {
+        if (replace[value] != kNoValue) {
+            value = replace[value];
+        } else if (copyOf[value] != kNoValue && version[copyOf[value]] == copyVersion[value]) {
+            value = copyOf[value];
+        }
+    };
+
+    for (uint32_t b : irReversePostorder(function)) {
+        const IrBlock& block = function.blocks[b];
+        for (uint32_t i = block.begin; i < block.end; i++) {
+            IrInst& inst = function.insts[i];
+            if (inst.op == IR_NOP || inst.op == IR_JMP) continue;
+            forEachOperand(function, inst, substitute);
+            if (!definesValue(inst)) continue;
+
+            uint32_t dst = inst.dst;
+            version[dst]++;  // 使以 dst 为来源的复制失效
+            copyOf[dst] = kNoValue;
+            if (inst.op != IR_MOV) continue;
+            uint32_t src = inst.a;
+            if (src == dst) {
+                inst.op = IR_NOP;
+                continue;
+            }
+            if (singleDefinition(function, defs, dst) &&
+                (isConst(function, src) || singleDefinition(function, defs, src))) {
+                replace[dst] = src;
+                inst.op = IR_NOP;
+                continue;
+            }
+            copyOf[dst] = src;
+            copyVersion[dst] = version[src];
+            local.push_back(dst);
+        }
+        for (uint32_t value : local) copyOf[value] = kNoValue;
+        local.clear();
+    }
+    irCompact(function);
+    return before - irInstructionCount(function);
+}
+
+size_t irRemoveUnreachable(IrFunction& function) {
+    irCompact(function);
+    size_t before = irInstructionCount(function);
+    uint32_t count = (uint32_t)function.blocks.size();
+
+    // 规范化终结指令并跳过空块
+    auto simplify = [&](IrInst& last) {
+        if (last.op == IR_BR && (last.b == last.c || isConst(function, last.a))) {
+            uint32_t target = last.b == last.c || truthy(function.values[last.a]) ? last.b : last.c;
+            last = IrInst{ IR_JMP, last.line, kNoValue, kNoValue, target, kNoValue };
+        }
+    };
+    for (IrBlock& block : function.blocks) {
+        if (block.end > block.begin) simplify(function.insts[block.end - 1]);
+    }
+    std::vector<uint32_t> forward = forwardTargets(function);
+    for (IrBlock& block : function.blocks) {
+        if (block.end == block.begin) continue;
+        IrInst& last = function.insts[block.end - 1];
+        if (last.op == IR_JMP) {
+            last.b = forward[last.b];
+        } else if (last.op == IR_BR) {
+            last.b = forward[last.b];
+            last.c = forward[last.c];
+            simplify(last);
+        }
+    }
+    irComputeCfg(function);
+
+    // 可达的块按逆后序排列；唯一前驱以 jmp 结尾的块并入前驱，组成一条链
+    std::vector<uint32_t> order = irReversePostorder(function);
+    std::vector<uint32_t> predCount(count, 0);
+    for (uint32_t b : order) {
+        for (uint32_t succ : function.blocks[b].succs) predCount[succ]++;
+    }
+    std::vector<uint32_t> newId(count, kNoBlock), chainNext(count, kNoBlock), heads;
+    for (uint32_t b : order) {
+        if (newId[b] != kNoBlock) continue;  // 已并入前驱
+        uint32_t id = (uint32_t)heads.size();
+        heads.push_back(b);
+        newId[b] = id;
+        for (uint32_t cur = b;;) {
+            const IrBlock& block = function.blocks[cur];
+            if (block.end == block.begin) break;
+            const IrInst& last = function.insts[block.end - 1];
+            uint32_t succ = last.b;
+            if (last.op != IR_JMP || succ == 0 || predCount[succ] != 1 || newId[succ] != kNoBlock) break;
+            chainNext[cur] = succ;
+            newId[succ] = id;
+            cur = succ;
+        }
+    }
+
+    // 按链重建指令数组与块表
+    std::vector<IrInst> insts;
+    std::vector<IrBlock> blocks(heads.size(), IrBlock{ 0, 0, {}, {} });
+    insts.reserve(function.insts.size());
+    for (uint32_t id = 0; id < heads.size(); id++) {
+        blocks[id].begin = (uint32_t)insts.size();
+        for (uint32_t cur = heads[id]; cur != kNoBlock; cur = chainNext[cur]) {
+            const IrBlock& block = function.blocks[cur];
+            uint32_t end = chainNext[cur] != kNoBlock ? block.end - 1 : block.end;  // 链中间的 jmp 省去
+            insts.insert(insts.end(), function.insts.begin() + block.begin, function.insts.begin() + end);
+        }
+        blocks[id].end = (uint32_t)insts.size();
+        if (blocks[id].end > blocks[id].begin) {
+            IrInst& last = insts.back();
+            if (last.op == IR_JMP || last.op == IR_BR) last.b = newId[last.b];
+            if (last.op == IR_BR) last.c = newId[last.c];
+        }
+    }
+    function.insts.swap(insts);
+    function.blocks.swap(blocks);
+    irComputeCfg(function);
+    return before - irInstructionCount(function);
+}
+
+/* INFO 活跃变量分析 */
+
+// 跨块活跃的值按引用范围分组，逐组在区间内做后向工作表迭代。
+// 组内的值在区间之外不被引用，路径离开区间（经前向边越过 last）后不会再回来，因此区间后的块出口都不活跃；
+// 区间前的块只有在组内某个值未经定义就可能被使用时才活跃，这时把区间扩展到函数入口重新求解
+struct LivenessBuilder {
+    IrFunction& function;
+    IrLiveness& liveness;
+
+    std::vector<uint32_t> order;                       // 可达块的 irNestedOrder
+    std::vector<uint32_t> position;                    // 块在 order 中的位置，不可达时为kNoBlock
+    std::vector<std::pair<uint32_t, uint32_t>> spans;  // 回边覆盖的位置区间，重叠的已合并
+    std::vector<uint32_t> lo, hi;                      // 各值被引用的块的位置范围
+    std::vector<uint32_t> mark, killed;                // 块内扫描的标记（等于stamp时有效）
+    uint32_t stamp = 0;
+    std::vector<std::pair<uint32_t, LivenessSlice>> pending;  // （块，出口位向量），按组的顺序产生
+
+    // 当前组：位置区间 [first, last] 中的块各有一个入口位向量
+    uint32_t group = 0;
+    uint32_t first = 0, last = 0;
+    size_t words = 0;
+    std::vector<uint64_t> sets;                        // 位置 p 的块为 sets[(p - first) * words ..)
+    std::vector<uint64_t> scratch;
+    std::vector<uint32_t> killStart, kills;            // 各块定义的组内值（CSR，位号）
+    std::vector<uint32_t> useStart, uses;              // 各块向上暴露使用的组内值（CSR，位号）
+    std::deque<uint32_t> work;
+    std::vector<bool> queued;
+
+    const std::vector<uint8_t>* only;                  // 只分析其中非0的值，nullptr 表示全部
+
+    LivenessBuilder(IrFunction& f, IrLiveness& l, const std::vector<uint8_t>* o) : function(f), liveness(l), only(o) {}
+
+    bool inGroup(uint32_t value) const {
+        return liveness.indexOf[value] != kNoValue && liveness.indexOf[value] / kLivenessGroupBits == group;
+    }
+    uint32_t bitOf(uint32_t value) const { return liveness.indexOf[value] % kLivenessGroupBits; }
+    uint64_t* setAt(uint32_t p) { return sets.data() + (p - first) * words; }
+    bool inRange(uint32_t p) const { return p >= first && p <= last; }
+
+    // 找出跨块活跃的值及各值被引用的范围，并合并回边区间
+    void collect() {
+        size_t count = function.values.size();
+        order = irNestedOrder(function);
+        position.assign(function.blocks.size(), kNoBlock);
+        for (uint32_t p = 0; p < order.size(); p++) position[order[p]] = p;
+        lo.assign(count, kNoBlock);
+        hi.assign(count, 0);
+        mark.assign(count, 0);
+        killed.assign(count, 0);
+        liveness.indexOf.assign(count, kNoValue);
+        for (uint32_t p = 0; p < order.size(); p++) {
+            const IrBlock& block = function.blocks[order[p]];
+            auto touch = [&](uint32_t v) {
+                lo[v] = std::min(lo[v], p);
+                hi[v] = std::max(hi[v], p);
+            };
+            stamp++;
+            for (uint32_t i = block.begin; i < block.end; i++) {
+                IrInst& inst = function.insts[i];
+                forEachOperand(function, inst, [&](uint32_t& value) {
+                    if (isConst(function, value)) return;
+                    touch(value);
+                    if (mark[value] != stamp && (!only || (*only)[value])) liveness.indexOf[value] = 0;
+                });
+                if (definesValue(inst)) {
+                    touch(inst.dst);
+                    mark[inst.dst] = stamp;
+                }
+            }
+            for (uint32_t succ : block.succs) {
+                if (position[succ] <= p) spans.push_back({ position[succ], p });
+            }
+        }
+        std::sort(spans.begin(), spans.end());
+        size_t merged = 0;
+        for (const auto& span : spans) {
+            if (merged > 0 && span.first <= spans[merged - 1].second) {
+                spans[merged - 1].second = std::max(spans[merged - 1].second, span.second);
+            } else {
+                spans[merged++] = span;
+            }
+        }
+        spans.resize(merged);
+        std::vector<uint32_t>& tracked = liveness.groupValues;
+        tracked.clear();
+        for (uint32_t v = 0; v < count; v++) {
+            if (liveness.indexOf[v] != kNoValue) tracked.push_back(v);
+        }
+        std::stable_sort(tracked.begin(), tracked.end(),
+                         [&](uint32_t x, uint32_t y) { return lo[x] != lo[y] ? lo[x] < lo[y] : hi[x] < hi[y]; });
+        for (uint32_t k = 0; k < tracked.size(); k++) liveness.indexOf[tracked[k]] = k;
+    }
+
+    // 把 [first, last] 扩展到与之相交的回边区间；合并后的区间互不重叠，只需看两端落在哪个区间中
+    void closeRange() {
+        auto containing = [&](uint32_t p) {
+            auto it = std::upper_bound(spans.begin(), spans.end(), std::make_pair(p, UINT32_MAX));
+            return it != spans.begin() && (it - 1)->second >= p ? it - 1 : spans.end();
+        };
+        auto low = containing(first);
+        if (low != spans.end()) first = low->first;
+        auto high = containing(last);
+        if (high != spans.end()) last = high->second;
+    }
+
+    // 建立当前组在区间内各块的定义集与向上暴露使用集，每个值在一块的表中只出现一次
+    void buildSets() {
+        uint32_t count = last - first + 1;
+        kills.clear();
+        uses.clear();
+        killStart.assign(count + 1, 0);
+        useStart.assign(count + 1, 0);
+        for (uint32_t p = first; p <= last; p++) {
+            killStart[p - first] = (uint32_t)kills.size();
+            useStart[p - first] = (uint32_t)uses.size();
+            const IrBlock& block = function.blocks[order[p]];
+            stamp++;
+            for (uint32_t i = block.begin; i < block.end; i++) {
+                IrInst& inst = function.insts[i];
+                forEachOperand(function, inst, [&](uint32_t& value) {
+                    if (isConst(function, value) || !inGroup(value) || mark[value] == stamp || killed[value] == stamp) return;
+                    mark[value] = stamp;
+                    uses.push_back(bitOf(value));
+                });
+                if (definesValue(inst) && inGroup(inst.dst) && killed[inst.dst] != stamp) {
+                    killed[inst.dst] = stamp;
+                    kills.push_back(bitOf(inst.dst));
+                }
+            }
+        }
+        killStart[count] = (uint32_t)kills.size();
+        useStart[count] = (uint32_t)uses.size();
+        sets.assign(count * words, 0);
+        scratch.assign(words, 0);
+        queued.assign(count, false);
+    }
+
+    void push(uint32_t p) {
+        if (p != kNoBlock && inRange(p) && !queued[p - first]) {
+            queued[p - first] = true;
+            work.push_back(p);
+        }
+    }
+
+    // 出口为区间内各后继入口之并，写入scratch
+    void liveOut(uint32_t p) {
+        std::fill(scratch.begin(), scratch.end(), 0);
+        for (uint32_t succ : function.blocks[order[p]].succs) {
+            uint32_t q = position[succ];
+            if (!inRange(q)) continue;
+            const uint64_t* in = setAt(q);
+            for (size_t w = 0; w < words; w++) scratch[w] |= in[w];
+        }
+    }
+
+    // 工作表迭代求各块入口的活跃集合：in = use ∪ (out - def)，某块的入口改变时前驱重新入表
+    void solve() {
+        buildSets();
+        for (uint32_t p = last + 1; p-- > first;) push(p);
+        while (!work.empty()) {
+            uint32_t p = work.front();
+            work.pop_front();
+            queued[p - first] = false;
+            liveOut(p);
+            uint64_t* set = scratch.data();
+            for (uint32_t k = killStart[p - first]; k < killStart[p - first + 1]; k++) {
+                set[kills[k] >> 6] &= ~((uint64_t)1 << (kills[k] & 63));
+            }
+            for (uint32_t k = useStart[p - first]; k < useStart[p - first + 1]; k++) {
+                set[uses[k] >> 6] |= (uint64_t)1 << (uses[k] & 63);
+            }
+            uint64_t* target = setAt(p);
+            if (std::equal(scratch.begin(), scratch.end(), target)) continue;
+            std::copy(scratch.begin(), scratch.end(), target);
+            for (uint32_t pred : function.blocks[order[p]].preds) push(position[pred]);
+        }
+    }
+
+    // 区间外的前驱处是否有活跃的组内值（只在组内的值可能未经定义就被使用时出现）
+    bool liveFromOutside() {
+        for (uint32_t p = first; p <= last; p++) {
+            const uint64_t* in = setAt(p);
+            if (std::all_of(in, in + words, [](uint64_t word) { return word == 0; })) continue;
+            for (uint32_t pred : function.blocks[order[p]].preds) {
+                if (position[pred] < first) return true;
+            }
+        }
+        return false;
+    }
+
+    // 保存当前组在区间内各块的出口位向量
+    void emit() {
+        for (uint32_t p = first; p <= last; p++) {
+            liveOut(p);
+            if (std::all_of(scratch.begin(), scratch.end(), [](uint64_t word) { return word == 0; })) continue;
+            pending.push_back({ order[p], LivenessSlice{ group, (uint32_t)liveness.bits.size() } });
+            liveness.bits.insert(liveness.bits.end(), scratch.begin(), scratch.end());
+        }
+    }
+
+    void run() {
+        // 只有一个块且没有回到自身的边时，没有值在块出口活跃（内联后大量的小函数）
+        if (function.blocks.size() == 1 && function.blocks[0].succs.empty()) {
+            liveness.groupValues.clear();
+            liveness.indexOf.assign(function.values.size(), kNoValue);
+            liveness.sliceStart.assign(2, 0);
+            liveness.slices.clear();
+            liveness.bits.clear();
+            return;
+        }
+        collect();
+        const std::vector<uint32_t>& tracked = liveness.groupValues;
+        liveness.bits.clear();
+        for (size_t k = 0; k < tracked.size(); k += kLivenessGroupBits, group++) {
+            size_t end = std::min(tracked.size(), k + kLivenessGroupBits);
+            first = UINT32_MAX;
+            last = 0;
+            words = (end - k + 63) / 64;
+            for (size_t j = k; j < end; j++) {
+                uint32_t v = tracked[j];
+                first = std::min(first, lo[v]);
+                last = std::max(last, hi[v]);
+            }
+            closeRange();
+            solve();
+            if (first > 0 && liveFromOutside()) {
+                first = 0;
+                solve();
+            }
+            emit();
+        }
+
+        // 按块计数排序，同一块的位向量保持组的顺序
+        uint32_t blockCount = (uint32_t)function.blocks.size();
+        liveness.sliceStart.assign(blockCount + 1, 0);
+        for (const auto& entry : pending) liveness.sliceStart[entry.first + 1]++;
+        for (uint32_t b = 0; b < blockCount; b++) liveness.sliceStart[b + 1] += liveness.sliceStart[b];
+        liveness.slices.resize(pending.size());
+        std::vector<uint32_t> cursor(liveness.sliceStart.begin(), liveness.sliceStart.end() - 1);
+        for (const auto& entry : pending) liveness.slices[cursor[entry.first]++] = entry.second;
+    }
+};
+
+void irComputeLiveness(IrFunction& function, IrLiveness& liveness, const std::vector<uint8_t>* only) {
+    LivenessBuilder builder(function, liveness, only);
+    builder.run();
+}
+
+size_t irEliminateDeadStores(IrFunction& function) {
+    irCompact(function);
+    size_t before = irInstructionCount(function);
+    size_t count = function.values.size();
+    uint32_t blockCount = (uint32_t)function.blocks.size();
+    irComputeCfg(function);
+
+    // 没有副作用、结果不用时可以删除的指令；除数可能为0的 int div 留到运行时报错
+    auto removable = [&](const IrInst& inst) {
+        if (inst.op == IR_CALL) return false;
+        if (inst.op == IR_DIV && function.values[inst.b].type == TYPE_INT) {
+            const IrValue& divisor = function.values[inst.b];
+            return divisor.kind == IRV_CONST && divisor.intValue != 0;
+        }
+        return true;
+    };
+
+    // 块内扫描的标记，等于当前轮次时分别表示在块内后面被使用、在块内后面被重新定义
+    std::vector<uint32_t> used(count, 0), redefined(count, 0);
+    uint32_t stamp = 0;
+    IrLiveness liveness;
+    for (bool stale = true; stale;) {
+        irComputeLiveness(function, liveness);
+
+        // 逐块向后扫描，删除结果不活跃的指令：定义之后在块内被使用，或在块内不再被定义且在出口处活跃时保留。
+        // 块内的连锁删除在同一次扫描中完成；删除的指令读取跨块活跃的值时，其他块的出口集合可能缩小，需要重新分析
+        stale = false;
+        for (uint32_t b = 0; b < blockCount; b++) {
+            const IrBlock& block = function.blocks[b];
+            stamp++;
+            for (uint32_t i = block.end; i-- > block.begin;) {
+                IrInst& inst = function.insts[i];
+                if (inst.op == IR_NOP) continue;
+                if (definesValue(inst)) {
+                    bool live = used[inst.dst] == stamp || (redefined[inst.dst] != stamp && liveness.isLiveOut(b, inst.dst));
+                    if (!live && removable(inst)) {
+                        forEachOperand(function, inst, [&](uint32_t& value) {
+                            if (liveness.crossBlock(value)) stale = true;
+                        });
+                        inst.op = IR_NOP;
+                        continue;
+                    }
+                    used[inst.dst] = 0;
+                    redefined[inst.dst] = stamp;
+                }
+                forEachOperand(function, inst, [&](uint32_t& value) {
+                    if (!isConst(function, value)) used[value] = stamp;
+                });
+            }
+        }
+    }
+    irCompact(function);
+    return before - irInstructionCount(function);
+}
+
+// 反复执行各遍。不可达块删除放在每轮开头：生成与内联留下的 jmp 链先连成直线代码，块内的常量与复制传播
+// 在第一轮就能走完整段。第一轮之后其余各遍的删除几乎只通过控制流（折叠掉的分支、变空的块）带来新的机会，
+// 因此一轮中没有删除指令，或者第二轮起不可达块删除没有删除指令时停止；常量折叠改掉的分支计入删除数
+static void runPasses(IrFunction& function, OptStats& stats) {
+    for (int round = 0; round < kOptMaxRounds; round++) {
+        size_t unreachable = irRemoveUnreachable(function);
+        if (round > 0 && unreachable == 0) break;
+        size_t folded = irFoldConstants(function);
+        if (folded > 0) compactValues(function);
+        size_t copies = irPropagateCopies(function);
+        size_t deadStores = irEliminateDeadStores(function);
+        stats.folded += folded;
+        stats.copies += copies;
+        stats.unreachable += unreachable;
+        stats.deadStores += deadStores;
+        if (folded + copies + unreachable + deadStores == 0) break;
+    }
+}
+
+// 级别2的 SSA 优化，之后重复各遍清除退出 SSA 留下的复制
+static void runSsaPasses(IrFunction& function, OptStats& stats) {
+    SsaStats ssa;
+    irSsaOptimize(function, ssa);
+    stats.gvn += ssa.gvn;
+    stats.hoisted += ssa.hoisted;
+    runPasses(function, stats);
+}
+
+void optimizeFunction(IrFunction& function, OptStats& stats, int level) {
+    irCompact(function);
+    irComputeCfg(function);
+    stats.before += irInstructionCount(function);
+    runPasses(function, stats);
+    if (level >= 2) runSsaPasses(function, stats);
+    stats.after += irInstructionCount(function);
+}
+
+void optimizeModule(IrModule& module, OptStats& stats, int level) {
+    if (level < 2) {
+        for (IrFunction& function : module.functions) {
+            optimizeFunction(function, stats, level);
+        }
+        return;
+    }
+    // 级别2：按调用图自底向上内联，各函数由上述各遍整理（见 irInlineModule），再删除无用函数，逐个做 SSA 优化
+    for (IrFunction& function : module.functions) {
+        irCompact(function);
+        irComputeCfg(function);
+        stats.before += irInstructionCount(function);
+    }
+    InlineStats inlining;
+    irInlineModule(module, inlining, [&](IrFunction& function) { runPasses(function, stats); });
+    stats.inlined += inlining.inlined;
+    stats.recursive += inlining.recursive;
+    stats.deadFunctions += irRemoveDeadFunctions(module);
+    for (IrFunction& function : module.functions) {
+        runSsaPasses(function, stats);
+        stats.after += irInstructionCount(function);
+    }
+}
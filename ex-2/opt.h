@@ -0,0 +1,113 @@
+#ifndef OPT_H
+#define OPT_H
+
+#include "ir.h"
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+/*
+ * 中间代码优化
+ * ===========================
+ * 在三地址码上反复执行以下各遍（最多 kOptMaxRounds 轮；每轮先做第3遍，把 jmp 链连成直线代码再传播），
+ * 直到某一轮不再删除指令，或者第二轮起第3遍不再删除指令：
+ *   1. 常量折叠：操作数都是常量的运算在编译时求值，结果与运行时语义（见 ir.h）逐位一致——
+ *      int 按补码回绕、除数为0的 div 保留到运行时、float 按单精度舍入；
+ *      已知常量沿块内向后传播，并带入唯一可执行前驱的后继块（折叠掉的分支边不算），
+ *      只定义一次的临时值在整个函数内传播；条件为常量的 br 改为 jmp，一串依次确定的分支在同一遍中折叠。
+ *   2. 复制传播：x = y 之后、x 或 y 被重新定义之前，对 x 的使用改为 y。
+ *      用“定义版本号”判断复制是否仍然有效，不需要在重新定义时逐个撤销。
+ *   3. 不可达块删除：删除入口不可达的块，跳过只有一条 jmp 的空块，
+ *      并把“唯一前驱以 jmp 结尾”的块并入前驱；块按逆后序重新编号。
+ *   4. 死存储删除：位向量活跃变量分析（块级工作表迭代），
+ *      删除结果不再被使用且没有副作用的指令。call 与可能除以0的 int div 不删除。
+ *      只有删除的指令读取跨块活跃的值时才重新做活跃分析，其余的删除不改变各块出口的活跃集合。
+ *
+ * 每一遍只顺序扫描指令或块。活跃分析只为跨块活跃的值分配位，这些值按被引用的块在 irNestedOrder
+ * 中的位置范围每 kLivenessGroupBits 个一组，每组的位向量只覆盖组内值的引用范围扩展到完整循环后的区间：
+ * 变量与分支都很多的函数按64位字并行计算，SSA 形式大量短命的临时值各组只覆盖一段，总开销不随块数 × 值数增长。
+ *
+ * 优化级别2（默认）按调用图自底向上内联小函数与只调用一次的函数（各函数展开之后做这些遍）、删除从 main
+ * 不可达的函数（见 callgraph.h），再做基于 SSA 的全局值编号与循环不变量外提（见 ssa.h），
+ * 然后重复上述各遍清除退出 SSA 留下的复制。
+ */
+
+static const int kOptMaxRounds = 8;
+
+// 各遍删除的指令数
+struct OptStats {
+    size_t folded = 0;        // 常量折叠（含改为 jmp 的条件分支）
+    size_t copies = 0;        // 复制传播
+    size_t unreachable = 0;   // 不可达块删除（含合并块省去的 jmp）
+    size_t deadStores = 0;    // 死存储删除
+    size_t gvn = 0;           // 全局值编号（级别2）
+    size_t hoisted = 0;       // 外提的循环不变量（级别2，指令数不变）
+    size_t inlined = 0;       // 内联展开的调用点（级别2）
+    size_t deadFunctions = 0; // 删除的无用函数（级别2）
+    size_t recursive = 0;     // 调用图中的递归函数（级别2，不内联）
+    size_t before = 0;        // 优化前的指令数
+    size_t after = 0;         // 优化后的指令数
+};
+
+static const size_t kLivenessGroupBits = 256;
+
+// 活跃变量分析结果：各块出口处活跃的值。只有跨块活跃的值（在某个块中先使用后定义）有位，
+// 按 groupValues 的顺序每 kLivenessGroupBits 个一组，每组在其区间内各块有一个出口位向量，全为0的不保存
+struct LivenessSlice {
+    uint32_t group;    // 组号
+    uint32_t offset;   // 位向量在 bits 中的起点（64位字）
+};
+
+struct IrLiveness {
+    std::vector<uint32_t> groupValues;  // 有位的值，第 k 个属于第 k / kLivenessGroupBits 组
+    std::vector<uint32_t> indexOf;      // 各值在 groupValues 中的下标，没有位时为kNoValue
+    std::vector<uint32_t> sliceStart;   // 块 b 的位向量为 slices[sliceStart[b] .. sliceStart[b+1])，按组号递增
+    std::vector<LivenessSlice> slices;
+    std::vector<uint64_t> bits;
+
+    bool crossBlock(uint32_t value) const { return indexOf[value] != kNoValue; }
+
+    // 值是否在块的出口处活跃
+    bool isLiveOut(uint32_t block, uint32_t value) const {
+        uint32_t index = indexOf[value];
+        if (index == kNoValue) return false;
+        uint32_t group = index / kLivenessGroupBits, bit = index % kLivenessGroupBits;
+        auto end = slices.begin() + sliceStart[block + 1];
+        auto it = std::lower_bound(slices.begin() + sliceStart[block], end, group,
+                                   [](const LivenessSlice& slice, uint32_t g) { return slice.group < g; });
+        return it != end && it->group == group && ((bits[it->offset + (bit >> 6)] >> (bit & 63)) & 1);
+    }
+
+    template <typename Fn>
+    void forEachLiveOut(uint32_t block, Fn fn) const {
+        for (uint32_t s = sliceStart[block]; s < sliceStart[block + 1]; s++) {
+            size_t base = (size_t)slices[s].group * kLivenessGroupBits;
+            size_t words = (std::min(groupValues.size() - base, kLivenessGroupBits) + 63) / 64;
+            const uint64_t* set = bits.data() + slices[s].offset;
+            for (size_t w = 0; w < words; w++) {
+                for (uint64_t word = set[w]; word != 0; word &= word - 1) {
+                    fn(groupValues[base + (w << 6) + (size_t)__builtin_ctzll(word)]);
+                }
+            }
+        }
+    }
+};
+
+/* INFO 优化接口 */
+
+// 活跃变量分析（需先 irComputeCfg），结果写入liveness；从入口不可达的块出口处没有活跃的值。
+// only 不为空时只分析其中非0的值，其余的值当作不跨块活跃
+void irComputeLiveness(IrFunction& function, IrLiveness& liveness, const std::vector<uint8_t>* only = nullptr);
+
+// 单独的各遍，返回删除的指令数（常量折叠另计改为 jmp 的条件分支）；执行后指令数组已压缩、控制流图已更新
+size_t irFoldConstants(IrFunction& function);
+size_t irPropagateCopies(IrFunction& function);
+size_t irRemoveUnreachable(IrFunction& function);
+size_t irEliminateDeadStores(IrFunction& function);
+
+// 对一个函数或整个程序按级别优化（1：上述各遍；2：另加 SSA 优化，整个程序时还有内联与无用函数删除），
+// 统计累加到stats
+void optimizeFunction(IrFunction& function, OptStats& stats, int level = 2);
+void optimizeModule(IrModule& module, OptStats& stats, int level = 2);
+
+#endif /* OPT_H */
@@ -0,0 +1,94 @@
+#include "output.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+/* 接口实现 */
+// 生成诊断文件的内容
+OutputFile renderDiagnosticsFile(const std::string& name, const std::vector<ParserError>& diagnostics,
+                                 const std::string& emptyNote) {
+    std::ostringstream file;
+    file << "行号\t错误信息\n";
+    file << "-------------------------------------\n";
+    
+    for (const auto& error : diagnostics) {
+        file << error.line << "\t" << error.message << "\n";
+    }
+    
+    if (diagnostics.empty()) {
+        file << emptyNote << "\n";
+    }
+    return { name, file.str() };
+}
+
+// 生成各输出文件的内容
+std::vector<OutputFile> renderOutputFiles(const std::vector<TokenAttr>& tokens, const std::vector<ErrorInfo>& lexErrors,
+                                          const std::vector<ParserError>* parseErrors) {
+    std::vector<OutputFile> files;
+    
+    // Token列表
+    {
+        std::ostringstream tokenFile;
+        tokenFile << "行号\t类型\t\t值\n";
+        tokenFile << "-------------------------------------\n";
+        
+        for (const auto& token : tokens) {
+            tokenFile << token.line << "\t" 
+                     << getTokenName(token.code) << "\t" 
+                     << token.value << "\n";
+        }
+        files.push_back({ "tokens.txt", tokenFile.str() });
+    }
+    
+    // 词法错误信息
+    if (!lexErrors.empty()) {
+        std::ostringstream errorFile;
+        errorFile << "行号\t错误信息\n";
+        errorFile << "-------------------------------------\n";
+        
+        for (const auto& error : lexErrors) {
+            errorFile << error.line << "\t" << error.message << "\n";
+        }
+        files.push_back({ "lex_errors.txt", errorFile.str() });
+    }
+    
+    // 语法错误信息
+    if (parseErrors != nullptr) {
+        // 始终创建语法错误文件，即使没有错误
+        files.push_back(renderDiagnosticsFile("parse_errors.txt", *parseErrors, "无语法错误"));
+    }
+    
+    return files;
+}
+
+// 输出结果到文件
+bool writeOutputFiles(const std::string& dirName, const std::vector<TokenAttr>& tokens,
+                      const std::vector<ErrorInfo>& lexErrors, const std::vector<ParserError>* parseErrors,
+                      const std::vector<OutputFile>& extraFiles) {
+    // 创建输出目录
+    struct stat info;
+    
+    if (stat(dirName.c_str(), &info) != 0) { // 检查目录是否存在
+        if (mkdir(dirName.c_str(), 0777) == -1) {
+            std::cerr << "错误: 无法创建目录 " << dirName << std::endl;
+            return false;
+        }
+    } else if (!(info.st_mode & S_IFDIR)) { // 如果存在但不是目录
+        std::cerr << "错误: " << dirName << " 已存在但不是目录" << std::endl;
+        return false;
+    }
+    
+    std::vector<OutputFile> files = renderOutputFiles(tokens, lexErrors, parseErrors);
+    files.insert(files.end(), extraFiles.begin(), extraFiles.end());
+    for (const auto& file : files) {
+        std::ofstream stream(dirName + "/" + file.name, std::ios::binary);
+        if (stream.is_open()) {
+            stream << file.content;
+            stream.close();
+        }
+    }
+    
+    return true;
+}
@@ -0,0 +1,35 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include "lexer.h"
+#include "parser.h"
+#include <string>
+#include <vector>
+
+/* INFO 结果输出接口 */
+
+// 一个输出文件：目录内的文件名与完整内容
+struct OutputFile {
+    std::string name;
+    std::string content;
+};
+
+// 生成诊断文件的内容（格式与 parse_errors.txt 相同），没有诊断时写入 emptyNote
+OutputFile renderDiagnosticsFile(const std::string& name, const std::vector<ParserError>& diagnostics,
+                                 const std::string& emptyNote);
+
+// 生成输出目录中各文件的内容（与writeOutputFiles写出的内容逐字节相同），供批量写出使用
+std::vector<OutputFile> renderOutputFiles(const std::vector<TokenAttr>& tokens, const std::vector<ErrorInfo>& lexErrors,
+                                          const std::vector<ParserError>* parseErrors);
+
+// 将分析结果写入目录 dirName（不存在时创建）：
+//   tokens.txt        Token列表
+//   lex_errors.txt    词法错误（有错误时）
+//   parse_errors.txt  语法错误（parseErrors非空指针时，即使没有错误也创建）
+//   extraFiles        其后各阶段（语义分析等）的附加结果文件
+// 目录无法创建时返回false
+bool writeOutputFiles(const std::string& dirName, const std::vector<TokenAttr>& tokens,
+                      const std::vector<ErrorInfo>& lexErrors, const std::vector<ParserError>* parseErrors,
+                      const std::vector<OutputFile>& extraFiles = {});
+
+#endif /* OUTPUT_H */
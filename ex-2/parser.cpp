@@ -1,13 +1,22 @@
 #include "parser.h"
+#include "trace.h"
 #include <iostream>
 #include <map>
 #include <string>
 #include <vector>
 
-/* 全局变量 */
-static TokenAttr g_token;               // 当前分析的Token
-static std::vector<ParserError> g_errors; // 语法错误列表
-static bool g_hasError = false;         // 是否有语法错误
+/* 全局变量（按线程独立） */
+static thread_local TokenAttr g_token;               // 当前分析的Token
+static thread_local std::vector<ParserError> g_errors; // 语法错误列表
+static thread_local bool g_hasError = false;         // 是否有语法错误
+static thread_local int g_lastLine = 1;              // 最近一个已匹配Token的行号
+static thread_local std::vector<FunctionInfo> g_functions; // 已识别的函数定义
+static thread_local long g_skippedTokens = 0;        // 错误恢复中跳过的Token总数
+static thread_local int g_nesting = 0;               // 当前语句/括号嵌套层数
+
+// 嵌套层数上限：递归下降每层会占用若干栈帧，超出上限时报错并跳过整个嵌套结构，
+// 避免病态输入（如上百万个 '(' 或 '{'）导致栈溢出
+static const int kMaxNestingDepth = 256;
 
 /*
  * Mini语言BNF文法定义 - 分层结构
@@ -38,7 +47,7 @@ static bool g_hasError = false;         // 是否有语法错误
  *                         | 'if' '(' <expression> ')' 'then' <statement> ('else' <statement>)?
  * <iteration-statement> ::= 'while' '(' <expression> ')' <statement>
  * <return-statement> ::= 'return' <expression>? ';'
- * <variable-declaration> ::= <type-specifier> <identifier> ('=' <expression>)? ';'
+ * <variable-declaration> ::= <type-specifier> <identifier> ('=' <logical-or-expression>)? ';'
  *
  * 第5层：表达式层
  * <expression> ::= <assignment-expression>
@@ -60,6 +69,8 @@ static bool g_hasError = false;         // 是否有语法错误
  * <additive-expression> ::= <multiplicative-expression>
  *                         | <additive-expression> '+' <multiplicative-expression>
  *                         | <additive-expression> '-' <multiplicative-expression>
+ *                         | <additive-expression> '|' <multiplicative-expression>
+ *                         | <additive-expression> '&' <multiplicative-expression>
  * <multiplicative-expression> ::= <primary-expression>
  *                               | <multiplicative-expression> '*' <primary-expression>
  *                               | <multiplicative-expression> '/' <primary-expression>
@@ -70,6 +81,8 @@ static bool g_hasError = false;         // 是否有语法错误
  *                        | '(' <expression> ')'  // 括号表达式
  *                        | <identifier> '(' <argument-list>? ')' // 函数调用
  * <argument-list> ::= <expression> | <argument-list> ',' <expression>
+ *
+ * tools/lalr_gen 读取本注释中的文法生成 lalr_tables.h（修改文法后运行 ./run_tests.sh lalr）
  */
 
 /* 前向声明所有解析函数 */
@@ -105,7 +118,8 @@ static void addError(const std::string& message) {
     ParserError error = { g_token.line, message };
     g_errors.push_back(error);
     g_hasError = true;  // 设置错误标志
-    std::cerr << "Syntax Error at line " << g_token.line << ": " << message << std::endl;
+    if (getLexerErrorEcho())
+        getLexerErrorStream() << "Syntax Error at line " << g_token.line << ": " << message << std::endl;
 }
 
 // 增强的错误报告函数，包含当前Token的详细信息
@@ -117,12 +131,14 @@ static void addDetailedError(const std::string& message) {
     ParserError error = { g_token.line, detailedMessage };
     g_errors.push_back(error);  // 确保错误被添加到g_errors向量中
     g_hasError = true;  // 设置错误标志
-    std::cerr << "Syntax Error at line " << g_token.line << ": " << detailedMessage << std::endl;
+    if (getLexerErrorEcho())
+        getLexerErrorStream() << "Syntax Error at line " << g_token.line << ": " << detailedMessage << std::endl;
 }
 
 // 匹配特定类型的Token
 static bool match(TokenCode code) {
     if (g_token.code == code) {
+        g_lastLine = g_token.line;
         g_token = getNextToken();  // INFO get next token
         return true;
     }
@@ -135,7 +151,7 @@ static bool isToken(TokenCode code) {
 }
 
 // 记录并跳过语法错误
-static void skipUntil(std::vector<TokenCode> syncSet) {
+static void skipUntil(const std::vector<TokenCode>& syncSet) {
     // 记录跳过的token，用于错误报告
     std::string skippedTokens = "";
     int skipCount = 0;
@@ -144,12 +160,12 @@ static void skipUntil(std::vector<TokenCode> syncSet) {
     while (g_token.code != TK_EOF) {
         for (TokenCode code : syncSet) {
             if (g_token.code == code) {
-                if (skipCount > 0) {
+                if (skipCount > 0 && getLexerErrorEcho()) {
                     std::string message = "已跳过 " + std::to_string(skipCount) + " 个token";
                     if (!skippedTokens.empty()) {
                         message += " (包括: " + skippedTokens + ")";
                     }
-                    std::cerr << "Info: " << message << std::endl;
+                    getLexerErrorStream() << "Info: " << message << std::endl;
                 }
                 return;
             }
@@ -165,11 +181,41 @@ static void skipUntil(std::vector<TokenCode> syncSet) {
             skippedTokens += "...";
         }
         skipCount++;
+        g_skippedTokens++;
         
         g_token = getNextToken();
     }
 }
 
+// 进入一层嵌套，离开作用域时自动退出
+struct NestingScope {
+    NestingScope() { g_nesting++; }
+    ~NestingScope() { g_nesting--; }
+};
+
+// 嵌套过深：报错一次，并跳过当前位置开始的整个括号/大括号结构或语句
+static bool skipTooDeep() {
+    addDetailedError("嵌套层数超过上限 " + std::to_string(kMaxNestingDepth));
+    int depth = 0;
+    while (g_token.code != TK_EOF) {
+        TokenCode code = g_token.code;
+        if (depth == 0 && (code == TK_CLOSEPA || code == TK_END)) {
+            break;  // 未匹配的右括号属于外层结构
+        }
+        if (code == TK_OPENPA || code == TK_BEGIN) {
+            depth++;
+        } else if (code == TK_CLOSEPA || code == TK_END) {
+            depth--;
+        }
+        g_skippedTokens++;
+        g_token = getNextToken();
+        if (depth == 0 && (code == TK_SEMOCOLOM || code == TK_CLOSEPA || code == TK_END)) {
+            break;
+        }
+    }
+    return true;  // 已报告错误并完成同步，调用者可继续分析
+}
+
 /* INFO 递归下降分析函数实现 */
 
 // <program> ::= <function-definition>+
@@ -183,7 +229,13 @@ static bool program() {
         // 检查是否为函数定义的开始（类型说明符）
         // std::cout << "program: " << getTokenName(g_token.code) << std::endl;  // TEST
         if (g_token.code == KW_INT || g_token.code == KW_DOUBLE || g_token.code == KW_FLOAT) {
-            if (!functionDefinition()) {
+            double traceStart = traceFunctionsEnabled() ? traceNowUs() : 0;
+            size_t functionCount = g_functions.size();
+            bool defined = functionDefinition();
+            if (traceFunctionsEnabled()) {
+                traceSpan("function", g_functions.size() > functionCount ? g_functions.back().name : "<invalid>", traceStart);
+            }
+            if (!defined) {
                 success = false;
                 // 提供更详细的错误信息
                 addDetailedError("函数定义语法错误");
@@ -206,6 +258,7 @@ static bool program() {
 // 第2层：函数定义层
 // <function-definition> ::= <type-specifier> <identifier> '(' <parameter-list>? ')' <compound-statement>
 static bool functionDefinition() {
+    TokenCode returnType = g_token.code;
     if (!typeSpecifier()) {
         addDetailedError("函数定义缺少类型说明符");
         return false;
@@ -215,6 +268,8 @@ static bool functionDefinition() {
         addDetailedError("函数定义缺少函数名");
         return false;
     }
+    FunctionInfo info = { g_token.value, returnType, g_token.line, g_token.line, {} };
+    g_functions.push_back(info);
     match(TK_IDENT);
     
     if (!match(TK_OPENPA)) {
@@ -232,7 +287,9 @@ static bool functionDefinition() {
         return false;
     }
     
-    if (!compoundStatement()) {
+    bool bodyOk = compoundStatement();
+    g_functions.back().endLine = g_lastLine;
+    if (!bodyOk) {
         addDetailedError("函数定义缺少函数体");
         return false;
     }
@@ -269,6 +326,7 @@ static bool parameterList() {
 // 第2层：函数定义层
 // <parameter-declaration> ::= <type-specifier> <identifier>
 static bool parameterDeclaration() {
+    TokenCode type = g_token.code;
     if (!typeSpecifier()) {
         addDetailedError("参数声明缺少类型说明符");
         return false;
@@ -278,6 +336,8 @@ static bool parameterDeclaration() {
         addDetailedError("参数声明缺少参数名");
         return false;
     }
+    ParamInfo param = { type, g_token.value };
+    g_functions.back().params.push_back(param);
     match(TK_IDENT);
     
     return true;
@@ -333,6 +393,11 @@ static bool statementList() {
 // INFO 不同的语句入口
 // <statement> ::= <expression-statement> | <compound-statement> | <selection-statement> | <iteration-statement> | <return-statement> | <variable-declaration>
 static bool statement() {
+    NestingScope scope;
+    if (g_nesting > kMaxNestingDepth) {
+        return skipTooDeep();
+    }
+    
     switch (g_token.code) {
         case TK_BEGIN:
             return compoundStatement();
@@ -623,6 +688,11 @@ static bool multiplicativeExpression() {
 //                       | '(' <expression> ')'
 //                       | <identifier> '(' <argument-list>? ')' // 函数调用
 static bool primaryExpression() {
+    NestingScope scope;
+    if (g_nesting > kMaxNestingDepth) {
+        return skipTooDeep();
+    }
+    
     if (g_token.code == TK_IDENT) {
         TokenAttr savedToken = g_token;
         match(TK_IDENT);
@@ -739,10 +809,28 @@ static bool argumentList() {
 void initParser(FILE* fp) {
     initLexer(fp);
     g_errors.clear();
+    g_functions.clear();
+    g_lastLine = 1;
+    g_skippedTokens = 0;
+    g_nesting = 0;
     g_hasError = false;  // 初始化错误标志
     // 不要在这里预先获取第一个token
 }
 
+void initParserBuffer(const char* data, size_t len) {
+    initLexerBuffer(data, len);
+    g_errors.clear();
+    g_functions.clear();
+    g_lastLine = 1;
+    g_skippedTokens = 0;
+    g_nesting = 0;
+    g_hasError = false;
+}
+
+void setParserErrorEcho(bool echo) {
+    setLexerErrorEcho(echo);
+}
+
 ParserResult parse() {
     bool success = program();
     // 如果有语法错误，返回错误结果
@@ -753,9 +841,21 @@ const std::vector<ParserError>& getParserErrors() {
     return g_errors;
 }
 
+long getSkippedTokenCount() {
+    return g_skippedTokens;
+}
+
+const std::vector<FunctionInfo>& getParsedFunctions() {
+    return g_functions;
+}
+
 void resetParser() {
     resetLexer();
     g_errors.clear();
+    g_functions.clear();
+    g_lastLine = 1;
+    g_skippedTokens = 0;
+    g_nesting = 0;
     g_hasError = false;  // 重置错误标志
     g_token = getNextToken();
 }
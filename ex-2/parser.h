@@ -17,17 +17,44 @@ struct ParserError {
     std::string message;    // 错误信息
 };
 
+// 函数参数信息
+struct ParamInfo {
+    TokenCode type;         // 参数类型（KW_INT/KW_DOUBLE/KW_FLOAT）
+    std::string name;       // 参数名
+};
+
+// 函数定义信息（语法分析过程中记录，供文档符号等使用）
+struct FunctionInfo {
+    std::string name;               // 函数名
+    TokenCode returnType;           // 返回类型
+    int line;                       // 函数名所在行
+    int endLine;                    // 函数定义结束行
+    std::vector<ParamInfo> params;  // 参数列表
+};
+
 /* INFO 语法分析器接口 */
 
 // 初始化语法分析器
 void initParser(FILE* fp);
 
+// 以内存缓冲区初始化语法分析器
+void initParserBuffer(const char* data, size_t len);
+
+// 设置当前线程是否将语法/词法错误回显到标准错误流（默认开启）
+void setParserErrorEcho(bool echo);
+
 // 执行语法分析
 ParserResult parse();
 
 // 获取所有语法错误信息
 const std::vector<ParserError>& getParserErrors();
 
+// 获取错误恢复（skipUntil）中跳过的Token总数
+long getSkippedTokenCount();
+
+// 获取语法分析过程中识别出的函数定义
+const std::vector<FunctionInfo>& getParsedFunctions();
+
 // 重置语法分析器
 void resetParser();
 
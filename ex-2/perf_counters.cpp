@@ -0,0 +1,141 @@
+#include "perf_counters.h"
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+static const char* counterNames[PERF_COUNTER_NUM] = {
+    "cycles", "instructions", "branch-misses", "L1d-misses", "LLC-misses"
+};
+
+/* 辅助函数 */
+// 填写计数器对应的事件类型与配置
+static void counterConfig(PerfCounterId id, perf_event_attr& attr) {
+    switch (id) {
+        case PERF_CYCLES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PERF_INSTRUCTIONS:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PERF_BRANCH_MISSES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case PERF_L1D_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D |
+                          (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case PERF_LLC_MISSES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        default:
+            break;
+    }
+}
+
+// 读取一个计数器，按复用比例换算；不可用时返回0
+static uint64_t readCounter(int fd) {
+    if (fd < 0) return 0;
+    uint64_t values[3];  // 计数值、启用时间、运行时间
+    if (read(fd, values, sizeof(values)) != (ssize_t)sizeof(values)) return 0;
+    if (values[2] == 0) return 0;
+    if (values[2] < values[1]) {
+        return (uint64_t)((double)values[0] * values[1] / values[2]);
+    }
+    return values[0];
+}
+
+/* 接口实现 */
+bool perfOpen(PerfCounters& perf) {
+    memset(perf.start, 0, sizeof(perf.start));
+    memset(perf.counts, 0, sizeof(perf.counts));
+    bool any = false;
+    for (int i = 0; i < PERF_COUNTER_NUM; i++) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        counterConfig((PerfCounterId)i, attr);
+        attr.exclude_kernel = 1;  // 仅统计用户态，兼容 perf_event_paranoid=2
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        perf.fds[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (perf.fds[i] < 0) {
+            perf.errors[i] = strerror(errno);
+        } else {
+            perf.errors[i].clear();
+            any = true;
+        }
+    }
+    return any;
+}
+
+void perfBegin(PerfCounters& perf) {
+    for (int i = 0; i < PERF_COUNTER_NUM; i++) {
+        perf.start[i] = readCounter(perf.fds[i]);
+    }
+}
+
+void perfEnd(PerfCounters& perf, StatsPhase phase) {
+    for (int i = 0; i < PERF_COUNTER_NUM; i++) {
+        perf.counts[phase][i] += readCounter(perf.fds[i]) - perf.start[i];
+    }
+}
+
+void perfClose(PerfCounters& perf) {
+    for (int i = 0; i < PERF_COUNTER_NUM; i++) {
+        if (perf.fds[i] >= 0) {
+            close(perf.fds[i]);
+            perf.fds[i] = -1;
+        }
+    }
+}
+
+void printPerfReport(const PerfCounters& perf, size_t tokens, std::ostream& out) {
+    char line[200];
+    out << "\n=== 硬件计数器 ===\n";
+
+    bool any = false;
+    for (int i = 0; i < PERF_COUNTER_NUM; i++) {
+        if (perf.fds[i] < 0) {
+            out << counterNames[i] << ": 不可用 (" << perf.errors[i] << ")\n";
+        } else {
+            any = true;
+        }
+    }
+    if (!any) {
+        out << "硬件计数器均不可用（虚拟机/容器或 perf_event_paranoid 限制），已跳过\n";
+        return;
+    }
+
+    out << "阶段\tcycles\t\tinstructions\tIPC\tbr-miss\tL1d-miss\tLLC-miss\n";
+    for (int p = 0; p < PHASE_NUM; p++) {
+        const uint64_t* c = perf.counts[p];
+        double ipc = c[PERF_CYCLES] ? (double)c[PERF_INSTRUCTIONS] / c[PERF_CYCLES] : 0.0;
+        snprintf(line, sizeof(line), "%s\t%-12llu\t%-12llu\t%.2f\t%llu\t%llu\t\t%llu\n",
+                 kPhaseNames[p],
+                 (unsigned long long)c[PERF_CYCLES], (unsigned long long)c[PERF_INSTRUCTIONS], ipc,
+                 (unsigned long long)c[PERF_BRANCH_MISSES], (unsigned long long)c[PERF_L1D_MISSES],
+                 (unsigned long long)c[PERF_LLC_MISSES]);
+        out << line;
+    }
+
+    if (tokens == 0) return;
+    out << "每Token（词法/语法）:\n";
+    for (int i = 0; i < PERF_COUNTER_NUM; i++) {
+        if (perf.fds[i] < 0) continue;
+        snprintf(line, sizeof(line), "  %-14s %.3f / %.3f\n", counterNames[i],
+                 (double)perf.counts[PHASE_LEX][i] / tokens,
+                 (double)perf.counts[PHASE_PARSE][i] / tokens);
+        out << line;
+    }
+}
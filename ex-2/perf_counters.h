@@ -0,0 +1,42 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include "stats.h"
+#include <cstdint>
+#include <string>
+#include <ostream>
+
+/* 采集的硬件计数器 */
+enum PerfCounterId {
+    PERF_CYCLES = 0,        // CPU周期
+    PERF_INSTRUCTIONS,      // 退休指令数
+    PERF_BRANCH_MISSES,     // 分支预测失败
+    PERF_L1D_MISSES,        // L1数据缓存读缺失
+    PERF_LLC_MISSES,        // 末级缓存缺失
+    PERF_COUNTER_NUM
+};
+
+/* 各阶段的硬件计数 */
+struct PerfCounters {
+    int fds[PERF_COUNTER_NUM];                  // perf_event文件描述符，-1表示不可用
+    std::string errors[PERF_COUNTER_NUM];       // 打开失败的原因
+    uint64_t start[PERF_COUNTER_NUM];           // 当前阶段开始时的读数
+    uint64_t counts[PHASE_NUM][PERF_COUNTER_NUM]; // 各阶段累计计数
+};
+
+// 为当前线程打开计数器；全部不可用时返回false（不影响正常分析）
+bool perfOpen(PerfCounters& perf);
+
+// 记录阶段开始时的读数
+void perfBegin(PerfCounters& perf);
+
+// 将从perfBegin到当前的计数累加到指定阶段
+void perfEnd(PerfCounters& perf, StatsPhase phase);
+
+// 关闭计数器
+void perfClose(PerfCounters& perf);
+
+// 输出各阶段的计数、IPC以及每Token的缺失次数
+void printPerfReport(const PerfCounters& perf, size_t tokens, std::ostream& out);
+
+#endif /* PERF_COUNTERS_H */
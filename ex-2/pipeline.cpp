@@ -0,0 +1,165 @@
+#include "pipeline.h"
+#include "trace.h"
+#include <atomic>
+#include <thread>
+#include <sstream>
+
+/* 环形缓冲区参数 */
+static const size_t kRingSlots = 4096;  // 槽位数（2的幂），决定内存上限
+static const size_t kBatch = 64;        // 每批发布的Token数
+static const int kSpinCount = 64;       // 让出CPU前的自旋次数
+
+// 一个槽位：Token及扫描它时产生的词法错误
+struct TokenSlot {
+    TokenAttr token;
+    std::vector<ErrorInfo> errors;
+};
+
+// 单生产者/单消费者环形缓冲区
+// head与tail只增不减，槽位下标为位置对kRingSlots取模
+struct TokenRing {
+    std::vector<TokenSlot> slots;
+    alignas(64) std::atomic<size_t> head;  // 消费者已读到的位置
+    alignas(64) std::atomic<size_t> tail;  // 生产者已发布的位置
+
+    TokenRing() : slots(kRingSlots), head(0), tail(0) {}
+};
+
+// 等待条件成立：先自旋，再让出CPU（单核上生产者与消费者必须交替运行）
+template <typename Ready>
+static void waitUntil(Ready ready) {
+    for (int spin = 0; !ready(); spin++) {
+        if (spin >= kSpinCount) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+// 生产者：在独立线程中扫描缓冲区，按批发布Token
+static void produceTokens(TokenRing& ring, const char* data, size_t len, bool echo, std::ostream* stream) {
+    double traceStart = traceEnabled() ? traceNowUs() : 0;
+    if (traceEnabled()) traceThreadName("pipeline lexer");
+    setLexerErrorEcho(echo);
+    setLexerErrorStream(stream);
+    initLexerBuffer(data, len);
+
+    size_t tail = 0;          // 下一个写入位置
+    size_t published = 0;     // 已发布的位置
+    size_t headCache = 0;     // 最近读到的消费者位置
+    size_t errorsSeen = 0;
+    TokenAttr token;
+    do {
+        token = getNextToken();
+
+        // 缓冲区满：先发布已写入的Token，再等待消费者腾出空间
+        if (tail - headCache == kRingSlots) {
+            ring.tail.store(tail, std::memory_order_release);
+            published = tail;
+            waitUntil([&] {
+                headCache = ring.head.load(std::memory_order_acquire);
+                return tail - headCache < kRingSlots;
+            });
+        }
+
+        TokenSlot& slot = ring.slots[tail & (kRingSlots - 1)];
+        slot.errors.clear();
+        const std::vector<ErrorInfo>& errors = getErrors();
+        for (; errorsSeen < errors.size(); errorsSeen++) {
+            slot.errors.push_back(errors[errorsSeen]);
+        }
+        slot.token = token;
+        tail++;
+
+        if (tail - published >= kBatch || token.code == TK_EOF) {
+            ring.tail.store(tail, std::memory_order_release);
+            published = tail;
+        }
+    } while (token.code != TK_EOF);
+
+    closeLexer();
+    if (traceEnabled()) traceSpan("phase", "pipeline lex", traceStart);
+}
+
+// 消费者一侧的读取状态
+struct TokenReader {
+    TokenRing& ring;
+    std::vector<TokenAttr>* tokens;
+    size_t head = 0;          // 下一个读取位置
+    size_t published = 0;     // 已发布的位置
+    size_t tailCache = 0;     // 最近读到的生产者位置
+    bool finished = false;    // 已读到EOF
+    bool recordErrors = true; // 是否把槽位中的词法错误转交给当前线程
+    TokenAttr eofToken;
+
+    TokenReader(TokenRing& r, std::vector<TokenAttr>* t) : ring(r), tokens(t) {}
+
+    TokenAttr next() {
+        if (finished) {
+            return eofToken;  // 与串行模式一致：EOF之后继续返回EOF
+        }
+
+        // 没有可读的Token：先发布读取位置，再等待生产者
+        if (head == tailCache) {
+            ring.head.store(head, std::memory_order_release);
+            published = head;
+            waitUntil([&] {
+                tailCache = ring.tail.load(std::memory_order_acquire);
+                return tailCache != head;
+            });
+        }
+
+        TokenSlot& slot = ring.slots[head & (kRingSlots - 1)];
+        if (recordErrors) {
+            for (const ErrorInfo& error : slot.errors) {
+                recordLexError(error);
+            }
+        }
+        TokenAttr token = std::move(slot.token);
+        head++;
+        if (head - published >= kBatch) {
+            ring.head.store(head, std::memory_order_release);
+            published = head;
+        }
+
+        if (token.code == TK_EOF) {
+            finished = true;
+            eofToken = token;
+        }
+        if (tokens) {
+            tokens->push_back(token);
+        }
+        return token;
+    }
+};
+
+/* 接口实现 */
+
+ParserResult parsePipelined(const char* data, size_t len, std::vector<TokenAttr>* tokens) {
+    TokenRing ring;
+    bool echo = getLexerErrorEcho();
+    std::ostream& stream = getLexerErrorStream();
+
+    // 语法分析过程中的回显先写入缓冲，保证在词法线程的回显之后输出
+    std::ostringstream parseEcho;
+    std::thread lexer(produceTokens, std::ref(ring), data, len, echo, &stream);
+
+    TokenReader reader(ring, tokens);
+    initParserBuffer(data, len);
+    setLexerErrorStream(&parseEcho);
+    setTokenSource([&reader] { return reader.next(); });
+    ParserResult result = parse();
+    setTokenSource(nullptr);
+    setLexerErrorStream(&stream);
+
+    // 语法分析可能在EOF之前结束：读完剩余Token（不再记录错误，与串行的语法分析一致），
+    // 使词法线程能够退出
+    reader.recordErrors = false;
+    while (!reader.finished) {
+        reader.next();
+    }
+    lexer.join();
+
+    stream << parseEcho.str();
+    stream.flush();
+    return result;
+}
@@ -0,0 +1,23 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "lexer.h"
+#include "parser.h"
+#include <vector>
+
+/*
+ * 流水线分析
+ * ===========================
+ * 词法分析线程把Token写入单生产者/单消费者无锁环形缓冲区，当前线程的语法分析器
+ * 通过 getNextToken 从中读取。读写位置按批发布以减少同步次数，缓冲区满时生产者等待，
+ * 内存占用与输入大小无关。
+ *
+ * 结果与串行的「一遍词法分析 + initParserBuffer/parse」完全相同：语法/词法错误、函数定义、
+ * 回退次数等仍通过原有接口获取；错误回显的内容与顺序也与串行模式一致
+ * （词法线程先回显第一遍的词法错误，语法分析过程中的输出在结束后整体写出）。
+ */
+
+// 以流水线方式分析缓冲区；tokens非空时按顺序收集全部Token（含EOF）
+ParserResult parsePipelined(const char* data, size_t len, std::vector<TokenAttr>* tokens);
+
+#endif /* PIPELINE_H */
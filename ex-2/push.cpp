@@ -0,0 +1,114 @@
+#include "push.h"
+#include <cstdlib>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// 语法分析器的栈大小：与主线程默认栈相同，页面按需分配，实际只占用用到的部分
+static const size_t kParserStackSize = 8u << 20;
+
+// 正在启动的会话（makecontext只能传递int参数）
+static thread_local PushParser* g_starting = nullptr;
+
+PushParser::PushParser(bool keepTokens) : m_keepTokens(keepTokens), m_stackSize(kParserStackSize) {
+    // 最低的一页设为不可访问，栈溢出时立即出错而不是破坏其他内存
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    m_stack = mmap(nullptr, m_stackSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (m_stack == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    mprotect(m_stack, page, PROT_NONE);
+
+    m_result.success = false;
+    m_result.tokenCount = 0;
+    m_result.skippedTokens = 0;
+}
+
+PushParser::~PushParser() {
+    // 挂起中的语法分析器栈上还有存活的对象：以输入结束让它正常运行完毕
+    if (m_started && !m_done) {
+        m_ended = true;
+        resume();
+    }
+    munmap(m_stack, m_stackSize);
+}
+
+// 语法分析器上下文的入口
+void PushParser::entry() {
+    PushParser* self = g_starting;
+    g_starting = nullptr;
+    self->run();
+    // 分析结束，回到调用者，此上下文不再恢复
+    swapcontext(&self->m_parser, &self->m_caller);
+}
+
+void PushParser::run() {
+    initParserBuffer("", 0);
+    setLexerRefill([this](const char*& data, size_t& len) { return nextChunk(data, len); });
+    if (m_keepTokens) {
+        setTokenSink(&m_result.tokens);
+    }
+
+    m_result.success = (parse() == RESULT_SUCCESS);
+    m_result.tokenCount = (size_t)getScannedTokenCount();
+    m_result.lexErrors = getErrors();
+    m_result.parseErrors = getParserErrors();
+    m_result.functions = getParsedFunctions();
+    m_result.skippedTokens = getSkippedTokenCount();
+    closeParser();
+    m_done = true;
+}
+
+// 词法分析器需要更多输入：有待处理的分段时直接交出，否则挂起等待下一次feed或finish
+bool PushParser::nextChunk(const char*& data, size_t& len) {
+    while (m_chunk == nullptr) {
+        if (m_ended) {
+            return false;
+        }
+        swapcontext(&m_parser, &m_caller);
+    }
+    data = m_chunk;
+    len = m_chunkLen;
+    m_chunk = nullptr;
+    return true;
+}
+
+// 切换到语法分析器，直到它再次需要输入或分析结束
+// 期间关闭当前线程的错误回显，返回时恢复调用者的设置
+void PushParser::resume() {
+    bool echo = getLexerErrorEcho();
+    setParserErrorEcho(false);
+    if (!m_started) {
+        m_started = true;
+        getcontext(&m_parser);
+        m_parser.uc_stack.ss_sp = m_stack;
+        m_parser.uc_stack.ss_size = m_stackSize;
+        m_parser.uc_link = nullptr;
+        makecontext(&m_parser, &PushParser::entry, 0);
+        g_starting = this;
+    }
+    swapcontext(&m_caller, &m_parser);
+    setParserErrorEcho(echo);
+}
+
+void PushParser::feed(const char* data, size_t len) {
+    if (m_done || m_ended || len == 0) {
+        return;
+    }
+    m_chunk = data;
+    m_chunkLen = len;
+    resume();
+    m_chunk = nullptr;  // 分析结束时分段可能未被取走，不再保留
+}
+
+void PushParser::feed(std::string_view chunk) {
+    feed(chunk.data(), chunk.size());
+}
+
+AnalysisResult PushParser::finish() {
+    m_ended = true;
+    if (!m_done) {
+        resume();
+    }
+    return std::move(m_result);
+}
@@ -0,0 +1,60 @@
+#ifndef PUSH_H
+#define PUSH_H
+
+#include "frontend.h"
+#include <string_view>
+#include <ucontext.h>
+
+/*
+ * 推送式分析
+ * ===========================
+ * 输入按任意大小的分段送入（feed），最后调用 finish 取得结果。语法分析器运行在独立的栈上：
+ * 词法分析器读完当前分段时挂起，返回 feed 的调用者，下一次 feed 时从挂起处继续，
+ * 因此分析与接收输入交替进行，不需要先拼接完整的输入。
+ *
+ * 每个分段只在对应的 feed 调用期间被读取，调用返回后即可释放或复用。
+ * 与 frontend.h 的接口一样，不读写文件，也不输出任何内容。
+ *
+ * 词法/语法分析器的状态按线程保存，同一线程中同一时刻只能有一个未结束的会话；
+ * 需要同时处理多路输入时，每路使用一个线程。
+ */
+
+class PushParser {
+public:
+    // keepTokens为true时在结果中保存Token列表
+    explicit PushParser(bool keepTokens = false);
+    ~PushParser();
+
+    PushParser(const PushParser&) = delete;
+    PushParser& operator=(const PushParser&) = delete;
+
+    // 送入一段输入；分析结束（如遇到终止符 '#'）后送入的内容被忽略
+    void feed(const char* data, size_t len);
+    void feed(std::string_view chunk);
+
+    // 输入结束：完成分析并返回结果（只能调用一次）
+    AnalysisResult finish();
+
+    // 语法分析是否已经结束
+    bool done() const { return m_done; }
+
+private:
+    static void entry();
+    void run();
+    void resume();
+    bool nextChunk(const char*& data, size_t& len);
+
+    bool m_keepTokens;
+    bool m_started = false;    // 语法分析是否已开始
+    bool m_done = false;       // 语法分析是否已结束
+    bool m_ended = false;      // 调用者是否已声明输入结束
+    const char* m_chunk = nullptr;  // 待交给词法分析器的分段
+    size_t m_chunkLen = 0;
+    void* m_stack = nullptr;   // 语法分析器使用的栈
+    size_t m_stackSize;
+    ucontext_t m_caller;       // feed/finish调用者的上下文
+    ucontext_t m_parser;       // 语法分析器的上下文
+    AnalysisResult m_result;
+};
+
+#endif /* PUSH_H */
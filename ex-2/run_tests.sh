@@ -8,7 +8,8 @@ cd "$(dirname "$0")"
 # 清理
 if [ "$1" = "clean" ]; then
     echo "清理编译文件..."
-    rm -f parser
+    rm -f parser mini_client bench/bench bench/opt_bench bench/vm_bench tools/mini_gen tests/pathological libminifront.a
+    rm -rf build
     exit 0
 fi
 
@@ -18,9 +19,102 @@ if [ "$1" = "clean-output" ]; then
     exit 0
 fi
 
+# 微基准：./run_tests.sh bench [--quick] [--json] ...
+if [ "$1" = "bench" ]; then
+    shift
+    echo "编译基准程序..." >&2
+    g++ -std=c++17 -O2 -pthread -o bench/bench bench/bench.cpp lexer.cpp parser.cpp pipeline.cpp lalr.cpp output.cpp token_shm.cpp trace.cpp json.cpp || exit 1
+    ./bench/bench "$@"
+    exit $?
+fi
+
+# 中间代码优化基准：./run_tests.sh optbench [--functions N] [--json] ...
+if [ "$1" = "optbench" ]; then
+    shift
+    echo "编译优化基准..." >&2
+    g++ -std=c++17 -O2 -pthread -o bench/opt_bench bench/opt_bench.cpp lexer.cpp parser.cpp ast.cpp sema.cpp ir.cpp opt.cpp ssa.cpp callgraph.cpp trace.cpp json.cpp || exit 1
+    ./bench/opt_bench "$@"
+    exit $?
+fi
+
+# 字节码虚拟机与 JIT 的基准与结果检查：./run_tests.sh vmbench [--check] [--no-jit] [--cc] [--reps N] [--json] ...
+if [ "$1" = "vmbench" ]; then
+    shift
+    echo "编译虚拟机基准..." >&2
+    g++ -std=c++17 -O2 -pthread -o bench/vm_bench bench/vm_bench.cpp lexer.cpp parser.cpp ast.cpp sema.cpp ir.cpp opt.cpp ssa.cpp callgraph.cpp vm.cpp jit.cpp emitc.cpp trace.cpp json.cpp || exit 1
+    ./bench/vm_bench "$@"
+    exit $?
+fi
+
+# C 后端：把 tests/programs 翻译为 C，用系统的 C 编译器（$CC，默认 cc）编译执行并检查结果：./run_tests.sh emitc
+if [ "$1" = "emitc" ]; then
+    shift
+    "$0" vmbench --check --no-jit --cc "$@"
+    exit $?
+fi
+
+# 病态输入复杂度回归：./run_tests.sh pathological [--quick] ...
+# 与 parser 相同不开优化编译，使栈深度检查与命令行程序一致
+if [ "$1" = "pathological" ]; then
+    shift
+    echo "编译病态输入测试..." >&2
+    g++ -std=c++17 -pthread -o tests/pathological tests/pathological.cpp lexer.cpp parser.cpp ast.cpp sema.cpp ir.cpp opt.cpp ssa.cpp callgraph.cpp dataflow.cpp emitc.cpp trace.cpp json.cpp || exit 1
+    ./tests/pathological "$@"
+    exit $?
+fi
+
+# 合成程序生成器：./run_tests.sh gen [--seed N] [--size 10M] ...
+if [ "$1" = "gen" ]; then
+    shift
+    g++ -std=c++17 -O2 -o tools/mini_gen tools/mini_gen.cpp || exit 1
+    ./tools/mini_gen "$@"
+    exit $?
+fi
+
+# 结果归档查询工具：./run_tests.sh arc list|cat|extract <归档> ...
+if [ "$1" = "arc" ]; then
+    shift
+    g++ -std=c++17 -O2 -o tools/mini_arc tools/mini_arc.cpp archive.cpp || exit 1
+    ./tools/mini_arc "$@"
+    exit $?
+fi
+
+# 共享内存Token流的参考消费者：./run_tests.sh tokview <段名> [--dump] ...
+if [ "$1" = "tokview" ]; then
+    shift
+    g++ -std=c++17 -O2 -o tools/mini_tokview tools/mini_tokview.cpp token_shm.cpp lexer.cpp || exit 1
+    ./tools/mini_tokview "$@"
+    exit $?
+fi
+
+# LALR(1) 分析表生成：读取 parser.cpp 的文法注释，重新生成 lalr_tables.h
+if [ "$1" = "lalr" ]; then
+    g++ -std=c++17 -O2 -o tools/lalr_gen tools/lalr_gen.cpp lexer.cpp || exit 1
+    ./tools/lalr_gen --grammar parser.cpp --expect 2 -o lalr_tables.h
+    exit $?
+fi
+
+# 前端静态库：词法/语法分析与内存缓冲区接口（frontend.h），不含命令行程序
+buildLibrary() {
+    mkdir -p build
+    for src in lexer parser frontend pipeline push lalr ast sema ir opt ssa callgraph dataflow vm jit emitc trace json; do
+        g++ -std=c++17 -pthread -c -o build/$src.o $src.cpp || return 1
+    done
+    ar rcs libminifront.a build/lexer.o build/parser.o build/frontend.o build/pipeline.o build/push.o build/lalr.o build/ast.o build/sema.o build/ir.o build/opt.o build/ssa.o build/callgraph.o build/dataflow.o build/vm.o build/jit.o build/emitc.o build/trace.o build/json.o
+}
+
+if [ "$1" = "lib" ]; then
+    echo "编译前端静态库..."
+    buildLibrary || exit 1
+    echo "已生成 libminifront.a"
+    exit 0
+fi
+
 # 编译
 echo "编译程序..."
-g++ -o parser lexer.cpp parser.cpp main.cpp
+buildLibrary || exit 1
+g++ -pthread -o parser main.cpp server.cpp frame.cpp lsp.cpp stats.cpp perf_counters.cpp alloc_stats.cpp output.cpp batch_io.cpp archive.cpp token_shm.cpp libminifront.a
+g++ -o mini_client mini_client.cpp frame.cpp
 
 # 确保输出目录存在
 mkdir -p tests/test1.txt-output
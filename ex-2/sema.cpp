@@ -0,0 +1,369 @@
+#include "sema.h"
+#include <algorithm>
+#include <string>
+
+/* INFO 作用域表 */
+
+// 开放寻址表 + 撤销日志。表项一旦插入就不再删除，未绑定时 slot 为 kNoSlot，
+// 因此出栈恢复时不需要墓碑
+struct ScopeTable {
+    struct Entry {
+        uint32_t name;    // kNoName 表示空
+        uint32_t slot;    // 当前绑定的槽位
+        uint32_t depth;   // 绑定所在的作用域深度
+    };
+    std::vector<Entry> table;
+    size_t used = 0;
+    std::vector<Entry> undo;          // 被遮蔽的旧绑定
+    std::vector<size_t> marks;        // 各作用域开始时的日志长度
+    uint32_t depth = 0;
+
+    ScopeTable() : table(256, Entry{ kNoName, kNoSlot, 0 }) {}
+
+    static size_t hash(uint32_t name) {
+        return (size_t)(name * 2654435761u);
+    }
+
+    Entry& entry(uint32_t name) {
+        size_t mask = table.size() - 1;
+        size_t i = hash(name) & mask;
+        while (table[i].name != kNoName && table[i].name != name) {
+            i = (i + 1) & mask;
+        }
+        if (table[i].name == kNoName) {
+            if ((used + 1) * 2 > table.size()) {
+                grow();
+                return entry(name);
+            }
+            table[i].name = name;
+            used++;
+        }
+        return table[i];
+    }
+
+    void grow() {
+        std::vector<Entry> old(table.size() * 2, Entry{ kNoName, kNoSlot, 0 });
+        old.swap(table);
+        size_t mask = table.size() - 1;
+        for (const Entry& e : old) {
+            if (e.name == kNoName) continue;
+            size_t i = hash(e.name) & mask;
+            while (table[i].name != kNoName) i = (i + 1) & mask;
+            table[i] = e;
+        }
+    }
+
+    // 当前可见的槽位，未声明时返回kNoSlot
+    uint32_t lookup(uint32_t name) {
+        return entry(name).slot;
+    }
+
+    // 在当前作用域声明；同一作用域内已声明时返回原槽位且不修改，否则返回kNoSlot
+    uint32_t declare(uint32_t name, uint32_t slot) {
+        Entry& e = entry(name);
+        if (e.slot != kNoSlot && e.depth == depth) {
+            return e.slot;
+        }
+        undo.push_back(e);
+        e.slot = slot;
+        e.depth = depth;
+        return kNoSlot;
+    }
+
+    void push() {
+        marks.push_back(undo.size());
+        depth++;
+    }
+
+    void pop() {
+        size_t mark = marks.back();
+        marks.pop_back();
+        while (undo.size() > mark) {
+            Entry old = undo.back();
+            undo.pop_back();
+            Entry& e = entry(old.name);
+            e.slot = old.slot;
+            e.depth = old.depth;
+        }
+        depth--;
+    }
+};
+
+/* INFO 分析 */
+
+struct SemaChecker {
+    AstProgram& program;
+    SemaResult& result;
+    ScopeTable scopes;
+    std::vector<uint32_t> functionByName;   // 标识符ID -> 函数编号（kNoSlot表示不是函数）
+    SemaFunction* current = nullptr;
+    std::vector<uint32_t> spine;             // 二元表达式的左脊，见 expression()
+
+    SemaChecker(AstProgram& target, SemaResult& output)
+        : program(target), result(output), functionByName(target.names.size(), kNoSlot) {}
+
+    const std::string& name(uint32_t id) const {
+        return program.names.name(id);
+    }
+
+    void error(int line, const std::string& message) {
+        result.diagnostics.push_back({ line, message });
+        result.errorCount++;
+    }
+
+    void warning(int line, const std::string& message) {
+        result.diagnostics.push_back({ line, "警告: " + message });
+        result.warningCount++;
+    }
+
+    // 把from类型的值隐式转换为to类型，可能丢失精度时给出警告
+    void convert(int line, MiniType from, MiniType to, const char* context) {
+        if (from > to && from != TYPE_NONE && to != TYPE_NONE) {
+            warning(line, std::string(context) + "隐式转换: " + miniTypeName(from) + " 转为 " +
+                              miniTypeName(to) + " 可能丢失精度");
+        }
+    }
+
+    void run() {
+        // 先登记全部函数，允许先调用后定义
+        for (size_t i = 0; i < program.functions.size(); i++) {
+            const AstNode& node = program.nodes[program.functions[i]];
+            SemaFunction function;
+            function.node = program.functions[i];
+            function.name = node.name;
+            function.returnType = node.type;
+            function.paramCount = 0;
+            result.functions.push_back(function);
+            if (functionByName[node.name] == kNoSlot) {
+                functionByName[node.name] = (uint32_t)i;
+            } else {
+                const AstNode& first = program.nodes[program.functions[functionByName[node.name]]];
+                error(node.line, "函数 '" + name(node.name) + "' 重复定义（第 " + std::to_string(first.line) +
+                                     " 行已定义）");
+            }
+        }
+        for (size_t i = 0; i < program.functions.size(); i++) {
+            function(result.functions[i]);
+        }
+        std::stable_sort(result.diagnostics.begin(), result.diagnostics.end(),
+                         [](const ParserError& a, const ParserError& b) { return a.line < b.line; });
+    }
+
+    // 声明一个变量并分配槽位
+    void declare(const AstNode& node, uint32_t& slot) {
+        slot = (uint32_t)current->slotTypes.size();
+        uint32_t previous = scopes.declare(node.name, slot);
+        if (previous != kNoSlot) {
+            error(node.line, "'" + name(node.name) + "' 在同一作用域内重复声明");
+            slot = previous;
+            return;
+        }
+        current->slotTypes.push_back(node.type);
+        current->slotNames.push_back(node.name);
+    }
+
+    void function(SemaFunction& function) {
+        current = &function;
+        AstNode& node = program.nodes[function.node];
+        scopes.push();
+        for (uint32_t param = node.a; param != kNoNode; param = program.nodes[param].next) {
+            AstNode& p = program.nodes[param];
+            declare(p, p.slot);
+        }
+        function.paramCount = (uint32_t)function.slotTypes.size();
+        // 函数体最外层与参数同属一个作用域
+        for (uint32_t stmt = program.nodes[node.b].a; stmt != kNoNode; stmt = program.nodes[stmt].next) {
+            statement(stmt);
+        }
+        scopes.pop();
+        current = nullptr;
+    }
+
+    void statement(uint32_t index) {
+        AstNode& node = program.nodes[index];
+        switch (node.kind) {
+            case AST_BLOCK:
+                scopes.push();
+                for (uint32_t stmt = node.a; stmt != kNoNode; stmt = program.nodes[stmt].next) {
+                    statement(stmt);
+                }
+                scopes.pop();
+                break;
+            case AST_VAR_DECL:
+                if (node.a != kNoNode) {
+                    convert(node.line, expression(node.a), node.type, "初始化");
+                }
+                declare(node, program.nodes[index].slot);
+                break;
+            case AST_EXPR_STMT:
+                if (node.a != kNoNode) expression(node.a);
+                break;
+            case AST_IF:
+                expression(node.a);
+                statement(node.b);
+                if (node.c != kNoNode) statement(node.c);
+                break;
+            case AST_WHILE:
+                expression(node.a);
+                statement(node.b);
+                break;
+            case AST_RETURN:
+                if (node.a != kNoNode) {
+                    convert(node.line, expression(node.a), current->returnType, "返回值");
+                } else {
+                    warning(node.line, "函数 '" + name(current->name) + "' 应返回 " +
+                                           miniTypeName(current->returnType) + " 值");
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    // 检查表达式并返回其类型。左结合的长运算链（a+b+c+...）形成很深的左脊，
+    // 沿左脊循环而只在右操作数上递归，递归深度受括号嵌套层数限制而与链长无关
+    MiniType expression(uint32_t index) {
+        size_t base = spine.size();
+        while (program.nodes[index].kind == AST_BINARY) {
+            spine.push_back(index);
+            index = program.nodes[index].a;
+        }
+        MiniType type = operand(index);
+        while (spine.size() > base) {
+            uint32_t binary = spine.back();
+            spine.pop_back();
+            MiniType right = expression(program.nodes[binary].b);
+            AstNode& node = program.nodes[binary];
+            switch (node.op) {
+                case TK_OR:
+                case TK_AND:
+                case TK_EQ:
+                case TK_LT:
+                case TK_GT:
+                case TK_LEQ:
+                case TK_GEQ:
+                    type = TYPE_INT;
+                    break;
+                case TK_BITAND:
+                case TK_BITOR:
+                    if (type != TYPE_INT || right != TYPE_INT) {
+                        error(node.line, std::string("运算符 '") + (node.op == TK_BITAND ? "&" : "|") +
+                                             "' 的操作数必须是int类型，实际为 " + miniTypeName(type) + " 与 " +
+                                             miniTypeName(right));
+                    }
+                    type = TYPE_INT;
+                    break;
+                default:
+                    type = std::max(type, right);  // 算术转换：取等级较高的类型
+                    break;
+            }
+            node.type = type;
+        }
+        return type;
+    }
+
+    // 非二元运算的表达式
+    MiniType operand(uint32_t index) {
+        AstNode& node = program.nodes[index];
+        switch (node.kind) {
+            case AST_INT_CONST:
+                if (node.intValue < INT32_MIN || node.intValue > INT32_MAX) {
+                    warning(node.line, "整型常量超出int范围，按int截断");
+                    node.intValue = (int32_t)(uint32_t)(uint64_t)node.intValue;
+                }
+                node.type = TYPE_INT;
+                break;
+            case AST_DOUBLE_CONST:
+                node.type = TYPE_DOUBLE;
+                break;
+            case AST_IDENT:
+                node.type = variable(node, index);
+                break;
+            case AST_ASSIGN: {
+                MiniType value = expression(node.a);
+                AstNode& assign = program.nodes[index];
+                assign.type = variable(assign, index);
+                convert(assign.line, value, assign.type, "赋值");
+                break;
+            }
+            case AST_CALL:
+                call(index);
+                break;
+            default:
+                break;
+        }
+        return program.nodes[index].type;
+    }
+
+    // 解析变量引用（AST_IDENT 或 AST_ASSIGN 的目标），返回变量类型
+    MiniType variable(AstNode& node, uint32_t index) {
+        uint32_t slot = scopes.lookup(node.name);
+        if (slot != kNoSlot) {
+            program.nodes[index].slot = slot;
+            return current->slotTypes[slot];
+        }
+        program.nodes[index].slot = kNoSlot;
+        if (functionByName[node.name] != kNoSlot) {
+            error(node.line, "'" + name(node.name) + "' 是函数，不能作为变量使用");
+        } else {
+            error(node.line, "未声明的标识符 '" + name(node.name) + "'");
+        }
+        return TYPE_INT;
+    }
+
+    void call(uint32_t index) {
+        const AstNode& node = program.nodes[index];
+        uint32_t callee = functionByName[node.name];
+        int line = node.line;
+        uint32_t calleeName = node.name;
+        if (scopes.lookup(calleeName) != kNoSlot) {
+            error(line, "'" + name(calleeName) + "' 是变量，不能作为函数调用");
+            callee = kNoSlot;
+        } else if (callee == kNoSlot) {
+            error(line, "未声明的函数 '" + name(calleeName) + "'");
+        }
+
+        // 逐个检查实参，并与形参类型比较
+        const AstNode* param = nullptr;
+        if (callee != kNoSlot) {
+            uint32_t first = program.nodes[program.functions[callee]].a;
+            param = first == kNoNode ? nullptr : &program.nodes[first];
+        }
+        size_t argCount = 0;
+        for (uint32_t arg = node.a; arg != kNoNode; arg = program.nodes[arg].next) {
+            MiniType type = expression(arg);
+            if (param != nullptr) {
+                convert(program.nodes[arg].line, type, param->type, "实参");
+                param = param->next == kNoNode ? nullptr : &program.nodes[param->next];
+            }
+            argCount++;
+        }
+
+        AstNode& target = program.nodes[index];
+        if (callee == kNoSlot) {
+            target.slot = kNoSlot;
+            target.type = TYPE_INT;
+            return;
+        }
+        const AstNode& definition = program.nodes[program.functions[callee]];
+        size_t paramCount = 0;
+        for (uint32_t p = definition.a; p != kNoNode; p = program.nodes[p].next) {
+            paramCount++;
+        }
+        if (argCount != paramCount) {
+            error(line, "函数 '" + name(calleeName) + "' 需要 " + std::to_string(paramCount) + " 个参数，实际传入 " +
+                            std::to_string(argCount) + " 个");
+        }
+        target.slot = callee;
+        target.type = definition.type;
+    }
+};
+
+/* 接口实现 */
+
+bool analyzeSemantics(AstProgram& program, SemaResult& result) {
+    result = SemaResult();
+    SemaChecker checker(program, result);
+    checker.run();
+    return result.errorCount == 0;
+}
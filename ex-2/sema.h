@@ -0,0 +1,54 @@
+#ifndef SEMA_H
+#define SEMA_H
+
+#include "ast.h"
+#include "parser.h"
+#include <vector>
+#include <cstdint>
+
+/*
+ * 语义分析
+ * ===========================
+ * 把语法树中的每个标识符解析到它的声明，并做类型检查：
+ *   错误：未声明的标识符、同一作用域内重复声明、函数重复定义、调用非函数、
+ *         把函数当作变量使用、实参个数不符、位运算（& |）作用于浮点操作数
+ *   警告：可能丢失精度的隐式转换（浮点转int、double转float）、整型常量超出int范围、
+ *         有返回类型的函数中不带值的 return
+ *
+ * 作用域规则与C相同：参数与函数体最外层的声明同属一个作用域，内层块可以遮蔽外层的变量
+ * 和函数名；变量从其声明之后（初值表达式之后）开始可见。函数在整个程序中可见，可以先调用后定义。
+ *
+ * 作用域栈是一张以标识符ID为键的开放寻址表加一个撤销日志：声明时把被遮蔽的旧绑定记入日志，
+ * 进入作用域只记下日志的长度，退出时按日志逐条恢复。压栈、出栈与查找都是O(1)，不复制表，
+ * 总耗时与程序规模成线性。
+ *
+ * 每个变量（含参数）得到所在函数内从0开始的稠密槽位（参数在前），写入语法树节点的 slot；
+ * 函数调用节点的 slot 为被调函数的编号（program.functions 的下标）。
+ */
+
+static const uint32_t kNoSlot = UINT32_MAX;
+
+// 一个函数的语义信息
+struct SemaFunction {
+    uint32_t node;                     // AST_FUNCTION 节点
+    uint32_t name;                     // 函数名ID
+    MiniType returnType;
+    uint32_t paramCount;               // 参数占用槽位 0..paramCount-1
+    std::vector<MiniType> slotTypes;   // 各槽位的类型
+    std::vector<uint32_t> slotNames;   // 各槽位的变量名ID
+};
+
+// 语义分析结果
+struct SemaResult {
+    std::vector<SemaFunction> functions;   // 与 program.functions 一一对应
+    std::vector<ParserError> diagnostics;  // 按源码顺序；警告的消息以“警告: ”开头
+    size_t errorCount = 0;
+    size_t warningCount = 0;
+};
+
+/* INFO 语义分析接口 */
+
+// 分析程序并标注语法树（表达式类型、变量槽位、被调函数），没有错误时返回true
+bool analyzeSemantics(AstProgram& program, SemaResult& result);
+
+#endif /* SEMA_H */
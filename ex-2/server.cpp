@@ -0,0 +1,458 @@
+#include "server.h"
+#include "frame.h"
+#include "frontend.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <list>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <csignal>
+#include <cerrno>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+/*
+ * 常驻编译服务
+ * ===========================
+ * 进程启动、iostream初始化等开销只付一次。轮询线程用poll复用监听套接字与各连接，
+ * 只负责收发与解码请求帧；分析在固定数目的分析线程中进行。词法/语法分析器的状态按线程独立，
+ * 每个分析线程就是一套常驻的分析器实例，在每个请求前以内存缓冲区重新初始化，
+ * 读文件缓冲区与响应缓冲区由各线程在请求之间复用。结果缓存由各线程共享，加锁访问。
+ * 同一连接上的请求可以同时在多个线程中分析，响应按请求的顺序写回。
+ * 连接为非阻塞：每个连接有自己的输入与输出缓冲区，请求帧到齐后才处理，
+ * 响应按可写情况逐步写出，单个缓慢或只发来半帧的客户端不影响其他连接。
+ */
+
+/* 最近结果缓存（LRU），以源程序内容为键 */
+struct CacheEntry {
+    uint64_t hash;
+    std::string source;     // 完整内容，用于排除哈希碰撞
+    std::string response;   // 已编码的响应负载（不含命中标记）
+};
+
+static std::list<CacheEntry> g_cache;  // 表头为最近使用
+static std::unordered_map<uint64_t, std::list<CacheEntry>::iterator> g_cacheIndex;
+static size_t g_cacheSize = 0;
+static std::mutex g_cacheMutex;        // 保护缓存（分析本身不持锁）
+
+/* 分析任务：轮询线程解码出请求后交给分析线程，完成后连同编码好的响应帧交回 */
+struct Job {
+    uint64_t conn;           // 连接编号
+    uint64_t seq;            // 在该连接上的请求序号
+    char kind;               // FRAME_PATH 或 FRAME_BUFFER
+    std::string payload;
+    std::string frame;       // 响应帧
+};
+
+static std::mutex g_jobMutex;
+static std::condition_variable g_jobReady;
+static std::deque<Job> g_jobs;           // 待分析的请求
+static std::vector<Job> g_finished;      // 已完成、等待轮询线程取回的请求
+static bool g_stopping = false;          // 分析线程应退出
+static int g_wakeFds[2] = { -1, -1 };    // 分析线程完成请求后写入一个字节，唤醒轮询线程
+
+static const size_t kMaxPendingRequests = 64;  // 单个连接上同时在分析的请求数上限，达到后暂停读取
+
+/* 辅助函数 */
+// FNV-1a 64位哈希
+static uint64_t hashSource(const std::string& s) {
+    uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// 读取整个文件到out
+static bool readWholeFile(const std::string& path, std::string& out) {
+    FILE* fp = fopen(path.c_str(), "rb");
+    if (fp == nullptr) {
+        return false;
+    }
+    out.clear();
+    char chunk[65536];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), fp)) > 0) {
+        out.append(chunk, n);
+    }
+    bool ok = !ferror(fp);
+    fclose(fp);
+    return ok;
+}
+
+// 追加一条诊断信息，转义其中的反斜杠与换行，保证一条诊断占一行
+static void appendEscaped(std::string& out, const std::string& message) {
+    for (char c : message) {
+        if (c == '\\') out += "\\\\";
+        else if (c == '\n') out += "\\n";
+        else out += c;
+    }
+    out += '\n';
+}
+
+// 分析源程序并将结果编码为响应负载（首行的命中标记由调用者追加）
+static void analyzeSource(const std::string& source, std::string& out) {
+    AnalysisResult result = analyzeBuffer(source, false);
+
+    out.clear();
+    out += result.success ? '1' : '0';
+    out += ' ' + std::to_string(result.tokenCount);
+    out += ' ' + std::to_string(result.lexErrors.size());
+    out += ' ' + std::to_string(result.parseErrors.size());
+    out += '\n';
+    for (const auto& error : result.lexErrors) {
+        out += 'L' + std::to_string(error.line) + '\t';
+        appendEscaped(out, error.message);
+    }
+    for (const auto& error : result.parseErrors) {
+        out += 'P' + std::to_string(error.line) + '\t';
+        appendEscaped(out, error.message);
+    }
+}
+
+// 在首行末尾插入缓存命中标记
+static void appendHitFlag(std::string& response, bool hit) {
+    size_t eol = response.find('\n');
+    response.insert(eol, hit ? " 1" : " 0");
+}
+
+// 处理一次分析请求，结果写入response；在分析线程中调用，缓存查找与更新加锁，分析不持锁
+static void handleSource(const std::string& source, std::string& response) {
+    uint64_t h = 0;
+    if (g_cacheSize > 0) {
+        h = hashSource(source);
+        std::lock_guard<std::mutex> lock(g_cacheMutex);
+        auto found = g_cacheIndex.find(h);
+        if (found != g_cacheIndex.end() && found->second->source == source) {
+            g_cache.splice(g_cache.begin(), g_cache, found->second);
+            response = found->second->response;
+            appendHitFlag(response, true);
+            return;
+        }
+    }
+
+    analyzeSource(source, response);
+    if (g_cacheSize > 0) {
+        std::lock_guard<std::mutex> lock(g_cacheMutex);
+        auto found = g_cacheIndex.find(h);
+        if (found != g_cacheIndex.end()) {  // 哈希碰撞或其他线程刚写入：覆盖旧条目
+            g_cache.erase(found->second);
+            g_cacheIndex.erase(found);
+        }
+        g_cache.push_front(CacheEntry{h, source, response});
+        g_cacheIndex[h] = g_cache.begin();
+        if (g_cache.size() > g_cacheSize) {
+            g_cacheIndex.erase(g_cache.back().hash);
+            g_cache.pop_back();
+        }
+    }
+    appendHitFlag(response, false);
+}
+
+// 分析线程：取出请求、分析并编码响应帧，交回轮询线程
+static void serveWorker() {
+    std::string readBuf;    // 本线程的读文件缓冲区
+    std::string response;   // 本线程的响应缓冲区
+    std::unique_lock<std::mutex> lock(g_jobMutex);
+    for (;;) {
+        g_jobReady.wait(lock, [] { return g_stopping || !g_jobs.empty(); });
+        if (g_jobs.empty()) {
+            return;
+        }
+        Job job = std::move(g_jobs.front());
+        g_jobs.pop_front();
+        lock.unlock();
+
+        if (job.kind == FRAME_PATH && !readWholeFile(job.payload, readBuf)) {
+            appendFrame(job.frame, FRAME_ERROR, "无法打开文件 " + job.payload);
+        } else {
+            handleSource(job.kind == FRAME_PATH ? readBuf : job.payload, response);
+            appendFrame(job.frame, FRAME_RESULT, response);
+        }
+        std::string().swap(job.payload);
+
+        lock.lock();
+        g_finished.push_back(std::move(job));
+        char byte = 1;
+        ssize_t ignored = write(g_wakeFds[1], &byte, 1);  // 管道已满时轮询线程必然会被唤醒
+        (void)ignored;
+    }
+}
+
+/* 连接状态：非阻塞读写，各自缓存未完整的请求帧与未写出的响应 */
+struct Connection {
+    int fd;
+    uint64_t id;                            // 连接编号，分析任务据此找回连接
+    std::string in;                         // 已收到、尚未处理的字节
+    std::string out;                        // 已编码、尚未写出的响应帧
+    bool closing = false;                   // 对端已关闭写端或请求有误：写完响应后关闭
+    uint64_t nextSeq = 0;                   // 下一个请求的序号
+    uint64_t nextOut = 0;                   // 下一个应写出的响应的序号
+    size_t pending = 0;                     // 正在分析的请求数
+    std::map<uint64_t, std::string> ready;  // 已完成、但之前还有请求未完成的响应帧
+};
+
+// 把连续完成的响应按请求顺序移到conn.out
+static void collectReady(Connection& conn) {
+    for (auto it = conn.ready.begin(); it != conn.ready.end() && it->first == conn.nextOut;
+         it = conn.ready.erase(it)) {
+        conn.out += it->second;
+        conn.nextOut++;
+    }
+}
+
+// 处理一帧请求：分析请求交给分析线程，其余的直接生成响应
+// 返回false表示不再处理该连接上的后续请求；quit置为true表示服务应退出
+static bool serveFrame(Connection& conn, char kind, std::string& payload, bool& quit, size_t& inFlight) {
+    switch (kind) {
+        case FRAME_PATH:
+        case FRAME_BUFFER: {
+            Job job = { conn.id, conn.nextSeq++, kind, std::move(payload), std::string() };
+            conn.pending++;
+            inFlight++;
+            {
+                std::lock_guard<std::mutex> lock(g_jobMutex);
+                g_jobs.push_back(std::move(job));
+            }
+            g_jobReady.notify_one();
+            return true;
+        }
+        case FRAME_QUIT:
+            quit = true;
+            return false;
+        default:
+            appendFrame(conn.ready[conn.nextSeq++], FRAME_ERROR, std::string("未知请求类型 ") + kind);
+            return false;
+    }
+}
+
+// 读出当前可读的全部数据；返回false表示应立即关闭该连接
+static bool receive(Connection& conn) {
+    char chunk[65536];
+    for (;;) {
+        ssize_t n = read(conn.fd, chunk, sizeof(chunk));
+        if (n > 0) {
+            conn.in.append(chunk, (size_t)n);
+            continue;
+        }
+        if (n == 0) {
+            conn.closing = true;
+            return true;
+        }
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+        return false;
+    }
+}
+
+// 处理已收到的完整帧，同时在分析的请求达到上限时暂停，其余的帧留到请求完成后再处理
+// 返回false表示应立即关闭该连接
+static bool dispatch(Connection& conn, bool& quit, size_t& inFlight) {
+    size_t offset = 0;
+    char kind;
+    std::string payload;
+    while (!quit && conn.pending < kMaxPendingRequests) {
+        bool malformed = false;
+        size_t used = decodeFrame(conn.in, offset, kind, payload, malformed);
+        if (malformed) return false;
+        if (used == 0) break;
+        offset += used;
+        if (!serveFrame(conn, kind, payload, quit, inFlight)) {
+            conn.closing = true;
+            conn.in.clear();
+            offset = 0;
+            break;
+        }
+    }
+    conn.in.erase(0, offset);
+    collectReady(conn);
+    return true;
+}
+
+// 尽量写出待发送的响应；返回false表示写出失败
+static bool flush(Connection& conn) {
+    size_t written = 0;
+    while (written < conn.out.size()) {
+        ssize_t n = write(conn.fd, conn.out.data() + written, conn.out.size() - written);
+        if (n > 0) {
+            written += (size_t)n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        return false;
+    }
+    conn.out.erase(0, written);
+    return true;
+}
+
+static void setNonBlocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+/* 接口实现 */
+int runServer(const std::string& socketPath, size_t cacheSize, int workers) {
+    g_cacheSize = cacheSize;
+    signal(SIGPIPE, SIG_IGN);  // 客户端提前断开时不终止服务
+    setParserErrorEcho(false);
+
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "错误: 套接字路径过长 " << socketPath << std::endl;
+        return 1;
+    }
+    strcpy(addr.sun_path, socketPath.c_str());
+
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        std::cerr << "错误: 无法创建套接字: " << strerror(errno) << std::endl;
+        return 1;
+    }
+    // 清理上次遗留的套接字文件；路径上已有其他类型的文件时拒绝启动，不删除
+    struct stat existing;
+    if (lstat(socketPath.c_str(), &existing) == 0) {
+        if (!S_ISSOCK(existing.st_mode)) {
+            std::cerr << "错误: " << socketPath << " 已存在且不是套接字文件" << std::endl;
+            close(listenFd);
+            return 1;
+        }
+        unlink(socketPath.c_str());
+    }
+    if (bind(listenFd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(listenFd, 64) < 0) {
+        std::cerr << "错误: 无法监听 " << socketPath << ": " << strerror(errno) << std::endl;
+        close(listenFd);
+        return 1;
+    }
+    if (pipe(g_wakeFds) < 0) {
+        std::cerr << "错误: 无法创建管道: " << strerror(errno) << std::endl;
+        close(listenFd);
+        unlink(socketPath.c_str());
+        return 1;
+    }
+    std::cout << "编译服务已启动: " << socketPath << "（" << workers << " 个分析线程）" << std::endl;
+
+    setNonBlocking(listenFd);
+    setNonBlocking(g_wakeFds[0]);
+    setNonBlocking(g_wakeFds[1]);
+    g_stopping = false;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < workers; i++) {
+        threads.emplace_back(serveWorker);
+    }
+
+    // fds[0]为监听套接字，fds[1]为唤醒管道，fds[i]（i >= 2）对应ids[i - 2]号连接
+    std::map<uint64_t, Connection> conns;
+    std::vector<pollfd> fds;
+    std::vector<uint64_t> ids;
+    std::vector<Job> finished;
+    uint64_t nextId = 0;
+    size_t inFlight = 0;   // 已交给分析线程、尚未取回的请求数
+    bool quit = false;
+
+    // 收到退出请求后不再读入与接受新请求，等已交出的请求都完成、响应写入输出缓冲区后退出
+    while (!quit || inFlight > 0) {
+        fds.clear();
+        ids.clear();
+        fds.push_back(pollfd{listenFd, (short)(quit ? 0 : POLLIN), 0});
+        fds.push_back(pollfd{g_wakeFds[0], POLLIN, 0});
+        for (auto& entry : conns) {
+            // 响应未写完时只等待可写，不再读入新请求（对端不读取响应时不无限缓存）；
+            // 正在分析的请求达到上限时也不读入。两者都不等待时不轮询该连接（挂断时不会反复唤醒）
+            const Connection& conn = entry.second;
+            bool reading = !quit && !conn.closing && conn.pending < kMaxPendingRequests;
+            short events = !conn.out.empty() ? POLLOUT : (short)(reading ? POLLIN : 0);
+            fds.push_back(pollfd{events ? conn.fd : -1, events, 0});
+            ids.push_back(entry.first);
+        }
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "错误: poll失败: " << strerror(errno) << std::endl;
+            break;
+        }
+
+        // 取回分析完成的请求，按序号放回各自的连接；连接已关闭时丢弃
+        if (fds[1].revents & POLLIN) {
+            char drain[256];
+            while (read(g_wakeFds[0], drain, sizeof(drain)) > 0) {}
+            {
+                std::lock_guard<std::mutex> lock(g_jobMutex);
+                finished.swap(g_finished);
+            }
+            for (Job& job : finished) {
+                inFlight--;
+                auto found = conns.find(job.conn);
+                if (found == conns.end()) continue;
+                found->second.pending--;
+                found->second.ready[job.seq] = std::move(job.frame);
+            }
+            finished.clear();
+        }
+
+        // 各连接：读入并处理已到齐的帧，写出按序完成的响应。只发来半帧的客户端不会阻塞其他连接
+        for (size_t k = 0; k < ids.size(); k++) {
+            auto found = conns.find(ids[k]);
+            Connection& conn = found->second;
+            bool ok = true;
+            if (!quit && (fds[k + 2].revents & (POLLIN | POLLHUP | POLLERR))) {
+                ok = receive(conn);
+            }
+            if (ok) {
+                ok = dispatch(conn, quit, inFlight);
+            }
+            if (ok && !conn.out.empty()) {
+                ok = flush(conn);
+            }
+            if (!ok || (conn.closing && conn.out.empty() && conn.nextOut == conn.nextSeq)) {
+                close(conn.fd);
+                conns.erase(found);
+            }
+        }
+
+        if (!quit && (fds[0].revents & POLLIN)) {
+            int clientFd;
+            while ((clientFd = accept(listenFd, nullptr, nullptr)) >= 0) {
+                setNonBlocking(clientFd);
+                Connection conn;
+                conn.fd = clientFd;
+                conn.id = nextId++;
+                conns.emplace(conn.id, std::move(conn));
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(g_jobMutex);
+        g_stopping = true;
+    }
+    g_jobReady.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // 退出前尽量送出已生成的响应
+    for (auto& entry : conns) {
+        collectReady(entry.second);
+        flush(entry.second);
+        close(entry.second.fd);
+    }
+    close(g_wakeFds[0]);
+    close(g_wakeFds[1]);
+    close(listenFd);
+    unlink(socketPath.c_str());
+    std::cout << "编译服务已退出" << std::endl;
+    return 0;
+}
@@ -0,0 +1,13 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <string>
+
+/* INFO 常驻编译服务接口 */
+
+// 在Unix域套接字上启动编译服务，阻塞直到收到退出请求
+// cacheSize 为最近结果缓存的条目数，0 表示不缓存；workers 为分析线程数（至少为1）
+// 返回进程退出码
+int runServer(const std::string& socketPath, size_t cacheSize, int workers);
+
+#endif /* SERVER_H */
@@ -0,0 +1,901 @@
+#include "ssa.h"
+#include "opt.h"
+#include <unordered_map>
+#include <algorithm>
+
+static const uint32_t kNoBlock = UINT32_MAX;
+
+/* INFO 公共工具 */
+
+static bool definesValue(const IrInst& inst) {
+    return inst.op >= IR_MOV && inst.op <= IR_CALL && inst.dst != kNoValue;
+}
+
+template <typename Fn>
+static void forEachOperand(IrFunction& function, IrInst& inst, Fn fn) {
+    switch (inst.op) {
+        case IR_NOP:
+        case IR_JMP:
+            break;
+        case IR_MOV:
+        case IR_CONV:
+        case IR_BR:
+        case IR_RET:
+            fn(inst.a);
+            break;
+        case IR_CALL:
+            for (uint32_t k = 0; k < inst.c; k++) fn(function.args[inst.b + k]);
+            break;
+        default:
+            fn(inst.a);
+            fn(inst.b);
+            break;
+    }
+}
+
+// 没有副作用、在任何路径上执行都不会出错的指令（可以投机执行）
+static bool speculatable(const IrFunction& function, const IrInst& inst) {
+    if (inst.op < IR_MOV || inst.op > IR_GE) return false;
+    if (inst.op == IR_DIV && function.values[inst.b].type == TYPE_INT) {
+        const IrValue& divisor = function.values[inst.b];
+        return divisor.kind == IRV_CONST && divisor.intValue != 0;
+    }
+    return true;
+}
+
+// 回边 t->h（h 支配 t）确定的自然循环
+struct NaturalLoop {
+    uint32_t header;
+    std::vector<uint32_t> blocks;   // 循环体的块，按逆后序排列（首个为循环头）
+};
+
+// 找出全部自然循环；同一循环头的多条回边合为一个循环。
+// 循环体以块表存放，总耗时与各循环块数之和成正比
+static std::vector<NaturalLoop> findLoops(const IrFunction& function, const DominatorTree& tree) {
+    std::vector<NaturalLoop> loops;
+    std::vector<uint32_t> work, rpoIndex(function.blocks.size(), kNoBlock), mark(function.blocks.size(), kNoBlock);
+    for (uint32_t i = 0; i < tree.order.size(); i++) rpoIndex[tree.order[i]] = i;
+    for (uint32_t h : tree.order) {
+        work.clear();
+        for (uint32_t pred : function.blocks[h].preds) {
+            if (tree.dominates(h, pred)) work.push_back(pred);
+        }
+        if (work.empty()) continue;
+        NaturalLoop loop{ h, { h } };
+        mark[h] = h;
+        for (uint32_t latch : work) {
+            if (mark[latch] != h) {
+                mark[latch] = h;
+                loop.blocks.push_back(latch);
+            }
+        }
+        // 从回边的源头逆向走到循环头
+        while (!work.empty()) {
+            uint32_t b = work.back();
+            work.pop_back();
+            if (b == h) continue;
+            for (uint32_t pred : function.blocks[b].preds) {
+                if (mark[pred] != h && tree.preorder[pred] != UINT32_MAX) {
+                    mark[pred] = h;
+                    loop.blocks.push_back(pred);
+                    work.push_back(pred);
+                }
+            }
+        }
+        std::sort(loop.blocks.begin(), loop.blocks.end(),
+                  [&](uint32_t x, uint32_t y) { return rpoIndex[x] < rpoIndex[y]; });
+        loops.push_back(std::move(loop));
+    }
+    return loops;
+}
+
+/* INFO SSA 优化 */
+
+// 退出 SSA 后按活跃信息合并复制 x = y：x 的其他定义处 y 不活跃、y 的定义处 x 不活跃时，
+// 两者可以共用一个名字，复制随之消失。嵌套循环的 φ 之间的复制由此消除。
+// 每轮先按两两不冲突的复制把值并成类，再扫描一遍检查类内任意两个值是否冲突：
+// 不冲突的类整体合并（一串复制在同一轮中合并）；冲突的类退回为每个值最多参与一次合并，
+// 合并后重新做活跃分析，最多 kOptMaxRounds 轮。合并只会扩大活跃范围，冲突的复制以后也冲突，
+// 不再作为候选；后面各轮只分析剩下的候选
+static void coalesceCopies(IrFunction& function) {
+    struct Candidate {
+        uint32_t dst, src;
+        bool interferes, merged;
+    };
+    size_t count = function.values.size();
+    IrLiveness liveness;
+    std::vector<Candidate> candidates, next;
+    std::vector<uint32_t> partnerStart, partners, cursor;
+    std::vector<uint32_t> touched(count, 0), merged(count, 0), rename(count, kNoValue);
+    std::vector<uint32_t> parent(count, kNoValue), liveCount(count, 0), countStamp(count, 0);
+    std::vector<uint8_t> liveHere(count, 0), related(count, 0), conflict(count, 0);
+    uint32_t stamp = 0, block = 0;
+    for (const IrInst& inst : function.insts) {
+        if (inst.op != IR_MOV || inst.dst == inst.a) continue;
+        const IrValue& src = function.values[inst.a];
+        if (src.kind != IRV_CONST && src.type == function.values[inst.dst].type) {
+            candidates.push_back(Candidate{ inst.dst, inst.a, false, false });
+        }
+    }
+
+    // 扫描位置处值是否活跃：块内已扫描过的值看块内的状态，否则看块出口。
+    // 只查询与复制有关的值，不展开出口处全部活跃的值（变量很多时每块上千个）
+    auto live = [&](uint32_t value) {
+        return touched[value] == stamp ? liveHere[value] != 0 : liveness.isLiveOut(block, value);
+    };
+    auto setLive = [&](uint32_t value, bool state) {
+        touched[value] = stamp;
+        liveHere[value] = state;
+    };
+    // 并查集：根为类的名字，优先保留变量
+    auto find = [&](uint32_t value) {
+        uint32_t root = value;
+        while (parent[root] != kNoValue) root = parent[root];
+        while (value != root) {
+            uint32_t up = parent[value];
+            parent[value] = root;
+            value = up;
+        }
+        return root;
+    };
+    auto classLive = [&](uint32_t root) -> uint32_t& {
+        if (countStamp[root] != stamp) {
+            countStamp[root] = stamp;
+            liveCount[root] = 0;
+        }
+        return liveCount[root];
+    };
+
+    for (int round = 1; round <= kOptMaxRounds; round++) {
+        if (candidates.empty()) return;
+        for (const Candidate& c : candidates) related[c.dst] = related[c.src] = 1;
+
+        // 值 -> 涉及它的候选复制（CSR）
+        partnerStart.assign(count + 1, 0);
+        for (const Candidate& c : candidates) {
+            partnerStart[c.dst + 1]++;
+            partnerStart[c.src + 1]++;
+        }
+        for (size_t v = 0; v < count; v++) partnerStart[v + 1] += partnerStart[v];
+        partners.resize(candidates.size() * 2);
+        cursor.assign(partnerStart.begin(), partnerStart.end() - 1);
+        for (uint32_t k = 0; k < candidates.size(); k++) {
+            partners[cursor[candidates[k].dst]++] = k;
+            partners[cursor[candidates[k].src]++] = k;
+        }
+        auto interfereWithLive = [&](uint32_t value, const IrInst* copy) {
+            for (uint32_t k = partnerStart[value]; k < partnerStart[value + 1]; k++) {
+                Candidate& c = candidates[partners[k]];
+                uint32_t other = c.dst == value ? c.src : c.dst;
+                if (live(other) && !(copy && copy->a == other)) c.interferes = true;
+            }
+        };
+
+        // 逐块向后扫描：定义一个值时，与它有复制关系且仍活跃的另一方与之冲突
+        irComputeLiveness(function, liveness, &related);
+        for (block = 0; block < function.blocks.size(); block++) {
+            const IrBlock& current = function.blocks[block];
+            stamp++;
+            for (uint32_t i = current.end; i-- > current.begin;) {
+                IrInst& inst = function.insts[i];
+                if (inst.op == IR_NOP) continue;
+                if (definesValue(inst)) {
+                    interfereWithLive(inst.dst, inst.op == IR_MOV ? &inst : nullptr);
+                    setLive(inst.dst, false);
+                }
+                forEachOperand(function, inst, [&](uint32_t& value) {
+                    if (function.values[value].kind != IRV_CONST) setLive(value, true);
+                });
+            }
+            // 入口处活跃的值（参数、未赋值的变量）都在函数开始时定义
+            if (block == 0) {
+                for (Candidate& c : candidates) {
+                    if (live(c.dst) && live(c.src)) c.interferes = true;
+                }
+            }
+        }
+
+        // 不冲突的复制连成类：临时值并入变量，否则目标并入源
+        for (const Candidate& c : candidates) {
+            if (c.interferes) continue;
+            uint32_t dst = find(c.dst), src = find(c.src);
+            if (dst == src) continue;
+            bool keepDst = dst < function.slotCount && src >= function.slotCount;
+            if (keepDst) parent[src] = dst;
+            else parent[dst] = src;
+        }
+
+        // 再扫描一遍，逐点维护各类中活跃的值的个数：定义一个值时，同类中还有其他活跃的值
+        // （复制的来源除外）则该类冲突
+        for (block = 0; block < function.blocks.size(); block++) {
+            const IrBlock& current = function.blocks[block];
+            stamp++;
+            liveness.forEachLiveOut(block, [&](uint32_t value) {
+                setLive(value, true);
+                classLive(find(value))++;
+            });
+            for (uint32_t i = current.end; i-- > current.begin;) {
+                IrInst& inst = function.insts[i];
+                if (inst.op == IR_NOP) continue;
+                if (definesValue(inst) && related[inst.dst]) {
+                    uint32_t root = find(inst.dst);
+                    uint32_t& liveInClass = classLive(root);
+                    uint32_t self = live(inst.dst) ? 1 : 0;
+                    uint32_t source = inst.op == IR_MOV && inst.a != inst.dst && related[inst.a] &&
+                                      find(inst.a) == root && live(inst.a) ? 1 : 0;
+                    if (liveInClass > self + source) conflict[root] = 1;
+                    liveInClass -= self;
+                    setLive(inst.dst, false);
+                }
+                forEachOperand(function, inst, [&](uint32_t& value) {
+                    if (!related[value] || live(value)) return;
+                    setLive(value, true);
+                    classLive(find(value))++;
+                });
+            }
+            if (block == 0) {
+                for (const Candidate& c : candidates) {
+                    if (classLive(find(c.dst)) > 1) conflict[find(c.dst)] = 1;
+                }
+            }
+        }
+
+        // 不冲突的类整体改名；冲突的类中每个值最多参与一次两两合并
+        size_t merges = 0;
+        for (Candidate& c : candidates) {
+            if (c.interferes) continue;
+            uint32_t root = find(c.dst);
+            if (!conflict[root]) {
+                if (c.dst != root) rename[c.dst] = root;
+                if (c.src != root) rename[c.src] = root;
+                c.merged = true;
+                merges++;
+                continue;
+            }
+            if (merged[c.dst] == (uint32_t)round || merged[c.src] == (uint32_t)round) continue;
+            c.merged = true;
+            merged[c.dst] = merged[c.src] = round;
+            bool keepDst = c.dst < function.slotCount && c.src >= function.slotCount;
+            if (keepDst) rename[c.src] = c.dst;
+            else rename[c.dst] = c.src;
+            merges++;
+        }
+        for (const Candidate& c : candidates) conflict[find(c.dst)] = 0;
+        for (const Candidate& c : candidates) parent[c.dst] = parent[c.src] = kNoValue;
+        if (merges == 0) return;
+        for (IrInst& inst : function.insts) {
+            if (inst.op == IR_NOP) continue;
+            forEachOperand(function, inst, [&](uint32_t& value) {
+                if (rename[value] != kNoValue) value = rename[value];
+            });
+            if (definesValue(inst) && rename[inst.dst] != kNoValue) inst.dst = rename[inst.dst];
+            if (inst.op == IR_MOV && inst.dst == inst.a) inst.op = IR_NOP;
+        }
+        // 本轮因另一方已合并而跳过的复制留作下一轮的候选（改用新名字，两边同名的已删除）
+        next.clear();
+        for (const Candidate& c : candidates) {
+            if (c.interferes || c.merged) continue;
+            uint32_t dst = rename[c.dst] != kNoValue ? rename[c.dst] : c.dst;
+            uint32_t src = rename[c.src] != kNoValue ? rename[c.src] : c.src;
+            if (dst != src) next.push_back(Candidate{ dst, src, false, false });
+        }
+        for (const Candidate& c : candidates) {
+            rename[c.dst] = rename[c.src] = kNoValue;
+            related[c.dst] = related[c.src] = 0;
+        }
+        candidates.swap(next);
+        irCompact(function);
+    }
+}
+
+struct SsaOptimizer {
+    IrFunction& function;
+    SsaStats& stats;
+    DominatorTree tree;
+    std::vector<std::vector<IrInst>> code;        // 各块的指令（不含 φ，NOP 表示已删除）
+
+    struct Phi {
+        uint32_t dst;      // φ 定义的值
+        uint32_t var;      // 重命名前的变量（或多次定义的临时值）
+        uint32_t args;     // 实参在 phiArgs 中的起始位置，顺序与块的前驱一致
+        bool live;
+    };
+    std::vector<Phi> phis;
+    std::vector<uint32_t> phiArgs;
+    std::vector<std::vector<uint32_t>> blockPhis; // 块 -> φ 下标
+    std::vector<uint32_t> defBlock;               // 值 -> 定义所在块；入口值与常量为 kNoBlock
+    uint32_t zeros[3] = { kNoValue, kNoValue, kNoValue };
+
+    SsaOptimizer(IrFunction& target, SsaStats& output) : function(target), stats(output) {}
+
+    uint32_t blockCount() const {
+        return (uint32_t)function.blocks.size();
+    }
+
+    uint32_t zero(MiniType type) {
+        uint32_t& value = zeros[type - TYPE_INT];
+        if (value == kNoValue) {
+            value = type == TYPE_INT ? irNewIntConst(function, 0) : irNewFloatConst(function, type, 0.0);
+        }
+        return value;
+    }
+
+    uint32_t newTemp(uint32_t like) {
+        MiniType type = function.values[like].type;
+        uint32_t name = function.values[like].name;
+        uint32_t value = irNewTemp(function, type);
+        function.values[value].name = name;  // 保留变量名，便于阅读输出
+        return value;
+    }
+
+    // 前驱 pred 在 block 的前驱表中的位置
+    uint32_t predIndex(uint32_t block, uint32_t pred) const {
+        const std::vector<uint32_t>& preds = function.blocks[block].preds;
+        return (uint32_t)(std::find(preds.begin(), preds.end(), pred) - preds.begin());
+    }
+
+    void run() {
+        irRemoveUnreachable(function);
+        insertPreheaders();
+        code.assign(blockCount(), {});
+        for (uint32_t b = 0; b < blockCount(); b++) {
+            const IrBlock& block = function.blocks[b];
+            code[b].assign(function.insts.begin() + block.begin, function.insts.begin() + block.end);
+        }
+        blockPhis.assign(blockCount(), {});
+        construct();
+        numberValues();
+        hoistInvariants();
+        destruct();
+        coalesceCopies(function);
+    }
+
+    // 循环头只有一个循环外前驱且该前驱只有这一个后继时，它就是前置块；否则新建一个
+    void insertPreheaders() {
+        irComputeDominators(function, tree);
+        bool added = false;
+        std::vector<uint32_t> outside;
+        for (uint32_t h : tree.order) {
+            outside.clear();
+            bool isHeader = false;
+            for (uint32_t pred : function.blocks[h].preds) {
+                if (tree.dominates(h, pred)) {
+                    isHeader = true;
+                } else {
+                    outside.push_back(pred);
+                }
+            }
+            if (!isHeader || outside.empty()) continue;
+            if (outside.size() == 1 && function.blocks[outside[0]].succs.size() == 1) continue;
+
+            uint32_t preheader = blockCount();
+            int line = function.insts[function.blocks[outside[0]].end - 1].line;
+            function.insts.push_back(IrInst{ IR_JMP, line, kNoValue, kNoValue, h, kNoValue });
+            function.blocks.push_back(IrBlock{ (uint32_t)function.insts.size() - 1, (uint32_t)function.insts.size(), {}, {} });
+            for (uint32_t pred : outside) {
+                IrInst& last = function.insts[function.blocks[pred].end - 1];
+                if (last.b == h) last.b = preheader;
+                if (last.op == IR_BR && last.c == h) last.c = preheader;
+            }
+            added = true;
+        }
+        if (added) {
+            irComputeCfg(function);
+            irComputeDominators(function, tree);
+        }
+    }
+
+    /* SSA 构造 */
+
+    void construct() {
+        uint32_t count = (uint32_t)function.values.size();
+        uint32_t blocks = blockCount();
+
+        // 需要重命名的值：变量与多次定义的临时值；其中跨块活跃的才需要 φ
+        std::vector<uint32_t> defs(count, 0), mark(count, kNoBlock);
+        std::vector<uint8_t> renamed(count, 0), global(count, 0);
+        for (uint32_t b = 0; b < blocks; b++) {
+            for (IrInst& inst : code[b]) {
+                forEachOperand(function, inst, [&](uint32_t& value) {
+                    if (mark[value] != b) global[value] = 1;
+                });
+                if (definesValue(inst)) {
+                    defs[inst.dst]++;
+                    mark[inst.dst] = b;
+                }
+            }
+        }
+        for (uint32_t value = 0; value < count; value++) {
+            const IrValue& v = function.values[value];
+            renamed[value] = v.kind == IRV_VAR || (v.kind == IRV_TEMP && defs[value] > 1);
+        }
+
+        // 各值的定义块（按值分组的紧凑数组，同一块只记一次）
+        std::vector<uint32_t> offsets(count + 1, 0), defBlocks;
+        std::fill(mark.begin(), mark.end(), kNoBlock);
+        for (uint32_t b = 0; b < blocks; b++) {
+            for (const IrInst& inst : code[b]) {
+                if (definesValue(inst) && renamed[inst.dst] && global[inst.dst] && mark[inst.dst] != b) {
+                    mark[inst.dst] = b;
+                    offsets[inst.dst + 1]++;
+                }
+            }
+        }
+        for (uint32_t value = 0; value < count; value++) offsets[value + 1] += offsets[value];
+        defBlocks.resize(offsets[count]);
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (uint32_t b = 0; b < blocks; b++) {
+            for (const IrInst& inst : code[b]) {
+                if (!definesValue(inst) || !renamed[inst.dst] || !global[inst.dst]) continue;
+                uint32_t& next = fill[inst.dst];
+                if (next == offsets[inst.dst] || defBlocks[next - 1] != b) defBlocks[next++] = b;
+            }
+        }
+
+        // φ 放置：定义块的支配边界的迭代闭包
+        std::vector<std::vector<uint32_t>> frontiers = irDominanceFrontiers(function, tree);
+        std::vector<uint32_t> hasPhi(blocks, kNoValue), queued(blocks, kNoValue), work;
+        for (uint32_t value = 0; value < count; value++) {
+            if (offsets[value] == offsets[value + 1]) continue;
+            for (uint32_t k = offsets[value]; k < offsets[value + 1]; k++) {
+                queued[defBlocks[k]] = value;
+                work.push_back(defBlocks[k]);
+            }
+            while (!work.empty()) {
+                uint32_t b = work.back();
+                work.pop_back();
+                for (uint32_t d : frontiers[b]) {
+                    if (hasPhi[d] == value) continue;
+                    hasPhi[d] = value;
+                    blockPhis[d].push_back((uint32_t)phis.size());
+                    phis.push_back(Phi{ newTemp(value), value, (uint32_t)phiArgs.size(), true });
+                    phiArgs.resize(phiArgs.size() + function.blocks[d].preds.size(), kNoValue);
+                    if (queued[d] != value) {
+                        queued[d] = value;
+                        work.push_back(d);
+                    }
+                }
+            }
+        }
+        stats.phis += phis.size();
+
+        // 重命名：沿支配树先序遍历，current 为各值的当前版本，离开子树时按撤销日志恢复。
+        // 参数的入口版本是参数本身，其余变量入口为0
+        std::vector<uint32_t> current(count);
+        for (uint32_t value = 0; value < count; value++) {
+            current[value] = value;
+            if (renamed[value] && value >= function.paramCount) current[value] = zero(function.values[value].type);
+        }
+        defBlock.assign(function.values.size(), kNoBlock);
+        std::vector<std::pair<uint32_t, uint32_t>> undo;
+        auto enter = [&](uint32_t b) {
+            for (uint32_t index : blockPhis[b]) {
+                const Phi& phi = phis[index];
+                undo.push_back({ phi.var, current[phi.var] });
+                current[phi.var] = phi.dst;
+                defBlock[phi.dst] = b;
+            }
+            for (IrInst& inst : code[b]) {
+                forEachOperand(function, inst, [&](uint32_t& value) {
+                    if (value < count && renamed[value]) value = current[value];
+                });
+                if (!definesValue(inst)) continue;
+                if (renamed[inst.dst]) {
+                    uint32_t version = newTemp(inst.dst);
+                    undo.push_back({ inst.dst, current[inst.dst] });
+                    current[inst.dst] = version;
+                    inst.dst = version;
+                    defBlock.resize(function.values.size(), kNoBlock);
+                }
+                defBlock[inst.dst] = b;
+            }
+            for (uint32_t succ : function.blocks[b].succs) {
+                uint32_t position = predIndex(succ, b);
+                for (uint32_t index : blockPhis[succ]) {
+                    phiArgs[phis[index].args + position] = current[phis[index].var];
+                }
+            }
+        };
+        walkDominatorTree(enter, [&](size_t mark) {
+            while (undo.size() > mark) {
+                current[undo.back().first] = undo.back().second;
+                undo.pop_back();
+            }
+        }, [&]() { return undo.size(); });
+        defBlock.resize(function.values.size(), kNoBlock);
+    }
+
+    // 支配树先序遍历（显式栈）：进入块时调用enter，离开其子树时以进入前的标记调用leave
+    template <typename Enter, typename Leave, typename Mark>
+    void walkDominatorTree(Enter enter, Leave leave, Mark mark) {
+        struct Frame {
+            uint32_t block;
+            size_t mark;
+            uint32_t child;
+        };
+        std::vector<Frame> stack;
+        if (tree.order.empty()) return;
+        size_t m = mark();
+        enter(tree.order[0]);
+        stack.push_back({ tree.order[0], m, tree.firstChild[tree.order[0]] });
+        while (!stack.empty()) {
+            Frame& top = stack.back();
+            if (top.child == kNoBlock) {
+                leave(top.mark);
+                stack.pop_back();
+                continue;
+            }
+            uint32_t child = top.child;
+            top.child = tree.nextSibling[child];
+            m = mark();
+            enter(child);
+            stack.push_back({ child, m, tree.firstChild[child] });
+        }
+    }
+
+    /* 全局值编号 */
+
+    struct ExprKey {
+        uint8_t op;
+        uint8_t type;
+        uint32_t a, b;
+        bool operator==(const ExprKey& other) const {
+            return op == other.op && type == other.type && a == other.a && b == other.b;
+        }
+    };
+    struct ExprHash {
+        size_t operator()(const ExprKey& key) const {
+            uint64_t h = ((uint64_t)key.a << 32 | key.b) * 0x9E3779B97F4A7C15ULL;
+            return (size_t)(h ^ (h >> 29) ^ ((uint64_t)key.op << 8 | key.type));
+        }
+    };
+
+    void numberValues() {
+        std::vector<uint32_t> replace(function.values.size(), kNoValue);
+        auto resolve = [&](uint32_t& value) {
+            while (replace[value] != kNoValue) value = replace[value];
+        };
+        std::unordered_map<ExprKey, uint32_t, ExprHash> table;
+        std::vector<ExprKey> scope;
+
+        auto enter = [&](uint32_t b) {
+            const std::vector<uint32_t>& list = blockPhis[b];
+            uint32_t predCount = (uint32_t)function.blocks[b].preds.size();
+            for (size_t i = 0; i < list.size(); i++) {
+                Phi& phi = phis[list[i]];
+                uint32_t same = kNoValue;
+                bool trivial = true;
+                for (uint32_t k = 0; k < predCount; k++) {
+                    uint32_t& arg = phiArgs[phi.args + k];
+                    resolve(arg);
+                    if (arg == phi.dst || arg == same) continue;
+                    if (same != kNoValue) trivial = false;
+                    same = arg;
+                }
+                uint32_t leader = trivial ? same : kNoValue;
+                // 同一块中实参完全相同的 φ 是重复的
+                for (size_t j = 0; j < i && leader == kNoValue; j++) {
+                    const Phi& other = phis[list[j]];
+                    if (other.live && std::equal(phiArgs.begin() + phi.args, phiArgs.begin() + phi.args + predCount,
+                                                 phiArgs.begin() + other.args)) {
+                        leader = other.dst;
+                    }
+                }
+                if (leader != kNoValue) {
+                    replace[phi.dst] = leader;
+                    phi.live = false;
+                    stats.gvn++;
+                }
+            }
+            for (IrInst& inst : code[b]) {
+                if (inst.op == IR_NOP) continue;
+                forEachOperand(function, inst, resolve);
+                if (inst.op == IR_MOV) {
+                    replace[inst.dst] = inst.a;
+                    inst.op = IR_NOP;
+                    stats.gvn++;
+                    continue;
+                }
+                if (inst.op < IR_CONV || inst.op > IR_GE) continue;
+                ExprKey key{ (uint8_t)inst.op, function.values[inst.dst].type, inst.a, inst.b };
+                switch (inst.op) {
+                    case IR_ADD:
+                    case IR_MUL:
+                    case IR_AND:
+                    case IR_OR:
+                    case IR_EQ:
+                    case IR_NE:
+                        if (key.a > key.b) std::swap(key.a, key.b);
+                        break;
+                    case IR_GT:
+                        key = ExprKey{ (uint8_t)IR_LT, key.type, inst.b, inst.a };
+                        break;
+                    case IR_GE:
+                        key = ExprKey{ (uint8_t)IR_LE, key.type, inst.b, inst.a };
+                        break;
+                    case IR_CONV:
+                        key.b = kNoValue;
+                        break;
+                    default:
+                        break;
+                }
+                auto found = table.find(key);
+                if (found != table.end()) {
+                    replace[inst.dst] = found->second;
+                    inst.op = IR_NOP;
+                    stats.gvn++;
+                } else {
+                    table.emplace(key, inst.dst);
+                    scope.push_back(key);
+                }
+            }
+        };
+        walkDominatorTree(enter, [&](size_t mark) {
+            while (scope.size() > mark) {
+                table.erase(scope.back());
+                scope.pop_back();
+            }
+        }, [&]() { return scope.size(); });
+
+        // 回边上的 φ 实参在循环头处理时尚未替换，最后统一替换一遍
+        for (uint32_t b = 0; b < blockCount(); b++) {
+            for (IrInst& inst : code[b]) forEachOperand(function, inst, resolve);
+            for (uint32_t index : blockPhis[b]) {
+                const Phi& phi = phis[index];
+                for (size_t k = 0; k < function.blocks[b].preds.size(); k++) resolve(phiArgs[phi.args + k]);
+            }
+        }
+    }
+
+    /* 循环不变量外提 */
+
+    void hoistInvariants() {
+        std::vector<NaturalLoop> loops = findLoops(function, tree);
+        stats.loops += loops.size();
+        // 内层循环的块数少，先处理；外提到内层前置块的指令随后可以继续外提
+        std::sort(loops.begin(), loops.end(),
+                  [](const NaturalLoop& a, const NaturalLoop& b) { return a.blocks.size() < b.blocks.size(); });
+        std::vector<IrInst> moved;
+        std::vector<uint32_t> inLoop(blockCount(), kNoBlock);   // 等于循环头时表示在当前循环中
+        for (const NaturalLoop& loop : loops) {
+            for (uint32_t b : loop.blocks) inLoop[b] = loop.header;
+            uint32_t preheader = kNoBlock, outside = 0;
+            for (uint32_t pred : function.blocks[loop.header].preds) {
+                if (inLoop[pred] != loop.header) {
+                    preheader = pred;
+                    outside++;
+                }
+            }
+            if (outside != 1 || function.blocks[preheader].succs.size() != 1) continue;
+
+            auto invariant = [&](uint32_t value) {
+                return defBlock[value] == kNoBlock || inLoop[defBlock[value]] != loop.header;
+            };
+            moved.clear();
+            for (uint32_t b : loop.blocks) {
+                for (IrInst& inst : code[b]) {
+                    if (inst.op == IR_NOP || !speculatable(function, inst)) continue;
+                    if (!invariant(inst.a) || (inst.op != IR_MOV && inst.op != IR_CONV && !invariant(inst.b))) continue;
+                    moved.push_back(inst);
+                    defBlock[inst.dst] = preheader;
+                    inst.op = IR_NOP;
+                }
+            }
+            if (moved.empty()) continue;
+            std::vector<IrInst>& target = code[preheader];
+            target.insert(target.end() - 1, moved.begin(), moved.end());
+            stats.hoisted += moved.size();
+        }
+    }
+
+    /* 退出 SSA */
+
+    void destruct() {
+        uint32_t blocks = blockCount();
+        std::vector<uint32_t> uses(function.values.size(), 0);
+        for (uint32_t b = 0; b < blocks; b++) {
+            for (IrInst& inst : code[b]) {
+                if (inst.op != IR_NOP) forEachOperand(function, inst, [&](uint32_t& value) { uses[value]++; });
+            }
+            for (uint32_t index : blockPhis[b]) {
+                if (!phis[index].live) continue;
+                for (size_t k = 0; k < function.blocks[b].preds.size(); k++) uses[phiArgs[phis[index].args + k]]++;
+            }
+        }
+
+        // 每个 φ：x' 在各前驱末尾得到实参，块首 x = x'
+        struct Pair {
+            uint32_t phiDst;     // x
+            uint32_t copy;       // x'
+            uint32_t block;
+            bool interferes;
+        };
+        std::vector<Pair> pairs;
+        std::vector<std::vector<IrInst>> heads(blocks), tails(blocks);
+        for (uint32_t b = 0; b < blocks; b++) {
+            const std::vector<uint32_t>& preds = function.blocks[b].preds;
+            for (uint32_t index : blockPhis[b]) {
+                const Phi& phi = phis[index];
+                if (!phi.live) continue;
+                uint32_t copy = newTemp(phi.dst);
+                int line = code[b].empty() ? 0 : code[b].front().line;
+                for (size_t k = 0; k < preds.size(); k++) {
+                    uint32_t arg = phiArgs[phi.args + k];
+                    uint32_t pred = preds[k];
+                    if (!retarget(pred, arg, copy, uses)) {
+                        tails[pred].push_back(IrInst{ IR_MOV, code[pred].back().line, copy, arg, kNoValue, kNoValue });
+                    }
+                }
+                heads[b].push_back(IrInst{ IR_MOV, line, phi.dst, copy, kNoValue, kNoValue });
+                pairs.push_back(Pair{ phi.dst, copy, b, false });
+            }
+        }
+        for (uint32_t b = 0; b < blocks; b++) {
+            if (heads[b].empty() && tails[b].empty()) continue;
+            std::vector<IrInst>& list = code[b];
+            list.insert(list.end() - 1, tails[b].begin(), tails[b].end());
+            list.insert(list.begin(), heads[b].begin(), heads[b].end());
+        }
+
+        // x 与 x' 合并的条件：x' 的每个定义之后 x 都不再活跃。x 的定义（块首）支配它的全部使用，
+        // 所以只需检查被该块支配的前驱：x' 的定义之后在本块中是否还读 x，以及能否经其他后继离开
+        std::vector<uint32_t> pairOfCopy(function.values.size(), kNoValue), readMark(function.values.size(), kNoBlock);
+        for (uint32_t k = 0; k < pairs.size(); k++) pairOfCopy[pairs[k].copy] = k;
+        for (Pair& pair : pairs) {
+            for (uint32_t pred : function.blocks[pair.block].preds) {
+                if (tree.dominates(pair.block, pred) && function.blocks[pred].succs.size() > 1) pair.interferes = true;
+            }
+        }
+        for (uint32_t b = 0; b < blocks; b++) {
+            if (tails[b].empty()) continue;
+            std::vector<IrInst>& list = code[b];
+            for (size_t i = list.size(); i-- > 0;) {
+                IrInst& inst = list[i];
+                if (inst.op == IR_NOP) continue;
+                if (definesValue(inst) && pairOfCopy[inst.dst] != kNoValue) {
+                    Pair& pair = pairs[pairOfCopy[inst.dst]];
+                    if (readMark[pair.phiDst] == b) pair.interferes = true;
+                }
+                forEachOperand(function, inst, [&](uint32_t& value) { readMark[value] = b; });
+            }
+        }
+        std::vector<uint32_t> rename(function.values.size(), kNoValue);
+        for (const Pair& pair : pairs) {
+            if (!pair.interferes) rename[pair.phiDst] = pair.copy;
+        }
+        for (uint32_t b = 0; b < blocks; b++) {
+            for (IrInst& inst : code[b]) {
+                if (inst.op == IR_NOP) continue;
+                forEachOperand(function, inst, [&](uint32_t& value) {
+                    if (rename[value] != kNoValue) value = rename[value];
+                });
+                if (inst.op == IR_MOV && rename[inst.dst] == inst.a) inst.op = IR_NOP;
+            }
+        }
+
+        // 重建指令数组
+        std::vector<IrInst> insts;
+        for (uint32_t b = 0; b < blocks; b++) {
+            IrBlock& block = function.blocks[b];
+            block.begin = (uint32_t)insts.size();
+            for (const IrInst& inst : code[b]) {
+                if (inst.op != IR_NOP) insts.push_back(inst);
+            }
+            block.end = (uint32_t)insts.size();
+        }
+        function.insts.swap(insts);
+        irComputeCfg(function);
+    }
+
+    // 实参只被这个 φ 使用且在前驱中由普通指令定义时，直接让该指令定义 x'
+    bool retarget(uint32_t pred, uint32_t arg, uint32_t copy, const std::vector<uint32_t>& uses) {
+        if (function.values[arg].kind != IRV_TEMP || uses[arg] != 1 || defBlock[arg] != pred) return false;
+        std::vector<IrInst>& list = code[pred];
+        for (size_t i = list.size(); i-- > 0;) {
+            if (list[i].op != IR_NOP && definesValue(list[i]) && list[i].dst == arg) {
+                list[i].dst = copy;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+/* 接口实现 */
+
+void irComputeDominators(const IrFunction& function, DominatorTree& tree) {
+    uint32_t count = (uint32_t)function.blocks.size();
+    tree.order = irReversePostorder(function);
+    std::vector<uint32_t> index(count, kNoBlock);
+    for (uint32_t i = 0; i < tree.order.size(); i++) index[tree.order[i]] = i;
+
+    // 在逆后序编号上迭代；求交时编号较大的一方沿直接支配者上移
+    std::vector<uint32_t> idom(tree.order.size(), kNoBlock);
+    if (!idom.empty()) idom[0] = 0;
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (uint32_t i = 1; i < tree.order.size(); i++) {
+            uint32_t result = kNoBlock;
+            for (uint32_t pred : function.blocks[tree.order[i]].preds) {
+                uint32_t p = index[pred];
+                if (p == kNoBlock || idom[p] == kNoBlock) continue;
+                if (result == kNoBlock) {
+                    result = p;
+                    continue;
+                }
+                uint32_t a = p, b = result;
+                while (a != b) {
+                    while (a > b) a = idom[a];
+                    while (b > a) b = idom[b];
+                }
+                result = a;
+            }
+            if (idom[i] != result) {
+                idom[i] = result;
+                changed = true;
+            }
+        }
+    }
+
+    tree.idom.assign(count, kNoBlock);
+    tree.firstChild.assign(count, kNoBlock);
+    tree.nextSibling.assign(count, kNoBlock);
+    tree.preorder.assign(count, kNoBlock);
+    tree.postorder.assign(count, kNoBlock);
+    if (tree.order.empty()) return;
+    tree.idom[tree.order[0]] = tree.order[0];
+    // 逆序插入使子节点按逆后序排列
+    for (uint32_t i = (uint32_t)tree.order.size(); i-- > 1;) {
+        uint32_t b = tree.order[i], parent = tree.order[idom[i]];
+        tree.idom[b] = parent;
+        tree.nextSibling[b] = tree.firstChild[parent];
+        tree.firstChild[parent] = b;
+    }
+    uint32_t pre = 0, post = 0;
+    std::vector<std::pair<uint32_t, uint32_t>> stack;   // 块与下一个要访问的子节点
+    tree.preorder[tree.order[0]] = pre++;
+    stack.push_back({ tree.order[0], tree.firstChild[tree.order[0]] });
+    while (!stack.empty()) {
+        auto& top = stack.back();
+        if (top.second == kNoBlock) {
+            tree.postorder[top.first] = post++;
+            stack.pop_back();
+            continue;
+        }
+        uint32_t child = top.second;
+        top.second = tree.nextSibling[child];
+        tree.preorder[child] = pre++;
+        stack.push_back({ child, tree.firstChild[child] });
+    }
+}
+
+std::vector<std::vector<uint32_t>> irDominanceFrontiers(const IrFunction& function, const DominatorTree& tree) {
+    std::vector<std::vector<uint32_t>> frontiers(function.blocks.size());
+    for (uint32_t b : tree.order) {
+        const std::vector<uint32_t>& preds = function.blocks[b].preds;
+        if (preds.size() < 2) continue;
+        for (uint32_t pred : preds) {
+            if (tree.preorder[pred] == kNoBlock) continue;  // 不可达的前驱
+            for (uint32_t runner = pred; runner != tree.idom[b]; runner = tree.idom[runner]) {
+                if (!frontiers[runner].empty() && frontiers[runner].back() == b) break;
+                frontiers[runner].push_back(b);
+            }
+        }
+    }
+    return frontiers;
+}
+
+std::vector<uint32_t> irLoopDepths(const IrFunction& function) {
+    DominatorTree tree;
+    irComputeDominators(function, tree);
+    std::vector<uint32_t> depths(function.blocks.size(), 0);
+    for (const NaturalLoop& loop : findLoops(function, tree)) {
+        for (uint32_t b : loop.blocks) depths[b]++;
+    }
+    return depths;
+}
+
+void irSsaOptimize(IrFunction& function, SsaStats& stats) {
+    SsaOptimizer optimizer(function, stats);
+    optimizer.run();
+}
@@ -0,0 +1,68 @@
+#ifndef SSA_H
+#define SSA_H
+
+#include "ir.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * 支配关系与基于 SSA 的优化
+ * ===========================
+ * 支配树用 Cooper-Harvey-Kennedy 的迭代算法求得：在逆后序编号上反复求前驱的
+ * 直接支配者的交，交沿直接支配者链上移，不建立任何集合。支配树以块编号为下标存放
+ * （idom、首个子节点、下一个兄弟），先序/后序编号使“a 支配 b”的判断为O(1)。
+ * 支配边界同样按CHK的方法，从每个汇合点的前驱沿支配树上行求得。
+ *
+ * irSsaOptimize 对一个函数依次：
+ *   1. 为每个 while 循环（回边 t->h，h 支配 t）准备唯一的前置块
+ *   2. 构造 SSA：只为跨块活跃的变量（半剪枝）在支配边界的迭代闭包上放置 φ，
+ *      沿支配树先序重命名，版本栈用撤销日志实现
+ *   3. 全局值编号：沿支配树先序遍历，作用域化的散列表记录已计算的表达式，
+ *      被支配的相同表达式（交换律、a>b 与 b<a 归一）、复制与多余的 φ 直接替换
+ *   4. 循环不变量外提：循环体是按逆后序排列的块表，由内向外把操作数都在循环外定义、
+ *      没有副作用且不会出错的指令移到前置块
+ *   5. 退出 SSA：每个 φ 用一个新临时值 x' 承接各前驱末尾的复制，块首 x = x'；
+ *      只被该 φ 使用的实参直接改为定义 x'。在前驱中 x' 被定义后 x 不再使用时，
+ *      x 与 x' 合并，循环变量因此不增加复制；其余复制 x = y 在两者活跃范围不冲突时合并
+ * 之后剩下的复制与死代码由 opt.h 的各遍清除。
+ */
+
+// 支配树（块编号为下标，不可达块的各项为 UINT32_MAX）
+struct DominatorTree {
+    std::vector<uint32_t> order;         // 可达块的逆后序
+    std::vector<uint32_t> idom;          // 直接支配者，入口为其自身
+    std::vector<uint32_t> firstChild;    // 支配树的首个子节点
+    std::vector<uint32_t> nextSibling;   // 支配树的下一个兄弟
+    std::vector<uint32_t> preorder;      // 支配树先序编号
+    std::vector<uint32_t> postorder;     // 支配树后序编号
+
+    // a 是否支配 b（a == b 时为真）
+    bool dominates(uint32_t a, uint32_t b) const {
+        return preorder[b] != UINT32_MAX && preorder[a] <= preorder[b] && postorder[b] <= postorder[a];
+    }
+};
+
+// SSA 优化统计
+struct SsaStats {
+    size_t phis = 0;        // 放置的 φ 数
+    size_t gvn = 0;         // 全局值编号删除的指令数（含复制与 φ）
+    size_t hoisted = 0;     // 外提到循环前置块的指令数
+    size_t loops = 0;       // 找到的循环数
+};
+
+/* INFO 分析与优化接口 */
+
+// 计算支配树（需先 irComputeCfg）
+void irComputeDominators(const IrFunction& function, DominatorTree& tree);
+
+// 各块的支配边界
+std::vector<std::vector<uint32_t>> irDominanceFrontiers(const IrFunction& function, const DominatorTree& tree);
+
+// 各块的循环嵌套深度（不在循环中为0，不可达块为0）
+std::vector<uint32_t> irLoopDepths(const IrFunction& function);
+
+// 构造 SSA，做全局值编号与循环不变量外提，再退出 SSA；统计累加到stats
+void irSsaOptimize(IrFunction& function, SsaStats& stats);
+
+#endif /* SSA_H */
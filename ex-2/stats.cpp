@@ -0,0 +1,247 @@
+#include "stats.h"
+#include "json.h"
+#include <ctime>
+#include <cstdio>
+#include <sys/resource.h>
+
+/* 辅助函数 */
+static double toSeconds(const timespec& ts) {
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// 计算吞吐量，耗时为0时返回0
+static double rate(double amount, double seconds) {
+    return seconds > 0 ? amount / seconds : 0.0;
+}
+
+/* 接口实现 */
+PhaseClock phaseNow() {
+    timespec wall, cpu;
+    clock_gettime(CLOCK_MONOTONIC, &wall);
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+    PhaseClock now = { toSeconds(wall), toSeconds(cpu) };
+    return now;
+}
+
+void addPhase(RunStats& stats, StatsPhase phase, const PhaseClock& start) {
+    PhaseClock now = phaseNow();
+    stats.wall[phase] += now.wall - start.wall;
+    stats.cpu[phase] += now.cpu - start.cpu;
+}
+
+void addPhaseAllocs(RunStats& stats, StatsPhase phase, const AllocSnapshot& start) {
+    AllocSnapshot now = allocSnapshot();
+    stats.allocTracked = true;
+    stats.allocCount[phase] += now.allocs - start.allocs;
+    stats.allocBytes[phase] += now.bytes - start.bytes;
+    int64_t peak = now.peak - start.live;
+    if (peak > stats.allocPeak[phase]) {
+        stats.allocPeak[phase] = peak;
+    }
+}
+
+void samplePeakRss(RunStats& stats) {
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        stats.peakRssKb = usage.ru_maxrss;  // Linux下单位为KB
+    }
+}
+
+void printStatsText(const RunStats& stats, std::ostream& out) {
+    char line[160];
+    out << "\n=== 运行统计 ===\n";
+    out << "阶段\t挂钟(ms)\tCPU(ms)\n";
+    double totalWall = 0, totalCpu = 0;
+    for (int i = 0; i < PHASE_NUM; i++) {
+        snprintf(line, sizeof(line), "%s\t%.3f\t\t%.3f\n", kPhaseNames[i], stats.wall[i] * 1e3, stats.cpu[i] * 1e3);
+        out << line;
+        totalWall += stats.wall[i];
+        totalCpu += stats.cpu[i];
+    }
+    snprintf(line, sizeof(line), "total\t%.3f\t\t%.3f\n", totalWall * 1e3, totalCpu * 1e3);
+    out << line;
+
+    snprintf(line, sizeof(line), "词法吞吐: %.2f MB/s, %.0f tokens/s\n",
+             rate(stats.bytes, stats.wall[PHASE_LEX]) / 1e6, rate(stats.tokens, stats.wall[PHASE_LEX]));
+    out << line;
+    if (stats.wall[PHASE_PARSE] > 0) {
+        snprintf(line, sizeof(line), "语法吞吐: %.2f MB/s, %.0f tokens/s\n",
+                 rate(stats.bytes, stats.wall[PHASE_PARSE]) / 1e6, rate(stats.tokens, stats.wall[PHASE_PARSE]));
+        out << line;
+    }
+    out << "输入字节: " << stats.bytes << "\n";
+    out << "回退次数(ungetToken): " << stats.backtracks << "\n";
+    out << "错误恢复跳过Token数(skipUntil): " << stats.skippedTokens << "\n";
+    if (stats.semantic) {
+        out << "语法树节点数: " << stats.astNodes << "\n";
+        out << "语义错误/警告: " << stats.semaErrors << " / " << stats.semaWarnings << "\n";
+    }
+    if (stats.ir) {
+        size_t total = 0;
+        for (const auto& function : stats.irFunctionInsts) total += function.second;
+        out << "IR指令数: " << total << "（基本块 " << stats.irBlocks << "）\n";
+        for (const auto& function : stats.irFunctionInsts) {
+            out << "  " << function.first << "\t" << function.second << "\n";
+        }
+    }
+    if (stats.optLevel > 0) {
+        out << "优化前IR指令数: " << stats.optBefore << "（优化级别 " << stats.optLevel << "）\n";
+        out << "各遍删除的指令: 常量折叠 " << stats.optRemoved[0] << "，复制传播 " << stats.optRemoved[1]
+            << "，不可达块 " << stats.optRemoved[2] << "，死存储 " << stats.optRemoved[3];
+        if (stats.optLevel >= 2) {
+            out << "，全局值编号 " << stats.optRemoved[4] << "；外提循环不变量 " << stats.optHoisted;
+        }
+        out << "\n";
+        if (stats.optLevel >= 2) {
+            out << "内联: " << stats.optInlined << " 处调用，删除无用函数 " << stats.optDeadFunctions << " 个\n";
+        }
+    }
+    if (stats.ran) {
+        out << "字节码指令数: " << stats.bytecodeInsts << "\n";
+        snprintf(line, sizeof(line), "执行: %llu 条字节码指令，%.3f ms，%.1f 百万条/秒\n",
+                 (unsigned long long)stats.executedInsts, stats.runSeconds * 1e3,
+                 stats.runSeconds > 0 ? stats.executedInsts / stats.runSeconds / 1e6 : 0.0);
+        out << line;
+        out << "运行结果: " << stats.runResult << "\n";
+    }
+    if (stats.jitRan) {
+        snprintf(line, sizeof(line), "JIT: 机器码 %zu 字节，编译 %.3f ms，执行 %.3f ms\n", stats.jitBytes,
+                 stats.jitCompileSeconds * 1e3, stats.jitSeconds * 1e3);
+        out << line;
+        out << "JIT结果: " << stats.jitResult << "\n";
+    }
+    if (stats.emittedC) {
+        snprintf(line, sizeof(line), "C 代码: %zu 字节，生成 %.3f ms\n", stats.cBytes, stats.cSeconds * 1e3);
+        out << line;
+    }
+    out << "峰值内存(RSS): " << stats.peakRssKb << " KB\n";
+
+    if (stats.allocTracked) {
+        out << "内存分配:\n";
+        out << "阶段\t次数\t\t字节\t\t峰值存活\n";
+        for (int i = 0; i < PHASE_NUM; i++) {
+            snprintf(line, sizeof(line), "%s\t%-10llu\t%-10llu\t%lld\n", kPhaseNames[i],
+                     (unsigned long long)stats.allocCount[i], (unsigned long long)stats.allocBytes[i],
+                     (long long)stats.allocPeak[i]);
+            out << line;
+        }
+        if (stats.tokens > 0) {
+            snprintf(line, sizeof(line), "每Token分配次数: 词法 %.2f, 语法 %.2f\n",
+                     (double)stats.allocCount[PHASE_LEX] / stats.tokens,
+                     (double)stats.allocCount[PHASE_PARSE] / stats.tokens);
+            out << line;
+        }
+        if (stats.semantic && stats.astNodes > 0) {
+            snprintf(line, sizeof(line), "每语法树节点（语义分析阶段）: 分配 %.2f 次, %.1f 字节\n",
+                     (double)stats.allocCount[PHASE_SEMA] / stats.astNodes,
+                     (double)stats.allocBytes[PHASE_SEMA] / stats.astNodes);
+            out << line;
+        }
+    }
+
+    out << "Token分布:\n";
+    for (int code = 0; code <= TK_EOF; code++) {
+        if (stats.tokenCounts[code] > 0) {
+            out << "  " << getTokenName((TokenCode)code) << "\t" << stats.tokenCounts[code] << "\n";
+        }
+    }
+}
+
+void printStatsJson(const RunStats& stats, std::ostream& out) {
+    char num[64];
+    std::string json = "{\"file\":";
+    appendJsonString(json, stats.filename);
+    json += ",\"bytes\":" + std::to_string(stats.bytes);
+    json += ",\"tokens\":" + std::to_string(stats.tokens);
+    json += ",\"phases\":{";
+    for (int i = 0; i < PHASE_NUM; i++) {
+        snprintf(num, sizeof(num), "{\"wall_ms\":%.6f,\"cpu_ms\":%.6f}", stats.wall[i] * 1e3, stats.cpu[i] * 1e3);
+        json += std::string(i ? "," : "") + "\"" + kPhaseNames[i] + "\":" + num;
+    }
+    json += "}";
+    snprintf(num, sizeof(num), "%.1f", rate(stats.bytes, stats.wall[PHASE_LEX]));
+    json += std::string(",\"lex_bytes_per_sec\":") + num;
+    snprintf(num, sizeof(num), "%.1f", rate(stats.tokens, stats.wall[PHASE_LEX]));
+    json += std::string(",\"lex_tokens_per_sec\":") + num;
+    snprintf(num, sizeof(num), "%.1f", rate(stats.tokens, stats.wall[PHASE_PARSE]));
+    json += std::string(",\"parse_tokens_per_sec\":") + num;
+    json += ",\"backtracks\":" + std::to_string(stats.backtracks);
+    json += ",\"skipped_tokens\":" + std::to_string(stats.skippedTokens);
+    json += ",\"lex_errors\":" + std::to_string(stats.lexErrors);
+    json += ",\"parse_errors\":" + std::to_string(stats.parseErrors);
+    if (stats.semantic) {
+        json += ",\"ast_nodes\":" + std::to_string(stats.astNodes);
+        json += ",\"sema_errors\":" + std::to_string(stats.semaErrors);
+        json += ",\"sema_warnings\":" + std::to_string(stats.semaWarnings);
+    }
+    if (stats.ir) {
+        json += ",\"ir\":{\"blocks\":" + std::to_string(stats.irBlocks) + ",\"functions\":{";
+        for (size_t i = 0; i < stats.irFunctionInsts.size(); i++) {
+            json += i ? "," : "";
+            appendJsonString(json, stats.irFunctionInsts[i].first);
+            json += ":" + std::to_string(stats.irFunctionInsts[i].second);
+        }
+        json += "}}";
+    }
+    if (stats.optLevel > 0) {
+        json += ",\"opt\":{\"level\":" + std::to_string(stats.optLevel) +
+                ",\"before\":" + std::to_string(stats.optBefore) +
+                ",\"folded\":" + std::to_string(stats.optRemoved[0]) +
+                ",\"copies\":" + std::to_string(stats.optRemoved[1]) +
+                ",\"unreachable\":" + std::to_string(stats.optRemoved[2]) +
+                ",\"dead_stores\":" + std::to_string(stats.optRemoved[3]) +
+                ",\"gvn\":" + std::to_string(stats.optRemoved[4]) +
+                ",\"hoisted\":" + std::to_string(stats.optHoisted) +
+                ",\"inlined\":" + std::to_string(stats.optInlined) +
+                ",\"dead_functions\":" + std::to_string(stats.optDeadFunctions) + "}";
+    }
+    if (stats.ran) {
+        json += ",\"run\":{\"bytecode\":" + std::to_string(stats.bytecodeInsts) +
+                ",\"executed\":" + std::to_string(stats.executedInsts) +
+                ",\"seconds\":" + std::to_string(stats.runSeconds) + ",\"result\":";
+        appendJsonString(json, stats.runResult);
+        json += "}";
+    }
+    if (stats.jitRan) {
+        json += ",\"jit\":{\"bytes\":" + std::to_string(stats.jitBytes) +
+                ",\"compile_seconds\":" + std::to_string(stats.jitCompileSeconds) +
+                ",\"seconds\":" + std::to_string(stats.jitSeconds) + ",\"result\":";
+        appendJsonString(json, stats.jitResult);
+        json += "}";
+    }
+    if (stats.emittedC) {
+        json += ",\"c\":{\"bytes\":" + std::to_string(stats.cBytes) +
+                ",\"seconds\":" + std::to_string(stats.cSeconds) + "}";
+    }
+    json += ",\"peak_rss_kb\":" + std::to_string(stats.peakRssKb);
+    if (stats.allocTracked) {
+        json += ",\"allocs\":{";
+        for (int i = 0; i < PHASE_NUM; i++) {
+            json += std::string(i ? "," : "") + "\"" + kPhaseNames[i] + "\":{\"count\":" +
+                    std::to_string(stats.allocCount[i]) + ",\"bytes\":" + std::to_string(stats.allocBytes[i]) +
+                    ",\"peak_live\":" + std::to_string(stats.allocPeak[i]) + "}";
+        }
+        json += "}";
+        snprintf(num, sizeof(num), "%.3f", stats.tokens ? (double)stats.allocCount[PHASE_LEX] / stats.tokens : 0.0);
+        json += std::string(",\"lex_allocs_per_token\":") + num;
+        snprintf(num, sizeof(num), "%.3f", stats.tokens ? (double)stats.allocCount[PHASE_PARSE] / stats.tokens : 0.0);
+        json += std::string(",\"parse_allocs_per_token\":") + num;
+        if (stats.semantic && stats.astNodes > 0) {
+            snprintf(num, sizeof(num), "%.3f", (double)stats.allocCount[PHASE_SEMA] / stats.astNodes);
+            json += std::string(",\"sema_allocs_per_ast_node\":") + num;
+            snprintf(num, sizeof(num), "%.3f", (double)stats.allocBytes[PHASE_SEMA] / stats.astNodes);
+            json += std::string(",\"sema_bytes_per_ast_node\":") + num;
+        }
+    }
+    json += ",\"token_counts\":{";
+    bool first = true;
+    for (int code = 0; code <= TK_EOF; code++) {
+        if (stats.tokenCounts[code] == 0) continue;
+        json += first ? "" : ",";
+        appendJsonString(json, getTokenName((TokenCode)code));
+        json += ":" + std::to_string(stats.tokenCounts[code]);
+        first = false;
+    }
+    json += "}}";
+    out << json << "\n";
+}
@@ -0,0 +1,96 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include "lexer.h"
+#include "alloc_stats.h"
+#include <string>
+#include <vector>
+#include <utility>
+#include <ostream>
+
+/* 统计的阶段 */
+enum StatsPhase {
+    PHASE_READ = 0,   // 读取文件
+    PHASE_LEX,        // 词法分析（收集Token列表）
+    PHASE_PARSE,      // 语法分析
+    PHASE_SEMA,       // 语义分析（含构造语法树）
+    PHASE_IR,         // 中间代码生成（含 --emit-c 的 C 代码生成）
+    PHASE_OPT,        // 中间代码优化
+    PHASE_RUN,        // 编译为字节码或机器码并执行（--run、--jit）
+    PHASE_OUTPUT,     // 输出结果
+    PHASE_NUM
+};
+
+// 各阶段的名称：--stats 的表格与 JSON 键、--perf 的表格与 --trace 的事件名都使用此表
+static const char* const kPhaseNames[PHASE_NUM] = { "read", "lex", "parse", "sema", "ir", "opt", "run", "output" };
+
+/* 时间点（秒） */
+struct PhaseClock {
+    double wall;      // 挂钟时间
+    double cpu;       // 当前线程的CPU时间
+};
+
+/* 单次运行的统计信息 */
+struct RunStats {
+    std::string filename;
+    size_t bytes = 0;                       // 输入字节数
+    size_t tokens = 0;                      // Token总数（含EOF）
+    double wall[PHASE_NUM] = {};            // 各阶段挂钟时间（秒）
+    double cpu[PHASE_NUM] = {};             // 各阶段CPU时间（秒）
+    long tokenCounts[TK_EOF + 1] = {};      // 各TokenCode出现次数
+    long backtracks = 0;                    // ungetToken 回退次数
+    long skippedTokens = 0;                 // skipUntil 跳过的Token数
+    size_t lexErrors = 0;
+    size_t parseErrors = 0;
+    bool semantic = false;                  // 是否进行了语义分析
+    size_t astNodes = 0;                    // 语法树节点数
+    size_t semaErrors = 0;
+    size_t semaWarnings = 0;
+    bool ir = false;                        // 是否生成了中间代码
+    size_t irBlocks = 0;                    // 基本块总数
+    std::vector<std::pair<std::string, size_t>> irFunctionInsts; // 各函数的IR指令数
+    int optLevel = 0;                       // 中间代码的优化级别（0表示未优化）
+    size_t optBefore = 0;                   // 优化前的IR指令数
+    size_t optRemoved[5] = {};              // 各遍删除的指令数：常量折叠、复制传播、不可达块、死存储、全局值编号
+    size_t optHoisted = 0;                  // 外提的循环不变量
+    size_t optInlined = 0;                  // 内联展开的调用点
+    size_t optDeadFunctions = 0;            // 删除的无用函数
+    bool ran = false;                       // 是否执行了程序
+    size_t bytecodeInsts = 0;               // 字节码指令数
+    uint64_t executedInsts = 0;             // 执行的字节码指令数
+    double runSeconds = 0;                  // 执行耗时（不含编译为字节码）
+    std::string runResult;                  // main 的返回值，或运行时错误
+    bool jitRan = false;                    // 是否以 JIT 执行了程序
+    size_t jitBytes = 0;                    // 机器码字节数
+    double jitCompileSeconds = 0;           // 生成机器码的耗时
+    double jitSeconds = 0;                  // 机器码的执行耗时
+    std::string jitResult;                  // JIT 执行的 main 的返回值，或运行时错误
+    bool emittedC = false;                  // 是否生成了 C 代码
+    size_t cBytes = 0;                      // C 代码字节数
+    double cSeconds = 0;                    // 生成 C 代码的耗时
+    long peakRssKb = 0;                     // 进程峰值常驻内存（KB）
+    bool allocTracked = false;              // 是否启用了分配统计
+    uint64_t allocCount[PHASE_NUM] = {};    // 各阶段分配次数
+    uint64_t allocBytes[PHASE_NUM] = {};    // 各阶段分配字节数
+    int64_t allocPeak[PHASE_NUM] = {};      // 各阶段相对开始时的峰值存活字节数
+};
+
+// 获取当前时间点
+PhaseClock phaseNow();
+
+// 将从start到当前的耗时累加到指定阶段
+void addPhase(RunStats& stats, StatsPhase phase, const PhaseClock& start);
+
+// 将从start到当前的分配计数累加到指定阶段（start须在阶段开始时经allocResetPeak后获取）
+void addPhaseAllocs(RunStats& stats, StatsPhase phase, const AllocSnapshot& start);
+
+// 记录进程峰值常驻内存
+void samplePeakRss(RunStats& stats);
+
+// 以文本格式输出统计信息
+void printStatsText(const RunStats& stats, std::ostream& out);
+
+// 以JSON格式（单行）输出统计信息
+void printStatsJson(const RunStats& stats, std::ostream& out);
+
+#endif /* STATS_H */
@@ -0,0 +1,477 @@
+#include "../lexer.h"
+#include "../parser.h"
+#include "../ast.h"
+#include "../sema.h"
+#include "../ir.h"
+#include "../opt.h"
+#include "../dataflow.h"
+#include "../emitc.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+/*
+ * 病态输入复杂度回归测试
+ * ===========================
+ * 为每个用例生成规模逐级翻倍的对抗性输入，分别测量词法分析（getNextToken() 扫描）、
+ * 语法分析（parse()）、语义分析（语法分析成功时，buildAst() + analyzeSemantics()，没有错误时另加
+ * lowerToIr() + checkDataflow() 的数据流检查）
+ * 与中间代码生成及优化（语义分析没有错误时，lowerToIr() + optimizeModule()，以及 emitC() 生成 C 代码）的耗时，
+ * 以及进程峰值内存，按 log(t2/t1)/log(n2/n1) 估计增长阶，
+ * 超过 --max-exponent（默认1.1，线性为1，平方为2）即判定失败。
+ *
+ * 每个规模在独立的子进程中运行，并限制其栈大小（默认8MB）与运行时间：
+ * 子进程因栈溢出等信号退出或超时同样判定失败。
+ *
+ * 用例：
+ *   minus_run        大量连续的 '-' 后跟数字
+ *   comment_lines    大量单行注释
+ *   endless_comment  一个没有换行的超长注释
+ *   open_paren       大量未匹配的 '('
+ *   open_brace       大量未匹配的 '{'
+ *   close_paren      大量多余的 ')'
+ *   nested_if        无大括号的 if 语句链
+ *   high_bytes       全部由 >= 0x80 的字节组成的二进制内容
+ *   unknown_symbols  大量未知符号（每个都产生词法错误）
+ *   long_ident       一个超长标识符
+ *   many_locals      一个函数中大量局部变量（语义分析的作用域表）
+ *   nested_scopes    大量嵌套块中的同名变量互相遮蔽（作用域压栈/出栈）
+ *   long_chain       一个很长的左结合表达式 a+b+c+...（语法树的深左脊）
+ *   branch_chain     大量条件为常量的 if 与 while（优化的控制流图与活跃变量分析）
+ *   call_chain       每个函数调用前一个的长函数链（调用图与逐层内联）
+ *   scoped_loops     大量块各自声明在 if 与 while 中跨块读写的变量（数据流检查的位向量与工作表）
+ *   many_branch_vars 一个函数中上千个变量在大量 if 分支中读写、到函数末尾都活跃（优化的活跃变量分析）
+ */
+
+static const double kMinSampleSeconds = 0.02;
+
+/* 命令行选项 */
+struct SuiteOptions {
+    size_t baseBytes = 1u << 20;  // 最小规模
+    int steps = 4;                // 规模个数（每级翻倍）
+    int reps = 3;                 // 每个规模的测量次数（取最小值）
+    double maxExponent = 1.1;     // 允许的最大增长阶
+    size_t stackKb = 8192;        // 子进程栈大小上限
+    int timeoutSec = 60;          // 子进程运行时间上限
+    std::string filter;           // 只运行名称包含该子串的用例
+};
+
+/* 单个规模的测量结果（由子进程通过管道传回） */
+struct SampleResult {
+    double lexSec;
+    double parseSec;
+    double semaSec;     // 语法分析失败时为0
+    double optSec;      // 存在语义错误时为0
+    long tokens;
+    long errors;
+};
+
+struct Sample {
+    size_t bytes;
+    bool ok;
+    std::string failure;
+    SampleResult result;
+    long peakRssKb;
+};
+
+struct PathoCase {
+    const char* name;
+    std::function<std::string(size_t)> make;
+    bool frontEndOnly = false;  // 只测量词法与语法分析（基线内存用）
+};
+
+/* INFO 输入生成 */
+
+static std::string repeat(const std::string& unit, size_t targetBytes) {
+    std::string src;
+    src.reserve(targetBytes + unit.size());
+    while (src.size() < targetBytes) {
+        src += unit;
+    }
+    return src;
+}
+
+static std::vector<PathoCase> makeCases() {
+    std::vector<PathoCase> cases;
+    cases.push_back({ "minus_run", [](size_t n) {
+        return "int main() { x = " + std::string(n, '-') + "1; }\n";
+    } });
+    cases.push_back({ "comment_lines", [](size_t n) {
+        return repeat("// comment\n", n) + "int main() { return 0; }\n";
+    } });
+    cases.push_back({ "endless_comment", [](size_t n) {
+        return "int main() { return 0; }\n//" + std::string(n, 'c');
+    } });
+    cases.push_back({ "open_paren", [](size_t n) {
+        return "int main() { x = " + std::string(n, '(');
+    } });
+    cases.push_back({ "open_brace", [](size_t n) {
+        return "int main() " + std::string(n, '{');
+    } });
+    cases.push_back({ "close_paren", [](size_t n) {
+        return "int main() { x = 1" + std::string(n, ')') + "; }\n";
+    } });
+    cases.push_back({ "nested_if", [](size_t n) {
+        return "int main() {\n" + repeat("if (x) ", n) + "x = 1;\n}\n";
+    } });
+    cases.push_back({ "high_bytes", [](size_t n) {
+        std::string src(n, '\0');
+        unsigned state = 12345;
+        for (size_t i = 0; i < n; i++) {
+            state = state * 1103515245u + 12345u;
+            src[i] = (char)(0x80 + (state >> 16) % 0x7F);  // 0x80..0xFE（0xFF等同于EOF）
+        }
+        return src;
+    } });
+    cases.push_back({ "unknown_symbols", [](size_t n) {
+        return "int main() {\n" + repeat("@ ", n) + "\n}\n";
+    } });
+    cases.push_back({ "long_ident", [](size_t n) {
+        return "int main() { " + std::string(n, 'a') + " = 1; }\n";
+    } });
+    cases.push_back({ "many_locals", [](size_t n) {
+        std::string src = "int main() {\n";
+        for (size_t i = 0; src.size() < n; i++) {
+            std::string name = "v" + std::to_string(i);
+            src += "int " + name + " = " + std::to_string(i % 100) + ";\n" + name + " = " + name + "+1;\n";
+        }
+        return src + "return v0;\n}\n";
+    } });
+    cases.push_back({ "nested_scopes", [](size_t n) {
+        // 嵌套深度保持在语法分析的上限以内，整体重复
+        std::string group;
+        for (int depth = 0; depth < 100; depth++) group += "{ int x = 1; int y" + std::to_string(depth) + " = x;\n";
+        group += "x = 2;\n" + std::string(100, '}') + "\n";
+        return "int main() {\n" + repeat(group, n) + "return 0;\n}\n";
+    } });
+    cases.push_back({ "long_chain", [](size_t n) {
+        return "int main() {\nint a = 1;\nreturn a" + repeat("+a", n) + ";\n}\n";
+    } });
+    cases.push_back({ "branch_chain", [](size_t n) {
+        std::string group = "if (a == b) then { s = s + a; } else { b = b + 1; }\n"
+                            "while (s < 10) { s = s + b; a = s; }\n";
+        return "int main() {\nint a = 1;\nint b = 2;\nint s = 0;\n" + repeat(group, n) + "return s;\n}\n";
+    } });
+    cases.push_back({ "call_chain", [](size_t n) {
+        // 每个函数调用前一个：调用图是一条长链，逐层内联
+        std::string src = "int f0(int x) {\nreturn x;\n}\n";
+        size_t count = 1;
+        for (; src.size() < n; count++) {
+            src += "int f" + std::to_string(count) + "(int x) {\nreturn f" + std::to_string(count - 1) + "(x)+1;\n}\n";
+        }
+        return src + "int main() {\nreturn f" + std::to_string(count - 1) + "(1);\n}\n";
+    } });
+    cases.push_back({ "scoped_loops", [](size_t n) {
+        // 大量块，各自声明在 if 与 while 中跨块读写的变量：变量数与基本块数都随规模增长，
+        // 整个函数共用一组位向量时是两者之积（变量名较长，使优化阶段的耗时留在时间上限以内）
+        return "int main() {\nint total = 0;\n" +
+               repeat("{\nint runningValue = total;\nint loopCounter = 1;\n"
+                      "if (runningValue < loopCounter) then {\nrunningValue = runningValue+ loopCounter;\n}"
+                      " else {\nloopCounter = runningValue;\n}\n"
+                      "while (loopCounter < 3) {\nloopCounter = loopCounter+ runningValue;\n}\n"
+                      "total = runningValue+ loopCounter;\n}\n", n) +
+               "return total;\n}\n";
+    } });
+    cases.push_back({ "many_branch_vars", [](size_t n) {
+        // 变量数固定为1000、分支数随规模增长：每块出口都有上千个活跃的值，
+        // 逐值记录（块, 值）对或每轮死存储删除都重新分析时，耗时是分支数的上千倍
+        const size_t vars = 1000;
+        std::string src = "int main() {\n";
+        for (size_t i = 0; i < vars; i++) src += "int v" + std::to_string(i) + " = " + std::to_string(i % 7) + ";\n";
+        std::string ret = "return v0";
+        for (size_t i = 1; i < vars; i++) ret += "+ v" + std::to_string(i);
+        for (size_t i = 0; src.size() + ret.size() < n; i++) {
+            std::string x = "v" + std::to_string(i % vars), y = "v" + std::to_string((i * 7 + 1) % vars);
+            src += "if (" + x + " < " + y + ") then { " + x + " = " + y + "+ 1; } else { " + y + " = " + x + "+ 2; }\n";
+        }
+        return src + ret + ";\n}\n";
+    } });
+    return cases;
+}
+
+/* INFO 测量 */
+
+static double nowSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 单次耗时：过短时重复执行至少 kMinSampleSeconds 再取平均，减小计时误差
+static double timePass(const std::function<void()>& pass) {
+    int iterations = 0;
+    double start = nowSeconds();
+    double elapsed = 0;
+    do {
+        pass();
+        iterations++;
+        elapsed = nowSeconds() - start;
+    } while (elapsed < kMinSampleSeconds);
+    return elapsed / iterations;
+}
+
+// 在子进程中运行：生成输入并分别测量两个阶段，结果写入管道
+static void runChild(const PathoCase& c, size_t bytes, const SuiteOptions& options, int fd) {
+    struct rlimit limit;
+    limit.rlim_cur = limit.rlim_max = options.stackKb * 1024;
+    setrlimit(RLIMIT_STACK, &limit);
+    alarm(options.timeoutSec);
+
+    std::string src = c.make(bytes);
+    SampleResult result = { 1e30, 1e30, 0, 0, 0, 0 };
+    setParserErrorEcho(false);
+
+    long lexErrors = 0;
+    auto lexPass = [&]() {
+        initLexerBuffer(src.data(), src.size());
+        long tokens = 0;
+        TokenAttr token;
+        do {
+            token = getNextToken();
+            tokens++;
+        } while (token.code != TK_EOF);
+        lexErrors = (long)getErrors().size();
+        closeLexer();
+        result.tokens = tokens;
+    };
+    auto parsePass = [&]() {
+        initParserBuffer(src.data(), src.size());
+        parse();
+        result.errors = lexErrors + (long)getParserErrors().size();
+        closeParser();
+    };
+
+    // 语义分析只在语法分析成功时进行，Token列表预先收集，不计入耗时
+    std::vector<TokenAttr> tokenList;
+    initParserBuffer(src.data(), src.size());
+    bool parsed = parse() == RESULT_SUCCESS && getErrors().empty() && !c.frontEndOnly;
+    closeParser();
+    if (parsed) {
+        initLexerBuffer(src.data(), src.size());
+        do {
+            tokenList.push_back(getNextToken());
+        } while (tokenList.back().code != TK_EOF);
+        closeLexer();
+    }
+    auto semaPass = [&]() {
+        AstProgram program;
+        SemaResult sema;
+        buildAst(tokenList, program);
+        if (analyzeSemantics(program, sema)) {
+            IrModule module;
+            DataflowStats dataflow;
+            lowerToIr(program, sema, module);
+            checkDataflow(module, sema, dataflow);
+        }
+    };
+
+    // 中间代码生成、优化与 C 代码生成在同一棵已分析的语法树上重复进行
+    AstProgram analyzed;
+    SemaResult analysis;
+    bool lowered = parsed && buildAst(tokenList, analyzed) && analyzeSemantics(analyzed, analysis);
+    auto optPass = [&]() {
+        IrModule module;
+        OptStats stats;
+        lowerToIr(analyzed, analysis, module);
+        optimizeModule(module, stats);
+        std::ostringstream c;
+        emitC(analyzed, analysis, "pathological.txt", c);
+    };
+
+    for (int rep = 0; rep < options.reps; rep++) {
+        result.lexSec = std::min(result.lexSec, timePass(lexPass));
+        result.parseSec = std::min(result.parseSec, timePass(parsePass));
+        if (parsed) {
+            result.semaSec = rep == 0 ? timePass(semaPass) : std::min(result.semaSec, timePass(semaPass));
+        }
+        if (lowered) {
+            result.optSec = rep == 0 ? timePass(optPass) : std::min(result.optSec, timePass(optPass));
+        }
+    }
+
+    ssize_t written = write(fd, &result, sizeof(result));
+    _exit(written == (ssize_t)sizeof(result) ? 0 : 2);
+}
+
+static Sample runSample(const PathoCase& c, size_t bytes, const SuiteOptions& options) {
+    Sample sample;
+    sample.bytes = bytes;
+    sample.ok = false;
+    sample.peakRssKb = 0;
+    memset(&sample.result, 0, sizeof(sample.result));
+
+    int fds[2];
+    if (pipe(fds) != 0) {
+        sample.failure = "pipe失败";
+        return sample;
+    }
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        runChild(c, bytes, options, fds[1]);
+    }
+    close(fds[1]);
+    if (pid < 0) {
+        close(fds[0]);
+        sample.failure = "fork失败";
+        return sample;
+    }
+
+    ssize_t got = read(fds[0], &sample.result, sizeof(sample.result));
+    close(fds[0]);
+    int status = 0;
+    struct rusage usage;
+    wait4(pid, &status, 0, &usage);
+    sample.peakRssKb = usage.ru_maxrss;
+
+    if (WIFSIGNALED(status)) {
+        int sig = WTERMSIG(status);
+        if (sig == SIGALRM) {
+            sample.failure = "超时（>" + std::to_string(options.timeoutSec) + "s）";
+        } else if (sig == SIGSEGV || sig == SIGBUS) {
+            sample.failure = std::string("崩溃: ") + strsignal(sig) + "（可能栈溢出）";
+        } else {
+            sample.failure = std::string("崩溃: ") + strsignal(sig);
+        }
+    } else if (got != (ssize_t)sizeof(sample.result) || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        sample.failure = "子进程异常退出";
+    } else {
+        sample.ok = true;
+    }
+    return sample;
+}
+
+// 估计增长阶：以最小与最大规模的比值计算
+static double growthExponent(double small, double large, double ratio) {
+    small = std::max(small, 1e-6);
+    large = std::max(large, 1e-6);
+    return std::log(large / small) / std::log(ratio);
+}
+
+static std::string formatSize(size_t bytes) {
+    char buf[32];
+    if (bytes >= (1u << 20)) {
+        snprintf(buf, sizeof(buf), "%gMB", bytes / 1048576.0);
+    } else {
+        snprintf(buf, sizeof(buf), "%gKB", bytes / 1024.0);
+    }
+    return buf;
+}
+
+/* INFO 命令行 */
+
+static void showUsage(const char* programName) {
+    std::cout << "用法: " << programName << " [选项]\n\n";
+    std::cout << "选项:\n";
+    std::cout << "  --quick               最小规模 128KB（默认 1MB）\n";
+    std::cout << "  --base-kb <n>         最小规模（KB）\n";
+    std::cout << "  --steps <n>           规模个数，每级翻倍（默认 4）\n";
+    std::cout << "  --reps <n>            每个规模测量次数，取最小值（默认 3）\n";
+    std::cout << "  --max-exponent <x>    允许的最大增长阶（默认 1.1）\n";
+    std::cout << "  --stack-kb <n>        子进程栈大小上限（默认 8192）\n";
+    std::cout << "  --timeout <秒>        每个规模的运行时间上限（默认 60）\n";
+    std::cout << "  --filter <子串>       只运行名称包含该子串的用例\n";
+}
+
+int main(int argc, char* argv[]) {
+    SuiteOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (arg == "-h" || arg == "--help") {
+            showUsage(argv[0]);
+            return 0;
+        } else if (arg == "--quick") {
+            options.baseBytes = 128u << 10;
+        } else if (value != nullptr && arg == "--base-kb") {
+            options.baseBytes = (size_t)std::max(1, atoi(value)) << 10; i++;
+        } else if (value != nullptr && arg == "--steps") {
+            options.steps = std::max(2, atoi(value)); i++;
+        } else if (value != nullptr && arg == "--reps") {
+            options.reps = std::max(1, atoi(value)); i++;
+        } else if (value != nullptr && arg == "--max-exponent") {
+            options.maxExponent = atof(value); i++;
+        } else if (value != nullptr && arg == "--stack-kb") {
+            options.stackKb = (size_t)std::max(64, atoi(value)); i++;
+        } else if (value != nullptr && arg == "--timeout") {
+            options.timeoutSec = std::max(1, atoi(value)); i++;
+        } else if (value != nullptr && arg == "--filter") {
+            options.filter = value; i++;
+        } else {
+            std::cerr << "错误: 未知选项 " << arg << "\n";
+            showUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    // 基线内存：空输入且只做词法与语法分析时子进程的峰值内存，用于扣除与输入无关的部分。
+    // 不运行后续阶段：否则基线含有 C 后端等的固定开销，高于语法分析就失败的用例，差值被截断后增长阶失真
+    PathoCase empty = { "empty", [](size_t) { return std::string(); }, true };
+    long baseRssKb = runSample(empty, 0, options).peakRssKb;
+
+    int failures = 0;
+    for (const PathoCase& c : makeCases()) {
+        if (!options.filter.empty() && std::string(c.name).find(options.filter) == std::string::npos) {
+            continue;
+        }
+
+        std::vector<Sample> samples;
+        size_t bytes = options.baseBytes;
+        for (int step = 0; step < options.steps; step++, bytes *= 2) {
+            samples.push_back(runSample(c, bytes, options));
+            if (!samples.back().ok) break;
+        }
+
+        printf("%-16s", c.name);
+        for (const Sample& s : samples) {
+            if (s.ok) {
+                printf("  %s: lex %.1fms parse %.1fms", formatSize(s.bytes).c_str(),
+                       s.result.lexSec * 1e3, s.result.parseSec * 1e3);
+                if (s.result.semaSec > 0) printf(" sema %.1fms", s.result.semaSec * 1e3);
+                if (s.result.optSec > 0) printf(" opt %.1fms", s.result.optSec * 1e3);
+                printf(" %ldMB", s.peakRssKb / 1024);
+            }
+        }
+        printf("\n");
+
+        const Sample& last = samples.back();
+        if (!last.ok) {
+            printf("  FAIL %s: %s\n", formatSize(last.bytes).c_str(), last.failure.c_str());
+            failures++;
+            continue;
+        }
+
+        const Sample& first = samples.front();
+        double ratio = (double)last.bytes / first.bytes;
+        double lexExp = growthExponent(first.result.lexSec, last.result.lexSec, ratio);
+        double parseExp = growthExponent(first.result.parseSec, last.result.parseSec, ratio);
+        double memExp = growthExponent(std::max(1L, first.peakRssKb - baseRssKb) * 1e-6,
+                                       std::max(1L, last.peakRssKb - baseRssKb) * 1e-6, ratio);
+        double semaExp = growthExponent(first.result.semaSec, last.result.semaSec, ratio);
+        double optExp = growthExponent(first.result.optSec, last.result.optSec, ratio);
+        bool pass = lexExp <= options.maxExponent && parseExp <= options.maxExponent &&
+                    semaExp <= options.maxExponent && optExp <= options.maxExponent && memExp <= options.maxExponent;
+        printf("  %s 增长阶: lex %.2f  parse %.2f  sema %.2f  opt %.2f  内存 %.2f  (tokens %ld, errors %ld)\n",
+               pass ? "PASS" : "FAIL", lexExp, parseExp, semaExp, optExp, memExp, last.result.tokens,
+               last.result.errors);
+        if (!pass) failures++;
+    }
+
+    if (failures > 0) {
+        printf("\n%d 个用例失败\n", failures);
+        return 1;
+    }
+    printf("\n全部通过\n");
+    return 0;
+}
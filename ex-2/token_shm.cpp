@@ -0,0 +1,225 @@
+#include "token_shm.h"
+#include <unordered_map>
+#include <chrono>
+#include <thread>
+#include <climits>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <time.h>
+
+static const char kMagic[8] = { 'M', 'I', 'N', 'I', 'T', 'O', 'K', '\0' };
+
+// 共享内存对象名须以'/'开头
+static std::string shmName(const std::string& name) {
+    return (!name.empty() && name[0] == '/') ? name : "/" + name;
+}
+
+static uint64_t alignUp(uint64_t value) {
+    return (value + 7) & ~(uint64_t)7;
+}
+
+/* INFO 字符串表 */
+
+// 相同的字符串只存一份
+struct StringTable {
+    std::string bytes;
+    std::unordered_map<std::string_view, uint32_t> offsets;
+
+    uint32_t add(std::string_view text) {
+        auto found = offsets.find(text);
+        if (found != offsets.end()) {
+            return found->second;
+        }
+        uint32_t offset = (uint32_t)bytes.size();
+        bytes.append(text.data(), text.size());
+        offsets.emplace(text, offset);
+        return offset;
+    }
+};
+
+/* 接口实现 */
+
+bool tokenShmPublish(const std::string& name, const std::string& sourceName, size_t sourceBytes,
+                     const std::vector<TokenAttr>& tokens, const std::vector<ErrorInfo>& lexErrors,
+                     const std::vector<ParserError>* parseErrors, bool parseSuccess, std::string& error) {
+    // 先在本地编码Token与诊断，得到各区域的大小
+    StringTable strings;
+    std::vector<ShmToken> packed(tokens.size());
+    for (size_t i = 0; i < tokens.size(); i++) {
+        const TokenAttr& token = tokens[i];
+        packed[i] = { (uint32_t)token.code, token.line, (uint32_t)token.type, token.table_row,
+                      strings.add(token.value), (uint32_t)token.value.size() };
+    }
+    std::vector<ShmDiagnostic> diagnostics;
+    for (const auto& lexError : lexErrors) {
+        diagnostics.push_back({ 0, lexError.line, strings.add(lexError.message), (uint32_t)lexError.message.size() });
+    }
+    if (parseErrors != nullptr) {
+        for (const auto& parseError : *parseErrors) {
+            diagnostics.push_back({ 1, parseError.line, strings.add(parseError.message),
+                                    (uint32_t)parseError.message.size() });
+        }
+    }
+    uint32_t sourceNameOffset = strings.add(sourceName);
+    if (strings.bytes.size() > UINT32_MAX) {
+        error = "字符串表超过4GB";
+        return false;
+    }
+
+    TokenShmHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.major = kTokenShmMajor;
+    header.minor = kTokenShmMinor;
+    header.state = TOKEN_SHM_WRITING;
+    header.headerSize = sizeof(TokenShmHeader);
+    header.tokenCount = packed.size();
+    header.tokenOffset = alignUp(sizeof(TokenShmHeader));
+    header.diagCount = diagnostics.size();
+    header.diagOffset = alignUp(header.tokenOffset + packed.size() * sizeof(ShmToken));
+    header.stringBytes = strings.bytes.size();
+    header.stringOffset = alignUp(header.diagOffset + diagnostics.size() * sizeof(ShmDiagnostic));
+    header.totalSize = alignUp(header.stringOffset + strings.bytes.size());
+    header.sourceBytes = sourceBytes;
+    header.sourceNameOffset = sourceNameOffset;
+    header.sourceNameLength = (uint32_t)sourceName.size();
+    header.result = parseErrors == nullptr ? TOKEN_SHM_LEX_ONLY
+                                           : (parseSuccess ? TOKEN_SHM_PARSE_SUCCESS : TOKEN_SHM_PARSE_ERROR);
+    header.lexErrorCount = (uint32_t)lexErrors.size();
+    header.parseErrorCount = parseErrors == nullptr ? 0 : (uint32_t)parseErrors->size();
+
+    // 新建段：旧段先删除，已映射旧段的消费者继续使用旧内容
+    std::string path = shmName(name);
+    shm_unlink(path.c_str());
+    int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        error = std::string("shm_open: ") + strerror(errno);
+        return false;
+    }
+    if (ftruncate(fd, (off_t)header.totalSize) != 0) {
+        error = std::string("ftruncate: ") + strerror(errno);
+        close(fd);
+        shm_unlink(path.c_str());
+        return false;
+    }
+    void* base = mmap(nullptr, header.totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        error = std::string("mmap: ") + strerror(errno);
+        shm_unlink(path.c_str());
+        return false;
+    }
+
+    // 段刚建立时全为0，state即为TOKEN_SHM_WRITING；先写内容，最后发布state
+    char* bytes = (char*)base;
+    memcpy(bytes, &header, sizeof(header));
+    if (!packed.empty()) memcpy(bytes + header.tokenOffset, packed.data(), packed.size() * sizeof(ShmToken));
+    if (!diagnostics.empty()) {
+        memcpy(bytes + header.diagOffset, diagnostics.data(), diagnostics.size() * sizeof(ShmDiagnostic));
+    }
+    memcpy(bytes + header.stringOffset, strings.bytes.data(), strings.bytes.size());
+
+    TokenShmHeader* shared = (TokenShmHeader*)base;
+    __atomic_store_n(&shared->state, (uint32_t)TOKEN_SHM_READY, __ATOMIC_RELEASE);
+    syscall(SYS_futex, &shared->state, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    munmap(base, header.totalSize);
+    return true;
+}
+
+bool tokenShmUnlink(const std::string& name) {
+    return shm_unlink(shmName(name).c_str()) == 0;
+}
+
+bool tokenShmOpen(const std::string& name, int waitMs, TokenShmView& view, std::string& error) {
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(std::max(0, waitMs));
+    std::string path = shmName(name);
+    view = TokenShmView();
+
+    // 等待段出现并设置好大小
+    int fd;
+    struct stat info;
+    while (true) {
+        fd = shm_open(path.c_str(), O_RDONLY, 0);
+        if (fd >= 0) {
+            if (fstat(fd, &info) == 0 && (size_t)info.st_size >= sizeof(TokenShmHeader)) {
+                break;
+            }
+            close(fd);
+        } else if (errno != ENOENT) {
+            error = std::string("shm_open: ") + strerror(errno);
+            return false;
+        }
+        if (Clock::now() >= deadline) {
+            error = "共享内存段 " + path + " 不存在";
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    size_t size = (size_t)info.st_size;
+    void* base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        error = std::string("mmap: ") + strerror(errno);
+        return false;
+    }
+    const TokenShmHeader* header = (const TokenShmHeader*)base;
+
+    // 等待就绪
+    while (__atomic_load_n(&header->state, __ATOMIC_ACQUIRE) != TOKEN_SHM_READY) {
+        Clock::duration left = deadline - Clock::now();
+        if (left <= Clock::duration::zero()) {
+            munmap(base, size);
+            error = "共享内存段 " + path + " 未就绪（发布者可能已退出）";
+            return false;
+        }
+        long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(left).count();
+        struct timespec timeout = { (time_t)(ns / 1000000000), (long)(ns % 1000000000) };
+        if (syscall(SYS_futex, &header->state, FUTEX_WAIT, TOKEN_SHM_WRITING, &timeout, nullptr, 0) != 0 &&
+            errno != EAGAIN && errno != EINTR && errno != ETIMEDOUT) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));  // 不支持时退回轮询
+        }
+    }
+
+    // 校验头部与各区域的边界
+    const char* fail = nullptr;
+    if (memcmp(header->magic, kMagic, sizeof(kMagic)) != 0) {
+        fail = "不是Token流共享内存段";
+    } else if (header->major != kTokenShmMajor) {
+        fail = "不支持的主版本";
+    } else if (header->headerSize < sizeof(TokenShmHeader) || header->totalSize > size ||
+               header->tokenOffset > size || header->tokenCount > (size - header->tokenOffset) / sizeof(ShmToken) ||
+               header->diagOffset > size ||
+               header->diagCount > (size - header->diagOffset) / sizeof(ShmDiagnostic) ||
+               header->stringOffset > size || header->stringBytes > size - header->stringOffset) {
+        fail = "段头部损坏";
+    }
+    if (fail != nullptr) {
+        error = fail;
+        if (header->major != kTokenShmMajor) error += " " + std::to_string(header->major);
+        munmap(base, size);
+        return false;
+    }
+
+    const char* bytes = (const char*)base;
+    view.header = header;
+    view.tokens = (const ShmToken*)(bytes + header->tokenOffset);
+    view.diagnostics = (const ShmDiagnostic*)(bytes + header->diagOffset);
+    view.strings = bytes + header->stringOffset;
+    view.mappedSize = size;
+    return true;
+}
+
+void tokenShmClose(TokenShmView& view) {
+    if (view.header != nullptr) {
+        munmap((void*)view.header, view.mappedSize);
+    }
+    view = TokenShmView();
+}
@@ -0,0 +1,118 @@
+#ifndef TOKEN_SHM_H
+#define TOKEN_SHM_H
+
+#include "lexer.h"
+#include "parser.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+/*
+ * 共享内存Token流（--export-shm）
+ * ===========================
+ * 把一个文件的Token流、词素字符串表与诊断信息发布到一个POSIX共享内存段，
+ * 下游进程以只读方式映射后直接使用，不需要解析 tokens.txt，也没有序列化或复制。
+ *
+ * 段布局（本机字节序，各区域按8字节对齐）：
+ *   TokenShmHeader | ShmToken[tokenCount] | ShmDiagnostic[diagCount] | 字符串表
+ * 词素、诊断消息与源文件名都以（偏移, 长度）引用字符串表，相同的词素只存一份。
+ *
+ * 就绪协议：
+ *   1. 发布者先删除同名旧段（已映射旧段的消费者不受影响），以 O_EXCL 新建并设置大小，
+ *      此时 state 为 TOKEN_SHM_WRITING（0）
+ *   2. 写入全部内容后以 release 语义把 state 置为 TOKEN_SHM_READY，并用 futex 唤醒等待者
+ *   3. 消费者映射后检查魔数与主版本，以 acquire 语义读取 state，未就绪时在 futex 上等待
+ * 段在发布者退出后仍然存在，直到某一方调用 tokenShmUnlink。
+ */
+
+static const uint32_t kTokenShmMajor = 1;   // 布局不兼容时递增
+static const uint32_t kTokenShmMinor = 0;   // 只在头部末尾追加字段时递增
+
+// 段状态
+enum TokenShmState {
+    TOKEN_SHM_WRITING = 0,
+    TOKEN_SHM_READY = 1
+};
+
+// 分析结果
+enum TokenShmResult {
+    TOKEN_SHM_PARSE_SUCCESS = 0,
+    TOKEN_SHM_PARSE_ERROR = 1,
+    TOKEN_SHM_LEX_ONLY = 2       // 仅进行了词法分析
+};
+
+// 段头部
+struct TokenShmHeader {
+    char magic[8];               // "MINITOK\0"
+    uint32_t major;
+    uint32_t minor;
+    uint32_t state;              // TokenShmState，以原子操作访问（futex字）
+    uint32_t headerSize;         // sizeof(TokenShmHeader)，供新版本追加字段
+    uint64_t totalSize;          // 整个段的字节数
+    uint64_t tokenCount;         // Token数（含EOF）
+    uint64_t tokenOffset;
+    uint64_t diagCount;          // 诊断数（先词法错误，后语法错误）
+    uint64_t diagOffset;
+    uint64_t stringBytes;
+    uint64_t stringOffset;
+    uint64_t sourceBytes;        // 源文件大小
+    uint32_t sourceNameOffset;   // 源文件名在字符串表中的位置
+    uint32_t sourceNameLength;
+    uint32_t result;             // TokenShmResult
+    uint32_t lexErrorCount;
+    uint32_t parseErrorCount;
+    uint32_t reserved;
+};
+
+// 一个Token
+struct ShmToken {
+    uint32_t code;               // TokenCode
+    int32_t line;
+    uint32_t type;               // TableTypeId
+    int32_t tableRow;
+    uint32_t valueOffset;        // 词素在字符串表中的位置
+    uint32_t valueLength;
+};
+
+// 一条诊断
+struct ShmDiagnostic {
+    uint32_t kind;               // 0 词法错误，1 语法错误
+    int32_t line;
+    uint32_t messageOffset;
+    uint32_t messageLength;
+};
+
+/* INFO 发布接口 */
+
+// 发布一个文件的分析结果；parseErrors为nullptr表示仅进行了词法分析
+bool tokenShmPublish(const std::string& name, const std::string& sourceName, size_t sourceBytes,
+                     const std::vector<TokenAttr>& tokens, const std::vector<ErrorInfo>& lexErrors,
+                     const std::vector<ParserError>* parseErrors, bool parseSuccess, std::string& error);
+
+// 删除共享内存段
+bool tokenShmUnlink(const std::string& name);
+
+/* INFO 消费接口 */
+
+// 只读映射的段
+struct TokenShmView {
+    const TokenShmHeader* header = nullptr;
+    const ShmToken* tokens = nullptr;
+    const ShmDiagnostic* diagnostics = nullptr;
+    const char* strings = nullptr;
+    size_t mappedSize = 0;
+};
+
+// 打开并只读映射共享内存段，最多等待waitMs毫秒直到段存在且就绪
+bool tokenShmOpen(const std::string& name, int waitMs, TokenShmView& view, std::string& error);
+
+// 解除映射
+void tokenShmClose(TokenShmView& view);
+
+// 字符串表中的一个字符串
+inline std::string_view tokenShmString(const TokenShmView& view, uint32_t offset, uint32_t length) {
+    return std::string_view(view.strings + offset, length);
+}
+
+#endif /* TOKEN_SHM_H */
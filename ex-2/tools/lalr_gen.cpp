@@ -0,0 +1,742 @@
+#include "../lexer.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+/*
+ * LALR(1) 分析表生成器
+ * ===========================
+ * 读取 parser.cpp 顶部注释中的 Mini 文法（EBNF：'...' 终结符、<...> 非终结符、
+ * | 选择、( ) 分组、? 可选、+ 重复），展开为 BNF 后构造 LALR(1) 自动机：
+ * 在 LR(0) 核心相同的状态上合并向前看符号，合并使向前看集合增大时重新传播，直到不动点。
+ *
+ * 输出 constexpr 头文件（lalr_tables.h）：
+ *   - 每个状态出现次数最多的归约作为默认归约，不再占用动作表的单元
+ *   - 每个非终结符出现次数最多的目标状态作为默认转移
+ *   - 剩余的动作/转移按行位移（row displacement）压缩：每行找一个偏移使其非空单元
+ *     落在未被占用的位置，用 check 数组区分各行
+ * 移进/归约冲突按移进解决（if-else 悬挂），归约/归约冲突按规则顺序解决，均在标准错误上报告。
+ */
+
+/* 生成器选项 */
+struct GenOptions {
+    std::string grammarFile = "parser.cpp";  // 含文法注释的源文件
+    std::string output;                      // 输出头文件，空表示标准输出
+    int expectConflicts = -1;                // 预期的冲突数，-1表示不检查
+};
+
+static const int kTerminals = TK_EOF + 1;   // 终结符即Token编码
+
+/* 文法 */
+struct Rule {
+    int lhs;                  // 非终结符编号
+    std::vector<int> rhs;     // 符号：小于kTerminals为终结符，否则为kTerminals + 非终结符编号
+};
+
+static std::vector<std::string> g_nonterminals;   // 非终结符名称
+static std::map<std::string, int> g_ntIndex;
+static std::vector<Rule> g_rules;
+static std::vector<std::vector<int>> g_rulesOf;   // 每个非终结符的规则
+static std::vector<int> g_referenced;             // 被引用但未定义时用于报错
+static GenOptions g_opt;
+
+/* INFO 文法读取 */
+
+// 引号中的终结符
+static int literalCode(const std::string& text) {
+    static const std::map<std::string, TokenCode> codes = {
+        { "int", KW_INT }, { "double", KW_DOUBLE }, { "float", KW_FLOAT }, { "if", KW_IF },
+        { "then", KW_THEN }, { "else", KW_ELSE }, { "return", KW_RETURN }, { "while", KW_WHILE },
+        { "+", TK_PLUS }, { "-", TK_MINUS }, { "*", TK_STAR }, { "/", TK_DIVIDE }, { "=", TK_ASSIGN },
+        { "&", TK_BITAND }, { "&&", TK_AND }, { "==", TK_EQ }, { "<", TK_LT }, { "<=", TK_LEQ },
+        { ">", TK_GT }, { ">=", TK_GEQ }, { "|", TK_BITOR }, { "||", TK_OR }, { "(", TK_OPENPA },
+        { ")", TK_CLOSEPA }, { "[", TK_OPENBR }, { "]", TK_CLOSEBR }, { "{", TK_BEGIN }, { "}", TK_END },
+        { ",", TK_COMMA }, { ";", TK_SEMOCOLOM }
+    };
+    auto found = codes.find(text);
+    if (found == codes.end()) {
+        std::cerr << "错误: 未知的终结符 '" << text << "'\n";
+        exit(1);
+    }
+    return found->second;
+}
+
+static int nonterminal(const std::string& name) {
+    auto found = g_ntIndex.find(name);
+    if (found != g_ntIndex.end()) {
+        return kTerminals + found->second;
+    }
+    int index = (int)g_nonterminals.size();
+    g_nonterminals.push_back(name);
+    g_ntIndex[name] = index;
+    g_rulesOf.emplace_back();
+    return kTerminals + index;
+}
+
+static void addRule(int lhs, const std::vector<int>& rhs) {
+    g_rulesOf[lhs - kTerminals].push_back((int)g_rules.size());
+    g_rules.push_back({ lhs - kTerminals, rhs });
+}
+
+// 右部的词法单元
+struct GrammarToken {
+    char kind;                // 'N' 非终结符，'T' 终结符，其余为 ( ) | ? + *
+    std::string text;
+};
+
+static std::vector<GrammarToken> tokenizeRhs(const std::string& text) {
+    std::vector<GrammarToken> tokens;
+    for (size_t i = 0; i < text.size();) {
+        char c = text[i];
+        if (c == ' ' || c == '\t') {
+            i++;
+        } else if (c == '<') {
+            size_t end = text.find('>', i);
+            tokens.push_back({ 'N', text.substr(i + 1, end - i - 1) });
+            i = end + 1;
+        } else if (c == '\'') {
+            size_t end = text.find('\'', i + 1);
+            tokens.push_back({ 'T', text.substr(i + 1, end - i - 1) });
+            i = end + 1;
+        } else {
+            tokens.push_back({ c, "" });
+            i++;
+        }
+    }
+    return tokens;
+}
+
+// EBNF右部的递归下降分析，分组与重复展开为辅助非终结符
+struct RhsParser {
+    const std::vector<GrammarToken>& tokens;
+    size_t pos;
+    std::string owner;        // 所属规则，用于命名辅助非终结符
+    int& auxCount;
+
+    char peek() const { return pos < tokens.size() ? tokens[pos].kind : '\0'; }
+
+    std::vector<std::vector<int>> alternatives() {
+        std::vector<std::vector<int>> alts;
+        alts.push_back(sequence());
+        while (peek() == '|') {
+            pos++;
+            alts.push_back(sequence());
+        }
+        return alts;
+    }
+
+    std::vector<int> sequence() {
+        std::vector<int> symbols;
+        while (peek() != '\0' && peek() != '|' && peek() != ')') {
+            int symbol = primary();
+            char op = peek();
+            if (op == '?' || op == '+' || op == '*') {
+                pos++;
+                int aux = nonterminal(owner + "$" + std::to_string(++auxCount));
+                if (op == '?') {
+                    addRule(aux, {});
+                    addRule(aux, { symbol });
+                } else if (op == '+') {
+                    addRule(aux, { symbol });
+                    addRule(aux, { aux, symbol });
+                } else {
+                    addRule(aux, {});
+                    addRule(aux, { aux, symbol });
+                }
+                symbol = aux;
+            }
+            symbols.push_back(symbol);
+        }
+        return symbols;
+    }
+
+    int primary() {
+        const GrammarToken& token = tokens[pos++];
+        if (token.kind == 'T') {
+            return literalCode(token.text);
+        }
+        if (token.kind == 'N') {
+            if (token.text == "identifier") {
+                return TK_IDENT;
+            }
+            int symbol = nonterminal(token.text);
+            g_referenced.push_back(symbol);
+            return symbol;
+        }
+        if (token.kind == '(') {
+            int aux = nonterminal(owner + "$" + std::to_string(++auxCount));
+            for (const auto& alt : alternatives()) {
+                addRule(aux, alt);
+            }
+            if (peek() != ')') {
+                std::cerr << "错误: <" << owner << "> 中的括号不匹配\n";
+                exit(1);
+            }
+            pos++;
+            return aux;
+        }
+        std::cerr << "错误: <" << owner << "> 中有意外的符号 '" << token.kind << "'\n";
+        exit(1);
+    }
+};
+
+// 去掉注释行前缀与行尾的 // 注释（引号内的除外）
+static std::string cleanLine(const std::string& line) {
+    size_t start = line.find_first_not_of(" \t*");
+    if (start == std::string::npos) return "";
+    std::string text;
+    bool quoted = false;
+    for (size_t i = start; i < line.size(); i++) {
+        if (line[i] == '\'') quoted = !quoted;
+        if (!quoted && line.compare(i, 2, "//") == 0) break;
+        text += line[i];
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) text.pop_back();
+    return text;
+}
+
+static void readGrammar(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "错误: 无法打开 " << path << "\n";
+        exit(1);
+    }
+
+    // 增广文法：规则0为 $accept ::= <program>，<constant> 为内置的常量类别
+    int accept = nonterminal("$accept");
+    int start = -1;
+    int constant = nonterminal("constant");
+    addRule(constant, { TK_INT });
+    addRule(constant, { TK_DOUBLE });
+
+    std::string line;
+    bool inGrammar = false;
+    std::string lhsName;          // 当前规则（续行以 | 开头）
+    int auxCount = 0;
+    std::vector<std::pair<std::string, std::string>> pieces;   // (左部, 右部文本)
+    while (std::getline(file, line)) {
+        if (!inGrammar) {
+            inGrammar = line.find("BNF文法定义") != std::string::npos;
+            continue;
+        }
+        if (line.find("*/") != std::string::npos) break;
+        std::string text = cleanLine(line);
+        size_t define = text.find("::=");
+        if (!text.empty() && text[0] == '<' && define != std::string::npos) {
+            lhsName = text.substr(1, text.find('>') - 1);
+            pieces.push_back({ lhsName, text.substr(define + 3) });
+        } else if (!text.empty() && text[0] == '|' && !lhsName.empty()) {
+            pieces.push_back({ lhsName, text.substr(1) });
+        } else {
+            lhsName.clear();      // 标题或说明文字
+        }
+    }
+    if (pieces.empty()) {
+        std::cerr << "错误: " << path << " 中没有找到文法注释\n";
+        exit(1);
+    }
+
+    for (const auto& piece : pieces) {
+        int lhs = nonterminal(piece.first);
+        if (start < 0) start = lhs;
+        std::vector<GrammarToken> tokens = tokenizeRhs(piece.second);
+        RhsParser parser = { tokens, 0, piece.first, auxCount };
+        for (const auto& alt : parser.alternatives()) {
+            addRule(lhs, alt);
+        }
+        if (parser.pos != tokens.size()) {
+            std::cerr << "错误: <" << piece.first << "> 的右部无法解析: " << piece.second << "\n";
+            exit(1);
+        }
+    }
+
+    // 规则0必须是增广规则：把它移到最前面
+    addRule(accept, { start });
+    std::rotate(g_rules.rbegin(), g_rules.rbegin() + 1, g_rules.rend());
+    for (auto& rules : g_rulesOf) rules.clear();
+    for (int r = 0; r < (int)g_rules.size(); r++) {
+        g_rulesOf[g_rules[r].lhs].push_back(r);
+    }
+
+    for (int symbol : g_referenced) {
+        if (g_rulesOf[symbol - kTerminals].empty()) {
+            std::cerr << "错误: 非终结符 <" << g_nonterminals[symbol - kTerminals] << "> 没有定义\n";
+            exit(1);
+        }
+    }
+}
+
+/* INFO FIRST 集合 */
+
+typedef uint64_t TermSet;   // 终结符集合（终结符不超过64个）
+static_assert(kTerminals <= 64, "终结符集合用64位表示");
+
+static std::vector<bool> g_nullable;
+static std::vector<TermSet> g_first;
+
+static void computeFirst() {
+    size_t count = g_nonterminals.size();
+    g_nullable.assign(count, false);
+    g_first.assign(count, 0);
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const Rule& rule : g_rules) {
+            TermSet first = 0;
+            bool nullable = true;
+            for (int symbol : rule.rhs) {
+                if (symbol < kTerminals) {
+                    first |= (TermSet)1 << symbol;
+                    nullable = false;
+                    break;
+                }
+                first |= g_first[symbol - kTerminals];
+                if (!g_nullable[symbol - kTerminals]) {
+                    nullable = false;
+                    break;
+                }
+            }
+            if ((g_first[rule.lhs] | first) != g_first[rule.lhs]) {
+                g_first[rule.lhs] |= first;
+                changed = true;
+            }
+            if (nullable && !g_nullable[rule.lhs]) {
+                g_nullable[rule.lhs] = true;
+                changed = true;
+            }
+        }
+    }
+}
+
+// 符号串 rhs[from..] 的FIRST集合；全部可空时并上follow
+static TermSet firstOf(const std::vector<int>& rhs, size_t from, TermSet follow) {
+    TermSet first = 0;
+    for (size_t i = from; i < rhs.size(); i++) {
+        int symbol = rhs[i];
+        if (symbol < kTerminals) {
+            return first | ((TermSet)1 << symbol);
+        }
+        first |= g_first[symbol - kTerminals];
+        if (!g_nullable[symbol - kTerminals]) {
+            return first;
+        }
+    }
+    return first | follow;
+}
+
+/* INFO LALR(1) 自动机 */
+
+// 项目：规则与点的位置
+typedef std::pair<int, int> Item;
+
+struct State {
+    std::vector<Item> kernel;              // 按顺序排列的核心项目
+    std::vector<TermSet> lookaheads;       // 与kernel一一对应
+    std::map<int, int> transitions;        // 符号 -> 目标状态
+};
+
+static std::vector<State> g_states;
+
+// 带向前看集合的闭包
+static void closure(const State& state, std::vector<Item>& items, std::vector<TermSet>& lookaheads) {
+    items = state.kernel;
+    lookaheads = state.lookaheads;
+    std::map<Item, size_t> position;
+    for (size_t i = 0; i < items.size(); i++) {
+        position[items[i]] = i;
+    }
+    std::deque<size_t> work;
+    for (size_t i = 0; i < items.size(); i++) work.push_back(i);
+    while (!work.empty()) {
+        size_t i = work.front();
+        work.pop_front();
+        const Rule& rule = g_rules[items[i].first];
+        size_t dot = (size_t)items[i].second;
+        if (dot >= rule.rhs.size() || rule.rhs[dot] < kTerminals) continue;
+        TermSet follow = firstOf(rule.rhs, dot + 1, lookaheads[i]);
+        for (int r : g_rulesOf[rule.rhs[dot] - kTerminals]) {
+            Item item(r, 0);
+            auto found = position.find(item);
+            if (found == position.end()) {
+                position[item] = items.size();
+                items.push_back(item);
+                lookaheads.push_back(follow);
+                work.push_back(items.size() - 1);
+            } else if ((lookaheads[found->second] | follow) != lookaheads[found->second]) {
+                lookaheads[found->second] |= follow;
+                work.push_back(found->second);
+            }
+        }
+    }
+}
+
+static void buildAutomaton() {
+    std::map<std::vector<Item>, int> byCore;
+    State initial;
+    initial.kernel.push_back(Item(0, 0));
+    initial.lookaheads.push_back((TermSet)1 << TK_EOF);
+    g_states.push_back(initial);
+    byCore[initial.kernel] = 0;
+
+    std::deque<int> work = { 0 };
+    std::vector<bool> queued(1, true);
+    while (!work.empty()) {
+        int current = work.front();
+        work.pop_front();
+        queued[current] = false;
+
+        std::vector<Item> items;
+        std::vector<TermSet> lookaheads;
+        closure(g_states[current], items, lookaheads);
+
+        // 按点后的符号分组，得到各后继状态的核心
+        std::map<int, std::map<Item, TermSet>> successors;
+        for (size_t i = 0; i < items.size(); i++) {
+            const Rule& rule = g_rules[items[i].first];
+            if ((size_t)items[i].second < rule.rhs.size()) {
+                successors[rule.rhs[items[i].second]][Item(items[i].first, items[i].second + 1)] |= lookaheads[i];
+            }
+        }
+
+        for (const auto& successor : successors) {
+            std::vector<Item> kernel;
+            for (const auto& item : successor.second) kernel.push_back(item.first);
+            auto found = byCore.find(kernel);
+            int target;
+            bool grew = false;
+            if (found == byCore.end()) {
+                // 新状态
+                target = (int)g_states.size();
+                State state;
+                state.kernel = kernel;
+                for (const auto& item : successor.second) state.lookaheads.push_back(item.second);
+                g_states.push_back(state);
+                byCore[kernel] = target;
+                queued.push_back(false);
+                grew = true;
+            } else {
+                // 核心相同：合并向前看集合
+                target = found->second;
+                size_t k = 0;
+                for (const auto& item : successor.second) {
+                    TermSet& merged = g_states[target].lookaheads[k++];
+                    if ((merged | item.second) != merged) {
+                        merged |= item.second;
+                        grew = true;
+                    }
+                }
+            }
+            g_states[current].transitions[successor.first] = target;
+            if (grew && !queued[target]) {
+                queued[target] = true;
+                work.push_back(target);
+            }
+        }
+    }
+}
+
+/* INFO 分析表 */
+
+// 动作编码：正数为移进到该状态，负数为按规则 -value 归约，0 为接受
+static const int kNoAction = 1 << 30;
+
+static std::vector<std::vector<int>> g_action;   // [状态][终结符]
+static std::vector<int> g_defaultReduce;         // 0 表示没有默认归约
+static std::vector<std::vector<int>> g_goto;     // [非终结符][状态]，-1表示无
+static std::vector<int> g_defaultGoto;
+static int g_srConflicts = 0;
+static int g_rrConflicts = 0;
+
+static std::string symbolName(int symbol) {
+    if (symbol < kTerminals) return getTokenName((TokenCode)symbol);
+    return "<" + g_nonterminals[symbol - kTerminals] + ">";
+}
+
+static std::string ruleText(int r) {
+    std::string text = "<" + g_nonterminals[g_rules[r].lhs] + "> ::=";
+    if (g_rules[r].rhs.empty()) text += " ε";
+    for (int symbol : g_rules[r].rhs) text += " " + symbolName(symbol);
+    return text;
+}
+
+static void buildTables() {
+    size_t stateCount = g_states.size();
+    g_action.assign(stateCount, std::vector<int>(kTerminals, kNoAction));
+    g_goto.assign(g_nonterminals.size(), std::vector<int>(stateCount, -1));
+
+    for (size_t s = 0; s < stateCount; s++) {
+        for (const auto& transition : g_states[s].transitions) {
+            if (transition.first < kTerminals) {
+                g_action[s][transition.first] = transition.second;
+            } else {
+                g_goto[transition.first - kTerminals][s] = transition.second;
+            }
+        }
+
+        std::vector<Item> items;
+        std::vector<TermSet> lookaheads;
+        closure(g_states[s], items, lookaheads);
+        for (size_t i = 0; i < items.size(); i++) {
+            int r = items[i].first;
+            if ((size_t)items[i].second != g_rules[r].rhs.size()) continue;
+            for (int t = 0; t < kTerminals; t++) {
+                if (!(lookaheads[i] & ((TermSet)1 << t))) continue;
+                int value = (r == 0) ? 0 : -r;
+                int& cell = g_action[s][t];
+                if (cell == kNoAction) {
+                    cell = value;
+                } else if (cell > 0) {
+                    g_srConflicts++;      // 移进优先
+                    std::cerr << "移进/归约冲突: 状态 " << s << " 遇到 " << symbolName(t) << "，移进（而非按 "
+                              << ruleText(r) << " 归约）\n";
+                } else {
+                    g_rrConflicts++;
+                    int kept = std::min(-cell, r);
+                    std::cerr << "归约/归约冲突: 状态 " << s << " 遇到 " << symbolName(t) << "，按 "
+                              << ruleText(kept) << " 归约\n";
+                    cell = -kept;
+                }
+            }
+        }
+    }
+
+    // 默认归约：每个状态出现次数最多的归约
+    g_defaultReduce.assign(stateCount, 0);
+    for (size_t s = 0; s < stateCount; s++) {
+        std::map<int, int> counts;
+        for (int t = 0; t < kTerminals; t++) {
+            if (g_action[s][t] < 0) counts[-g_action[s][t]]++;
+        }
+        int best = 0, bestCount = 0;
+        for (const auto& count : counts) {
+            if (count.second > bestCount) {
+                best = count.first;
+                bestCount = count.second;
+            }
+        }
+        g_defaultReduce[s] = best;
+        for (int t = 0; t < kTerminals && best != 0; t++) {
+            if (g_action[s][t] == -best) g_action[s][t] = kNoAction;
+        }
+    }
+
+    // 默认转移：每个非终结符出现次数最多的目标
+    g_defaultGoto.assign(g_nonterminals.size(), 0);
+    for (size_t n = 0; n < g_nonterminals.size(); n++) {
+        std::map<int, int> counts;
+        for (size_t s = 0; s < stateCount; s++) {
+            if (g_goto[n][s] >= 0) counts[g_goto[n][s]]++;
+        }
+        int best = 0, bestCount = 0;
+        for (const auto& count : counts) {
+            if (count.second > bestCount) {
+                best = count.first;
+                bestCount = count.second;
+            }
+        }
+        g_defaultGoto[n] = best;
+        for (size_t s = 0; s < stateCount; s++) {
+            if (g_goto[n][s] == best) g_goto[n][s] = -1;
+        }
+    }
+}
+
+/* 行位移压缩结果 */
+struct PackedTable {
+    std::vector<int> base;        // 每行的偏移
+    std::vector<int> check;       // 单元所属的行，-1为空
+    std::vector<int> value;
+};
+
+// 行位移压缩：按非空单元数从多到少放置各行，每行取第一个不冲突的偏移
+// 表尾补足一整行的宽度，查表时不需要检查越界
+static PackedTable packRows(const std::vector<std::vector<int>>& rows, int empty, size_t width) {
+    PackedTable table;
+    table.base.assign(rows.size(), 0);
+    std::vector<size_t> order(rows.size());
+    std::vector<std::vector<int>> columns(rows.size());
+    for (size_t r = 0; r < rows.size(); r++) {
+        order[r] = r;
+        for (size_t c = 0; c < width; c++) {
+            if (rows[r][c] != empty) columns[r].push_back((int)c);
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return columns[a].size() > columns[b].size();
+    });
+
+    for (size_t r : order) {
+        if (columns[r].empty()) continue;
+        for (int base = -columns[r].front();; base++) {
+            bool fits = true;
+            for (int c : columns[r]) {
+                size_t slot = (size_t)(base + c);
+                if (slot < table.check.size() && table.check[slot] != -1) {
+                    fits = false;
+                    break;
+                }
+            }
+            if (!fits) continue;
+            for (int c : columns[r]) {
+                size_t slot = (size_t)(base + c);
+                if (slot >= table.check.size()) {
+                    table.check.resize(slot + 1, -1);
+                    table.value.resize(slot + 1, 0);
+                }
+                table.check[slot] = (int)r;
+                table.value[slot] = rows[r][c];
+            }
+            table.base[r] = base;
+            break;
+        }
+    }
+    // 负偏移的行查表时下标可能小于0：整体右移，使最小下标为0
+    int minBase = 0;
+    for (int base : table.base) minBase = std::min(minBase, base);
+    if (minBase < 0) {
+        table.check.insert(table.check.begin(), (size_t)-minBase, -1);
+        table.value.insert(table.value.begin(), (size_t)-minBase, 0);
+        for (int& base : table.base) base -= minBase;
+    }
+    int maxBase = 0;
+    for (int base : table.base) maxBase = std::max(maxBase, base);
+    table.check.resize(std::max(table.check.size(), (size_t)maxBase + width), -1);
+    table.value.resize(table.check.size(), 0);
+    return table;
+}
+
+/* INFO 输出 */
+
+static void writeArray(std::ostream& out, const char* type, const char* name, const std::vector<int>& values,
+                       const char* comment) {
+    out << "// " << comment << "\n";
+    out << "static constexpr " << type << " " << name << "[" << values.size() << "] = {";
+    for (size_t i = 0; i < values.size(); i++) {
+        out << (i % 16 == 0 ? "\n    " : " ") << values[i] << (i + 1 < values.size() ? "," : "");
+    }
+    out << "\n};\n\n";
+}
+
+static void writeHeader(std::ostream& out, const PackedTable& action, const PackedTable& gotos) {
+    size_t stateCount = g_states.size();
+    size_t actionEntries = 0, gotoEntries = 0;
+    for (int check : action.check) actionEntries += check >= 0;
+    for (int check : gotos.check) gotoEntries += check >= 0;
+
+    out << "#ifndef LALR_TABLES_H\n#define LALR_TABLES_H\n\n";
+    out << "#include <cstdint>\n\n";
+    out << "/*\n";
+    out << " * Mini 文法的 LALR(1) 分析表\n";
+    out << " * ===========================\n";
+    out << " * 由 tools/lalr_gen 根据 " << g_opt.grammarFile << " 中的文法注释生成，请勿手工修改\n";
+    out << " * （修改文法后运行 ./run_tests.sh lalr 重新生成）。\n";
+    out << " *\n";
+    out << " * " << stateCount << " 个状态，" << g_rules.size() << " 条规则，" << g_srConflicts
+        << " 个移进/归约冲突（按移进解决），" << g_rrConflicts << " 个归约/归约冲突\n";
+    out << " * 动作表：未压缩 " << stateCount * kTerminals << " 个单元，去掉默认归约后剩 " << actionEntries
+        << " 项，压缩为 " << action.check.size() << " 个单元\n";
+    out << " * 转移表：未压缩 " << stateCount * g_nonterminals.size() << " 个单元，去掉默认转移后剩 "
+        << gotoEntries << " 项，压缩为 " << gotos.check.size() << " 个单元\n";
+    out << " *\n";
+    out << " * 查表：动作 i = kLalrActionBase[s] + t，kLalrActionCheck[i] == s 时为 kLalrActionValue[i]\n";
+    out << " *      （正数移进到该状态，负数按规则 -v 归约，0 接受），否则按 kLalrDefaultReduce[s] 归约（0为出错）；\n";
+    out << " *      转移 i = kLalrGotoBase[A] + s，kLalrGotoCheck[i] == A 时为 kLalrGotoValue[i]，否则为 kLalrDefaultGoto[A]\n";
+    out << " *\n";
+    out << " * 规则：\n";
+    for (size_t r = 0; r < g_rules.size(); r++) {
+        out << " *   " << r << ": " << ruleText((int)r) << "\n";
+    }
+    out << " */\n\n";
+
+    out << "static constexpr int kLalrStateCount = " << stateCount << ";\n";
+    out << "static constexpr int kLalrTerminalCount = " << kTerminals << ";\n";
+    out << "static constexpr int kLalrNonterminalCount = " << g_nonterminals.size() << ";\n";
+    out << "static constexpr int kLalrRuleCount = " << g_rules.size() << ";\n\n";
+
+    std::vector<int> lhs, length;
+    for (const Rule& rule : g_rules) {
+        lhs.push_back(rule.lhs);
+        length.push_back((int)rule.rhs.size());
+    }
+    writeArray(out, "int16_t", "kLalrRuleLhs", lhs, "规则左部的非终结符编号");
+    writeArray(out, "uint8_t", "kLalrRuleLength", length, "规则右部的长度");
+    writeArray(out, "int32_t", "kLalrActionBase", action.base, "各状态在动作表中的偏移");
+    writeArray(out, "int16_t", "kLalrActionCheck", action.check, "动作单元所属的状态");
+    writeArray(out, "int16_t", "kLalrActionValue", action.value, "动作");
+    writeArray(out, "int16_t", "kLalrDefaultReduce", g_defaultReduce, "各状态的默认归约规则");
+    writeArray(out, "int32_t", "kLalrGotoBase", gotos.base, "各非终结符在转移表中的偏移");
+    writeArray(out, "int16_t", "kLalrGotoCheck", gotos.check, "转移单元所属的非终结符");
+    writeArray(out, "int16_t", "kLalrGotoValue", gotos.value, "转移目标状态");
+    writeArray(out, "int16_t", "kLalrDefaultGoto", g_defaultGoto, "各非终结符的默认转移目标");
+
+    out << "// 非终结符名称\n";
+    out << "static constexpr const char* kLalrNonterminalNames[" << g_nonterminals.size() << "] = {";
+    for (size_t n = 0; n < g_nonterminals.size(); n++) {
+        out << (n % 4 == 0 ? "\n    " : " ") << "\"" << g_nonterminals[n] << "\""
+            << (n + 1 < g_nonterminals.size() ? "," : "");
+    }
+    out << "\n};\n\n";
+    out << "#endif /* LALR_TABLES_H */\n";
+}
+
+static void showUsage(const char* programName) {
+    std::cout << "用法: " << programName << " [--grammar parser.cpp] [--expect 冲突数] [-o lalr_tables.h]\n";
+}
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            showUsage(argv[0]);
+            return 0;
+        } else if (arg == "--grammar" && i + 1 < argc) {
+            g_opt.grammarFile = argv[++i];
+        } else if (arg == "--expect" && i + 1 < argc) {
+            g_opt.expectConflicts = atoi(argv[++i]);
+        } else if (arg == "-o" && i + 1 < argc) {
+            g_opt.output = argv[++i];
+        } else {
+            showUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    readGrammar(g_opt.grammarFile);
+    computeFirst();
+    buildAutomaton();
+    buildTables();
+    if (g_states.size() > 32767) {
+        std::cerr << "错误: 状态数超过int16_t的范围\n";
+        return 1;
+    }
+
+    std::vector<std::vector<int>> gotoRows = g_goto;
+    PackedTable action = packRows(g_action, kNoAction, kTerminals);
+    PackedTable gotos = packRows(gotoRows, -1, g_states.size());
+
+    std::cerr << g_states.size() << " 个状态，" << g_rules.size() << " 条规则，" << g_srConflicts
+              << " 个移进/归约冲突，" << g_rrConflicts << " 个归约/归约冲突\n";
+    if (g_opt.expectConflicts >= 0 && g_srConflicts + g_rrConflicts != g_opt.expectConflicts) {
+        std::cerr << "错误: 预期 " << g_opt.expectConflicts << " 个冲突\n";
+        return 1;
+    }
+
+    if (g_opt.output.empty()) {
+        writeHeader(std::cout, action, gotos);
+    } else {
+        std::ofstream out(g_opt.output);
+        if (!out.is_open()) {
+            std::cerr << "错误: 无法写入 " << g_opt.output << "\n";
+            return 1;
+        }
+        writeHeader(out, action, gotos);
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include "../archive.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <sys/stat.h>
+
+/*
+ * 结果归档查询工具
+ * ===========================
+ * 读取 --archive 生成的归档：列出其中的输入文件，输出某个输入的某个结果文件，
+ * 或把某个输入的全部结果还原为与普通模式相同的 -output 目录。
+ * 按路径在排序的索引中二分查找；同一路径被分析多次时取最后写入的一次。
+ */
+
+static void showUsage(const char* programName) {
+    std::cout << "用法: " << programName << " <命令> <归档> [参数]\n\n";
+    std::cout << "命令:\n";
+    std::cout << "  list <归档>                      列出归档中的输入文件及各结果文件大小\n";
+    std::cout << "  cat <归档> <输入> [结果文件]      输出一个结果文件（默认 tokens.txt）\n";
+    std::cout << "  extract <归档> <输入> [目录]      还原全部结果文件（默认目录 <输入>-output）\n\n";
+    std::cout << "示例: " << programName << " cat results.arc tests/test2.txt parse_errors.txt\n";
+}
+
+// 查找输入文件的记录，不存在时返回nullptr
+static const ArchiveRecord* findRecord(const std::vector<ArchiveRecord>& records, const std::string& input) {
+    auto last = std::upper_bound(records.begin(), records.end(), input,
+                                 [](const std::string& path, const ArchiveRecord& record) {
+                                     return path < record.path;
+                                 });
+    if (last == records.begin() || (last - 1)->path != input) {
+        return nullptr;
+    }
+    return &*(last - 1);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        showUsage(argv[0]);
+        return 1;
+    }
+    std::string command = argv[1];
+    std::string archive = argv[2];
+
+    std::vector<ArchiveRecord> records;
+    bool indexed = false;
+    std::string error;
+    if (!readArchiveIndex(archive, records, indexed, error)) {
+        std::cerr << "错误: " << archive << ": " << error << "\n";
+        return 1;
+    }
+    if (!indexed) {
+        std::cerr << "警告: " << archive << " 没有有效索引（写入未正常结束），已扫描恢复 "
+                  << records.size() << " 条记录\n";
+    }
+
+    if (command == "list") {
+        for (const auto& record : records) {
+            std::cout << record.path;
+            for (const auto& entry : record.entries) {
+                std::cout << "\t" << entry.name << " " << entry.size;
+            }
+            std::cout << "\n";
+        }
+        return 0;
+    }
+
+    if ((command != "cat" && command != "extract") || argc < 4) {
+        showUsage(argv[0]);
+        return 1;
+    }
+    std::string input = argv[3];
+    const ArchiveRecord* record = findRecord(records, input);
+    if (record == nullptr) {
+        std::cerr << "错误: 归档中没有 " << input << "\n";
+        return 1;
+    }
+
+    if (command == "cat") {
+        std::string name = argc > 4 ? argv[4] : "tokens.txt";
+        for (const auto& entry : record->entries) {
+            if (entry.name != name) continue;
+            std::string data;
+            if (!readArchiveEntry(archive, entry, data)) {
+                std::cerr << "错误: 无法读取 " << input << "/" << name << "\n";
+                return 1;
+            }
+            std::cout << data;
+            return 0;
+        }
+        std::cerr << "错误: " << input << " 没有结果文件 " << name << "\n";
+        return 1;
+    }
+
+    // extract
+    std::string dirName = argc > 4 ? argv[4] : input + "-output";
+    struct stat info;
+    if (stat(dirName.c_str(), &info) != 0) {
+        if (mkdir(dirName.c_str(), 0777) == -1) {
+            std::cerr << "错误: 无法创建目录 " << dirName << std::endl;
+            return 1;
+        }
+    } else if (!(info.st_mode & S_IFDIR)) {
+        std::cerr << "错误: " << dirName << " 已存在但不是目录" << std::endl;
+        return 1;
+    }
+    for (const auto& entry : record->entries) {
+        std::string data;
+        std::ofstream file(dirName + "/" + entry.name, std::ios::binary);
+        if (!readArchiveEntry(archive, entry, data) || !(file << data)) {
+            std::cerr << "错误: 无法还原 " << dirName << "/" << entry.name << "\n";
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,506 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+
+/*
+ * Mini语言合成程序生成器
+ * ===========================
+ * 按 parser.cpp 顶部的分层文法逐层生成程序：每个生成函数对应一个非终结符。
+ * 在错误注入率为0时，生成的程序同时满足词法器的约束（常量后紧跟运算符或分隔符、
+ * 减号与数字之间留空格）以及语义分析的约束（变量先声明后使用、只调用已定义的函数
+ * 且实参个数正确、`&`/`|` 只作用于 int）：每个表达式按所需的类型生成，初值、实参、
+ * 赋值与返回值都不高于目标类型，也不产生隐式转换的警告。可直接用于基准、扩展性与
+ * 后续各阶段的测试。
+ *
+ * 输出以流式写出，大小从KB到GB均不需要把程序保存在内存中；
+ * 相同的种子与参数总是生成完全相同的字节序列。
+ */
+
+/* 生成参数 */
+struct GenOptions {
+    uint64_t seed = 1;
+    uint64_t targetBytes = 0;     // 目标大小（0表示按函数个数生成）
+    int functions = 10;           // 函数个数（未指定大小时）
+    int depth = 3;                // 语句最大嵌套深度
+    int stmts = 6;                // 每个语句块的平均语句数
+    int exprLen = 4;              // 表达式的平均操作数个数
+    int vocab = 64;               // 标识符词汇表大小
+    double commentDensity = 0.1;  // 每条语句前插入注释的概率
+    double nonAscii = 0.0;        // 注释与缩进中出现非ASCII字符的概率
+    double lexErrors = 0.0;       // 每条语句注入词法错误的概率
+    double syntaxErrors = 0.0;    // 每条语句注入语法错误的概率
+    std::string output;           // 输出文件，空表示标准输出
+};
+
+/* 可复现的伪随机数（splitmix64），不依赖标准库分布的实现细节 */
+struct Rng {
+    uint64_t state;
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+    // [0, n)
+    int below(int n) { return n <= 1 ? 0 : (int)(next() % (uint64_t)n); }
+    // [lo, hi]
+    int range(int lo, int hi) { return lo + below(hi - lo + 1); }
+    bool chance(double p) { return p > 0 && (next() >> 11) * (1.0 / 9007199254740992.0) < p; }
+};
+
+/* 已定义的函数（供调用），类型为 kTypes 的下标 */
+struct FuncSig {
+    std::string name;
+    int returnType;
+    std::vector<int> params;  // 各形参的类型
+};
+
+/* 作用域中的变量 */
+struct VarInfo {
+    std::string name;
+    int type;
+};
+
+/* INFO 生成器状态 */
+static GenOptions g_opt;
+static Rng g_rng;
+static FILE* g_out = nullptr;
+static std::string g_buf;             // 写缓冲区
+static uint64_t g_written = 0;        // 已写出的字节数
+static char g_lastChar = '\n';        // 最后写出的字符（缓冲区可能刚被刷出）
+static bool g_afterNumber = false;    // 上一个Token是否为常量（其后不能有空白）
+static std::vector<std::string> g_vocab;
+static std::vector<FuncSig> g_functions;
+static std::vector<std::vector<VarInfo>> g_scopes;  // 当前函数内的作用域栈
+
+// 按隐式转换的等级排列（同 MiniType）：低等级的值转换为高等级不丢失精度
+static const char* kTypes[] = { "int", "float", "double" };
+static const int kIntType = 0;
+static const int kAnyType = 2;  // double：任何值都可以转换为它
+static const char* kNonAscii[] = { "中", "文", "注", "释", "é", "ß", "Ω", "→", "𝄞" };
+static const char* kCommentWords[] = { "compute", "loop", "check", "value", "TODO", "update", "result" };
+
+/* INFO 输出 */
+static void flushOut(bool force) {
+    if (force || g_buf.size() >= (1u << 20)) {
+        fwrite(g_buf.data(), 1, g_buf.size(), g_out);
+        g_buf.clear();
+    }
+}
+
+// 写出原样文本
+static void raw(const std::string& text) {
+    if (text.empty()) return;
+    g_buf += text;
+    g_written += text.size();
+    g_lastChar = text.back();
+    flushOut(false);
+}
+
+// 写出一个Token：常量之后紧贴，其余情况用空格分隔
+static void tok(const std::string& text) {
+    if (!g_afterNumber && g_lastChar != ' ' && g_lastChar != '\n' && g_lastChar != '(') {
+        raw(" ");
+    }
+    raw(text);
+    g_afterNumber = false;
+}
+
+static void number(const std::string& text) {
+    tok(text);
+    g_afterNumber = true;
+}
+
+static void newline(int indent) {
+    raw("\n");
+    g_afterNumber = false;
+    raw(std::string(indent * 4, ' '));
+    if (g_rng.chance(g_opt.nonAscii)) {
+        raw(kNonAscii[g_rng.below(9)]);  // 词法器会跳过非ASCII字符
+        raw(" ");
+    }
+}
+
+/* INFO 词汇与作用域 */
+
+// 第i个标识符：字母开头，后跟字母数字，且不与关键字冲突
+static std::string makeIdent(int i) {
+    static const char* stems[] = { "val", "tmp", "cnt", "sum", "acc", "idx", "num", "res", "lim", "buf" };
+    std::string name = stems[i % 10];
+    int n = i / 10;
+    if (n > 0) name += std::to_string(n);
+    return name;
+}
+
+static bool inScope(const std::string& name) {
+    for (const auto& scope : g_scopes) {
+        for (const auto& v : scope) {
+            if (v.name == name) return true;
+        }
+    }
+    return false;
+}
+
+// 随机选择一个类型不高于 maxType 的可见变量，没有时返回空指针
+static const VarInfo* pickVar(int maxType) {
+    int total = 0;
+    for (const auto& scope : g_scopes) {
+        for (const auto& v : scope) total += v.type <= maxType;
+    }
+    if (total == 0) return nullptr;
+    int k = g_rng.below(total);
+    for (const auto& scope : g_scopes) {
+        for (const auto& v : scope) {
+            if (v.type <= maxType && k-- == 0) return &v;
+        }
+    }
+    return nullptr;
+}
+
+// 随机选择一个返回类型不高于 maxType 的已定义函数，没有时返回空指针
+static const FuncSig* pickFunction(int maxType) {
+    int total = 0;
+    for (const auto& fn : g_functions) total += fn.returnType <= maxType;
+    if (total == 0) return nullptr;
+    int k = g_rng.below(total);
+    for (const auto& fn : g_functions) {
+        if (fn.returnType <= maxType && k-- == 0) return &fn;
+    }
+    return nullptr;
+}
+
+// 选择一个当前不可见的新名字，词汇表用尽时返回空串
+static std::string freshVar() {
+    for (int attempt = 0; attempt < 8; attempt++) {
+        const std::string& name = g_vocab[g_rng.below((int)g_vocab.size())];
+        if (!inScope(name)) return name;
+    }
+    for (const auto& name : g_vocab) {
+        if (!inScope(name)) return name;
+    }
+    return "";
+}
+
+/* INFO 按文法生成 */
+
+// 以下各函数生成的表达式类型都不高于 maxType
+static void expression(int depth, int maxType);
+static void logicalOrExpression(int depth, int maxType);
+
+// <constant>：带小数点的常量为 double
+static void constant(int maxType) {
+    int kind = g_rng.below(10);
+    if (kind < 6 || (kind < 8 && maxType != kAnyType)) {
+        number(std::to_string(g_rng.range(0, 1000)));
+    } else if (kind < 8) {
+        number(std::to_string(g_rng.range(0, 99)) + "." + std::to_string(g_rng.range(0, 99)));
+    } else {
+        number("-" + std::to_string(g_rng.range(1, 500)));  // 负数常量
+    }
+}
+
+// <function-call> ::= <identifier> '(' <argument-list>? ')'
+static void functionCall(const FuncSig& fn, int depth) {
+    tok(fn.name);
+    raw("(");
+    g_afterNumber = false;
+    for (size_t i = 0; i < fn.params.size(); i++) {
+        if (i > 0) tok(",");
+        logicalOrExpression(depth + 1, fn.params[i]);
+    }
+    tok(")");
+}
+
+// <primary-expression>
+static void primaryExpression(int depth, int maxType) {
+    int choice = g_rng.below(10);
+    const VarInfo* var = pickVar(maxType);
+    const FuncSig* fn = choice < 3 && depth < 3 ? pickFunction(maxType) : nullptr;
+    if (choice < 2 && depth < 3) {
+        tok("(");
+        expression(depth + 1, maxType);
+        tok(")");
+    } else if (choice < 3 && fn != nullptr) {
+        functionCall(*fn, depth);
+    } else if (choice < 7 && var != nullptr) {
+        tok(var->name);
+    } else {
+        constant(maxType);
+    }
+}
+
+// 由 <logical-or-expression> 到 <multiplicative-expression> 的各层运算符
+static const char* kBinaryOps[] = { "||", "&&", "==", "<", ">", "<=", ">=", "+", "-", "|", "&", "*", "/" };
+
+// <logical-or-expression>：按平均长度生成一串二元运算。
+// 操作数都不高于 maxType；`|` 与 `&` 只作用于 int，期望其他类型时改为同一层的 `+` 与 `-`
+static void logicalOrExpression(int depth, int maxType) {
+    int operands = 1 + g_rng.below(std::max(1, g_opt.exprLen * 2 - 1));
+    if (depth > 0) operands = std::max(1, operands / (depth + 1));
+    for (int i = 0; i < operands; i++) {
+        if (i > 0) {
+            // 算术运算更常见
+            int op = g_rng.chance(0.6) ? 7 + g_rng.below(6) : g_rng.below(7);
+            if (maxType != kIntType && (op == 9 || op == 10)) op -= 2;
+            tok(kBinaryOps[op]);
+        }
+        primaryExpression(depth, maxType);
+    }
+}
+
+// <expression> ::= <assignment-expression>，赋值的右侧不高于变量的类型
+static void expression(int depth, int maxType) {
+    const VarInfo* var = pickVar(maxType);
+    if (depth == 0 && var != nullptr && g_rng.chance(0.5)) {
+        tok(var->name);
+        tok("=");
+        maxType = var->type;
+    }
+    logicalOrExpression(depth, maxType);
+}
+
+// 注入一个词法错误
+static void lexError() {
+    switch (g_rng.below(4)) {
+        case 0: tok("@"); break;                                   // 未知符号
+        case 1: tok("$"); break;                                   // 未知符号
+        case 2: number(std::to_string(g_rng.range(1, 99)) + "abc"); break;  // 非法数字后缀
+        default: number("1.2.3"); break;                           // 多个小数点
+    }
+}
+
+static void compoundStatement(int indent, int depth);
+static void statement(int indent, int depth);
+
+// <variable-declaration> ::= <type-specifier> <identifier> ('=' <expression>)? ';'
+static void variableDeclaration() {
+    std::string name = freshVar();
+    if (name.empty()) {
+        expression(0, kAnyType);
+        tok(";");
+        return;
+    }
+    int type = g_rng.below(3);
+    tok(kTypes[type]);
+    tok(name);
+    if (g_rng.chance(0.8)) {
+        tok("=");
+        logicalOrExpression(0, type);
+    }
+    tok(";");
+    g_scopes.back().push_back({ name, type });
+}
+
+// <statement>
+static void statement(int indent, int depth) {
+    newline(indent);
+    if (g_rng.chance(g_opt.commentDensity)) {
+        raw("// ");
+        int words = g_rng.range(1, 6);
+        for (int i = 0; i < words; i++) {
+            raw(g_rng.chance(g_opt.nonAscii) ? kNonAscii[g_rng.below(9)] : kCommentWords[g_rng.below(7)]);
+            raw(" ");
+        }
+        newline(indent);
+    }
+
+    bool syntaxError = g_rng.chance(g_opt.syntaxErrors);
+    if (g_rng.chance(g_opt.lexErrors)) {
+        lexError();
+    }
+
+    int choice = g_rng.below(10);
+    if (depth < g_opt.depth && choice == 0) {
+        // <selection-statement>
+        tok("if");
+        tok("(");
+        logicalOrExpression(0, kAnyType);
+        if (!syntaxError) tok(")");
+        if (g_rng.chance(0.3)) tok("then");
+        compoundStatement(indent, depth + 1);
+        if (g_rng.chance(0.5)) {
+            tok("else");
+            compoundStatement(indent, depth + 1);
+        }
+    } else if (depth < g_opt.depth && choice == 1) {
+        // <iteration-statement>
+        tok("while");
+        tok("(");
+        logicalOrExpression(0, kAnyType);
+        tok(")");
+        compoundStatement(indent, depth + 1);
+    } else if (depth < g_opt.depth && choice == 2) {
+        compoundStatement(indent, depth + 1);
+    } else if (choice < 6) {
+        variableDeclaration();
+        if (syntaxError) tok(")");
+    } else {
+        // <expression-statement>
+        expression(0, kAnyType);
+        if (syntaxError) {
+            tok(g_rng.chance(0.5) ? "+" : "");  // 悬空运算符或缺少分号
+        } else {
+            tok(";");
+        }
+    }
+}
+
+// <compound-statement> ::= '{' <statement-list>? '}'
+static void compoundStatement(int indent, int depth) {
+    tok("{");
+    g_scopes.push_back(std::vector<VarInfo>());
+    int count = g_rng.range(1, std::max(1, g_opt.stmts * 2 - 1));
+    if (depth > 0) count = std::max(1, count / (depth + 1));
+    for (int i = 0; i < count; i++) {
+        statement(indent + 1, depth);
+    }
+    g_scopes.pop_back();
+    newline(indent);
+    tok("}");
+}
+
+// <function-definition> ::= <type-specifier> <identifier> '(' <parameter-list>? ')' <compound-statement>
+static void functionDefinition(const std::string& name, int arity) {
+    FuncSig sig = { name, g_rng.below(3), std::vector<int>() };
+    tok(kTypes[sig.returnType]);
+    tok(name);
+    raw("(");
+    g_scopes.assign(1, std::vector<VarInfo>());
+    for (int i = 0; i < arity; i++) {
+        if (i > 0) tok(",");
+        std::string param = freshVar();
+        int type = g_rng.below(3);
+        tok(kTypes[type]);
+        tok(param);
+        g_scopes.back().push_back({ param, type });
+        sig.params.push_back(type);
+    }
+    tok(")");
+    // 函数体：语句列表后以return结束
+    tok("{");
+    g_scopes.push_back(std::vector<VarInfo>());
+    int count = g_rng.range(1, std::max(1, g_opt.stmts * 2 - 1));
+    for (int i = 0; i < count; i++) {
+        statement(1, 0);
+    }
+    newline(1);
+    tok("return");
+    logicalOrExpression(0, sig.returnType);
+    tok(";");
+    g_scopes.clear();
+    newline(0);
+    tok("}");
+    raw("\n\n");
+    g_afterNumber = false;
+
+    g_functions.push_back(sig);
+}
+
+// <program> ::= <function-definition>+
+static void program() {
+    for (int i = 0; i < g_opt.vocab; i++) {
+        g_vocab.push_back(makeIdent(i));
+    }
+    int index = 0;
+    while (g_opt.targetBytes > 0 ? g_written < g_opt.targetBytes : index < g_opt.functions - 1) {
+        functionDefinition("fn" + std::to_string(index), g_rng.range(0, 3));
+        index++;
+        // 只保留最近的函数作为调用目标，避免候选集无界增长
+        if (g_functions.size() > 64) g_functions.erase(g_functions.begin());
+    }
+    functionDefinition("main", 0);
+}
+
+/* INFO 命令行 */
+
+// 解析带单位的大小：123、64K、10M、2G
+static uint64_t parseSize(const char* text) {
+    char* end = nullptr;
+    double value = strtod(text, &end);
+    switch (end && *end ? (*end | 0x20) : 0) {
+        case 'k': value *= 1024.0; break;
+        case 'm': value *= 1024.0 * 1024.0; break;
+        case 'g': value *= 1024.0 * 1024.0 * 1024.0; break;
+        default: break;
+    }
+    return (uint64_t)value;
+}
+
+static void showUsage(const char* programName) {
+    std::cout << "用法: " << programName << " [选项]\n\n";
+    std::cout << "选项:\n";
+    std::cout << "  --seed <n>            随机种子（默认 1），相同种子与参数输出完全相同\n";
+    std::cout << "  --size <大小>         目标大小，如 64K、10M、2G（优先于 --functions）\n";
+    std::cout << "  --functions <n>       函数个数（默认 10，含 main）\n";
+    std::cout << "  --depth <n>           if/while/块 的最大嵌套深度（默认 3）\n";
+    std::cout << "  --stmts <n>           每个语句块的平均语句数（默认 6）\n";
+    std::cout << "  --expr-len <n>        表达式平均操作数个数（默认 4）\n";
+    std::cout << "  --vocab <n>           标识符词汇表大小（默认 64）\n";
+    std::cout << "  --comments <p>        每条语句前插入注释的概率（默认 0.1）\n";
+    std::cout << "  --non-ascii <p>       非ASCII字符出现概率（默认 0）\n";
+    std::cout << "  --lex-errors <p>      每条语句注入词法错误的概率（默认 0）\n";
+    std::cout << "  --syntax-errors <p>   每条语句注入语法错误的概率（默认 0）\n";
+    std::cout << "  -o <文件>             输出文件（默认标准输出）\n\n";
+    std::cout << "示例: " << programName << " --seed 42 --size 100M -o big.txt\n";
+}
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (arg == "-h" || arg == "--help") {
+            showUsage(argv[0]);
+            return 0;
+        } else if (value == nullptr) {
+            std::cerr << "错误: 选项缺少参数或未知 " << arg << "\n";
+            return 1;
+        } else if (arg == "--seed") {
+            g_opt.seed = strtoull(value, nullptr, 10);
+        } else if (arg == "--size") {
+            g_opt.targetBytes = parseSize(value);
+        } else if (arg == "--functions") {
+            g_opt.functions = std::max(1, atoi(value));
+        } else if (arg == "--depth") {
+            g_opt.depth = std::max(0, atoi(value));
+        } else if (arg == "--stmts") {
+            g_opt.stmts = std::max(1, atoi(value));
+        } else if (arg == "--expr-len") {
+            g_opt.exprLen = std::max(1, atoi(value));
+        } else if (arg == "--vocab") {
+            g_opt.vocab = std::max(1, atoi(value));
+        } else if (arg == "--comments") {
+            g_opt.commentDensity = atof(value);
+        } else if (arg == "--non-ascii") {
+            g_opt.nonAscii = atof(value);
+        } else if (arg == "--lex-errors") {
+            g_opt.lexErrors = atof(value);
+        } else if (arg == "--syntax-errors") {
+            g_opt.syntaxErrors = atof(value);
+        } else if (arg == "-o") {
+            g_opt.output = value;
+        } else {
+            std::cerr << "错误: 未知选项 " << arg << "\n";
+            showUsage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+
+    g_rng.state = g_opt.seed;
+    g_out = g_opt.output.empty() ? stdout : fopen(g_opt.output.c_str(), "wb");
+    if (g_out == nullptr) {
+        std::cerr << "错误: 无法写入 " << g_opt.output << "\n";
+        return 1;
+    }
+
+    program();
+    flushOut(true);
+    if (g_out != stdout) {
+        fclose(g_out);
+    }
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include "../token_shm.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+/*
+ * 共享内存Token流的参考消费者
+ * ===========================
+ * 以只读方式映射 --export-shm 发布的段，直接在映射上遍历Token与诊断（不复制）。
+ * 默认输出摘要与各类Token的数量；--dump 按 tokens.txt 的格式输出Token列表，
+ * --diagnostics 按 lex_errors.txt / parse_errors.txt 的格式输出诊断，可与文本结果直接比较。
+ */
+
+static void showUsage(const char* programName) {
+    std::cout << "用法: " << programName << " <段名> [选项]\n\n";
+    std::cout << "选项:\n";
+    std::cout << "  --wait <毫秒>   等待段出现并就绪的最长时间（默认 5000）\n";
+    std::cout << "  --dump          按 tokens.txt 的格式输出Token列表\n";
+    std::cout << "  --diagnostics   输出词法与语法错误\n";
+    std::cout << "  --unlink        读取后删除共享内存段\n";
+}
+
+// 字符串引用是否在字符串表内
+static bool validString(const TokenShmView& view, uint32_t offset, uint32_t length) {
+    return offset <= view.header->stringBytes && length <= view.header->stringBytes - offset;
+}
+
+int main(int argc, char* argv[]) {
+    std::string name;
+    int waitMs = 5000;
+    bool dump = false;
+    bool diagnostics = false;
+    bool unlinkAfter = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            showUsage(argv[0]);
+            return 0;
+        } else if (arg == "--wait" && i + 1 < argc) {
+            waitMs = atoi(argv[++i]);
+        } else if (arg == "--dump") {
+            dump = true;
+        } else if (arg == "--diagnostics") {
+            diagnostics = true;
+        } else if (arg == "--unlink") {
+            unlinkAfter = true;
+        } else if (arg[0] != '-' && name.empty()) {
+            name = arg;
+        } else {
+            showUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (name.empty()) {
+        showUsage(argv[0]);
+        return 1;
+    }
+
+    TokenShmView view;
+    std::string error;
+    if (!tokenShmOpen(name, waitMs, view, error)) {
+        std::cerr << "错误: " << error << "\n";
+        return 1;
+    }
+    const TokenShmHeader& header = *view.header;
+
+    // 先校验全部字符串引用，之后可以放心地直接使用映射
+    bool valid = validString(view, header.sourceNameOffset, header.sourceNameLength);
+    for (uint64_t i = 0; valid && i < header.tokenCount; i++) {
+        valid = view.tokens[i].code <= TK_EOF &&
+                validString(view, view.tokens[i].valueOffset, view.tokens[i].valueLength);
+    }
+    for (uint64_t i = 0; valid && i < header.diagCount; i++) {
+        valid = validString(view, view.diagnostics[i].messageOffset, view.diagnostics[i].messageLength);
+    }
+    if (!valid) {
+        std::cerr << "错误: 段内容损坏\n";
+        tokenShmClose(view);
+        return 1;
+    }
+
+    if (dump) {
+        std::cout << "行号\t类型\t\t值\n";
+        std::cout << "-------------------------------------\n";
+        for (uint64_t i = 0; i < header.tokenCount; i++) {
+            const ShmToken& token = view.tokens[i];
+            std::cout << token.line << "\t" << getTokenName((TokenCode)token.code) << "\t"
+                      << tokenShmString(view, token.valueOffset, token.valueLength) << "\n";
+        }
+    }
+
+    if (diagnostics) {
+        for (uint64_t i = 0; i < header.diagCount; i++) {
+            const ShmDiagnostic& diagnostic = view.diagnostics[i];
+            std::cout << (diagnostic.kind == 0 ? "词法错误" : "语法错误") << "\t" << diagnostic.line << "\t"
+                      << tokenShmString(view, diagnostic.messageOffset, diagnostic.messageLength) << "\n";
+        }
+    }
+
+    if (!dump && !diagnostics) {
+        static const char* results[] = { "成功", "有错误", "仅词法分析" };
+        std::vector<uint64_t> counts(TK_EOF + 1, 0);
+        for (uint64_t i = 0; i < header.tokenCount; i++) {
+            counts[view.tokens[i].code]++;
+        }
+        std::cout << "文件: " << tokenShmString(view, header.sourceNameOffset, header.sourceNameLength) << "\n";
+        std::cout << "格式版本: " << header.major << "." << header.minor << "\n";
+        std::cout << "源文件字节数: " << header.sourceBytes << "\n";
+        std::cout << "分析结果: " << (header.result <= TOKEN_SHM_LEX_ONLY ? results[header.result] : "未知") << "\n";
+        std::cout << "Token总数: " << header.tokenCount << "\n";
+        std::cout << "字符串表字节数: " << header.stringBytes << "\n";
+        std::cout << "词法错误总数: " << header.lexErrorCount << "\n";
+        std::cout << "语法错误总数: " << header.parseErrorCount << "\n";
+        for (int code = 0; code <= TK_EOF; code++) {
+            if (counts[code] > 0) {
+                std::cout << "  " << getTokenName((TokenCode)code) << "\t" << counts[code] << "\n";
+            }
+        }
+    }
+
+    tokenShmClose(view);
+    if (unlinkAfter && !tokenShmUnlink(name)) {
+        std::cerr << "错误: 无法删除共享内存段 " << name << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include "trace.h"
+#include "json.h"
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <cstdio>
+
+/* 单个跨度事件 */
+struct TraceEvent {
+    const char* category;
+    std::string name;
+    double startUs;
+    double durUs;
+};
+
+/* 线程私有的事件缓冲区，首次使用时以无锁方式挂到全局链表上 */
+struct TraceBuffer {
+    int tid;
+    std::string threadName;
+    std::vector<TraceEvent> events;
+    TraceBuffer* next;
+};
+
+static bool g_enabled = false;
+static bool g_functions = false;
+static std::atomic<TraceBuffer*> g_buffers(nullptr);
+static std::atomic<int> g_nextTid(1);
+static const std::chrono::steady_clock::time_point g_origin = std::chrono::steady_clock::now();
+static thread_local TraceBuffer* t_buffer = nullptr;
+
+/* 辅助函数 */
+// 获取当前线程的缓冲区，不存在时创建并登记
+static TraceBuffer* threadBuffer() {
+    if (t_buffer == nullptr) {
+        TraceBuffer* buf = new TraceBuffer();
+        buf->tid = g_nextTid.fetch_add(1);
+        buf->next = g_buffers.load(std::memory_order_relaxed);
+        while (!g_buffers.compare_exchange_weak(buf->next, buf, std::memory_order_release,
+                                                std::memory_order_relaxed)) {
+        }
+        t_buffer = buf;
+    }
+    return t_buffer;
+}
+
+/* 接口实现 */
+void traceEnable(bool functions) {
+    g_enabled = true;
+    g_functions = functions;
+}
+
+bool traceEnabled() {
+    return g_enabled;
+}
+
+bool traceFunctionsEnabled() {
+    return g_functions;
+}
+
+double traceNowUs() {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - g_origin).count();
+}
+
+void traceSpan(const char* category, const std::string& name, double startUs) {
+    if (!g_enabled) return;
+    double now = traceNowUs();
+    threadBuffer()->events.push_back(TraceEvent{category, name, startUs, now - startUs});
+}
+
+void traceThreadName(const std::string& name) {
+    if (!g_enabled) return;
+    threadBuffer()->threadName = name;
+}
+
+bool traceWrite(const std::string& path) {
+    FILE* fp = fopen(path.c_str(), "w");
+    if (fp == nullptr) {
+        return false;
+    }
+
+    std::string line;
+    char num[96];
+    bool first = true;
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", fp);
+    for (TraceBuffer* buf = g_buffers.load(std::memory_order_acquire); buf; buf = buf->next) {
+        if (!buf->threadName.empty()) {
+            line = first ? "" : ",\n";
+            line += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" + std::to_string(buf->tid) +
+                    ",\"args\":{\"name\":";
+            appendJsonString(line, buf->threadName);
+            line += "}}";
+            fputs(line.c_str(), fp);
+            first = false;
+        }
+        for (const auto& ev : buf->events) {
+            line = first ? "" : ",\n";
+            line += "{\"ph\":\"X\",\"pid\":1,\"tid\":" + std::to_string(buf->tid) + ",\"cat\":\"";
+            line += ev.category;
+            line += "\",\"name\":";
+            appendJsonString(line, ev.name);
+            snprintf(num, sizeof(num), ",\"ts\":%.3f,\"dur\":%.3f}", ev.startUs, ev.durUs);
+            line += num;
+            fputs(line.c_str(), fp);
+            first = false;
+        }
+    }
+    fputs("\n]}\n", fp);
+    return fclose(fp) == 0;
+}
@@ -0,0 +1,33 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <string>
+
+/*
+ * Chrome/Perfetto 追踪事件输出（--trace）
+ * 每个线程把跨度记录在自己的缓冲区中，记录时不加锁；
+ * 进程结束前由主线程统一写出为 trace-event JSON。
+ */
+
+// 启用追踪；functions 为true时同时记录每个函数定义的解析跨度
+void traceEnable(bool functions);
+
+// 是否启用追踪
+bool traceEnabled();
+
+// 是否记录函数定义跨度
+bool traceFunctionsEnabled();
+
+// 当前时间（微秒，相对进程内的追踪起点）
+double traceNowUs();
+
+// 记录一个从startUs到当前时刻的跨度（仅写当前线程的缓冲区）
+void traceSpan(const char* category, const std::string& name, double startUs);
+
+// 为当前线程命名（显示在追踪视图的线程标题上）
+void traceThreadName(const std::string& name);
+
+// 写出所有线程记录的事件，须在工作线程结束后调用
+bool traceWrite(const std::string& path);
+
+#endif /* TRACE_H */
@@ -0,0 +1,617 @@
+#include "vm.h"
+#include <unordered_map>
+#include <cstdio>
+
+static const char* const kOpNames[VM_OP_COUNT] = {
+#define VM_NAME(name, text, format) text,
+    VM_OPCODES(VM_NAME)
+#undef VM_NAME
+};
+
+static const char* const kOpFormats[VM_OP_COUNT] = {
+#define VM_FORMAT(name, text, format) format,
+    VM_OPCODES(VM_FORMAT)
+#undef VM_FORMAT
+};
+
+/* INFO 运行时语义（与 ir.h、opt.cpp 的常量折叠一致） */
+
+static inline int32_t wrapAdd(int32_t x, int32_t y) {
+    return (int32_t)((uint32_t)x + (uint32_t)y);
+}
+
+static inline int32_t wrapSub(int32_t x, int32_t y) {
+    return (int32_t)((uint32_t)x - (uint32_t)y);
+}
+
+static inline int32_t wrapMul(int32_t x, int32_t y) {
+    return (int32_t)((uint32_t)x * (uint32_t)y);
+}
+
+// 除数非0；INT_MIN / -1 的结果为 INT_MIN
+static inline int32_t divide(int32_t x, int32_t y) {
+    return y == -1 ? wrapSub(0, x) : x / y;
+}
+
+// 浮点转 int：向零截断，超出范围或 NaN 时为 INT_MIN
+static inline int32_t toInt(double d) {
+    return d > -2147483649.0 && d < 2147483648.0 ? (int32_t)d : INT32_MIN;
+}
+
+/* INFO 字节码生成 */
+
+// 程序的常量池索引：每种类型一张表，位模式 -> 常量池下标
+struct ConstIndex {
+    std::unordered_map<uint64_t, int32_t> byType[TYPE_DOUBLE + 1];
+};
+
+struct BytecodeCompiler {
+    const IrFunction& function;
+    VmProgram& program;
+    ConstIndex& constIndex;
+    std::vector<int32_t> reg;                            // 值 -> 寄存器，未分配为-1
+    std::vector<uint32_t> uses;                          // 各值被使用的次数
+    std::vector<uint32_t> blockStart;                    // 块 -> 首条指令的下标
+    std::vector<std::pair<size_t, uint32_t>> fixups;     // 待填写跳转目标的指令与目标块
+    int32_t nextReg;
+    int32_t scratch[2] = { -1, -1 };                     // 暂存寄存器（装入左操作数常量等）
+    uint32_t current = 0;                                // 正在生成的块
+    int32_t line = 0;
+
+    BytecodeCompiler(const IrFunction& function, VmProgram& program, ConstIndex& constIndex)
+        : function(function), program(program), constIndex(constIndex), reg(function.values.size(), -1),
+          uses(function.values.size(), 0), nextReg((int32_t)function.slotCount) {
+        for (uint32_t v = 0; v < function.slotCount; v++) reg[v] = (int32_t)v;
+    }
+
+    bool isConst(uint32_t value) const { return function.values[value].kind == IRV_CONST; }
+    MiniType typeOf(uint32_t value) const { return function.values[value].type; }
+
+    int32_t regOf(uint32_t value) {
+        if (reg[value] < 0) reg[value] = nextReg++;
+        return reg[value];
+    }
+
+    int32_t scratchReg(int k) {
+        if (scratch[k] < 0) scratch[k] = nextReg++;
+        return scratch[k];
+    }
+
+    int32_t constOf(uint32_t value) {
+        const IrValue& v = function.values[value];
+        VmSlot slot;
+        slot.bits = 0;
+        if (v.type == TYPE_INT) slot.i = v.intValue;
+        else if (v.type == TYPE_FLOAT) slot.f = (float)v.doubleValue;
+        else slot.d = v.doubleValue;
+        std::unordered_map<uint64_t, int32_t>& index = constIndex.byType[v.type];
+        auto it = index.find(slot.bits);
+        if (it != index.end()) return it->second;
+        program.consts.push_back(slot);
+        program.constTypes.push_back(v.type);
+        index.emplace(slot.bits, (int32_t)program.consts.size() - 1);
+        return (int32_t)program.consts.size() - 1;
+    }
+
+    size_t emit(VmOp op, int32_t a, int32_t b, int32_t c) {
+        program.code.push_back(VmInst{ nullptr, op, a, b, c });
+        program.lines.push_back(line);
+        return program.code.size() - 1;
+    }
+
+    void jumpTo(VmOp op, int32_t a, int32_t b, uint32_t block) {
+        fixups.push_back({ emit(op, a, b, 0), block });
+    }
+
+    // 跳到 block；是下一个块时省去
+    void jumpUnlessNext(uint32_t block) {
+        if (block != current + 1) jumpTo(VM_JMP, 0, 0, block);
+    }
+
+    // 把常量装入寄存器
+    void load(int32_t dst, uint32_t value) {
+        if (typeOf(value) == TYPE_INT) emit(VM_LOADI, dst, 0, function.values[value].intValue);
+        else emit(VM_LOADK, dst, 0, constOf(value));
+    }
+
+    // 操作数所在的寄存器，常量先装入第k个暂存寄存器
+    int32_t operand(uint32_t value, int k) {
+        if (!isConst(value)) return regOf(value);
+        int32_t r = scratchReg(k);
+        load(r, value);
+        return r;
+    }
+
+    static bool commutative(IrOp op) {
+        return op == IR_ADD || op == IR_MUL || op == IR_AND || op == IR_OR || op == IR_EQ || op == IR_NE;
+    }
+
+    // a op b 等价于 b flip(op) a
+    static IrOp flip(IrOp op) {
+        switch (op) {
+            case IR_LT: return IR_GT;
+            case IR_LE: return IR_GE;
+            case IR_GT: return IR_LT;
+            case IR_GE: return IR_LE;
+            default: return op;
+        }
+    }
+
+    // 条件取反（只用于 int 比较）
+    static IrOp negate(IrOp op) {
+        switch (op) {
+            case IR_EQ: return IR_NE;
+            case IR_NE: return IR_EQ;
+            case IR_LT: return IR_GE;
+            case IR_LE: return IR_GT;
+            case IR_GT: return IR_LE;
+            default: return IR_LT;   // IR_GE
+        }
+    }
+
+    // 各类型二元运算的首个操作码；int 有 and/or，浮点没有
+    static VmOp binaryOp(IrOp op, MiniType type, bool constant) {
+        if (type == TYPE_INT) return (VmOp)((constant ? VM_ADD_IK : VM_ADD_I) + (op - IR_ADD));
+        uint32_t offset = op <= IR_DIV ? op - IR_ADD : op - IR_EQ + 4;
+        if (type == TYPE_FLOAT) return (VmOp)((constant ? VM_ADD_FK : VM_ADD_F) + offset);
+        return (VmOp)((constant ? VM_ADD_DK : VM_ADD_D) + offset);
+    }
+
+    // 右操作数为常量时的编码：int 为立即数，浮点为常量池下标
+    int32_t constOperand(uint32_t value) {
+        return typeOf(value) == TYPE_INT ? function.values[value].intValue : constOf(value);
+    }
+
+    // 左操作数为常量时交换；返回是否能以“寄存器 op 常量”的形式生成
+    bool orient(IrOp& op, uint32_t& a, uint32_t& b) {
+        if (isConst(a) && !isConst(b)) {
+            if (commutative(op)) {
+                std::swap(a, b);
+            } else if (op >= IR_LT) {
+                std::swap(a, b);
+                op = flip(op);
+            }
+        }
+        // int 除以常量0 留到运行时报错，走寄存器形式
+        return isConst(b) && !(op == IR_DIV && typeOf(b) == TYPE_INT && function.values[b].intValue == 0);
+    }
+
+    void binary(const IrInst& inst) {
+        IrOp op = inst.op;
+        uint32_t a = inst.a, b = inst.b;
+        MiniType type = typeOf(a);
+        bool constant = orient(op, a, b);
+        int32_t left = operand(a, 0);
+        int32_t right = constant ? constOperand(b) : operand(b, 1);
+        emit(binaryOp(op, type, constant), regOf(inst.dst), left, right);
+    }
+
+    void conv(const IrInst& inst) {
+        MiniType from = typeOf(inst.a), to = typeOf(inst.dst);
+        int32_t src = operand(inst.a, 0), dst = regOf(inst.dst);
+        if (from == to) {
+            emit(VM_MOV, dst, src, 0);
+            return;
+        }
+        static const VmOp ops[4][4] = {
+            {},
+            { VM_MOV, VM_MOV, VM_CONV_IF, VM_CONV_ID },
+            { VM_MOV, VM_CONV_FI, VM_MOV, VM_CONV_FD },
+            { VM_MOV, VM_CONV_DI, VM_CONV_DF, VM_MOV },
+        };
+        emit(ops[from][to], dst, src, 0);
+    }
+
+    // 比较后紧跟只以其结果为条件的 br（int 操作数）时合并为比较跳转
+    bool fusable(const IrInst& compare, const IrInst& next) const {
+        return compare.op >= IR_EQ && compare.op <= IR_GE && next.op == IR_BR && next.a == compare.dst &&
+               function.values[compare.dst].kind == IRV_TEMP && uses[compare.dst] == 1 &&
+               typeOf(compare.a) == TYPE_INT && !(isConst(compare.a) && isConst(compare.b));
+    }
+
+    void compareBranch(const IrInst& compare, const IrInst& br) {
+        IrOp op = compare.op;
+        uint32_t a = compare.a, b = compare.b;
+        bool constant = orient(op, a, b);
+        uint32_t target = br.b, other = br.c;
+        if (target == current + 1) {
+            op = negate(op);
+            std::swap(target, other);
+        }
+        int32_t left = regOf(a);
+        int32_t right = constant ? function.values[b].intValue : regOf(b);
+        jumpTo((VmOp)((constant ? VM_BEQK : VM_BEQ) + (op - IR_EQ)), left, right, target);
+        jumpUnlessNext(other);
+    }
+
+    void branch(const IrInst& br) {
+        const IrValue& condition = function.values[br.a];
+        if (condition.kind == IRV_CONST) {
+            bool taken = condition.type == TYPE_INT ? condition.intValue != 0 : condition.doubleValue != 0;
+            jumpUnlessNext(taken ? br.b : br.c);
+            return;
+        }
+        int32_t r = regOf(br.a);
+        if (condition.type == TYPE_INT && br.b == current + 1) {
+            jumpTo(VM_JZ_I, r, 0, br.c);
+            return;
+        }
+        VmOp op = condition.type == TYPE_INT ? VM_JNZ_I : condition.type == TYPE_FLOAT ? VM_JNZ_F : VM_JNZ_D;
+        jumpTo(op, r, 0, br.b);
+        jumpUnlessNext(br.c);
+    }
+
+    void call(const IrInst& inst) {
+        int32_t offset = (int32_t)program.callArgs.size();
+        for (uint32_t k = 0; k < inst.c; k++) {
+            uint32_t arg = function.args[inst.b + k];
+            program.callArgs.push_back(isConst(arg) ? ~constOf(arg) : regOf(arg));
+        }
+        int32_t dst = inst.dst != kNoValue ? regOf(inst.dst) : scratchReg(0);
+        emit(VM_CALL, dst, (int32_t)inst.a, offset);
+    }
+
+    void run(VmFunction& target) {
+        for (const IrInst& inst : function.insts) {
+            if (inst.op == IR_NOP) continue;
+            if (inst.op == IR_CALL) {
+                for (uint32_t k = 0; k < inst.c; k++) uses[function.args[inst.b + k]]++;
+            } else if (inst.op >= IR_MOV && inst.op <= IR_GE) {
+                uses[inst.a]++;
+                if (inst.op != IR_MOV && inst.op != IR_CONV) uses[inst.b]++;
+            } else if (inst.op == IR_BR || inst.op == IR_RET) {
+                uses[inst.a]++;
+            }
+        }
+
+        target.entry = (uint32_t)program.code.size();
+        blockStart.assign(function.blocks.size(), 0);
+        for (current = 0; current < function.blocks.size(); current++) {
+            const IrBlock& block = function.blocks[current];
+            blockStart[current] = (uint32_t)program.code.size();
+            for (uint32_t i = block.begin; i < block.end; i++) {
+                const IrInst& inst = function.insts[i];
+                line = inst.line;
+                switch (inst.op) {
+                    case IR_NOP:
+                        break;
+                    case IR_MOV:
+                        if (isConst(inst.a)) load(regOf(inst.dst), inst.a);
+                        else emit(VM_MOV, regOf(inst.dst), regOf(inst.a), 0);
+                        break;
+                    case IR_CONV:
+                        conv(inst);
+                        break;
+                    case IR_CALL:
+                        call(inst);
+                        break;
+                    case IR_JMP:
+                        jumpUnlessNext(inst.b);
+                        break;
+                    case IR_BR:
+                        branch(inst);
+                        break;
+                    case IR_RET:
+                        emit(VM_RET, operand(inst.a, 0), 0, 0);
+                        break;
+                    default:
+                        if (i + 1 < block.end && fusable(inst, function.insts[i + 1])) {
+                            compareBranch(inst, function.insts[i + 1]);
+                            i++;
+                        } else {
+                            binary(inst);
+                        }
+                        break;
+                }
+            }
+        }
+        for (const auto& fixup : fixups) program.code[fixup.first].c = (int32_t)blockStart[fixup.second];
+        target.frameSize = (uint32_t)nextReg;
+    }
+};
+
+/* 接口实现 */
+
+void compileBytecode(const IrModule& module, VmProgram& program) {
+    program = VmProgram();
+    ConstIndex constIndex;
+    for (const IrFunction& function : module.functions) {
+        VmFunction target;
+        target.name = function.name;
+        target.returnType = function.returnType;
+        target.paramCount = function.paramCount;
+        target.slotCount = function.slotCount;
+        BytecodeCompiler compiler(function, program, constIndex);
+        compiler.run(target);
+        program.functions.push_back(target);
+    }
+}
+
+uint32_t vmFindFunction(const VmProgram& program, const std::string& name) {
+    for (uint32_t f = 0; f < program.functions.size(); f++) {
+        if (program.functions[f].name == name) return f;
+    }
+    return UINT32_MAX;
+}
+
+// 解释器主循环：直接线索化，每条指令的处理例程末尾跳到下一条的处理例程
+bool vmRun(VmProgram& program, VmMachine& machine, uint32_t function, VmResult& result) {
+    static const void* const handlers[VM_OP_COUNT] = {
+#define VM_LABEL(name, text, format) &&L_##name,
+        VM_OPCODES(VM_LABEL)
+#undef VM_LABEL
+    };
+    if (!program.threaded) {
+        for (VmInst& inst : program.code) inst.handler = handlers[inst.op];
+        program.threaded = true;
+    }
+    if (machine.stack.size() < kVmStackSlots) machine.stack.resize(kVmStackSlots);
+    if (machine.frames.size() < kVmMaxDepth) machine.frames.resize(kVmMaxDepth);
+
+    const VmFunction* functions = program.functions.data();
+    const VmInst* const code = program.code.data();
+    const VmSlot* const consts = program.consts.data();
+    const int32_t* const callArgs = program.callArgs.data();
+    VmFrame* const frames = machine.frames.data();
+    const VmSlot* const stackEnd = machine.stack.data() + machine.stack.size();
+
+    const VmFunction& entry = functions[function];
+    result = VmResult();
+    result.type = entry.returnType;
+    VmSlot* base = machine.stack.data();
+    uint32_t frameSize = entry.frameSize;
+    size_t depth = 0;
+    uint64_t executed = 0;
+    const VmInst* pc = code + entry.entry;
+    if (base + frameSize > stackEnd) {
+        result.error = "调用栈溢出";
+        return false;
+    }
+    for (uint32_t k = 0; k < entry.slotCount; k++) base[k].bits = 0;
+
+#define I(r) base[r].i
+#define F(r) base[r].f
+#define D(r) base[r].d
+#define DISPATCH()            \
+    do {                      \
+        executed++;           \
+        goto *pc->handler;    \
+    } while (0)
+#define NEXT()   \
+    do {         \
+        pc++;    \
+        DISPATCH(); \
+    } while (0)
+#define JUMP(target)             \
+    do {                         \
+        pc = code + (target);    \
+        DISPATCH();              \
+    } while (0)
+
+// 二元运算：T 为槽位字段，K 为“寄存器 op 常量”形式的右操作数
+#define BINARY_INT(NAME, EXPR)                                         \
+    L_##NAME##_I : {                                                   \
+        int32_t x = I(pc->b), y = I(pc->c);                            \
+        I(pc->a) = (EXPR);                                             \
+        NEXT();                                                        \
+    }                                                                  \
+    L_##NAME##_IK : {                                                  \
+        int32_t x = I(pc->b), y = pc->c;                               \
+        I(pc->a) = (EXPR);                                             \
+        NEXT();                                                        \
+    }
+#define BINARY_FLOAT(NAME, SUFFIX, FIELD, RESULT, EXPR)                \
+    L_##NAME##_##SUFFIX : {                                            \
+        auto x = base[pc->b].FIELD, y = base[pc->c].FIELD;             \
+        base[pc->a].RESULT = (EXPR);                                   \
+        NEXT();                                                        \
+    }                                                                  \
+    L_##NAME##_##SUFFIX##K : {                                         \
+        auto x = base[pc->b].FIELD, y = consts[pc->c].FIELD;           \
+        base[pc->a].RESULT = (EXPR);                                   \
+        NEXT();                                                        \
+    }
+#define BINARY_REAL(SUFFIX, FIELD)                                     \
+    BINARY_FLOAT(ADD, SUFFIX, FIELD, FIELD, x + y)                     \
+    BINARY_FLOAT(SUB, SUFFIX, FIELD, FIELD, x - y)                     \
+    BINARY_FLOAT(MUL, SUFFIX, FIELD, FIELD, x * y)                     \
+    BINARY_FLOAT(DIV, SUFFIX, FIELD, FIELD, x / y)                     \
+    BINARY_FLOAT(EQ, SUFFIX, FIELD, i, x == y)                         \
+    BINARY_FLOAT(NE, SUFFIX, FIELD, i, x != y)                         \
+    BINARY_FLOAT(LT, SUFFIX, FIELD, i, x < y)                          \
+    BINARY_FLOAT(LE, SUFFIX, FIELD, i, x <= y)                         \
+    BINARY_FLOAT(GT, SUFFIX, FIELD, i, x > y)                          \
+    BINARY_FLOAT(GE, SUFFIX, FIELD, i, x >= y)
+// 比较跳转：c 为目标
+#define COMPARE_BRANCH(NAME, OP)                                       \
+    L_##NAME : {                                                       \
+        if (I(pc->a) OP I(pc->b)) JUMP(pc->c);                         \
+        NEXT();                                                        \
+    }                                                                  \
+    L_##NAME##K : {                                                    \
+        if (I(pc->a) OP pc->b) JUMP(pc->c);                            \
+        NEXT();                                                        \
+    }
+
+    DISPATCH();
+
+L_MOV:
+    base[pc->a] = base[pc->b];
+    NEXT();
+L_LOADI:
+    I(pc->a) = pc->c;
+    NEXT();
+L_LOADK:
+    base[pc->a] = consts[pc->c];
+    NEXT();
+
+    BINARY_INT(ADD, wrapAdd(x, y))
+    BINARY_INT(SUB, wrapSub(x, y))
+    BINARY_INT(MUL, wrapMul(x, y))
+    BINARY_INT(AND, x & y)
+    BINARY_INT(OR, x | y)
+    BINARY_INT(EQ, x == y)
+    BINARY_INT(NE, x != y)
+    BINARY_INT(LT, x < y)
+    BINARY_INT(LE, x <= y)
+    BINARY_INT(GT, x > y)
+    BINARY_INT(GE, x >= y)
+L_DIV_I : {
+    int32_t y = I(pc->c);
+    if (y == 0) goto divideByZero;
+    I(pc->a) = divide(I(pc->b), y);
+    NEXT();
+}
+L_DIV_IK:
+    I(pc->a) = divide(I(pc->b), pc->c);
+    NEXT();
+
+    BINARY_REAL(F, f)
+    BINARY_REAL(D, d)
+
+L_CONV_IF:
+    F(pc->a) = (float)I(pc->b);
+    NEXT();
+L_CONV_ID:
+    D(pc->a) = (double)I(pc->b);
+    NEXT();
+L_CONV_FI:
+    I(pc->a) = toInt(F(pc->b));
+    NEXT();
+L_CONV_FD:
+    D(pc->a) = (double)F(pc->b);
+    NEXT();
+L_CONV_DI:
+    I(pc->a) = toInt(D(pc->b));
+    NEXT();
+L_CONV_DF:
+    F(pc->a) = (float)D(pc->b);
+    NEXT();
+
+L_JMP:
+    JUMP(pc->c);
+L_JNZ_I:
+    if (I(pc->a) != 0) JUMP(pc->c);
+    NEXT();
+L_JZ_I:
+    if (I(pc->a) == 0) JUMP(pc->c);
+    NEXT();
+L_JNZ_F:
+    if (F(pc->a) != 0) JUMP(pc->c);
+    NEXT();
+L_JNZ_D:
+    if (D(pc->a) != 0) JUMP(pc->c);
+    NEXT();
+
+    COMPARE_BRANCH(BEQ, ==)
+    COMPARE_BRANCH(BNE, !=)
+    COMPARE_BRANCH(BLT, <)
+    COMPARE_BRANCH(BLE, <=)
+    COMPARE_BRANCH(BGT, >)
+    COMPARE_BRANCH(BGE, >=)
+
+L_CALL : {
+    const VmFunction& callee = functions[pc->b];
+    VmSlot* next = base + frameSize;
+    if (depth == kVmMaxDepth || next + callee.frameSize > stackEnd) goto stackOverflow;
+    const int32_t* args = callArgs + pc->c;
+    for (uint32_t k = 0; k < callee.paramCount; k++) next[k] = args[k] >= 0 ? base[args[k]] : consts[~args[k]];
+    for (uint32_t k = callee.paramCount; k < callee.slotCount; k++) next[k].bits = 0;
+    frames[depth++] = VmFrame{ pc, base, frameSize };
+    base = next;
+    frameSize = callee.frameSize;
+    JUMP(callee.entry);
+}
+L_RET : {
+    VmSlot value = base[pc->a];
+    if (depth == 0) {
+        result.value = value;
+        result.ok = true;
+        result.instructions = executed;
+        return true;
+    }
+    const VmFrame& frame = frames[--depth];
+    pc = frame.pc;
+    base = frame.base;
+    frameSize = frame.frameSize;
+    base[pc->a] = value;
+    NEXT();
+}
+
+divideByZero:
+    result.error = "int 除以0";
+    result.errorLine = program.lines[pc - code];
+    result.instructions = executed;
+    return false;
+stackOverflow:
+    result.error = "调用栈溢出（深度 " + std::to_string(depth) + "）";
+    result.errorLine = program.lines[pc - code];
+    result.instructions = executed;
+    return false;
+
+#undef I
+#undef F
+#undef D
+#undef DISPATCH
+#undef NEXT
+#undef JUMP
+#undef BINARY_INT
+#undef BINARY_FLOAT
+#undef BINARY_REAL
+#undef COMPARE_BRANCH
+}
+
+std::string vmValueText(MiniType type, VmSlot value) {
+    if (type == TYPE_INT) return std::to_string(value.i);
+    char buf[64];
+    snprintf(buf, sizeof(buf), type == TYPE_FLOAT ? "%.9g" : "%.17g", type == TYPE_FLOAT ? (double)value.f : value.d);
+    return buf;
+}
+
+std::string dumpBytecode(const VmProgram& program) {
+    std::string out;
+    char buf[64];
+    for (size_t f = 0; f < program.functions.size(); f++) {
+        const VmFunction& function = program.functions[f];
+        size_t end = f + 1 < program.functions.size() ? program.functions[f + 1].entry : program.code.size();
+        out += std::string(miniTypeName(function.returnType)) + " " + function.name + "    ; 参数 " +
+               std::to_string(function.paramCount) + "，变量 " + std::to_string(function.slotCount) + "，帧 " +
+               std::to_string(function.frameSize) + " 槽\n";
+        for (size_t i = function.entry; i < end; i++) {
+            const VmInst& inst = program.code[i];
+            const char* format = kOpFormats[inst.op];
+            snprintf(buf, sizeof(buf), "%6zu  %-8s", i, kOpNames[inst.op]);
+            out += buf;
+            const int32_t fields[3] = { inst.a, inst.b, inst.c };
+            bool first = true;
+            for (int k = 0; k < 3; k++) {
+                if (format[k] == '-') continue;
+                out += first ? " " : ", ";
+                first = false;
+                int32_t x = fields[k];
+                switch (format[k]) {
+                    case 'r': out += "r" + std::to_string(x); break;
+                    case 'i': out += std::to_string(x); break;
+                    case 'k': out += vmValueText(program.constTypes[x], program.consts[x]); break;
+                    case 't': out += "@" + std::to_string(x); break;
+                    case 'f': out += program.functions[x].name; break;
+                    case 'a': {
+                        const VmFunction& callee = program.functions[inst.b];
+                        out += "(";
+                        for (uint32_t p = 0; p < callee.paramCount; p++) {
+                            int32_t arg = program.callArgs[x + p];
+                            if (p) out += ", ";
+                            out += arg >= 0 ? "r" + std::to_string(arg)
+                                            : vmValueText(program.constTypes[~arg], program.consts[~arg]);
+                        }
+                        out += ")";
+                        break;
+                    }
+                }
+            }
+            out += "\n";
+        }
+        out += "\n";
+    }
+    return out;
+}
@@ -0,0 +1,151 @@
+#ifndef VM_H
+#define VM_H
+
+#include "ir.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/*
+ * 字节码与虚拟机
+ * ===========================
+ * 由中间代码（可先经 opt.h 优化）编译为寄存器式字节码并执行，语义与 ir.h 一致：
+ *   - 寄存器：函数的每个变量与临时值在帧中占一个8字节槽位（VmSlot），按声明的静态类型
+ *     以 int32/float/double 不装箱存放。指令按操作数类型特化（add.i/add.f/add.d），运行时不检查类型。
+ *   - 常量：int 常量作为立即数编在指令中，浮点常量放在程序的常量池。右操作数为常量时用 k 形式的指令；
+ *     左操作数为常量时交换操作数（比较同时翻转），不能交换时先装入暂存寄存器。
+ *   - 比较的结果只被紧随其后的 br 使用时（int 操作数），两条合并为一条比较跳转指令；
+ *     跳转到下一个块时省去 jmp，必要时把条件取反。
+ *   - 分发：直接线索化。第一次执行前把每条指令的操作码换成处理例程的地址（GCC 的标签地址），
+ *     每条指令末尾 goto *pc->handler 跳到下一条的处理例程，没有集中的 switch。
+ *   - 调用：全部帧在一个预先分配的连续槽位栈上，被调用者的帧紧接在调用者的帧之后；
+ *     返回地址与帧基址存放在预先分配的调用信息数组中。调用与返回不分配堆内存。
+ *     变量在函数入口清零（参数除外），超出栈容量时报告运行时错误。
+ * 运行时错误（int 除以0、调用栈溢出）报告源码行号并停止执行。
+ */
+
+// 一个寄存器槽位：按静态类型解释
+union VmSlot {
+    int32_t i;
+    float f;
+    double d;
+    uint64_t bits;
+};
+
+// 操作码：名称、文本、操作数格式（a b c 三个字段：r 寄存器，i 立即数，k 常量池下标，
+// t 跳转目标，f 函数编号，a 实参表下标，- 不用）
+// 各类型的二元运算按 IrOp 的顺序排列，编译时按偏移选取
+#define VM_OPCODES(X)                                                                        \
+    X(MOV, "mov", "rr-") X(LOADI, "loadi", "r-i") X(LOADK, "loadk", "r-k")                   \
+    X(ADD_I, "add.i", "rrr") X(SUB_I, "sub.i", "rrr") X(MUL_I, "mul.i", "rrr")              \
+    X(DIV_I, "div.i", "rrr") X(AND_I, "and.i", "rrr") X(OR_I, "or.i", "rrr")                \
+    X(EQ_I, "eq.i", "rrr") X(NE_I, "ne.i", "rrr") X(LT_I, "lt.i", "rrr")                    \
+    X(LE_I, "le.i", "rrr") X(GT_I, "gt.i", "rrr") X(GE_I, "ge.i", "rrr")                    \
+    X(ADD_IK, "add.ik", "rri") X(SUB_IK, "sub.ik", "rri") X(MUL_IK, "mul.ik", "rri")        \
+    X(DIV_IK, "div.ik", "rri") X(AND_IK, "and.ik", "rri") X(OR_IK, "or.ik", "rri")          \
+    X(EQ_IK, "eq.ik", "rri") X(NE_IK, "ne.ik", "rri") X(LT_IK, "lt.ik", "rri")              \
+    X(LE_IK, "le.ik", "rri") X(GT_IK, "gt.ik", "rri") X(GE_IK, "ge.ik", "rri")              \
+    X(ADD_F, "add.f", "rrr") X(SUB_F, "sub.f", "rrr") X(MUL_F, "mul.f", "rrr")              \
+    X(DIV_F, "div.f", "rrr") X(EQ_F, "eq.f", "rrr") X(NE_F, "ne.f", "rrr")                  \
+    X(LT_F, "lt.f", "rrr") X(LE_F, "le.f", "rrr") X(GT_F, "gt.f", "rrr")                    \
+    X(GE_F, "ge.f", "rrr")                                                                  \
+    X(ADD_FK, "add.fk", "rrk") X(SUB_FK, "sub.fk", "rrk") X(MUL_FK, "mul.fk", "rrk")        \
+    X(DIV_FK, "div.fk", "rrk") X(EQ_FK, "eq.fk", "rrk") X(NE_FK, "ne.fk", "rrk")            \
+    X(LT_FK, "lt.fk", "rrk") X(LE_FK, "le.fk", "rrk") X(GT_FK, "gt.fk", "rrk")              \
+    X(GE_FK, "ge.fk", "rrk")                                                                \
+    X(ADD_D, "add.d", "rrr") X(SUB_D, "sub.d", "rrr") X(MUL_D, "mul.d", "rrr")              \
+    X(DIV_D, "div.d", "rrr") X(EQ_D, "eq.d", "rrr") X(NE_D, "ne.d", "rrr")                  \
+    X(LT_D, "lt.d", "rrr") X(LE_D, "le.d", "rrr") X(GT_D, "gt.d", "rrr")                    \
+    X(GE_D, "ge.d", "rrr")                                                                  \
+    X(ADD_DK, "add.dk", "rrk") X(SUB_DK, "sub.dk", "rrk") X(MUL_DK, "mul.dk", "rrk")        \
+    X(DIV_DK, "div.dk", "rrk") X(EQ_DK, "eq.dk", "rrk") X(NE_DK, "ne.dk", "rrk")            \
+    X(LT_DK, "lt.dk", "rrk") X(LE_DK, "le.dk", "rrk") X(GT_DK, "gt.dk", "rrk")              \
+    X(GE_DK, "ge.dk", "rrk")                                                                \
+    X(CONV_IF, "conv.if", "rr-") X(CONV_ID, "conv.id", "rr-") X(CONV_FI, "conv.fi", "rr-")  \
+    X(CONV_FD, "conv.fd", "rr-") X(CONV_DI, "conv.di", "rr-") X(CONV_DF, "conv.df", "rr-")  \
+    X(JMP, "jmp", "--t") X(JNZ_I, "jnz.i", "r-t") X(JZ_I, "jz.i", "r-t")                    \
+    X(JNZ_F, "jnz.f", "r-t") X(JNZ_D, "jnz.d", "r-t")                                       \
+    X(BEQ, "beq", "rrt") X(BNE, "bne", "rrt") X(BLT, "blt", "rrt")                          \
+    X(BLE, "ble", "rrt") X(BGT, "bgt", "rrt") X(BGE, "bge", "rrt")                          \
+    X(BEQK, "beqk", "rit") X(BNEK, "bnek", "rit") X(BLTK, "bltk", "rit")                    \
+    X(BLEK, "blek", "rit") X(BGTK, "bgtk", "rit") X(BGEK, "bgek", "rit")                    \
+    X(CALL, "call", "rfa") X(RET, "ret", "r--")
+
+enum VmOp : uint32_t {
+#define VM_ENUM(name, text, format) VM_##name,
+    VM_OPCODES(VM_ENUM)
+#undef VM_ENUM
+    VM_OP_COUNT
+};
+
+// 一条指令（定长，24字节）
+struct VmInst {
+    const void* handler;    // 线索化后为处理例程的地址
+    VmOp op;
+    int32_t a, b, c;        // 操作数，格式见 VM_OPCODES
+};
+
+// 一个函数
+struct VmFunction {
+    std::string name;
+    MiniType returnType;
+    uint32_t entry;         // 首条指令在 code 中的下标
+    uint32_t paramCount;    // 参数为寄存器 0..paramCount-1
+    uint32_t slotCount;     // 变量为寄存器 0..slotCount-1，入口时参数之外的变量清零
+    uint32_t frameSize;     // 帧的槽位数
+};
+
+// 整个程序
+struct VmProgram {
+    std::vector<VmInst> code;           // 全部函数的指令，跳转目标为其中的下标
+    std::vector<int32_t> lines;         // 各指令的源码行号
+    std::vector<VmSlot> consts;         // 常量池（按类型存放）
+    std::vector<MiniType> constTypes;
+    std::vector<int32_t> callArgs;      // 调用的实参：非负为寄存器，负数 ~k 为常量池下标
+    std::vector<VmFunction> functions;  // 与 IrModule::functions 一一对应
+    bool threaded = false;              // 是否已线索化
+};
+
+// 执行时的栈（可在多次执行间复用）
+struct VmFrame {
+    const VmInst* pc;       // 调用指令
+    VmSlot* base;           // 调用者的帧基址
+    uint32_t frameSize;     // 调用者的帧大小
+};
+
+struct VmMachine {
+    std::vector<VmSlot> stack;          // 全部帧的槽位
+    std::vector<VmFrame> frames;        // 调用信息
+};
+
+static const size_t kVmStackSlots = 1u << 20;   // 槽位栈容量（8MB）
+static const size_t kVmMaxDepth = 1u << 16;     // 最大调用深度
+
+// 一次执行的结果
+struct VmResult {
+    bool ok = false;
+    MiniType type = TYPE_INT;     // 返回值类型
+    VmSlot value;                 // 返回值
+    uint64_t instructions = 0;    // 执行的指令数
+    int32_t errorLine = 0;        // 运行时错误的源码行号
+    std::string error;            // 运行时错误信息
+};
+
+/* INFO 编译与执行接口 */
+
+// 由中间代码生成字节码
+void compileBytecode(const IrModule& module, VmProgram& program);
+
+// 函数编号，不存在时返回 UINT32_MAX
+uint32_t vmFindFunction(const VmProgram& program, const std::string& name);
+
+// 以全0的实参执行第function个函数，返回是否正常结束
+bool vmRun(VmProgram& program, VmMachine& machine, uint32_t function, VmResult& result);
+
+// 返回值的文本（按类型）
+std::string vmValueText(MiniType type, VmSlot value);
+
+// 以文本形式输出字节码
+std::string dumpBytecode(const VmProgram& program);
+
+#endif /* VM_H */